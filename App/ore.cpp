@@ -62,20 +62,27 @@ int main(int argc, char** argv) {
         exit(0);
     }
 
-    if (argc != 2) {
-        std::cout << endl << "usage: ORE path/to/ore.xml" << endl << endl;
+    // service mode, commands are read from stdin and responses are written to stdout, see OREApp::serve()
+    bool serve = argc == 3 && string(argv[1]) == "--serve";
+
+    if (argc != 2 && !serve) {
+        std::cout << endl << "usage: ORE path/to/ore.xml" << endl;
+        std::cout << "       ORE --serve path/to/ore.xml" << endl << endl;
         return -1;
     }
 
     ore::data::initBuilders();
 
-    string inputFile(argv[1]);
+    string inputFile(argv[argc - 1]);
 
     try {
         auto params = boost::make_shared<Parameters>();
         params->fromFile(inputFile);
-        OREApp ore(params, true);
-        ore.run();
+        OREApp ore(params, !serve);
+        if (serve)
+            ore.serve(cin, cout);
+        else
+            ore.run();
         return 0;
     } catch (const exception& e) {
         cout << endl << "an error occurred: " << e.what() << endl;
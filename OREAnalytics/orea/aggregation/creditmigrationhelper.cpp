@@ -32,6 +32,9 @@
 #include <ql/math/distributions/normaldistribution.hpp>
 #include <ql/time/daycounters/actualactual.hpp>
 
+#include <atomic>
+#include <future>
+
 using namespace QuantLib;
 using namespace QuantExt;
 
@@ -208,14 +211,14 @@ void CreditMigrationHelper::initEntityStateSimulation() {
 
 } // initEntityStatesSimulation
 
-std::vector<Matrix> CreditMigrationHelper::initEntityStateSimulation(const Size date, const Size path) {
+std::vector<Matrix> CreditMigrationHelper::initEntityStateSimulation(const Size date, const Size path,
+                                                                     const std::map<string, Matrix>& transMat) const {
     std::vector<Matrix> res = std::vector<Matrix>(parameters_->entities().size(), Matrix(n_, n_, 0.0));
 
     const std::vector<string>& matrixNames = parameters_->transitionMatrices();
 
     // build terminal matrices conditional on global states
     Size numWarnings = 0;
-    auto transMat = rescaledTransitionMatrices(date);
     for (Size i = 0; i < parameters_->entities().size(); ++i) {
         const Matrix& m = transMat.at(matrixNames[i]);
         for (Size ii = 0; ii < m.rows(); ++ii) {
@@ -444,6 +447,116 @@ void CreditMigrationHelper::generateConditionalMigrationPnl(const Size date, con
     }
 } // generateConditionalMigrationPnl
 
+Real CreditMigrationHelper::addPathPnlDistribution(const Size date, const Size path,
+                                                   const std::map<string, Matrix>& transMat,
+                                                   HullWhiteBucketing& hwBucketing, Array& res) {
+
+    const std::vector<string>& entities = parameters_->entities();
+    const std::set<std::string>& tradeIds = cube_->ids();
+    Size numPaths = cube_->samples();
+
+    // 2a market pnl (t0 to horizon date, over whole cube)
+
+    Real cash = 0.0;
+
+    if (parameters_->marketRisk()) {
+        for (Size j = 0; j <= date + 1; ++j) {
+            for (auto const& tradeId : tradeIds) {
+                Size i = cube_->idsAndIndexes().at(tradeId);
+                // get cumulative survival probability on the path
+                Real sp = 1.0;
+                //Real rr = 0.0;
+                // FIXME 1
+                // Methodology question: Do we need/want to multiply with the stochastic discount factor
+                // here if we do an explicit credit default simulation at horizon?
+                // FIXME 2
+                // make CDS PnL neutral bei weighting flows with surv prob and generating protection flow
+                // with default prob
+                if (parameters_->zeroMarketPnl() && j > 0 &&
+                    tradeCreditCurves_.find(tradeId) != tradeCreditCurves_.end()) {
+                    string creditCurve = tradeCreditCurves_.at(tradeId);
+                    sp = aggData_->get(j - 1, path, AggregationScenarioDataType::SurvivalWeight, creditCurve);
+                    //rr = aggData_->get(j - 1, path, AggregationScenarioDataType::RecoveryRate, creditCurve);
+                }
+                if (j == 0) {
+                    // at t0 we flip the sign of the npvs to get the initial cash balance
+                    cash -= cube_->getT0(i, 0);
+                    // collect intermediate cashflows
+                    if (cubeIndexCashflows_ != Null<Size>())
+                        cash += cube_->getT0(i, cubeIndexCashflows_);
+                } else if (j <= date) {
+                    // collect intermediate cashflows
+                    if (cubeIndexCashflows_ != Null<Size>())
+                        cash += sp * cube_->get(i, j - 1, path, cubeIndexCashflows_);
+                } else {
+                    // at the horizon date we realise the npv
+                    cash += sp * cube_->get(i, j - 1, path, 0);
+                }
+            }
+        } // for data
+    }     // if market risk
+
+    if (!parameters_->creditRisk()) {
+        // if we just add scalar market pnl realisations, we don't really need
+        // the bucketing algorithm to do that, we just update the result
+        // distribution directly
+        res[hwBucketing.index(cash)] += 1.0 / static_cast<Real>(numPaths);
+        return cash;
+    }
+
+    // 2b credit migration pnl (at horizon date, over entities specified in credit simulation parameters)
+
+    std::vector<Array> condProbs, pnl;
+
+    if (evaluation_ != Evaluation::Analytic) {
+        // 2b-1 generate pnl on the path using simulated idiosyncratic factors
+        condProbs.resize(1, Array(parameters_->paths(), 1.0 / static_cast<Real>(parameters_->paths())));
+        // we could build the distribution more efficiently here, but later in 2c we add the market pnl
+        // maybe extend the hw bucketing so that we can feed precomputed distributions and just update
+        // these with additional data?
+        pnl.resize(1, Array(parameters_->paths(), 0.0));
+        auto cond = initEntityStateSimulation(date, path, transMat);
+        // the inner paths use a substream determined by the seed and the global path, so that they do not
+        // depend on the order in which the global paths are processed
+        MersenneTwisterUniformRng mt(std::vector<unsigned long>{static_cast<unsigned long>(parameters_->seed()),
+                                                                static_cast<unsigned long>(path)});
+        for (Size path2 = 0; path2 < parameters_->paths(); ++path2) {
+            simulateEntityStates(cond, path, mt);
+            pnl[0][path2] = generateMigrationPnl(date, path, n_);
+        }
+    } else {
+        // 2b-2 generate pnl distribution without simulation of idiosyncratic factors using the conditional
+        // independence of migration on the path / systemic factors
+
+        // n+1 states, since for CDS we have to subdivide the issuer default into
+        // i) default of issuer and non-default of CDS cpty
+        // ii) default of issuer, default of CDS cpty (but after the issuer default)
+        // iii) default of issuer, default of CDS cpty (before the issuer default)
+        // for non-CDS trades for all sub-states the pnl will be set to the same value
+        // for CDS trades i)+ii) will have the same pnl, but iii) will have a zero pnl
+        // in total, we only have to distinguish i)+ii) and iii), i.e. we need one
+        // additional state
+
+        condProbs.resize(entities.size(), Array(n_ + 1, 0.0));
+        pnl.resize(entities.size(), Array(n_ + 1, 0.0));
+        generateConditionalMigrationPnl(date, path, transMat, condProbs, pnl);
+    }
+
+    // 2c aggregate market pnl and credit migration pnl
+
+    if (parameters_->marketRisk()) {
+        condProbs.push_back(Array(1, 1.0));
+        pnl.push_back(Array(1, cash));
+    }
+
+    hwBucketing.computeMultiState(condProbs.begin(), condProbs.end(), pnl.begin());
+
+    // 2d add pnl contribution of path to result distribution
+    res += hwBucketing.probability() / static_cast<Real>(numPaths);
+
+    return cash;
+} // addPathPnlDistribution
+
 Array CreditMigrationHelper::pnlDistribution(const Size date) {
 
     // FIXME if we ask this method for more than one time step, it might be more efficient to
@@ -452,7 +565,6 @@ Array CreditMigrationHelper::pnlDistribution(const Size date) {
 
     LOG("Compute PnL distribution for date " << date);
     QL_REQUIRE(date < cube_->numDates(), "date index " << date << " out of range 0..." << cube_->numDates() - 1);
-    const std::vector<string>& entities = parameters_->entities();
 
     // 1 get transition matrices for entities and rescale them to horizon
 
@@ -466,116 +578,44 @@ Array CreditMigrationHelper::pnlDistribution(const Size date) {
 
     // 2 compute conditional pnl distributions and average over paths
 
-    const std::set<std::string>& tradeIds = cube_->ids();
-    Array res(bucketing_.buckets(), 0.0);
+    // The paths are split into blocks of fixed size which are processed by the worker threads. Each block
+    // collects its own distribution, the blocks are merged in their natural order at the end, so that the
+    // result does not depend on the number of threads.
 
+    const Size blockSize = 64;
     Size numPaths = cube_->samples();
-    Real avgCash = 0.0;
-
-    HullWhiteBucketing hwBucketing(bucketing_.upperBucketBound().begin(), bucketing_.upperBucketBound().end());
-
-    MersenneTwisterUniformRng mt(parameters_->seed());
-
-    for (Size path = 0; path < numPaths; ++path) {
-
-        // 2a market pnl (t0 to horizon date, over whole cube)
-
-        Real cash = 0.0;
-
-        if (parameters_->marketRisk()) {
-            for (Size j = 0; j <= date + 1; ++j) {
-                for (auto const& tradeId : tradeIds) {
-                    Size i = cube_->idsAndIndexes().at(tradeId);
-                    // get cumulative survival probability on the path
-                    Real sp = 1.0;
-                    //Real rr = 0.0;
-                    // FIXME 1
-                    // Methodology question: Do we need/want to multiply with the stochastic discount factor
-                    // here if we do an explicit credit default simulation at horizon?
-                    // FIXME 2
-                    // make CDS PnL neutral bei weighting flows with surv prob and generating protection flow
-                    // with default prob
-                    if (parameters_->zeroMarketPnl() && j > 0 &&
-                        tradeCreditCurves_.find(tradeId) != tradeCreditCurves_.end()) {
-                        string creditCurve = tradeCreditCurves_.at(tradeId);
-                        sp = aggData_->get(j - 1, path, AggregationScenarioDataType::SurvivalWeight, creditCurve);
-                        //rr = aggData_->get(j - 1, path, AggregationScenarioDataType::RecoveryRate, creditCurve);
-                    }
-                    if (j == 0) {
-                        // at t0 we flip the sign of the npvs to get the initial cash balance
-                        cash -= cube_->getT0(i, 0);
-                        // collect intermediate cashflows
-                        if (cubeIndexCashflows_ != Null<Size>())
-                            cash += cube_->getT0(i, cubeIndexCashflows_);
-                    } else if (j <= date) {
-                        // collect intermediate cashflows
-                        if (cubeIndexCashflows_ != Null<Size>())
-                            cash += sp * cube_->get(i, j - 1, path, cubeIndexCashflows_);
-                    } else {
-                        // at the horizon date we realise the npv
-                        cash += sp * cube_->get(i, j - 1, path, 0);
-                    }
-                }
-            } // for data
-        }     // if market risk
-
-        if (!parameters_->creditRisk()) {
-            // if we just add scalar market pnl realisations, we don't really need
-            // the bucketing algorithm to do that, we just update the result
-            // distribution directly
-            res[hwBucketing.index(cash)] += 1.0 / static_cast<Real>(numPaths);
-            continue;
-        }
-
-        // 2b credit migration pnl (at horizon date, over entities specified in credit simulation parameters)
-
-        std::vector<Array> condProbs, pnl;
-
-        if (evaluation_ != Evaluation::Analytic) {
-            // 2b-1 generate pnl on the path using simulated idiosyncratic factors
-            condProbs.resize(1, Array(parameters_->paths(), 1.0 / static_cast<Real>(parameters_->paths())));
-            // we could build the distribution more efficiently here, but later in 2c we add the market pnl
-            // maybe extend the hw bucketing so that we can feed precomputed distributions and just update
-            // these with additional data?
-            pnl.resize(1, Array(parameters_->paths(), 0.0));
-            auto cond = initEntityStateSimulation(date, path);
-            for (Size path2 = 0; path2 < parameters_->paths(); ++path2) {
-                simulateEntityStates(cond, path, mt);
-                pnl[0][path2] = generateMigrationPnl(date, path, n_);
+    Size numBlocks = (numPaths + blockSize - 1) / blockSize;
+    Size nThreads = std::max<Size>(1, std::min(parameters_->threads(), numBlocks));
+
+    std::vector<Array> blockRes(numBlocks, Array(bucketing_.buckets(), 0.0));
+    std::vector<Real> blockCash(numBlocks, 0.0);
+    std::atomic<Size> nextBlock(0);
+
+    auto worker = [this, date, blockSize, numPaths, numBlocks, &transMat, &blockRes, &blockCash, &nextBlock]() {
+        HullWhiteBucketing hwBucketing(bucketing_.upperBucketBound().begin(), bucketing_.upperBucketBound().end());
+        for (Size b = nextBlock++; b < numBlocks; b = nextBlock++) {
+            for (Size path = b * blockSize; path < std::min((b + 1) * blockSize, numPaths); ++path) {
+                // average market risk pnl
+                blockCash[b] += addPathPnlDistribution(date, path, transMat, hwBucketing, blockRes[b]) /
+                                static_cast<Real>(numPaths);
             }
-        } else {
-            // 2b-2 generate pnl distribution without simulation of idiosyncratic factors using the conditional
-            // independence of migration on the path / systemic factors
-
-            // n+1 states, since for CDS we have to subdivide the issuer default into
-            // i) default of issuer and non-default of CDS cpty
-            // ii) default of issuer, default of CDS cpty (but after the issuer default)
-            // iii) default of issuer, default of CDS cpty (before the issuer default)
-            // for non-CDS trades for all sub-states the pnl will be set to the same value
-            // for CDS trades i)+ii) will have the same pnl, but iii) will have a zero pnl
-            // in total, we only have to distinguish i)+ii) and iii), i.e. we need one
-            // additional state
-
-            condProbs.resize(entities.size(), Array(n_ + 1, 0.0));
-            pnl.resize(entities.size(), Array(n_ + 1, 0.0));
-            generateConditionalMigrationPnl(date, path, transMat, condProbs, pnl);
-        }
-
-        // 2c aggregate market pnl and credit migration pnl
-
-        if (parameters_->marketRisk()) {
-            condProbs.push_back(Array(1, 1.0));
-            pnl.push_back(Array(1, cash));
         }
+    };
 
-        hwBucketing.computeMultiState(condProbs.begin(), condProbs.end(), pnl.begin());
+    LOG("Process " << numPaths << " paths in " << numBlocks << " blocks on " << nThreads << " threads");
+    std::vector<std::future<void>> results;
+    for (Size t = 1; t < nThreads; ++t)
+        results.push_back(std::async(std::launch::async, worker));
+    worker();
+    for (auto& r : results)
+        r.get();
 
-        // 2d add pnl contribution of path to result distribution
-        res += hwBucketing.probability() / static_cast<Real>(numPaths);
-        // average market risk pnl
-        avgCash += cash / static_cast<Real>(numPaths);
-
-    } // for path
+    Array res(bucketing_.buckets(), 0.0);
+    Real avgCash = 0.0;
+    for (Size b = 0; b < numBlocks; ++b) {
+        res += blockRes[b];
+        avgCash += blockCash[b];
+    }
 
     DLOG("Expected Market Risk PnL at date " << date << ": " << avgCash);
     return res;
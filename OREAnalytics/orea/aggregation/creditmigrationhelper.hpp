@@ -65,7 +65,8 @@ public:
     void build(const std::map<std::string, boost::shared_ptr<Trade>>& trades);
 
     const std::vector<Real>& upperBucketBound() const { return bucketing_.upperBucketBound(); }
-    //
+    /*! Returns the pnl distribution for the given date. The paths are processed on
+        CreditSimulationParameters::threads() threads, the result does not depend on the number of threads. */
     Array pnlDistribution(const Size date);
 
 private:
@@ -88,10 +89,12 @@ private:
         Evaluation = TerminalSimulation:
         Return transition matrix for each entity for the given date,
         conditional on the global terminal state on the given path */
-    std::vector<Matrix> initEntityStateSimulation(const Size date, const Size path);
+    std::vector<Matrix> initEntityStateSimulation(const Size date, const Size path,
+                                                  const std::map<string, Matrix>& transMat) const;
 
     /*! Generate one entity state sample path for all entities given the global state path
-        and given the conditional transition matrices for all entities at the terminal date. */
+        and given the conditional transition matrices for all entities at the terminal date.
+        Distinct paths can be simulated concurrently. */
     void simulateEntityStates(const std::vector<Matrix>& cond, const Size path, const MersenneTwisterUniformRng& mt);
 
     //! Look up the simulated entity credit state for the given entity, date and path
@@ -106,6 +109,11 @@ private:
     void generateConditionalMigrationPnl(const Size date, const Size path, const std::map<string, Matrix>& transMat,
                                          std::vector<Array>& condProbs, std::vector<Array>& pnl) const;
 
+    /*! Add the pnl distribution on the given global path weighted by 1 / samples to res and return the
+        market pnl on the path, the bucketing is used as a workspace */
+    Real addPathPnlDistribution(const Size date, const Size path, const std::map<string, Matrix>& transMat,
+                                QuantExt::HullWhiteBucketing& hwBucketing, Array& res);
+
     boost::shared_ptr<CreditSimulationParameters> parameters_;
     boost::shared_ptr<NPVCube> cube_, nettedCube_;
     boost::shared_ptr<AggregationScenarioData> aggData_;
@@ -76,6 +76,9 @@ void CreditSimulationParameters::fromXML(XMLNode* root) {
     doubleDefault_ = XMLUtils::getChildValueAsBool(node, "DoubleDefault", true);
     seed_ = XMLUtils::getChildValueAsInt(node, "Seed", true);
     paths_ = XMLUtils::getChildValueAsInt(node, "Paths", true);
+    int threads = XMLUtils::getChildValueAsInt(node, "Threads", false, 1);
+    QL_REQUIRE(threads > 0, "CreditSimulationParameters: Threads must be positive, got " << threads);
+    threads_ = threads;
     creditMode_ = XMLUtils::getChildValue(node, "CreditMode", true);
     loanExposureMode_ = XMLUtils::getChildValue(node, "LoanExposureMode", true);
 
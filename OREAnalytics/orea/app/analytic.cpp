@@ -35,6 +35,7 @@
 #include <ored/portfolio/builders/multilegoption.hpp>
 #include <ored/portfolio/builders/swaption.hpp>
 #include <ored/portfolio/structuredtradeerror.hpp>
+#include <ored/portfolio/tradefactory.hpp>
 
 #include <boost/timer/timer.hpp>
 
@@ -48,6 +49,24 @@ using boost::timer::default_places;
 namespace ore {
 namespace analytics {
 
+namespace {
+// a copy of the trade that can be built independently of the original, via the trade's XML representation
+boost::shared_ptr<Trade> copyTrade(const boost::shared_ptr<Trade>& trade) {
+    try {
+        XMLDocument doc;
+        XMLNode* node = trade->toXML(doc);
+        auto copy = TradeFactory::instance().build(trade->tradeType());
+        copy->fromXML(node);
+        copy->id() = trade->id();
+        return copy;
+    } catch (const std::exception& e) {
+        WLOG("Analytic: could not copy trade " << trade->id() << " (" << e.what() << "), build the input trade");
+        trade->reset();
+        return trade;
+    }
+}
+} // namespace
+
 Analytic::Analytic(std::unique_ptr<Impl> impl,
          const std::set<std::string>& analyticTypes,
          const boost::shared_ptr<InputParameters>& inputs,
@@ -102,6 +121,19 @@ std::vector<QuantLib::ext::shared_ptr<Analytic>> Analytic::allDependentAnalytics
     return analytics;
 }
 
+void Analytic::setWarmStart(const bool flag) {
+    warmStart_ = flag;
+    for (const auto& [_, a] : dependentAnalytics_)
+        a->setWarmStart(flag);
+}
+
+void Analytic::resetMarket() {
+    market_ = nullptr;
+    warmTrades_.clear();
+    for (const auto& [_, a] : dependentAnalytics_)
+        a->resetMarket();
+}
+
 const std::string Analytic::label() const { 
     return impl_ ? impl_->label() : string(); 
 }
@@ -158,6 +190,13 @@ void Analytic::buildMarket(const boost::shared_ptr<ore::data::InMemoryLoader>& l
 
     QL_REQUIRE(loader, "market data loader not set");
     QL_REQUIRE(configurations().curveConfig, "curve configurations not set");
+
+    // in warm start mode we keep the market built from the same loader in a previous run
+    if (warmStart_ && market_ && loader_ == loader) {
+        LOG("Analytic::buildMarket: reuse warm market");
+        return;
+    }
+    warmTrades_.clear();
     
     // first build the market if we have a todaysMarketParams
     if (configurations().todaysMarketParams) {
@@ -171,7 +210,7 @@ void Analytic::buildMarket(const boost::shared_ptr<ore::data::InMemoryLoader>& l
             market_ = boost::make_shared<TodaysMarket>(inputs()->asof(), configurations().todaysMarketParams, loader_,
                                                        configurations().curveConfig, inputs()->continueOnError(),
                                                        true, inputs()->lazyMarketBuilding(), inputs()->refDataManager(),
-                                                       false, *inputs()->iborFallbackConfig());
+                                                       warmStart_, *inputs()->iborFallbackConfig());
             // Note: we usually wrap the market into a PC market, but skip this step here
         } catch (const std::exception& e) {
             if (marketRequired)
@@ -192,23 +231,46 @@ void Analytic::marketCalibration(const boost::shared_ptr<MarketCalibrationReport
 }
 
 void Analytic::buildPortfolio() {
-    QuantLib::ext::shared_ptr<Portfolio> tmp = portfolio_ ? portfolio_ : inputs()->portfolio();
+    // in warm start mode the trades are taken from the input portfolio, which may have changed since the last run
+    QuantLib::ext::shared_ptr<Portfolio> tmp = portfolio_ && !warmStart_ ? portfolio_ : inputs()->portfolio();
         
     // create a new empty portfolio
     portfolio_ = boost::make_shared<Portfolio>(inputs()->buildFailedTrades());
 
-    tmp->reset();
-    // populate with trades
-    for (const auto& [tradeId, trade] : tmp->trades())
-        // If portfolio was already provided to the analytic, make sure to only process those given trades.
-        portfolio()->add(trade);
+    // in warm start mode we build copies of the input trades and keep them between runs, a copy is reused if the input
+    // trade was not replaced and the copy still holds the instrument built against the warm market
+    auto warmPortfolio = boost::make_shared<Portfolio>(inputs()->buildFailedTrades());
+    std::map<std::string, boost::shared_ptr<Trade>> sources;
+    for (const auto& [tradeId, trade] : tmp->trades()) {
+        if (!warmStart_) {
+            trade->reset();
+            // If portfolio was already provided to the analytic, make sure to only process those given trades.
+            portfolio()->add(trade);
+            continue;
+        }
+        sources[tradeId] = trade;
+        auto w = warmTrades_.find(tradeId);
+        if (market_ && w != warmTrades_.end() && w->second.source == trade &&
+            w->second.trade->instrument() == w->second.instrument) {
+            warmPortfolio->add(w->second.trade);
+        } else {
+            portfolio()->add(copyTrade(trade));
+        }
+    }
     
     if (market_) {
         replaceTrades();
 
         LOG("Build the portfolio");
-        boost::shared_ptr<EngineFactory> factory = impl()->engineFactory();
-        portfolio()->build(factory, "analytic/" + label());
+        if (!warmStart_ || !portfolio()->empty()) {
+            boost::shared_ptr<EngineFactory> factory = impl()->engineFactory();
+            portfolio()->build(factory, "analytic/" + label());
+        }
+        if (!warmPortfolio->empty()) {
+            LOG("Reuse " << warmPortfolio->size() << " warm trades, built " << portfolio()->size() << " trades");
+            for (const auto& [tradeId, trade] : warmPortfolio->trades())
+                portfolio()->add(trade);
+        }
 
         // remove dates that will have matured
         Date maturityDate = inputs()->asof();
@@ -217,6 +279,15 @@ void Analytic::buildPortfolio() {
 
         LOG("Filter trades that expire before " << maturityDate);
         portfolio()->removeMatured(maturityDate);
+
+        if (warmStart_) {
+            warmTrades_.clear();
+            for (const auto& [tradeId, trade] : portfolio()->trades()) {
+                auto s = sources.find(tradeId);
+                if (s != sources.end())
+                    warmTrades_[tradeId] = {s->second, trade, trade->instrument()};
+            }
+        }
     } else {
         ALOG("Skip building the portfolio, because market not set");
     }
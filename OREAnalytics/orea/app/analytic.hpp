@@ -24,6 +24,7 @@
 
 #include <ored/marketdata/todaysmarketparameters.hpp>
 #include <ored/marketdata/inmemoryloader.hpp>
+#include <ored/portfolio/instrumentwrapper.hpp>
 #include <ored/portfolio/nettingsetmanager.hpp>
 #include <ored/report/inmemoryreport.hpp>
 
@@ -131,6 +132,15 @@ public:
     const bool getWriteIntermediateReports() const { return writeIntermediateReports_; }
     void setWriteIntermediateReports(const bool flag) { writeIntermediateReports_ = flag; }
 
+    /*! Keep the market and the built trades between runs, see OREApp::serve(). The market is then built with
+        preserved quote linkage, so that changes of loader quotes are picked up by the bootstrapped yield curves, and
+        only trades that are new or replaced in the input portfolio or were rebuilt elsewhere since the last run are
+        built again. Applies to the dependent analytics as well. */
+    void setWarmStart(const bool flag);
+    bool warmStart() const { return warmStart_; }
+    //! Discard the warm market and trades, they are rebuilt in the next run
+    void resetMarket();
+
     //! Check whether any of the requested run types is covered by this analytic
     bool match(const std::set<std::string>& runTypes);
 
@@ -170,6 +180,20 @@ protected:
     //! and that parent/calling analytic will be writing its own set of intermediate reports
     bool writeIntermediateReports_ = true;
 
+    //! Keep the market and the built trades between runs
+    bool warmStart_ = false;
+    /*! The trades built against market_ in the last run, by trade id, only used in warm start mode. The analytic
+        builds its own copies of the input trades, since the input trades are shared with the other analytics. */
+    struct WarmTrade {
+        //! the input trade that was copied
+        boost::shared_ptr<ore::data::Trade> source;
+        //! the copy built by this analytic
+        boost::shared_ptr<ore::data::Trade> trade;
+        //! the instrument of the copy after the build, it is rebuilt elsewhere if this changes (e.g. in a simulation)
+        boost::shared_ptr<ore::data::InstrumentWrapper> instrument;
+    };
+    std::map<std::string, WarmTrade> warmTrades_;
+
     std::map<std::string, boost::shared_ptr<Analytic>> dependentAnalytics_;
 };
 
@@ -26,6 +26,8 @@
 #include <orea/scenario/scenario.hpp>
 #include <orea/scenario/scenariosimmarketplus.hpp>
 #include <orea/scenario/shiftscenariogenerator.hpp>
+#include <ored/marketdata/clonedloader.hpp>
+#include <ored/marketdata/todaysmarket.hpp>
 #include <ored/utilities/to_string.hpp>
 
 using namespace ore::data;
@@ -89,10 +91,37 @@ void ParConversionAnalyticImpl::runAnalytic(const boost::shared_ptr<ore::data::I
             configs.todaysMarketParams, nullptr, inputs_->marketConfig("pricing"), true, false,
             *inputs_->iborFallbackConfig());
 
-        parAnalysis->computeParInstrumentSensitivities(simMarket);
+        std::string jacobiInverseCache;
+        if (!inputs_->jacobiCacheDirectory().empty()) {
+            path cacheDir(inputs_->jacobiCacheDirectory());
+            parAnalysis->setJacobiCache((cacheDir / "jacobi_cache.csv").string(), inputs_->jacobiCacheTolerance());
+            jacobiInverseCache = (cacheDir / "jacobi_inverse_cache.csv").string();
+        }
+
+        if (inputs_->nThreads() == 1) {
+            parAnalysis->computeParInstrumentSensitivities(simMarket);
+        } else {
+            // the other threads reprice the par instruments on sim markets built from cloned market data
+            std::vector<boost::shared_ptr<ClonedLoader>> loaders(inputs_->nThreads());
+            for (Size i = 1; i < loaders.size(); ++i)
+                loaders[i] = boost::make_shared<ClonedLoader>(inputs_->asof(), loader);
+            parAnalysis->computeParInstrumentSensitivities(
+                inputs_->nThreads(),
+                [this, &simMarket, &loaders, &configs](Size id) -> boost::shared_ptr<ScenarioSimMarket> {
+                    if (id == 0)
+                        return simMarket;
+                    auto market = boost::make_shared<TodaysMarket>(
+                        inputs_->asof(), configs.todaysMarketParams, loaders[id], configs.curveConfig, true, true,
+                        false, inputs_->refDataManager(), false, *inputs_->iborFallbackConfig(), false);
+                    return buildScenarioSimMarketForSensitivityAnalysis(
+                        market, configs.simMarketParams, configs.sensiScenarioData, configs.curveConfig,
+                        configs.todaysMarketParams, nullptr, inputs_->marketConfig("pricing"), true, false,
+                        *inputs_->iborFallbackConfig());
+                });
+        }
 
-        boost::shared_ptr<ParSensitivityConverter> parConverter =
-            boost::make_shared<ParSensitivityConverter>(parAnalysis->parSensitivities(), parAnalysis->shiftSizes());
+        boost::shared_ptr<ParSensitivityConverter> parConverter = boost::make_shared<ParSensitivityConverter>(
+            parAnalysis->parSensitivities(), parAnalysis->shiftSizes(), jacobiInverseCache);
 
         map<RiskFactorKey, Size> factorToIndex;
 
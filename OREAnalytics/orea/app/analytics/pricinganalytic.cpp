@@ -22,7 +22,9 @@
 #include <orea/engine/parsensitivityanalysis.hpp>
 #include <orea/engine/parsensitivitycubestream.hpp>
 #include <orea/engine/sensitivityanalysisplus.hpp>
+#include <orea/engine/sensitivityfilestream.hpp>
 #include <orea/engine/stresstest.hpp>
+#include <ored/marketdata/clonedloader.hpp>
 #include <ored/marketdata/todaysmarket.hpp>
 
 using namespace ore::data;
@@ -219,6 +221,12 @@ void PricingAnalyticImpl::runAnalytic(
                 .writeSensitivityReport(*report, ss, inputs_->sensiThreshold());
             analytic()->reports()[type]["sensitivity"] = report;
 
+            if (!inputs_->sensiBinaryOutputFile().empty()) {
+                std::string fileName = (inputs_->resultsPath() / inputs_->sensiBinaryOutputFile()).string();
+                LOG("Sensi analysis - write sensitivities in binary format to " << fileName);
+                writeSensitivityBinaryFile(fileName, *ss, inputs_->sensiThreshold());
+            }
+
             LOG("Sensi analysis - write sensitivity scenario report in memory");
             boost::shared_ptr<InMemoryReport> scenarioReport = boost::make_shared<InMemoryReport>();
             ReportWriter(inputs_->reportNaString())
@@ -228,9 +236,37 @@ void PricingAnalyticImpl::runAnalytic(
 
             if (inputs_->parSensi()) {
                 LOG("Sensi analysis - par conversion");
-                parAnalysis->computeParInstrumentSensitivities(sensiAnalysis->simMarket());
-                boost::shared_ptr<ParSensitivityConverter> parConverter =
-                    boost::make_shared<ParSensitivityConverter>(parAnalysis->parSensitivities(), parAnalysis->shiftSizes());
+                std::string jacobiInverseCache;
+                if (!inputs_->jacobiCacheDirectory().empty()) {
+                    path cacheDir(inputs_->jacobiCacheDirectory());
+                    parAnalysis->setJacobiCache((cacheDir / "jacobi_cache.csv").string(),
+                                                inputs_->jacobiCacheTolerance());
+                    jacobiInverseCache = (cacheDir / "jacobi_inverse_cache.csv").string();
+                }
+                if (inputs_->nThreads() == 1) {
+                    parAnalysis->computeParInstrumentSensitivities(sensiAnalysis->simMarket());
+                } else {
+                    // the other threads reprice the par instruments on sim markets built from cloned market data
+                    std::vector<boost::shared_ptr<ClonedLoader>> loaders(inputs_->nThreads());
+                    for (Size i = 1; i < loaders.size(); ++i)
+                        loaders[i] = boost::make_shared<ClonedLoader>(inputs_->asof(), loader);
+                    auto& configs = analytic()->configurations();
+                    parAnalysis->computeParInstrumentSensitivities(
+                        inputs_->nThreads(),
+                        [this, &sensiAnalysis, &loaders, &configs](Size id) -> boost::shared_ptr<ScenarioSimMarket> {
+                            if (id == 0)
+                                return sensiAnalysis->simMarket();
+                            auto market = boost::make_shared<TodaysMarket>(
+                                inputs_->asof(), configs.todaysMarketParams, loaders[id], configs.curveConfig, true,
+                                true, false, inputs_->refDataManager(), false, *inputs_->iborFallbackConfig(), false);
+                            return buildScenarioSimMarketForSensitivityAnalysis(
+                                market, configs.simMarketParams, configs.sensiScenarioData, configs.curveConfig,
+                                configs.todaysMarketParams, nullptr, Market::defaultConfiguration, true,
+                                inputs_->alignPillars(), *inputs_->iborFallbackConfig());
+                        });
+                }
+                boost::shared_ptr<ParSensitivityConverter> parConverter = boost::make_shared<ParSensitivityConverter>(
+                    parAnalysis->parSensitivities(), parAnalysis->shiftSizes(), jacobiInverseCache);
                 auto parCube = boost::make_shared<ZeroToParCube>(sensiAnalysis->sensiCube(), parConverter, typesDisabled, true);
                 LOG("Sensi analysis - write par sensitivity report in memory");
                 boost::shared_ptr<ParSensitivityCubeStream> pss = boost::make_shared<ParSensitivityCubeStream>(parCube, baseCurrency);
@@ -21,9 +21,12 @@
 #include <orea/app/reportwriter.hpp>
 #include <orea/app/structuredanalyticserror.hpp>
 #include <orea/app/structuredanalyticswarning.hpp>
+#include <orea/cube/diskcube.hpp>
 #include <orea/cube/jointnpvcube.hpp>
+#include <orea/engine/cashflowtablecalculator.hpp>
 #include <orea/engine/amcvaluationengine.hpp>
 #include <orea/engine/mporcalculator.hpp>
+#include <orea/engine/multiprocessvaluationengine.hpp>
 #include <orea/engine/multistatenpvcalculator.hpp>
 #include <orea/engine/multithreadedvaluationengine.hpp>
 #include <orea/engine/observationmode.hpp>
@@ -98,7 +101,7 @@ boost::shared_ptr<EngineFactory> XvaAnalyticImpl::engineFactory() {
     std::vector<boost::shared_ptr<EngineBuilder>> extraEngineBuilders; 
     std::vector<boost::shared_ptr<LegBuilder>> extraLegBuilders;
 
-    if (runSimulation_) {
+    if (runSimulation_ || runPreTrade_) {
         // link to the sim market here
         QL_REQUIRE(simMarket_, "Simulaton market not set");
         engineFactory_ = boost::make_shared<EngineFactory>(edCopy, simMarket_, configurations,
@@ -159,7 +162,7 @@ void XvaAnalyticImpl::buildCrossAssetModel(const bool continueOnCalibrationError
         inputs_->marketConfig("infcalibration"), inputs_->marketConfig("crcalibration"),
         inputs_->marketConfig("simulation"), false, continueOnCalibrationError, "",
         inputs_->salvageCorrelationMatrix() ? SalvagingAlgorithm::Spectral : SalvagingAlgorithm::None,
-        "xva cam building");
+        "xva cam building", inputs_->nThreads());
     model_ = *modelBuilder.model();
 }
 
@@ -178,7 +181,11 @@ void XvaAnalyticImpl::initCube(boost::shared_ptr<NPVCube>& cube, const std::set<
     for (Size i = 0; i < grid_->valuationDates().size(); ++i)
         DLOG("initCube: grid[" << i << "]=" << io::iso_date(grid_->valuationDates()[i]));
     
-    if (cubeDepth == 1)
+    if (inputs_->cubeMemoryBudget() > 0)
+        cube = boost::make_shared<SinglePrecisionDiskCube>(inputs_->asof(), ids, grid_->valuationDates(), samples_,
+                                                           cubeDepth, inputs_->cubeMemoryBudget() << 20, 0, 0,
+                                                           inputs_->cubeDirectory(), 0.0f);
+    else if (cubeDepth == 1)
         cube = boost::make_shared<SinglePrecisionInMemoryCube>(inputs_->asof(),
             ids, grid_->valuationDates(), samples_, 0.0f);
     else
@@ -202,16 +209,17 @@ void XvaAnalyticImpl::initClassicRun(const boost::shared_ptr<Portfolio>& portfol
 
     }
 
-    // We can skip the cube initialization if the mt val engine is used, since it builds its own cubes
-    if (inputs_->nThreads() == 1) {
+    // We can skip the cube initialization if the mt or mp val engine is used, since they build their own cubes
+    if (inputs_->nThreads() == 1 && inputs_->nProcesses() == 1) {
         if (portfolio->size() > 0)
             initCube(cube_, portfolio->ids(), cubeDepth_);
         // not required by any calculators in ore at the moment
         nettingSetCube_ = nullptr;
         // Init counterparty cube for the storage of survival probabilities
         if (inputs_->storeSurvivalProbabilities()) {
-            // Use full list of counterparties, not just those in the sub-portflio
-            auto counterparties = inputs_->portfolio()->counterparties();
+            // Use full list of counterparties, not just those in the sub-portflio, unless we price pre-trade
+            // candidates, their survival probabilities are merged into the loaded counterparty cube
+            auto counterparties = (runPreTrade_ ? portfolio : inputs_->portfolio())->counterparties();
             counterparties.insert(inputs_->dvaName());
             initCube(cptyCube_, counterparties, 1);
         } else {
@@ -265,13 +273,15 @@ void XvaAnalyticImpl::buildClassicCube(const boost::shared_ptr<Portfolio>& portf
     // set up valuation calculator factory
     auto calculators = [this]() {
         vector<boost::shared_ptr<ValuationCalculator>> calculators;
+        boost::shared_ptr<NPVCalculator> npvCalc =
+            inputs_->cashflowTablePricing()
+                ? boost::make_shared<CashflowTableNPVCalculator>(inputs_->exposureBaseCurrency())
+                : boost::make_shared<NPVCalculator>(inputs_->exposureBaseCurrency());
         if (analytic()->configurations().scenarioGeneratorData->withCloseOutLag()) {
-            boost::shared_ptr<NPVCalculator> npvCalc =
-                boost::make_shared<NPVCalculator>(inputs_->exposureBaseCurrency());
             calculators.push_back(boost::make_shared<MPORCalculator>(npvCalc, cubeInterpreter_->defaultDateNpvIndex(),
                                                                      cubeInterpreter_->closeOutDateNpvIndex()));
         } else
-            calculators.push_back(boost::make_shared<NPVCalculator>(inputs_->exposureBaseCurrency()));
+            calculators.push_back(npvCalc);
         if (inputs_->storeFlows())
             calculators.push_back(boost::make_shared<CashflowCalculator>(
                 inputs_->exposureBaseCurrency(), inputs_->asof(), grid_, cubeInterpreter_->mporFlowsIndex()));
@@ -306,7 +316,35 @@ void XvaAnalyticImpl::buildClassicCube(const boost::shared_ptr<Portfolio>& portf
     auto progressBar = boost::make_shared<SimpleProgressBar>(o.str(), ConsoleLog::instance().width(), ConsoleLog::instance().progressBarWidth());
     auto progressLog = boost::make_shared<ProgressLog>("Building cube", 100, ORE_NOTICE);
 
-    if(inputs_->nThreads() == 1) {
+    if (inputs_->nProcesses() > 1) {
+
+        // multi-process engine run, the workers write to mini-cubes in shared memory which are joined without copying
+
+        MultiProcessValuationEngine engine(
+            inputs_->nProcesses(), inputs_->asof(), grid_, samples_, analytic()->loader(), scenarioGenerator_,
+            inputs_->simulationPricingEngine(), inputs_->curveConfigs().get(),
+            analytic()->configurations().todaysMarketParams, inputs_->marketConfig("simulation"),
+            analytic()->configurations().simMarketParams, false, false, boost::make_shared<ScenarioFilter>(),
+            inputs_->refDataManager(), *inputs_->iborFallbackConfig(), true, false, cubeDepth_, false,
+            inputs_->storeSurvivalProbabilities(), inputs_->dvaName(), "xva-simulation");
+
+        // the first worker populates the aggregation scenario data, which the engine copies back from shared memory
+        engine.setAggregationScenarioData(simMarket_->aggregationScenarioData());
+
+        engine.registerProgressIndicator(progressBar);
+        engine.registerProgressIndicator(progressLog);
+
+        engine.buildCube(portfolio, calculators, cptyCalculators,
+                         analytic()->configurations().scenarioGeneratorData->withMporStickyDate());
+
+        cube_ = boost::make_shared<JointNPVCube>(engine.outputCubes(), portfolio->ids());
+        nettingSetCube_ = nullptr;
+
+        if (inputs_->storeSurvivalProbabilities())
+            cptyCube_ = boost::make_shared<JointNPVCube>(
+                engine.outputCptyCubes(), std::set<std::string>(), false,
+                [](Real a, Real x) { return std::max(a, x); }, 0.0);
+    } else if(inputs_->nThreads() == 1) {
 
         // single-threaded engine run
 
@@ -324,7 +362,12 @@ void XvaAnalyticImpl::buildClassicCube(const boost::shared_ptr<Portfolio>& portf
         auto cubeFactory = [this](const QuantLib::Date& asof, const std::set<std::string>& ids,
                                   const std::vector<QuantLib::Date>& dates,
                                   const Size samples) -> boost::shared_ptr<NPVCube> {
-            if (cubeDepth_ == 1)
+            // the memory budget is shared between the mini-cubes of the threads
+            if (inputs_->cubeMemoryBudget() > 0)
+                return boost::make_shared<SinglePrecisionDiskCube>(
+                    asof, ids, dates, samples, cubeDepth_, (inputs_->cubeMemoryBudget() << 20) / inputs_->nThreads(),
+                    0, 0, inputs_->cubeDirectory(), 0.0f);
+            else if (cubeDepth_ == 1)
                 return boost::make_shared<SinglePrecisionInMemoryCube>(asof, ids, dates, samples, 0.0f);
             else
                 return boost::make_shared<SinglePrecisionInMemoryCubeN>(asof, ids, dates, samples,
@@ -354,6 +397,9 @@ void XvaAnalyticImpl::buildClassicCube(const boost::shared_ptr<Portfolio>& portf
             boost::make_shared<ScenarioFilter>(), inputs_->refDataManager(),
             *inputs_->iborFallbackConfig(), true, false, cubeFactory, {}, cptyCubeFactory, "xva-simulation");
 
+        // the engine populates the aggregation scenario data from the sim market of its first thread
+        engine.setAggregationScenarioData(simMarket_->aggregationScenarioData());
+
         engine.registerProgressIndicator(progressBar);
         engine.registerProgressIndicator(progressLog);
 
@@ -494,6 +540,113 @@ void XvaAnalyticImpl::amcRun(bool doClassicRun) {
     LOG("XVA: amcRun completed");
 }
 
+void XvaAnalyticImpl::preTradeRun() {
+
+    LOG("XVA: preTradeRun");
+
+    runPreTrade_ = true;
+
+    // the workers of the multi-process engine do not populate the aggregation scenario data that we need to check the
+    // candidate simulation against the loaded market cube
+    QL_REQUIRE(inputs_->nProcesses() == 1, "XVA pre-trade: nProcesses > 1 is not supported, use nThreads instead");
+
+    boost::shared_ptr<NPVCube> loadedCube = cube_, loadedNettingSetCube = nettingSetCube_,
+                               loadedCptyCube = cptyCube_;
+
+    for (const auto& [tradeId, trade] : inputs_->preTradePortfolio()->trades()) {
+        QL_REQUIRE(loadedCube->idsAndIndexes().count(tradeId) == 0,
+                   "XVA pre-trade: candidate trade '" << tradeId << "' is contained in the input cube already");
+    }
+
+    // The candidates are simulated on the same paths as the loaded cube, i.e. the scenario generator is rebuilt from
+    // the same configuration (model, grid, seed) as in the run that produced the cube
+
+    LOG("XVA: Build simulation market and scenario generator for pre-trade candidates");
+    buildScenarioSimMarket();
+    auto globalParams = inputs_->simulationPricingEngine()->globalParameters();
+    auto continueOnCalErr = globalParams.find("ContinueOnCalibrationError");
+    bool continueOnErr = (continueOnCalErr != globalParams.end()) && parseBool(continueOnCalErr->second);
+    buildScenarioGenerator(continueOnErr);
+    simMarket_->scenarioGenerator() = scenarioGenerator_;
+
+    QL_REQUIRE(loadedCube->dates() == grid_->valuationDates() && loadedCube->samples() == samples_,
+               "XVA pre-trade: input cube dimensions (" << loadedCube->numDates() << " dates, " << loadedCube->samples()
+                                                        << " samples) do not match the simulation ("
+                                                        << grid_->valuationDates().size() << " dates, " << samples_
+                                                        << " samples)");
+    QL_REQUIRE(scenarioData_->dimDates() == grid_->valuationDates().size() && scenarioData_->dimSamples() == samples_,
+               "XVA pre-trade: input market cube dimensions (" << scenarioData_->dimDates() << " dates, "
+                                                               << scenarioData_->dimSamples()
+                                                               << " samples) do not match the simulation");
+
+    // The loaded market cube is used for post processing, the candidate run writes to a separate one that is
+    // compared against the loaded numeraires below
+
+    auto candidateScenarioData =
+        boost::make_shared<InMemoryAggregationScenarioData>(grid_->valuationDates().size(), samples_);
+    simMarket_->aggregationScenarioData() = candidateScenarioData;
+
+    classicRun(inputs_->preTradePortfolio());
+    boost::shared_ptr<NPVCube> candidateCube = cube_;
+
+    QL_REQUIRE(scenarioData_->has(AggregationScenarioDataType::Numeraire),
+               "XVA pre-trade: input market cube does not contain the numeraire");
+    QL_REQUIRE(candidateScenarioData->has(AggregationScenarioDataType::Numeraire),
+               "XVA pre-trade: candidate simulation did not populate the numeraire");
+    for (Size d = 0; d < grid_->valuationDates().size(); ++d) {
+        for (Size s = 0; s < samples_; ++s) {
+            Real x = scenarioData_->get(d, s, AggregationScenarioDataType::Numeraire);
+            Real y = candidateScenarioData->get(d, s, AggregationScenarioDataType::Numeraire);
+            QL_REQUIRE(std::abs(x - y) <= 1.0E-8 * std::max(1.0, std::abs(x)),
+                       "XVA pre-trade: simulated numeraire " << y << " does not match the input market cube " << x
+                                                            << " at date " << d << ", sample " << s
+                                                            << ", check that the simulation configuration is the"
+                                                               " one used to produce the input cubes");
+        }
+    }
+
+    // Only the netting sets of the candidates are post processed, before and after adding the candidates
+
+    std::set<std::string> nettingSets;
+    for (const auto& [tradeId, trade] : classicPortfolio_->trades())
+        nettingSets.insert(trade->envelope().nettingSetId());
+
+    basePortfolio_ = boost::make_shared<Portfolio>();
+    auto preTradePortfolio = boost::make_shared<Portfolio>();
+    for (const auto& [tradeId, trade] : analytic()->portfolio()->trades()) {
+        if (nettingSets.find(trade->envelope().nettingSetId()) == nettingSets.end())
+            continue;
+        if (loadedCube->idsAndIndexes().count(tradeId) == 0) {
+            WLOG("XVA pre-trade: trade " << tradeId << " not found in the input cube, it is excluded from netting set "
+                                         << trade->envelope().nettingSetId());
+            continue;
+        }
+        basePortfolio_->add(trade);
+        preTradePortfolio->add(trade);
+    }
+    for (const auto& [tradeId, trade] : classicPortfolio_->trades())
+        preTradePortfolio->add(trade);
+
+    LOG("XVA pre-trade: " << classicPortfolio_->size() << " candidates in " << nettingSets.size()
+                          << " netting sets with " << basePortfolio_->size() << " existing trades");
+
+    if (basePortfolio_->size() > 0)
+        baseCube_ = boost::make_shared<JointNPVCube>(std::vector<boost::shared_ptr<NPVCube>>{loadedCube},
+                                                     basePortfolio_->ids());
+    cube_ = boost::make_shared<JointNPVCube>(loadedCube, candidateCube, preTradePortfolio->ids());
+    nettingSetCube_ = loadedNettingSetCube;
+    if (loadedCptyCube && cptyCube_)
+        cptyCube_ = boost::make_shared<JointNPVCube>(
+            loadedCptyCube, cptyCube_, std::set<std::string>(), false, [](Real a, Real x) { return std::max(a, x); },
+            0.0);
+    else
+        cptyCube_ = loadedCptyCube;
+
+    analytic()->setPortfolio(preTradePortfolio);
+
+    LOG("XVA: preTradeRun completed");
+}
+
 void XvaAnalyticImpl::runPostProcessor() {
     boost::shared_ptr<NettingSetManager> netting = inputs_->nettingSetManager();
     map<string, bool> analytics;
@@ -706,6 +859,10 @@ void XvaAnalyticImpl::runAnalytic(const boost::shared_ptr<ore::data::InMemoryLoa
         if (inputs_->cptyCube())
             cptyCube_ = inputs_->cptyCube();
         CONSOLE("OK");
+
+        // ... and add the pre-trade candidates, if any
+        if (inputs_->preTradePortfolio() && !inputs_->preTradePortfolio()->trades().empty())
+            preTradeRun();
     }
 
     MEM_LOG;
@@ -736,6 +893,20 @@ void XvaAnalyticImpl::runAnalytic(const boost::shared_ptr<ore::data::InMemoryLoa
          * This is where the aggregation work is done: call the post-processor
          *********************************************************************/
 
+        if (runPreTrade_ && basePortfolio_->size() > 0) {
+            CONSOLEW("XVA: Pre-Trade Base Aggregation");
+            auto portfolio = analytic()->portfolio();
+            auto cube = cube_;
+            analytic()->setPortfolio(basePortfolio_);
+            cube_ = baseCube_;
+            runPostProcessor();
+            basePostProcess_ = postProcess_;
+            dimCalculator_ = nullptr;
+            analytic()->setPortfolio(portfolio);
+            cube_ = cube;
+            CONSOLE("OK");
+        }
+
         CONSOLEW("XVA: Aggregation");
         runPostProcessor();
         CONSOLE("OK");
@@ -799,6 +970,12 @@ void XvaAnalyticImpl::runAnalytic(const boost::shared_ptr<ore::data::InMemoryLoa
             .writeXVA(*xvaReport, inputs_->exposureAllocationMethod(), analytic()->portfolio(), postProcess_);
         analytic()->reports()["XVA"]["xva"] = xvaReport;
 
+        if (runPreTrade_) {
+            auto preTradeReport = boost::make_shared<InMemoryReport>();
+            ReportWriter(inputs_->reportNaString()).writePreTradeXVA(*preTradeReport, basePostProcess_, postProcess_);
+            analytic()->reports()["XVA"]["xva_pretrade"] = preTradeReport;
+        }
+
         if (inputs_->netCubeOutput()) {
             auto report = boost::make_shared<InMemoryReport>();
             ReportWriter(inputs_->reportNaString()).writeCube(*report, postProcess_->netCube());
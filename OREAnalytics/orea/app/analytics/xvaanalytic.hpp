@@ -56,6 +56,8 @@ protected:
     void buildAmcPortfolio();
     void amcRun(bool doClassicRun);
 
+    void preTradeRun();
+
     void runPostProcessor();
 
     Matrix creditStateCorrelationMatrix() const;
@@ -70,6 +72,11 @@ protected:
     boost::shared_ptr<CubeInterpretation> cubeInterpreter_;
     boost::shared_ptr<DynamicInitialMarginCalculator> dimCalculator_;
     boost::shared_ptr<PostProcess> postProcess_;
+
+    // pre-trade run: the netting sets of the candidates before adding them
+    boost::shared_ptr<Portfolio> basePortfolio_;
+    boost::shared_ptr<NPVCube> baseCube_;
+    boost::shared_ptr<PostProcess> basePostProcess_;
     
     Size cubeDepth_ = 0;
     boost::shared_ptr<DateGrid> grid_;
@@ -77,6 +84,7 @@ protected:
 
     bool runSimulation_ = false;
     bool runXva_ = false;
+    bool runPreTrade_ = false;
 };
 
 class XvaAnalytic : public Analytic {
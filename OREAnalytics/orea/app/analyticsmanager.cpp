@@ -25,12 +25,15 @@
 #include <orea/app/analyticsmanager.hpp>
 #include <orea/app/reportwriter.hpp>
 #include <orea/app/structuredanalyticserror.hpp>
+#include <orea/engine/pricingprofiler.hpp>
 
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/to_string.hpp>
 
 #include <ql/errors.hpp>
 
+#include <algorithm>
+
 using namespace std;
 using namespace boost::filesystem;
 using ore::data::InMemoryReport;
@@ -125,6 +128,9 @@ void AnalyticsManager::runAnalytics(const std::set<std::string>& analyticTypes,
     if (analytics_.size() == 0)
         return;
 
+    // the pricing profile is reported per run, also for repeated runs in service mode
+    PricingProfiler::instance().reset();
+
     std::vector<boost::shared_ptr<ore::data::TodaysMarketParameters>> tmps = todaysMarketParams();
     std::set<Date> marketDates;
     for (const auto& a : analytics_) {
@@ -142,10 +148,17 @@ void AnalyticsManager::runAnalytics(const std::set<std::string>& analyticTypes,
     LOG("AnalyticsManager::runAnalytics: requireMarketData " << (requireMarketData ? "Y" : "N"));
     
     if (requireMarketData) {
-        // load the market data
-        if (tmps.size() > 0) {
+        // load the market data, in warm start mode only if a market date is required that was not loaded before
+        if (tmps.size() > 0 && (!warmStart_ || !std::includes(loaderDates_.begin(), loaderDates_.end(),
+                                                              marketDates.begin(), marketDates.end()))) {
             LOG("AnalyticsManager::runAnalytics: populate loader");
+            if (warmStart_) {
+                // keep the dates loaded before, the markets built from the previous loader data are rebuilt
+                marketDates.insert(loaderDates_.begin(), loaderDates_.end());
+                resetMarkets();
+            }
             marketDataLoader_->populateLoader(tmps, marketDates);
+            loaderDates_ = marketDates;
         }
         
         boost::shared_ptr<InMemoryReport> mdReport = boost::make_shared<InMemoryReport>();
@@ -170,6 +183,7 @@ void AnalyticsManager::runAnalytics(const std::set<std::string>& analyticTypes,
     for (auto a : analytics_) {
         if (matches(analyticTypes, a.second->analyticTypes()) > 0) {
             LOG("run analytic with label '" << a.first << "'");
+            a.second->setWarmStart(warmStart_);
             a.second->runAnalytic(marketDataLoader_->loader(), analyticTypes);
             LOG("run analytic with label '" << a.first << "' finished.");
             // then populate the market calibration report if required
@@ -185,6 +199,14 @@ void AnalyticsManager::runAnalytics(const std::set<std::string>& analyticTypes,
         reports_["STATS"]["pricingstats"] = pricingStatsReport;
     }
 
+    if (PricingProfiler::instance().enabled()) {
+        auto pricingProfileReport = boost::make_shared<InMemoryReport>();
+        ReportWriter(inputs_->reportNaString())
+            .writePricingProfile(*pricingProfileReport, PricingProfiler::instance().profile(),
+                                 inputs_->pricingEngine());
+        reports_["STATS"]["pricingprofile"] = pricingProfileReport;
+    }
+
     if (marketCalibrationReport) {
         auto report = marketCalibrationReport->outputCalibrationReport();
         if (report) {
@@ -196,6 +218,12 @@ void AnalyticsManager::runAnalytics(const std::set<std::string>& analyticTypes,
     inputs_->writeOutParameters();
 }
 
+void AnalyticsManager::resetMarkets() {
+    LOG("AnalyticsManager: Reset the markets of all analytics");
+    for (auto a : analytics_)
+        a.second->resetMarket();
+}
+
 Analytic::analytic_reports const AnalyticsManager::reports() {
     Analytic::analytic_reports reports = reports_;
     for (auto a : analytics_) {
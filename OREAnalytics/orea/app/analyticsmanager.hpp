@@ -52,6 +52,13 @@ public:
                       const boost::shared_ptr<MarketCalibrationReportBase>& marketCalibrationReport = nullptr);
     void addAnalytic(const std::string& label, const boost::shared_ptr<Analytic>& analytic);
 
+    /*! In warm start mode the market data loader is populated again only if a call of runAnalytics() requires
+        market dates that were not loaded before, and the analytics keep their market and built trades between
+        calls, see Analytic::setWarmStart() */
+    void setWarmStart(const bool flag) { warmStart_ = flag; }
+    //! Rebuild the markets of all analytics from the current loader data in the next call of runAnalytics()
+    void resetMarkets();
+
     // returns a vector of all analytics, including dependent analytics
     std::map<std::string, boost::shared_ptr<Analytic>> analytics() { return analytics_; }
     void clear();
@@ -74,6 +81,9 @@ private:
     Analytic::analytic_reports reports_;
     std::set<std::string> validAnalytics_;
     std::set<std::string> requestedAnalytics_;
+    bool warmStart_ = false;
+    //! the market dates the loader was populated for
+    std::set<QuantLib::Date> loaderDates_;
 };
 
 boost::shared_ptr<AnalyticsManager> parseAnalytics(const std::string& s,
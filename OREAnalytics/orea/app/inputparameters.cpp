@@ -277,6 +277,20 @@ void InputParameters::setMarketCubeFromFile(const std::string& file) {
     mktCube_ = loadAggregationScenarioData(file);
 }
 
+void InputParameters::setPreTradePortfolio(const std::string& xml) {
+    preTradePortfolio_ = boost::make_shared<Portfolio>(buildFailedTrades_);
+    preTradePortfolio_->fromXMLString(xml);
+}
+
+void InputParameters::setPreTradePortfolioFromFile(const std::string& fileNameString, const std::string& inputPath) {
+    vector<string> files = getFileNames(fileNameString, inputPath);
+    preTradePortfolio_ = boost::make_shared<Portfolio>(buildFailedTrades_);
+    for (auto file : files) {
+        LOG("Loading pre-trade portfolio from file: " << file);
+        preTradePortfolio_->fromFile(file);
+    }
+}
+
 void InputParameters::setVarQuantiles(const std::string& s) {
     // parse to vector<Real>
     varQuantiles_ = parseListOfValues<Real>(s, &parseReal);
@@ -309,7 +323,10 @@ void InputParameters::setCovarianceDataFromBuffer(const std::string& xml) {
 }
 
 void InputParameters::setSensitivityStreamFromFile(const std::string& fileName) {
-    sensitivityStream_ = boost::make_shared<SensitivityFileStream>(fileName);
+    if (SensitivityRecordTable::isBinaryFile(fileName))
+        sensitivityStream_ = boost::make_shared<SensitivityBinaryFileStream>(fileName);
+    else
+        sensitivityStream_ = boost::make_shared<SensitivityFileStream>(fileName);
 }
 
 void InputParameters::setSensitivityStreamFromBuffer(const std::string& buffer) {
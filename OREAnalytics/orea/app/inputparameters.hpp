@@ -84,6 +84,7 @@ public:
     void setPortfolioFromFile(const std::string& fileNameString, const std::string& inputPath); 
     void setMarketConfigs(const std::map<std::string, std::string>& m);
     void setThreads(int i) { nThreads_ = i; }
+    void setProcesses(int i) { nProcesses_ = i; }
     void setEntireMarket(bool b) { entireMarket_ = b; }
     void setAllFixings(bool b) { allFixings_ = b; }
     void setEomInflationFixings(bool b) { eomInflationFixings_ = b; }
@@ -94,6 +95,7 @@ public:
     void setCsvSeparator(const char& c) { csvSeparator_ = c; }
     void setCsvCommentCharacter(const char& c) { csvCommentCharacter_ = c; }
     void setDryRun(bool b) { dryRun_ = b; }
+    void setPricingProfile(bool b) { pricingProfile_ = b; }
     void setMporDays(Size s) { mporDays_ = s; }
     void setMporDate(const QuantLib::Date& d) { mporDate_ = d; }
     void setMporCalendar(const std::string& s); 
@@ -116,8 +118,11 @@ public:
     void setParSensi(bool b) { parSensi_ = b; }
     void setAlignPillars(bool b) { alignPillars_ = b; }
     void setOutputJacobi(bool b) { outputJacobi_ = b; }
+    void setJacobiCacheDirectory(const std::string& s) { jacobiCacheDirectory_ = s; }
+    void setJacobiCacheTolerance(Real r) { jacobiCacheTolerance_ = r; }
     void setUseSensiSpreadedTermStructures(bool b) { useSensiSpreadedTermStructures_ = b; }
     void setSensiThreshold(Real r) { sensiThreshold_ = r; }
+    void setSensiBinaryOutputFile(const std::string& s) { sensiBinaryOutputFile_ = s; }
     void setSensiSimMarketParams(const std::string& xml);
     void setSensiSimMarketParamsFromFile(const std::string& fileName);
     void setSensiScenarioData(const std::string& xml);
@@ -165,6 +170,9 @@ public:
     void setStoreFlows(bool b) { storeFlows_ = b; }
     void setStoreCreditStateNPVs(Size states) { storeCreditStateNPVs_ = states; }
     void setStoreSurvivalProbabilities(bool b) { storeSurvivalProbabilities_ = b; }
+    void setCashflowTablePricing(bool b) { cashflowTablePricing_ = b; }
+    void setCubeMemoryBudget(Size mb) { cubeMemoryBudget_ = mb; }
+    void setCubeDirectory(const std::string& s) { cubeDirectory_ = s; }
     void setWriteCube(bool b) { writeCube_ = b; }
     void setWriteScenarios(bool b) { writeScenarios_ = b; }
     void setExposureSimMarketParams(const std::string& xml);
@@ -199,6 +207,8 @@ public:
     void setCptyCubeFromFile(const std::string& file);
     void setMarketCubeFromFile(const std::string& file);
     // boost::shared_ptr<AggregationScenarioData> mktCube();
+    void setPreTradePortfolio(const std::string& xml);
+    void setPreTradePortfolioFromFile(const std::string& fileNameString, const std::string& inputPath);
     void setFlipViewXVA(bool b) { flipViewXVA_ = b; }
     void setFullInitialCollateralisation(bool b) { fullInitialCollateralisation_ = b; }
     void setExposureProfiles(bool b) { exposureProfiles_ = b; }
@@ -342,6 +352,7 @@ public:
 
     QuantLib::Size maxRetries() const { return maxRetries_; }
     QuantLib::Size nThreads() const { return nThreads_; }
+    QuantLib::Size nProcesses() const { return nProcesses_; }
     bool entireMarket() { return entireMarket_; }
     bool allFixings() { return allFixings_; }
     bool eomInflationFixings() { return eomInflationFixings_; }
@@ -354,6 +365,7 @@ public:
     char csvSeparator() const { return csvSeparator_; }
     char csvEscapeChar() const { return csvEscapeChar_; }
     bool dryRun() const { return dryRun_; }
+    bool pricingProfile() const { return pricingProfile_; }
     QuantLib::Size mporDays() { return mporDays_; }
     QuantLib::Date mporDate();
     const QuantLib::Calendar mporCalendar() {
@@ -390,8 +402,13 @@ public:
     bool parSensi() const { return parSensi_; };
     bool alignPillars() const { return alignPillars_; };
     bool outputJacobi() const { return outputJacobi_; };
+    // directory for the cached Jacobi matrix and its inverse used in the par conversion, empty means no caching
+    const std::string& jacobiCacheDirectory() const { return jacobiCacheDirectory_; }
+    QuantLib::Real jacobiCacheTolerance() const { return jacobiCacheTolerance_; }
     bool useSensiSpreadedTermStructures() { return useSensiSpreadedTermStructures_; }
     QuantLib::Real sensiThreshold() const { return sensiThreshold_; }
+    // file name in the results path for the sensitivities in binary format, empty means no binary output
+    const std::string& sensiBinaryOutputFile() const { return sensiBinaryOutputFile_; }
     const boost::shared_ptr<ore::analytics::ScenarioSimMarketParameters>& sensiSimMarketParams() { return sensiSimMarketParams_; }
     const boost::shared_ptr<ore::analytics::SensitivityScenarioData>& sensiScenarioData() { return sensiScenarioData_; }
     const boost::shared_ptr<ore::data::EngineData>& sensiPricingEngine() { return sensiPricingEngine_; }
@@ -431,6 +448,10 @@ public:
     bool storeFlows() { return storeFlows_; }
     Size storeCreditStateNPVs() { return storeCreditStateNPVs_; }
     bool storeSurvivalProbabilities() { return storeSurvivalProbabilities_; }
+    bool cashflowTablePricing() { return cashflowTablePricing_; }
+    // memory budget for the npv cube in MB, 0 means the cube is held in memory entirely
+    Size cubeMemoryBudget() { return cubeMemoryBudget_; }
+    const std::string& cubeDirectory() { return cubeDirectory_; }
     bool writeCube() { return writeCube_; }
     bool writeScenarios() { return writeScenarios_; }
     const boost::shared_ptr<ore::analytics::ScenarioSimMarketParameters>& exposureSimMarketParams() { return exposureSimMarketParams_; }
@@ -451,6 +472,7 @@ public:
     const boost::shared_ptr<NPVCube>& nettingSetCube() { return nettingSetCube_; }
     const boost::shared_ptr<NPVCube>& cptyCube() { return cptyCube_; }
     const boost::shared_ptr<AggregationScenarioData>& mktCube() { return mktCube_; }
+    const boost::shared_ptr<ore::data::Portfolio>& preTradePortfolio() { return preTradePortfolio_; }
     bool flipViewXVA() { return flipViewXVA_; }
     bool fullInitialCollateralisation() { return fullInitialCollateralisation_; }
     bool exposureProfiles() { return exposureProfiles_; }
@@ -604,6 +626,7 @@ protected:
     boost::shared_ptr<ore::data::Portfolio> portfolio_, useCounterpartyOriginalPortfolio_;
     QuantLib::Size maxRetries_ = 7;
     QuantLib::Size nThreads_ = 1;
+    QuantLib::Size nProcesses_ = 1;
    
     bool entireMarket_ = false; 
     bool allFixings_ = false; 
@@ -617,6 +640,7 @@ protected:
     char csvEscapeChar_ = '\\';
     std::string reportNaString_ = "#N/A";
     bool dryRun_ = false;
+    bool pricingProfile_ = false;
     QuantLib::Date mporDate_;
     QuantLib::Size mporDays_ = 10;
     QuantLib::Calendar mporCalendar_;
@@ -644,9 +668,12 @@ protected:
     bool xbsParConversion_ = false;
     bool parSensi_ = false;
     bool outputJacobi_ = false;
+    std::string jacobiCacheDirectory_;
+    QuantLib::Real jacobiCacheTolerance_ = 0.0;
     bool alignPillars_ = false;
     bool useSensiSpreadedTermStructures_ = true;
     QuantLib::Real sensiThreshold_ = 1e-6;
+    std::string sensiBinaryOutputFile_;
     boost::shared_ptr<ore::analytics::ScenarioSimMarketParameters> sensiSimMarketParams_;
     boost::shared_ptr<ore::analytics::SensitivityScenarioData> sensiScenarioData_;
     boost::shared_ptr<ore::data::EngineData> sensiPricingEngine_;
@@ -687,6 +714,9 @@ protected:
     bool storeFlows_ = false;
     Size storeCreditStateNPVs_ = 0;
     bool storeSurvivalProbabilities_ = false;
+    bool cashflowTablePricing_ = false;
+    Size cubeMemoryBudget_ = 0;
+    std::string cubeDirectory_;
     bool writeCube_ = false;
     bool writeScenarios_ = false;
     boost::shared_ptr<ore::analytics::ScenarioSimMarketParameters> exposureSimMarketParams_;
@@ -705,6 +735,8 @@ protected:
     // intermediate results of the exposure simulation, before aggregation
     boost::shared_ptr<NPVCube> cube_, nettingSetCube_, cptyCube_;
     boost::shared_ptr<AggregationScenarioData> mktCube_;
+    // candidate trades priced against the loaded cubes
+    boost::shared_ptr<ore::data::Portfolio> preTradePortfolio_;
 
     /**************
      * XVA analytic
@@ -246,33 +246,8 @@ void OREApp::analytics() {
         // Run the requested analytics
         analyticsManager_->runAnalytics(inputs_->analytics(), mcr);
 
-        // Write reports to files in the results path
-        Analytic::analytic_reports reports = analyticsManager_->reports();
-        analyticsManager_->toFile(reports,
-                                  inputs_->resultsPath().string(), outputs_->fileNameMap(),
-                                  inputs_->csvSeparator(), inputs_->csvCommentCharacter(),
-                                  inputs_->csvQuoteChar(), inputs_->reportNaString());
-
-        // Write npv cube(s)
-        for (auto a : analyticsManager_->npvCubes()) {
-            for (auto b : a.second) {
-                LOG("write npv cube " << b.first);
-                string reportName = b.first;
-                std::string fileName = inputs_->resultsPath().string() + "/" + outputs_->outputFileName(reportName, "csv.gz");
-                LOG("write npv cube " << reportName << " to file " << fileName);
-                saveCube(fileName, *b.second);
-            }
-        }
-        
-        // Write market cube(s)
-        for (auto a : analyticsManager_->mktCubes()) {
-            for (auto b : a.second) {
-                string reportName = b.first;
-                std::string fileName = inputs_->resultsPath().string() + "/" + outputs_->outputFileName(reportName, "csv.gz");
-                LOG("write market cube " << reportName << " to file " << fileName);
-                saveAggregationScenarioData(fileName, *b.second);
-            }
-        }        
+        // Write reports and cubes to files in the results path
+        writeResults();
     }
     catch (std::exception& e) {
         ostringstream oss;
@@ -287,6 +262,36 @@ void OREApp::analytics() {
     LOG("ORE analytics done");
 }
 
+void OREApp::writeResults() {
+    // Write reports to files in the results path
+    Analytic::analytic_reports reports = analyticsManager_->reports();
+    analyticsManager_->toFile(reports,
+                              inputs_->resultsPath().string(), outputs_->fileNameMap(),
+                              inputs_->csvSeparator(), inputs_->csvCommentCharacter(),
+                              inputs_->csvQuoteChar(), inputs_->reportNaString());
+
+    // Write npv cube(s)
+    for (auto a : analyticsManager_->npvCubes()) {
+        for (auto b : a.second) {
+            LOG("write npv cube " << b.first);
+            string reportName = b.first;
+            std::string fileName = inputs_->resultsPath().string() + "/" + outputs_->outputFileName(reportName, "csv.gz");
+            LOG("write npv cube " << reportName << " to file " << fileName);
+            saveCube(fileName, *b.second);
+        }
+    }
+    
+    // Write market cube(s)
+    for (auto a : analyticsManager_->mktCubes()) {
+        for (auto b : a.second) {
+            string reportName = b.first;
+            std::string fileName = inputs_->resultsPath().string() + "/" + outputs_->outputFileName(reportName, "csv.gz");
+            LOG("write market cube " << reportName << " to file " << fileName);
+            saveAggregationScenarioData(fileName, *b.second);
+        }
+    }
+}
+
 OREApp::OREApp(boost::shared_ptr<Parameters> params, bool console, 
                const boost::filesystem::path& logRootPath)
     : params_(params), inputs_(nullptr) {
@@ -414,6 +419,123 @@ void OREApp::run(const std::vector<std::string>& marketData,
     LOG("ORE analytics done");
 }
 
+void OREApp::serve(std::istream& in, std::ostream& out) {
+    QL_REQUIRE(params_, "ORE input parameters not set, the service mode requires the first OREApp c'tor");
+    LOG("ORE service starting");
+
+    Settings::instance().evaluationDate() = inputs_->asof();
+    GlobalPseudoCurrencyMarketParameters::instance().set(inputs_->pricingEngine()->globalParameters());
+    InstrumentConventions::instance().setConventions(inputs_->conventions());
+
+    // quotes entering bootstrapped yield curves, which observe the loader quotes in the warm market
+    static const std::set<MarketDatum::InstrumentType> linkedQuoteTypes = {
+        MarketDatum::InstrumentType::MM,         MarketDatum::InstrumentType::MM_FUTURE,
+        MarketDatum::InstrumentType::OI_FUTURE,  MarketDatum::InstrumentType::FRA,
+        MarketDatum::InstrumentType::IMM_FRA,    MarketDatum::InstrumentType::IR_SWAP,
+        MarketDatum::InstrumentType::BASIS_SWAP, MarketDatum::InstrumentType::BMA_SWAP,
+        MarketDatum::InstrumentType::CC_BASIS_SWAP, MarketDatum::InstrumentType::CC_FIX_FLOAT_SWAP};
+
+    // analytics that move the evaluation date, the warm market built with preserved quote linkage does not support this
+    static const std::set<std::string> dateMovingAnalytics = {"EXPOSURE", "XVA", "SCENARIO_STATISTICS"};
+
+    // (re)load the market data files and set up a fresh analytics manager in warm start mode
+    boost::shared_ptr<CSVLoader> csvLoader;
+    boost::shared_ptr<MarketDataLoader> loader;
+    auto start = [this, &csvLoader, &loader]() {
+        csvLoader = buildCsvLoader(params_);
+        loader = boost::make_shared<MarketDataCsvLoader>(inputs_, csvLoader);
+        analyticsManager_ = boost::make_shared<AnalyticsManager>(inputs_, loader);
+        analyticsManager_->setWarmStart(true);
+    };
+    start();
+
+    std::string line;
+    while (std::getline(in, line)) {
+        boost::trim(line);
+        if (line.empty() || line[0] == '#')
+            continue;
+        vector<string> tokens;
+        boost::split(tokens, line, boost::is_any_of(" \t"), boost::token_compress_on);
+        const string command = boost::to_upper_copy(tokens.front());
+        DLOG("ORE service command: " << line);
+        try {
+            if (command == "QUIT") {
+                out << "OK" << std::endl;
+                break;
+            } else if (command == "QUOTE") {
+                QL_REQUIRE(tokens.size() == 3, "usage: QUOTE name value");
+                Real value = parseReal(tokens[2]);
+                // update the file data, it is copied to the loader whenever the loader is (re)populated
+                QL_REQUIRE(csvLoader->has(tokens[1], inputs_->asof()), "quote " << tokens[1] << " not found");
+                auto source = boost::dynamic_pointer_cast<QuantLib::SimpleQuote>(
+                    csvLoader->get(tokens[1], inputs_->asof())->quote().currentLink());
+                QL_REQUIRE(source, "quote " << tokens[1] << " can not be updated");
+                source->setValue(value);
+                // update the loaded quote, the markets built on it observe it or are rebuilt
+                const auto& loaded = loader->loader();
+                if (loaded && loaded->has(tokens[1], inputs_->asof())) {
+                    auto datum = loaded->get(tokens[1], inputs_->asof());
+                    if (auto quote = boost::dynamic_pointer_cast<QuantLib::SimpleQuote>(datum->quote().currentLink()))
+                        quote->setValue(value);
+                    if (linkedQuoteTypes.count(datum->instrumentType()) == 0)
+                        analyticsManager_->resetMarkets();
+                }
+                out << "OK" << std::endl;
+            } else if (command == "TRADES") {
+                QL_REQUIRE(tokens.size() == 2, "usage: TRADES file[,file...]");
+                QL_REQUIRE(inputs_->portfolio(), "no portfolio loaded");
+                Size n = 0;
+                for (const auto& file : getFileNames(tokens[1], params_->get("setup", "inputPath"))) {
+                    Portfolio trades(inputs_->buildFailedTrades());
+                    trades.fromFile(file);
+                    for (const auto& [tradeId, trade] : trades.trades()) {
+                        inputs_->portfolio()->remove(tradeId);
+                        inputs_->portfolio()->add(trade);
+                        ++n;
+                    }
+                }
+                out << "OK " << n << std::endl;
+            } else if (command == "REMOVE") {
+                QL_REQUIRE(tokens.size() == 2, "usage: REMOVE id");
+                QL_REQUIRE(inputs_->portfolio() && inputs_->portfolio()->remove(tokens[1]),
+                           "trade " << tokens[1] << " not found");
+                out << "OK" << std::endl;
+            } else if (command == "RUN") {
+                QL_REQUIRE(tokens.size() <= 2, "usage: RUN [type,type,...]");
+                std::set<std::string> analyticTypes = inputs_->analytics();
+                if (tokens.size() == 2) {
+                    vector<string> types;
+                    boost::split(types, tokens[1], boost::is_any_of(","), boost::token_compress_on);
+                    analyticTypes = std::set<std::string>(types.begin(), types.end());
+                }
+                for (const auto& t : analyticTypes)
+                    QL_REQUIRE(dateMovingAnalytics.count(t) == 0,
+                               "analytic " << t << " moves the evaluation date, run it in batch mode");
+                cpu_timer timer;
+                boost::shared_ptr<MarketCalibrationReportBase> mcr;
+                if (inputs_->outputTodaysMarketCalibration()) {
+                    auto marketCalibrationReport = boost::make_shared<ore::data::InMemoryReport>();
+                    mcr = boost::make_shared<MarketCalibrationReport>(string(), marketCalibrationReport);
+                }
+                analyticsManager_->runAnalytics(analyticTypes, mcr);
+                writeResults();
+                timer.stop();
+                out << "OK " << timer.format(default_places, "%w") << std::endl;
+            } else if (command == "RELOAD") {
+                start();
+                out << "OK" << std::endl;
+            } else {
+                QL_FAIL("unknown command '" << tokens.front() << "'");
+            }
+        } catch (const std::exception& e) {
+            ALOG("ORE service: command '" << line << "' failed: " << e.what());
+            out << "ERROR " << boost::replace_all_copy(string(e.what()), "\n", " ") << std::endl;
+        }
+    }
+
+    LOG("ORE service done");
+}
+
 void OREApp::buildInputParameters(boost::shared_ptr<InputParameters> inputs,
                                   const boost::shared_ptr<Parameters>& params) {
     QL_REQUIRE(inputs, "InputParameters not created yet");
@@ -475,6 +597,12 @@ void OREApp::buildInputParameters(boost::shared_ptr<InputParameters> inputs,
     if (tmp != "")
         inputs->setDryRun(parseBool(tmp));
 
+    tmp = params_->get("setup", "pricingProfile", false);
+    if (tmp != "") {
+        inputs->setPricingProfile(parseBool(tmp));
+        PricingProfiler::instance().setEnabled(inputs->pricingProfile());
+    }
+
     tmp = params_->get("setup", "reportNaString", false);
     if (tmp != "")
         inputs->setReportNaString(tmp);
@@ -487,6 +615,10 @@ void OREApp::buildInputParameters(boost::shared_ptr<InputParameters> inputs,
     if (tmp != "")
         inputs->setThreads(parseInteger(tmp));
 
+    tmp = params_->get("setup", "nProcesses", false);
+    if (tmp != "")
+        inputs->setProcesses(parseInteger(tmp));
+
     tmp = params_->get("setup", "entireMarket", false);
     if (tmp != "")
         inputs->setEntireMarket(parseBool(tmp));
@@ -656,6 +788,14 @@ void OREApp::buildInputParameters(boost::shared_ptr<InputParameters> inputs,
         if (tmp != "")
             inputs->setAlignPillars(parseBool(tmp));
 
+        tmp = params_->get("sensitivity", "jacobiCacheDirectory", false);
+        if (tmp != "")
+            inputs->setJacobiCacheDirectory(tmp);
+
+        tmp = params_->get("sensitivity", "jacobiCacheTolerance", false);
+        if (tmp != "")
+            inputs->setJacobiCacheTolerance(parseReal(tmp));
+
         tmp = params_->get("sensitivity", "marketConfigFile", false);
         if (tmp != "") {
             string file = inputPath + "/" + tmp;
@@ -688,6 +828,10 @@ void OREApp::buildInputParameters(boost::shared_ptr<InputParameters> inputs,
         tmp = params_->get("sensitivity", "outputSensitivityThreshold", false);
         if (tmp != "")
             inputs->setSensiThreshold(parseReal(tmp));
+
+        tmp = params_->get("sensitivity", "sensitivityBinaryOutputFile", false);
+        if (tmp != "")
+            inputs->setSensiBinaryOutputFile(tmp);
     }
 
     /****************
@@ -913,6 +1057,18 @@ void OREApp::buildInputParameters(boost::shared_ptr<InputParameters> inputs,
         tmp = params_->get("simulation", "storeSurvivalProbabilities", false);
         if (tmp == "Y")
             inputs->setStoreSurvivalProbabilities(true);
+
+        tmp = params_->get("simulation", "cashflowTablePricing", false);
+        if (tmp == "Y")
+            inputs->setCashflowTablePricing(true);
+
+        tmp = params_->get("simulation", "cubeMemoryBudget", false);
+        if (tmp != "")
+            inputs->setCubeMemoryBudget(parseInteger(tmp));
+
+        tmp = params_->get("simulation", "cubeDirectory", false);
+        if (tmp != "")
+            inputs->setCubeDirectory(tmp);
         
         tmp = params_->get("simulation", "nettingSetId", false);
         if (tmp != "")
@@ -992,6 +1148,12 @@ void OREApp::buildInputParameters(boost::shared_ptr<InputParameters> inputs,
         inputs->setMarketCubeFromFile(cubeFile);
         LOG("MktCube loading done");
     }
+
+    tmp = params_->get("xva", "preTradePortfolioFile", false);
+    if (inputs->loadCube() && tmp != "") {
+        LOG("Load pre-trade portfolio from " << tmp);
+        inputs->setPreTradePortfolioFromFile(tmp, inputPath);
+    }
     
     tmp = params_->get("xva", "flipViewXVA", false);
     if (tmp != "")
@@ -1299,6 +1461,14 @@ void OREApp::buildInputParameters(boost::shared_ptr<InputParameters> inputs,
         if (tmp != "")
             inputs->setParConversionOutputJacobi(parseBool(tmp));
 
+        tmp = params_->get("zeroToParSensiConversion", "jacobiCacheDirectory", false);
+        if (tmp != "")
+            inputs->setJacobiCacheDirectory(tmp);
+
+        tmp = params_->get("zeroToParSensiConversion", "jacobiCacheTolerance", false);
+        if (tmp != "")
+            inputs->setJacobiCacheTolerance(parseReal(tmp));
+
     }
 
     /**********************
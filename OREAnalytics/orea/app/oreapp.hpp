@@ -56,6 +56,23 @@ public:
     void run(const std::vector<std::string>& marketData,
              const std::vector<std::string>& fixingData);
     
+    /*! Service mode after using the first OREApp c'tor: reads commands line by line from \p in and writes one
+        response line per command to \p out, starting with OK or ERROR. The market data, today's markets and the
+        built trades are kept between runs, so that runs after small quote or trade changes are fast:
+
+        - QUOTE name value: set the value of a market quote in the market data file
+        - TRADES file[,file...]: add the trades in the portfolio files (relative to inputPath), replacing trades
+          with the same ids
+        - REMOVE id: remove a trade from the portfolio
+        - RUN [type,type,...]: run the given analytics, or the analytics in ore.xml, and write the reports; analytics
+          that move the evaluation date (EXPOSURE, XVA, SCENARIO_STATISTICS) are rejected
+        - RELOAD: reload the market data files and rebuild everything in the next run
+        - QUIT: stop the service
+
+        Changes of bootstrapped yield curve quotes are picked up by the warm market, other quote changes cause a
+        rebuild of the markets from the updated quotes in the next run. */
+    void serve(std::istream& in, std::ostream& out);
+
     boost::shared_ptr<InputParameters> getInputs() { return inputs_; }
 
     std::set<std::string> getAnalyticTypes();
@@ -78,6 +95,8 @@ public:
     
 protected:
     virtual void analytics();
+    //! Write the reports and cubes of the analytics manager to files in the results path
+    void writeResults();
 
     //! Populate InputParameters object from classic ORE key-value pairs in Parameters 
     void buildInputParameters(boost::shared_ptr<InputParameters> inputs,
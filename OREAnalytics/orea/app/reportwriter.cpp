@@ -628,11 +628,11 @@ void ReportWriter::writeCashflowNpv(ore::data::Report& report, const ore::data::
     map<string, Real> npvMap;
     Date asof = Settings::instance().evaluationDate();
     for (Size i = 0; i < cashflowReport.rows(); ++i) {
-        string tradeId = boost::get<string>(cashflowReport.data(tradeIdColumn).at(i));
-        string tradeType = boost::get<string>(cashflowReport.data(tradeTypeColumn).at(i));
-        Date payDate = boost::get<Date>(cashflowReport.data(payDateColumn).at(i));
-        string ccy = boost::get<string>(cashflowReport.data(ccyColumn).at(i));
-        Real pv = boost::get<Real>(cashflowReport.data(pvColumn).at(i));
+        const string& tradeId = cashflowReport.stringValue(i, tradeIdColumn);
+        const string& tradeType = cashflowReport.stringValue(i, tradeTypeColumn);
+        Date payDate = cashflowReport.dateData(payDateColumn).at(i);
+        const string& ccy = cashflowReport.stringValue(i, ccyColumn);
+        Real pv = cashflowReport.realData(pvColumn).at(i);
         Real fx = 1.0;
 	// There shouldn't be entries in the cf report without ccy. We assume ccy = baseCcy in this case and log an error.
         if (ccy.empty()) {
@@ -1002,6 +1002,38 @@ void ReportWriter::writeXVA(ore::data::Report& report, const string& allocationM
     report.end();
 }
 
+void ReportWriter::writePreTradeXVA(ore::data::Report& report, boost::shared_ptr<PostProcess> basePostProcess,
+                                    boost::shared_ptr<PostProcess> postProcess) {
+    Size precision = 2;
+    report.addColumn("NettingSetId", string());
+    const vector<string> xvas = {"CVA", "DVA", "FBA", "FCA", "COLVA", "MVA"};
+    for (auto const& x : xvas)
+        report.addColumn("Base" + x, double(), precision)
+            .addColumn(x, double(), precision)
+            .addColumn("Marginal" + x, double(), precision);
+
+    auto values = [](const boost::shared_ptr<PostProcess>& p, const string& n) {
+        return vector<Real>{p->nettingSetCVA(n),   p->nettingSetDVA(n),   p->nettingSetFBA(n),
+                            p->nettingSetFCA(n),   p->nettingSetCOLVA(n), p->nettingSetMVA(n)};
+    };
+
+    for (const auto& [n, _] : postProcess->nettingSetIds()) {
+        try {
+            vector<Real> after = values(postProcess, n);
+            vector<Real> before(after.size(), 0.0);
+            if (basePostProcess && basePostProcess->nettingSetIds().count(n) > 0)
+                before = values(basePostProcess, n);
+            report.next().add(n);
+            for (Size i = 0; i < after.size(); ++i)
+                report.add(before[i]).add(after[i]).add(after[i] - before[i]);
+        } catch (const std::exception& e) {
+            ALOG(StructuredAnalyticsErrorMessage("Pre-Trade XVA Report", "Error during writing xva for netting set.",
+                                                 e.what(), {{"nettingSetId", n}}));
+        }
+    }
+    report.end();
+}
+
 void ReportWriter::writeNettingSetColva(ore::data::Report& report, boost::shared_ptr<PostProcess> postProcess,
                                         const string& nettingSetId) {
     const vector<Date> dates = postProcess->cube()->dates();
@@ -1422,6 +1454,58 @@ void ReportWriter::writePricingStats(ore::data::Report& report, const boost::sha
     LOG("Pricing stats report written");
 }
 
+void ReportWriter::writePricingProfile(ore::data::Report& report, const PricingProfile& profile,
+                                       const boost::shared_ptr<EngineData>& engineData) {
+
+    LOG("Writing Pricing profile report");
+
+    report.addColumn("Category", string())
+        .addColumn("Rank", Size())
+        .addColumn("Name", string())
+        .addColumn("NumberOfCalls", Size())
+        .addColumn("CumulativeTiming", Size())
+        .addColumn("AverageTiming", Size())
+        .addColumn("Share", double(), 4);
+
+    auto addRows = [&report](const string& category,
+                             const vector<std::pair<string, PricingProfile::Entry>>& entries) {
+        double total = 0.0;
+        for (auto const& e : entries)
+            total += static_cast<double>(e.second.wallTime);
+        for (Size i = 0; i < entries.size(); ++i) {
+            Size num = entries[i].second.count;
+            Size cumulative = entries[i].second.wallTime / 1000;
+            Size average = num > 0 ? cumulative / num : 0;
+            report.next()
+                .add(category)
+                .add(i + 1)
+                .add(entries[i].first)
+                .add(num)
+                .add(cumulative)
+                .add(average)
+                .add(total > 0.0 ? entries[i].second.wallTime / total : 0.0);
+        }
+    };
+
+    for (auto c : {PricingProfile::Category::Phase, PricingProfile::Category::Calculator,
+                   PricingProfile::Category::TradeType, PricingProfile::Category::Trade})
+        addRows(ore::data::to_string(c), profile.ranked(c));
+
+    if (engineData) {
+        PricingProfile engines;
+        for (auto const& [tradeType, e] : profile.ranked(PricingProfile::Category::TradeType)) {
+            string name = engineData->hasProduct(tradeType)
+                              ? engineData->model(tradeType) + "/" + engineData->engine(tradeType)
+                              : "n/a (" + tradeType + ")";
+            engines.add(PricingProfile::Category::TradeType, name, e.wallTime, e.count);
+        }
+        addRows("EngineBuilder", engines.ranked(PricingProfile::Category::TradeType));
+    }
+
+    report.end();
+    LOG("Pricing profile report written");
+}
+
 void ReportWriter::writeCube(ore::data::Report& report, const boost::shared_ptr<NPVCube>& cube,
                              const std::map<std::string, std::string>& nettingSetMap) {
     LOG("Writing cube report");
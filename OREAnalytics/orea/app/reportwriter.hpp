@@ -29,6 +29,7 @@
 #include <orea/app/parameters.hpp>
 #include <orea/cube/npvcube.hpp>
 #include <orea/cube/sensitivitycube.hpp>
+#include <orea/engine/pricingprofiler.hpp>
 #include <orea/engine/sensitivitystream.hpp>
 #include <orea/simm/crifrecord.hpp>
 #include <orea/simm/simmresults.hpp>
@@ -36,6 +37,7 @@
 #include <ored/marketdata/market.hpp>
 #include <ored/marketdata/todaysmarketparameters.hpp>
 #include <ored/marketdata/todaysmarketcalibrationinfo.hpp>
+#include <ored/portfolio/enginedata.hpp>
 #include <ored/marketdata/loader.hpp>
 #include <ored/portfolio/portfolio.hpp>
 #include <ored/report/report.hpp>
@@ -96,6 +98,11 @@ public:
     virtual void writeXVA(ore::data::Report& report, const string& allocationMethod,
                           boost::shared_ptr<Portfolio> portfolio, boost::shared_ptr<PostProcess> postProcess);
 
+    /*! Netting set XVA before and after adding the pre-trade candidates and the marginal XVA. The base post process
+        may be null if none of the candidate netting sets exists yet. */
+    virtual void writePreTradeXVA(ore::data::Report& report, boost::shared_ptr<PostProcess> basePostProcess,
+                                  boost::shared_ptr<PostProcess> postProcess);
+
     virtual void writeAggregationScenarioData(ore::data::Report& report, const AggregationScenarioData& data);
 
     virtual void writeScenarioReport(ore::data::Report& report,
@@ -122,6 +129,11 @@ public:
 
     virtual void writePricingStats(ore::data::Report& report, const boost::shared_ptr<Portfolio>& portfolio);
 
+    /*! Ranked pricing profile, by category and descending wall time. If engine data is given, the trade type timings
+        are also aggregated by the model / engine configured for the trade type. */
+    virtual void writePricingProfile(ore::data::Report& report, const PricingProfile& profile,
+                                     const boost::shared_ptr<ore::data::EngineData>& engineData = nullptr);
+
     virtual void writeCube(ore::data::Report& report, const boost::shared_ptr<NPVCube>& cube,
                            const std::map<std::string, std::string>& nettingSetMap = std::map<std::string, std::string>());
 
@@ -18,6 +18,7 @@
 
 #include <orea/app/reportwriter.hpp>
 #include <orea/app/sensitivityrunner.hpp>
+#include <orea/engine/pricingprofiler.hpp>
 #include <orea/engine/sensitivitycubestream.hpp>
 #include <ored/report/csvreport.hpp>
 #include <ored/utilities/log.hpp>
@@ -49,6 +50,8 @@ void SensitivityRunner::runSensitivityAnalysis(boost::shared_ptr<Market> market,
     MEM_LOG;
     LOG("Running sensitivity analysis");
 
+    PricingProfiler::instance().reset();
+
     boost::shared_ptr<ScenarioSimMarketParameters> simMarketData(new ScenarioSimMarketParameters);
     sensiData_ = boost::make_shared<SensitivityScenarioData>();
     boost::shared_ptr<EngineData> engineData = boost::make_shared<EngineData>();
@@ -134,6 +137,12 @@ void SensitivityRunner::sensiOutputReports(const boost::shared_ptr<SensitivityAn
 
     CSVFileReport pricingStatsReport(params_->get("setup", "outputPath") + "/pricingstats_sensi.csv");
     ore::analytics::ReportWriter().writePricingStats(pricingStatsReport, sensiAnalysis->portfolio());
+
+    if (PricingProfiler::instance().enabled()) {
+        CSVFileReport pricingProfileReport(params_->get("setup", "outputPath") + "/pricingprofile_sensi.csv");
+        ore::analytics::ReportWriter().writePricingProfile(pricingProfileReport,
+                                                           PricingProfiler::instance().profile());
+    }
 }
 
 } // namespace analytics
@@ -0,0 +1,70 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/cube/diskcube.hpp>
+
+#include <ored/utilities/log.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/device/file.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+
+namespace ore {
+namespace analytics {
+
+CubeTileStore::CubeTileStore(const std::string& directory) {
+    boost::filesystem::path base =
+        directory.empty() ? boost::filesystem::temp_directory_path() : boost::filesystem::path(directory);
+    boost::filesystem::path p = base / boost::filesystem::unique_path("orecube-%%%%-%%%%-%%%%-%%%%");
+    boost::filesystem::create_directories(p);
+    path_ = p.string();
+    DLOG("CubeTileStore: created tile directory " << path_);
+}
+
+CubeTileStore::~CubeTileStore() {
+    boost::system::error_code ec;
+    boost::filesystem::remove_all(path_, ec);
+    if (ec) {
+        WLOG("CubeTileStore: could not remove tile directory " << path_ << ": " << ec.message());
+    }
+}
+
+std::string CubeTileStore::fileName(Size tile) const {
+    return (boost::filesystem::path(path_) / ("tile_" + std::to_string(tile) + ".gz")).string();
+}
+
+void CubeTileStore::write(Size tile, const char* data, std::size_t bytes) {
+    boost::iostreams::filtering_ostream out;
+    out.push(boost::iostreams::gzip_compressor(boost::iostreams::gzip_params(boost::iostreams::gzip::best_speed)));
+    out.push(boost::iostreams::file_sink(fileName(tile), std::ios_base::binary));
+    out.write(data, bytes);
+    out.reset();
+}
+
+void CubeTileStore::read(Size tile, char* data, std::size_t bytes) const {
+    boost::iostreams::filtering_istream in;
+    in.push(boost::iostreams::gzip_decompressor());
+    in.push(boost::iostreams::file_source(fileName(tile), std::ios_base::binary));
+    in.read(data, bytes);
+    QL_REQUIRE(static_cast<std::size_t>(in.gcount()) == bytes,
+               "CubeTileStore: could not read " << bytes << " bytes from " << fileName(tile));
+}
+
+} // namespace analytics
+} // namespace ore
@@ -0,0 +1,245 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/cube/diskcube.hpp
+    \brief A cube implementation that keeps a bounded number of tiles in memory and the rest on disk
+    \ingroup cube
+*/
+
+#pragma once
+
+#include <orea/cube/npvcube.hpp>
+
+#include <ql/errors.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ore {
+namespace analytics {
+using QuantLib::Date;
+using QuantLib::Real;
+using QuantLib::Size;
+
+//! Directory holding the compressed tiles of a DiskCube, the directory is removed on destruction
+/*! \ingroup cube
+ */
+class CubeTileStore {
+public:
+    //! creates a unique directory below \p directory, or below the system temp directory if empty
+    explicit CubeTileStore(const std::string& directory = std::string());
+    ~CubeTileStore();
+    CubeTileStore(const CubeTileStore&) = delete;
+    CubeTileStore& operator=(const CubeTileStore&) = delete;
+
+    //! write \p bytes bytes from \p data to tile \p tile, gzip compressed
+    void write(Size tile, const char* data, std::size_t bytes);
+    //! read \p bytes bytes of tile \p tile into \p data
+    void read(Size tile, char* data, std::size_t bytes) const;
+
+    const std::string& path() const { return path_; }
+
+private:
+    std::string fileName(Size tile) const;
+    std::string path_;
+};
+
+//! DiskCube stores the cube in tiles, of which only as many as fit into a memory budget are held in memory
+/*! A tile holds the values of a block of ids and a block of samples, for all dates and depths. Tiles are held in
+    memory in a least recently used cache, a tile evicted from the cache is written to disk in compressed form if it
+    was modified and read back on the next access. The T0 values are always held in memory.
+
+    If no block sizes are given, they are chosen such that both the valuation engine write pattern (sample by sample,
+    for all ids) and the post processing read pattern (id by id, for all samples) only touch as many tiles as fit into
+    half of the memory budget, so that both can stream through the cube without reading a tile twice.
+
+    Since also reads modify the tile cache, get() and set() are serialised by a mutex, so that the cube can be read
+    from several threads, e.g. in the credit migration post processing. This class is a template to allow both single
+    and double precision implementations.
+
+    \ingroup cube
+ */
+template <typename T> class DiskCube : public NPVCube {
+public:
+    DiskCube(const Date& asof, const std::set<std::string>& ids, const std::vector<Date>& dates, Size samples,
+             Size depth,
+             //! memory budget for the tile cache in bytes
+             std::size_t memoryBudget,
+             //! number of ids per tile, 0 = derive from the memory budget
+             Size idBlockSize = 0,
+             //! number of samples per tile, 0 = derive from the memory budget
+             Size sampleBlockSize = 0,
+             //! directory for the tile files, empty = system temp directory
+             const std::string& directory = std::string(), const T& t = T())
+        : asof_(asof), dates_(dates), samples_(samples), depth_(depth), t_(t), t0Data_(ids.size() * depth, t),
+          store_(directory) {
+        QL_REQUIRE(ids.size() > 0, "DiskCube: no ids specified");
+        QL_REQUIRE(dates.size() > 0, "DiskCube: no dates specified");
+        QL_REQUIRE(samples > 0, "DiskCube: samples must be > 0");
+        QL_REQUIRE(depth > 0, "DiskCube: depth must be > 0");
+        Size pos = 0;
+        for (const auto& id : ids)
+            idIdx_[id] = pos++;
+
+        std::size_t perId = dates_.size() * samples_ * depth_ * sizeof(T);
+        std::size_t perSample = ids.size() * dates_.size() * depth_ * sizeof(T);
+        idBlockSize_ = idBlockSize > 0 ? idBlockSize : std::max<std::size_t>(memoryBudget / (2 * perId), 1);
+        sampleBlockSize_ =
+            sampleBlockSize > 0 ? sampleBlockSize : std::max<std::size_t>(memoryBudget / (2 * perSample), 1);
+        idBlockSize_ = std::min(idBlockSize_, ids.size());
+        sampleBlockSize_ = std::min(sampleBlockSize_, samples_);
+        idBlocks_ = (ids.size() + idBlockSize_ - 1) / idBlockSize_;
+        sampleBlocks_ = (samples_ + sampleBlockSize_ - 1) / sampleBlockSize_;
+
+        std::size_t tileBytes = idBlockSize_ * sampleBlockSize_ * dates_.size() * depth_ * sizeof(T);
+        capacity_ = std::max<std::size_t>(memoryBudget / tileBytes, 1);
+        tiles_.resize(idBlocks_ * sampleBlocks_);
+    }
+
+    Size numIds() const override { return idIdx_.size(); }
+    Size numDates() const override { return dates_.size(); }
+    Size samples() const override { return samples_; }
+    Size depth() const override { return depth_; }
+    const std::map<std::string, Size>& idsAndIndexes() const override { return idIdx_; }
+    const std::vector<QuantLib::Date>& dates() const override { return dates_; }
+    QuantLib::Date asof() const override { return asof_; }
+
+    Real getT0(Size i, Size d) const override {
+        check(i, 0, 0, d);
+        return t0Data_[i * depth_ + d];
+    }
+
+    void setT0(Real value, Size i, Size d) override {
+        check(i, 0, 0, d);
+        t0Data_[i * depth_ + d] = static_cast<T>(value);
+    }
+
+    Real get(Size i, Size j, Size k, Size d) const override {
+        check(i, j, k, d);
+        std::lock_guard<std::mutex> lock(mutex_);
+        return tile(i, k).data[offset(i, j, k, d)];
+    }
+
+    void set(Real value, Size i, Size j, Size k, Size d) override {
+        check(i, j, k, d);
+        std::lock_guard<std::mutex> lock(mutex_);
+        Tile& t = tile(i, k);
+        t.data[offset(i, j, k, d)] = static_cast<T>(value);
+        t.dirty = true;
+    }
+
+    //! Tile layout and cache statistics
+    Size idBlockSize() const { return idBlockSize_; }
+    Size sampleBlockSize() const { return sampleBlockSize_; }
+    Size tilesInMemory() const { return lru_.size(); }
+    Size maxTilesInMemory() const { return capacity_; }
+    Size tileReads() const { return tileReads_; }
+    Size tileWrites() const { return tileWrites_; }
+    const std::string& tileDirectory() const { return store_.path(); }
+
+private:
+    struct Tile {
+        std::vector<T> data;
+        bool dirty = false;
+        bool onDisk = false;
+        typename std::list<Size>::iterator lruPos;
+    };
+
+    void check(Size i, Size j, Size k, Size d) const {
+        QL_REQUIRE(i < numIds(), "Out of bounds on ids (i=" << i << ", numIds=" << numIds() << ")");
+        QL_REQUIRE(j < numDates(), "Out of bounds on dates (j=" << j << ", numDates=" << numDates() << ")");
+        QL_REQUIRE(k < samples(), "Out of bounds on samples (k=" << k << ", samples=" << samples() << ")");
+        QL_REQUIRE(d < depth(), "Out of bounds on depth (d=" << d << ", depth=" << depth() << ")");
+    }
+
+    // number of samples in the sample block of sample k, the last block may be shorter
+    Size sampleBlockLength(Size k) const {
+        Size k0 = (k / sampleBlockSize_) * sampleBlockSize_;
+        return std::min(sampleBlockSize_, samples_ - k0);
+    }
+
+    // position within the tile, the values are stored by id, date, sample, depth
+    Size offset(Size i, Size j, Size k, Size d) const {
+        return (((i % idBlockSize_) * dates_.size() + j) * sampleBlockLength(k) + k % sampleBlockSize_) * depth_ + d;
+    }
+
+    // the tile containing id i and sample k, loaded into memory
+    Tile& tile(Size i, Size k) const {
+        Size n = (i / idBlockSize_) * sampleBlocks_ + k / sampleBlockSize_;
+        Tile& t = tiles_[n];
+        if (!t.data.empty()) {
+            if (t.lruPos != lru_.begin())
+                lru_.splice(lru_.begin(), lru_, t.lruPos);
+            return t;
+        }
+        if (lru_.size() >= capacity_)
+            evict();
+        Size i0 = (i / idBlockSize_) * idBlockSize_;
+        Size length = std::min(idBlockSize_, idIdx_.size() - i0) * dates_.size() * sampleBlockLength(k) * depth_;
+        t.data.assign(length, t_);
+        if (t.onDisk) {
+            store_.read(n, reinterpret_cast<char*>(t.data.data()), length * sizeof(T));
+            ++tileReads_;
+        }
+        t.dirty = false;
+        lru_.push_front(n);
+        t.lruPos = lru_.begin();
+        return t;
+    }
+
+    // remove the least recently used tile from memory, write it to disk if modified
+    void evict() const {
+        Size n = lru_.back();
+        lru_.pop_back();
+        Tile& t = tiles_[n];
+        if (t.dirty) {
+            store_.write(n, reinterpret_cast<const char*>(t.data.data()), t.data.size() * sizeof(T));
+            t.onDisk = true;
+            ++tileWrites_;
+        }
+        std::vector<T>().swap(t.data);
+        t.dirty = false;
+    }
+
+    QuantLib::Date asof_;
+    std::vector<QuantLib::Date> dates_;
+    Size samples_, depth_;
+    T t_;
+    std::map<std::string, Size> idIdx_;
+    std::vector<T> t0Data_;
+
+    Size idBlockSize_, sampleBlockSize_, idBlocks_, sampleBlocks_, capacity_;
+    mutable std::vector<Tile> tiles_;
+    mutable std::list<Size> lru_;
+    mutable CubeTileStore store_;
+    mutable Size tileReads_ = 0, tileWrites_ = 0;
+    mutable std::mutex mutex_;
+};
+
+//! DiskCube with single precision floating point numbers.
+using SinglePrecisionDiskCube = DiskCube<float>;
+
+//! DiskCube with double precision floating point numbers.
+using DoublePrecisionDiskCube = DiskCube<double>;
+
+} // namespace analytics
+} // namespace ore
@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <fstream>
 #include <vector>
 
@@ -137,6 +138,14 @@ public:
         this->check(i, j, k, d);
         this->data_[i][j][k] = static_cast<T>(value);
     }
+    //! Set the values of all samples
+    void setSamples(const std::vector<Real>& values, Size i, Size j, Size d) override {
+        this->check(i, j, 0, d);
+        QL_REQUIRE(values.size() == this->samples_,
+                   "InMemoryCube::setSamples(): got " << values.size() << " values, expected " << this->samples_);
+        std::transform(values.begin(), values.end(), this->data_[i][j].begin(),
+                       [](Real v) { return static_cast<T>(v); });
+    }
 };
 
 //! InMemoryCube of variable depth
@@ -178,6 +187,14 @@ public:
         this->check(i, j, k, d);
         this->data_[i][j][k][d] = static_cast<T>(value);
     }
+    //! Set the values of all samples
+    void setSamples(const std::vector<Real>& values, Size i, Size j, Size d) override {
+        this->check(i, j, 0, d);
+        QL_REQUIRE(values.size() == this->samples_,
+                   "InMemoryCube::setSamples(): got " << values.size() << " values, expected " << this->samples_);
+        for (Size k = 0; k < values.size(); ++k)
+            this->data_[i][j][k][d] = static_cast<T>(values[k]);
+    }
 };
 
 //! InMemoryCube of depth 1 with single precision floating point numbers.
@@ -107,6 +107,9 @@ public:
     virtual void set(Real value, const std::string& id, const QuantLib::Date& date, Size sample, Size depth = 0) {
         set(value, index(id), index(date), sample, depth);
     }
+    /*! Set the values of all samples for the given id, date and depth, \p values must have one entry per sample. The
+        default implementation calls set() for each sample, derived classes can provide a faster bulk write. */
+    virtual void setSamples(const std::vector<Real>& values, Size id, Size date, Size depth = 0);
 
     /*! remove all values for a given id, i.e. change the state as if setT0() and set() has never been called for the id
         the default implementation has generelly to be overriden in derived classes depending on how values are stored */
@@ -145,6 +148,13 @@ inline void NPVCube::remove(Size id) {
     }
 }
 
+inline void NPVCube::setSamples(const std::vector<Real>& values, Size id, Size date, Size depth) {
+    QL_REQUIRE(values.size() == samples(),
+               "NPVCube::setSamples(): got " << values.size() << " values, expected " << samples());
+    for (Size sample = 0; sample < values.size(); ++sample)
+        set(values[sample], id, date, sample, depth);
+}
+
 inline void NPVCube::remove(Size id, Size sample) {
     for (Size date = 0; date < this->numDates(); ++date) {
         for (Size depth = 0; depth < this->depth(); ++depth) {
@@ -0,0 +1,118 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/cube/pnlaggregationcube.hpp>
+
+#include <ql/errors.hpp>
+
+namespace ore {
+namespace analytics {
+
+PnlAggregationCube::PnlAggregationCube(const Date& asof, const std::set<std::string>& ids,
+                                       const std::vector<Date>& dates, Size samples,
+                                       const std::map<std::string, std::set<std::string>>& groups)
+    : asof_(asof), dates_(dates), samples_(samples) {
+    QL_REQUIRE(ids.size() > 0, "PnlAggregationCube: no ids specified");
+    QL_REQUIRE(dates.size() > 0, "PnlAggregationCube: no dates specified");
+    QL_REQUIRE(samples > 0, "PnlAggregationCube: samples must be > 0");
+    Size pos = 0;
+    for (const auto& id : ids)
+        ids_[id] = pos++;
+    idGroups_.resize(ids_.size());
+    idT0_.resize(ids_.size(), 0.0);
+    pos = 0;
+    for (const auto& [name, groupIds] : groups) {
+        groups_[name] = pos;
+        for (const auto& id : groupIds) {
+            auto i = ids_.find(id);
+            if (i != ids_.end())
+                idGroups_[i->second].push_back(pos);
+        }
+        ++pos;
+    }
+    groupT0_.resize(groups_.size(), 0.0);
+    groupValues_.resize(groups_.size(), std::vector<Real>(dates_.size() * samples_, 0.0));
+}
+
+Real PnlAggregationCube::getT0(Size id, Size depth) const {
+    QL_REQUIRE(id < idT0_.size(), "PnlAggregationCube::getT0(): id (" << id << ") out of range");
+    QL_REQUIRE(depth == 0, "PnlAggregationCube::getT0(): depth (" << depth << ") must be zero");
+    return idT0_[id];
+}
+
+void PnlAggregationCube::setT0(Real value, Size id, Size depth) {
+    QL_REQUIRE(id < idT0_.size(), "PnlAggregationCube::setT0(): id (" << id << ") out of range");
+    QL_REQUIRE(depth == 0, "PnlAggregationCube::setT0(): depth (" << depth << ") must be zero");
+    for (auto g : idGroups_[id])
+        groupT0_[g] += value - idT0_[id];
+    idT0_[id] = value;
+}
+
+Real PnlAggregationCube::get(Size, Size, Size, Size) const {
+    QL_FAIL("PnlAggregationCube::get(): id level values are not stored, use pnl()");
+}
+
+void PnlAggregationCube::set(Real value, Size id, Size date, Size sample, Size depth) {
+    QL_REQUIRE(id < idGroups_.size(), "PnlAggregationCube::set(): id (" << id << ") out of range");
+    QL_REQUIRE(date < dates_.size(), "PnlAggregationCube::set(): date (" << date << ") out of range");
+    QL_REQUIRE(sample < samples_, "PnlAggregationCube::set(): sample (" << sample << ") out of range");
+    QL_REQUIRE(depth == 0, "PnlAggregationCube::set(): depth (" << depth << ") must be zero");
+    Size pos = date * samples_ + sample;
+    for (auto g : idGroups_[id])
+        groupValues_[g][pos] += value;
+}
+
+void PnlAggregationCube::remove(Size id) {
+    QL_REQUIRE(id < idGroups_.size(), "PnlAggregationCube::remove(): id (" << id << ") out of range");
+    for (const auto& [name, pos] : ids_) {
+        if (pos == id) {
+            removedIds_.insert(name);
+            break;
+        }
+    }
+}
+
+void PnlAggregationCube::remove(Size id, Size) { remove(id); }
+
+std::set<std::string> PnlAggregationCube::groups() const {
+    std::set<std::string> res;
+    for (const auto& g : groups_)
+        res.insert(g.first);
+    return res;
+}
+
+Size PnlAggregationCube::group(const std::string& group) const {
+    auto g = groups_.find(group);
+    QL_REQUIRE(g != groups_.end(), "PnlAggregationCube: group '" << group << "' not found");
+    return g->second;
+}
+
+std::vector<Real> PnlAggregationCube::pnl(const std::string& group, Size date) const {
+    QL_REQUIRE(date < dates_.size(), "PnlAggregationCube::pnl(): date (" << date << ") out of range");
+    Size g = this->group(group);
+    std::vector<Real> res(groupValues_[g].begin() + date * samples_,
+                          groupValues_[g].begin() + (date + 1) * samples_);
+    for (auto& v : res)
+        v -= groupT0_[g];
+    return res;
+}
+
+Real PnlAggregationCube::t0(const std::string& group) const { return groupT0_[this->group(group)]; }
+
+} // namespace analytics
+} // namespace ore
@@ -0,0 +1,95 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/cube/pnlaggregationcube.hpp
+    \brief cube accumulating P&L per group of ids instead of storing id level values
+    \ingroup cube
+*/
+
+#pragma once
+
+#include <orea/cube/npvcube.hpp>
+
+#include <map>
+#include <set>
+
+namespace ore {
+namespace analytics {
+
+using QuantLib::Date;
+using QuantLib::Real;
+using QuantLib::Size;
+
+//! Cube accumulating P&L per group of ids
+/*! The values passed to set() are added to the running totals of all groups containing the id, so that the memory
+    used by the cube is groups x dates x samples instead of ids x dates x samples. The T0 values are stored per id, the
+    P&L of a group is the total value minus the total T0 value over the ids in the group. Each id, date, sample cell
+    must be set at most once, only depth 0 is supported.
+
+    Id level values can not be retrieved, get() throws. A call to remove() can not back out the values already added
+    for the id, the id is recorded instead, see removedIds(). Ids not contained in any group are ignored.
+*/
+class PnlAggregationCube : public NPVCube {
+public:
+    PnlAggregationCube(const Date& asof, const std::set<std::string>& ids, const std::vector<Date>& dates,
+                       Size samples, const std::map<std::string, std::set<std::string>>& groups);
+
+    Size numIds() const override { return ids_.size(); }
+    Size numDates() const override { return dates_.size(); }
+    Size samples() const override { return samples_; }
+    Size depth() const override { return 1; }
+    const std::map<std::string, Size>& idsAndIndexes() const override { return ids_; }
+    const std::vector<Date>& dates() const override { return dates_; }
+    Date asof() const override { return asof_; }
+
+    Real getT0(Size id, Size depth = 0) const override;
+    void setT0(Real value, Size id, Size depth = 0) override;
+    Real get(Size id, Size date, Size sample, Size depth = 0) const override;
+    void set(Real value, Size id, Size date, Size sample, Size depth = 0) override;
+
+    void remove(Size id) override;
+    void remove(Size id, Size sample) override;
+
+    //! The group names
+    std::set<std::string> groups() const;
+    //! The P&L of a group on a date, one entry per sample
+    std::vector<Real> pnl(const std::string& group, Size date = 0) const;
+    //! The total T0 value of a group
+    Real t0(const std::string& group) const;
+    //! Ids for which remove() was called, their values are still included in the group totals
+    const std::set<std::string>& removedIds() const { return removedIds_; }
+
+private:
+    Size group(const std::string& group) const;
+
+    Date asof_;
+    std::map<std::string, Size> ids_;
+    std::vector<Date> dates_;
+    Size samples_;
+    std::map<std::string, Size> groups_;
+    // groups for each id
+    std::vector<std::vector<Size>> idGroups_;
+    std::vector<Real> idT0_;
+    std::vector<Real> groupT0_;
+    // group totals, indexed by group and then date * samples + sample
+    std::vector<std::vector<Real>> groupValues_;
+    std::set<std::string> removedIds_;
+};
+
+} // namespace analytics
+} // namespace ore
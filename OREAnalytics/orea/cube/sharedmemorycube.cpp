@@ -0,0 +1,57 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/cube/sharedmemorycube.hpp>
+
+#if defined(_WIN32) || defined(_WIN64)
+#include <cstdlib>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace ore {
+namespace analytics {
+
+SharedMemoryBlock::SharedMemoryBlock(std::size_t bytes) : size_(std::max<std::size_t>(bytes, 1)) {
+#if defined(_WIN32) || defined(_WIN64)
+    data_ = std::malloc(size_);
+    QL_REQUIRE(data_ != nullptr, "SharedMemoryBlock: could not allocate " << size_ << " bytes");
+#else
+    data_ = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    QL_REQUIRE(data_ != MAP_FAILED, "SharedMemoryBlock: could not map " << size_ << " bytes of shared memory");
+#endif
+}
+
+SharedMemoryBlock::~SharedMemoryBlock() {
+#if defined(_WIN32) || defined(_WIN64)
+    std::free(data_);
+#else
+    munmap(data_, size_);
+#endif
+}
+
+bool SharedMemoryBlock::shared() {
+#if defined(_WIN32) || defined(_WIN64)
+    return false;
+#else
+    return true;
+#endif
+}
+
+} // namespace analytics
+} // namespace ore
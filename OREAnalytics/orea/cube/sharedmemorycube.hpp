@@ -0,0 +1,154 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/cube/sharedmemorycube.hpp
+    \brief A cube implementation that stores the cube in memory shared with forked processes
+    \ingroup cube
+*/
+
+#pragma once
+
+#include <orea/cube/npvcube.hpp>
+
+#include <ql/errors.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+
+namespace ore {
+namespace analytics {
+using QuantLib::Date;
+using QuantLib::Real;
+using QuantLib::Size;
+
+//! Block of memory that is shared with child processes created by fork() after its construction
+/*! On POSIX systems the block is an anonymous shared memory mapping, writes of a child process are visible to the
+    parent process and vice versa. On other systems the block is ordinary heap memory, which is not shared.
+
+    \ingroup cube
+ */
+class SharedMemoryBlock {
+public:
+    explicit SharedMemoryBlock(std::size_t bytes);
+    ~SharedMemoryBlock();
+    SharedMemoryBlock(const SharedMemoryBlock&) = delete;
+    SharedMemoryBlock& operator=(const SharedMemoryBlock&) = delete;
+
+    void* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+    //! Is the block shared with child processes on this system?
+    static bool shared();
+
+private:
+    void* data_;
+    std::size_t size_;
+};
+
+//! SharedMemoryCube stores the cube in a SharedMemoryBlock
+/*! The T0 values and the future values are stored in one contiguous block, so that worker processes forked after
+    the construction of the cube can write their results directly into the cube of the parent process. This class is
+    a template to allow both single and double precision implementations.
+
+    \ingroup cube
+ */
+template <typename T> class SharedMemoryCube : public NPVCube {
+public:
+    SharedMemoryCube(const Date& asof, const std::set<std::string>& ids, const std::vector<Date>& dates, Size samples,
+                     Size depth = 1, const T& t = T())
+        : asof_(asof), dates_(dates), samples_(samples), depth_(depth) {
+        QL_REQUIRE(ids.size() > 0, "SharedMemoryCube: no ids specified");
+        QL_REQUIRE(dates.size() > 0, "SharedMemoryCube: no dates specified");
+        QL_REQUIRE(samples > 0, "SharedMemoryCube: samples must be > 0");
+        QL_REQUIRE(depth > 0, "SharedMemoryCube: depth must be > 0");
+        Size pos = 0;
+        for (const auto& id : ids)
+            idIdx_[id] = pos++;
+        Size n = ids.size() * depth_ * (1 + dates_.size() * samples_);
+        block_ = std::make_unique<SharedMemoryBlock>(n * sizeof(T));
+        data_ = static_cast<T*>(block_->data());
+        std::fill(data_, data_ + n, t);
+    }
+
+    Size numIds() const override { return idIdx_.size(); }
+    Size numDates() const override { return dates_.size(); }
+    Size samples() const override { return samples_; }
+    Size depth() const override { return depth_; }
+    const std::map<std::string, Size>& idsAndIndexes() const override { return idIdx_; }
+    const std::vector<QuantLib::Date>& dates() const override { return dates_; }
+    QuantLib::Date asof() const override { return asof_; }
+
+    Real getT0(Size i, Size d) const override {
+        check(i, 0, 0, d);
+        return data_[i * depth_ + d];
+    }
+
+    void setT0(Real value, Size i, Size d) override {
+        check(i, 0, 0, d);
+        data_[i * depth_ + d] = static_cast<T>(value);
+    }
+
+    Real get(Size i, Size j, Size k, Size d) const override {
+        check(i, j, k, d);
+        return data_[index(i, j, k, d)];
+    }
+
+    void set(Real value, Size i, Size j, Size k, Size d) override {
+        check(i, j, k, d);
+        data_[index(i, j, k, d)] = static_cast<T>(value);
+    }
+
+    void setSamples(const std::vector<Real>& values, Size i, Size j, Size d) override {
+        check(i, j, 0, d);
+        QL_REQUIRE(values.size() == samples_,
+                   "SharedMemoryCube::setSamples(): got " << values.size() << " values, expected " << samples_);
+        T* p = data_ + index(i, j, 0, d);
+        for (Size k = 0; k < values.size(); ++k, p += depth_)
+            *p = static_cast<T>(values[k]);
+    }
+
+private:
+    void check(Size i, Size j, Size k, Size d) const {
+        QL_REQUIRE(i < numIds(), "Out of bounds on ids (i=" << i << ", numIds=" << numIds() << ")");
+        QL_REQUIRE(j < numDates(), "Out of bounds on dates (j=" << j << ", numDates=" << numDates() << ")");
+        QL_REQUIRE(k < samples(), "Out of bounds on samples (k=" << k << ", samples=" << samples() << ")");
+        QL_REQUIRE(d < depth(), "Out of bounds on depth (d=" << d << ", depth=" << depth() << ")");
+    }
+
+    // the T0 values come first, then the future values by id, date, sample, depth
+    Size index(Size i, Size j, Size k, Size d) const {
+        return idIdx_.size() * depth_ + ((i * dates_.size() + j) * samples_ + k) * depth_ + d;
+    }
+
+    QuantLib::Date asof_;
+    std::vector<QuantLib::Date> dates_;
+    Size samples_, depth_;
+    std::map<std::string, Size> idIdx_;
+    std::unique_ptr<SharedMemoryBlock> block_;
+    T* data_;
+};
+
+//! SharedMemoryCube with single precision floating point numbers.
+using SinglePrecisionSharedMemoryCube = SharedMemoryCube<float>;
+
+//! SharedMemoryCube with double precision floating point numbers.
+using DoublePrecisionSharedMemoryCube = SharedMemoryCube<double>;
+
+} // namespace analytics
+} // namespace ore
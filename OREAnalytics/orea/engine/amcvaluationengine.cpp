@@ -30,6 +30,7 @@
 
 #include <qle/indexes/fallbackiborindex.hpp>
 #include <qle/instruments/payment.hpp>
+#include <qle/methods/batchedmultipathgenerator.hpp>
 #include <qle/methods/multipathgeneratorbase.hpp>
 #include <qle/methods/multipathvariategenerator.hpp>
 #include <qle/pricingengines/mcmultilegbaseengine.hpp>
@@ -41,7 +42,9 @@
 
 #include <boost/timer/timer.hpp>
 
+#include <atomic>
 #include <future>
+#include <mutex>
 
 using namespace ore::data;
 using namespace ore::analytics;
@@ -89,7 +92,7 @@ Real discount(const boost::shared_ptr<CrossAssetModel>& model,
 
 std::vector<QuantExt::RandomVariable>
 simulatePathInterface2(const boost::shared_ptr<AmcCalculator>& amcCalc, const std::vector<Real>& pathTimes,
-                       std::vector<std::vector<RandomVariable>>& paths, const std::vector<bool>& isRelevantTime,
+                       const std::vector<std::vector<RandomVariable>>& paths, const std::vector<bool>& isRelevantTime,
                        const bool moveStateToPreviousTime, const std::string& tradeLabel,
                        const std::string& tradeType) {
     try {
@@ -103,8 +106,8 @@ simulatePathInterface2(const boost::shared_ptr<AmcCalculator>& amcCalc, const st
 }
 
 std::vector<QuantExt::RandomVariable>
-feeContributions(const Size j, const boost::shared_ptr<ScenarioGeneratorData>& sgd, const Date& asof,
-                 const Size samples, const std::vector<std::vector<std::tuple<Size, Real, QuantLib::Date>>>& tradeFees,
+feeContributions(const std::vector<std::tuple<Size, Real, QuantLib::Date>>& fees,
+                 const boost::shared_ptr<ScenarioGeneratorData>& sgd, const Date& asof, const Size samples,
                  const boost::shared_ptr<CrossAssetModel>& model,
                  const std::vector<std::vector<std::vector<Real>>>& fxBuffer,
                  const std::vector<std::vector<std::vector<Real>>>& irStateBuffer) {
@@ -116,16 +119,16 @@ feeContributions(const Size j, const boost::shared_ptr<ScenarioGeneratorData>& s
         if (k == 0 || !sgd->withCloseOutLag() || !sgd->withMporStickyDate() ||
             sgd->getGrid()->isValuationDate()[k - 1]) {
             result.push_back(RandomVariable(samples, 0.0));
-            if (tradeFees[j].empty())
+            if (fees.empty())
                 continue;
             for (Size i = 0; i < samples; ++i) {
                 Real tmp = 0.0;
-                for (Size f = 0; f < tradeFees[j].size(); ++f) {
-                    if (std::get<2>(tradeFees[j][f]) > simDate) {
+                for (Size f = 0; f < fees.size(); ++f) {
+                    if (std::get<2>(fees[f]) > simDate) {
                         Real t = sgd->getGrid()->timeGrid()[k];
-                        Real T = model->irModel(0)->termStructure()->timeFromReference(std::get<2>(tradeFees[j][f]));
-                        tmp += std::get<1>(tradeFees[j][f]) * fx(fxBuffer, std::get<0>(tradeFees[j][f]), k, i) *
-                               discount(model, irStateBuffer, std::get<0>(tradeFees[j][f]), k, t, T, i) *
+                        Real T = model->irModel(0)->termStructure()->timeFromReference(std::get<2>(fees[f]));
+                        tmp += std::get<1>(fees[f]) * fx(fxBuffer, std::get<0>(fees[f]), k, i) *
+                               discount(model, irStateBuffer, std::get<0>(fees[f]), k, t, T, i) *
                                num(model, irStateBuffer, 0, k, t, i);
                     }
                 }
@@ -136,100 +139,201 @@ feeContributions(const Size j, const boost::shared_ptr<ScenarioGeneratorData>& s
     return result;
 }
 
-void runCoreEngine(const boost::shared_ptr<ore::data::Portfolio>& portfolio,
-                   const boost::shared_ptr<QuantExt::CrossAssetModel>& model,
-                   const boost::shared_ptr<ore::data::Market>& market,
-                   const boost::shared_ptr<ore::analytics::ScenarioGeneratorData>& sgd,
-                   const std::vector<string>& aggDataIndices, const std::vector<string>& aggDataCurrencies,
-                   const Size aggDataNumberCreditStates, boost::shared_ptr<ore::analytics::AggregationScenarioData> asd,
-                   boost::shared_ptr<NPVCube> outputCube, boost::shared_ptr<ProgressIndicator> progressIndicator) {
+// the simulated paths and the buffers derived from them, these are shared read-only between the valuation threads
+
+struct AmcPathData {
+    // path times, i.e. the time grid without the T0 time
+    std::vector<Real> pathTimes;
+    // paths[j][k] holds state k at pathTimes[j] for all samples
+    std::vector<std::vector<RandomVariable>> paths;
+    // model state at T0
+    Array initialValues;
+    // fx rates and ir states on the full grid (i.e. valuation + close-out dates, also including the T0 date)
+    std::vector<std::vector<std::vector<Real>>> fxBuffer, irStateBuffer;
+    // indicators for valuation times, close-out times and all times on the path times
+    std::vector<bool> allTimes, valuationTimes, closeOutTimes;
+
+    Real pathValue(const Size state, const Size timeIndex, const Size sample) const {
+        return timeIndex == 0 ? initialValues[state] : paths[timeIndex - 1][state][sample];
+    }
+};
 
-    progressIndicator->updateProgress(0, portfolio->size() + 1);
+boost::shared_ptr<AmcPathData> generatePaths(const boost::shared_ptr<QuantExt::CrossAssetModel>& model,
+                                             const boost::shared_ptr<ore::analytics::ScenarioGeneratorData>& sgd,
+                                             const Size samples) {
 
-    // base currency is the base currency of the cam
+    boost::timer::cpu_timer timer;
+    auto result = boost::make_shared<AmcPathData>();
 
-    Currency baseCurrency = model->irlgm1f(0)->currency();
+    auto process = model->stateProcess();
+    QL_REQUIRE(sgd->getGrid()->timeGrid().size() > 0, "AMCValuationEngine: empty time grid given");
+    result->pathTimes.assign(std::next(sgd->getGrid()->timeGrid().begin(), 1), sgd->getGrid()->timeGrid().end());
+    result->initialValues = process->initialValues();
 
-    // timings
+    // generate the paths for all samples in one batch
 
-    boost::timer::cpu_timer timer, timerTotal;
-    Real calibrationTime = 0.0, valuationTime = 0.0, asdTime = 0.0, bufferTime = 0.0, pathGenTime = 0.0, residualTime,
-         totalTime;
-    timerTotal.start();
+    LOG("Generate paths...");
+    BatchedMultiPathGenerator pathGenerator(sgd->sequenceType(), process, sgd->getGrid()->timeGrid(), sgd->seed(),
+                                            sgd->ordering(), sgd->directionIntegers());
+    pathGenerator.nextBatch(samples, result->paths);
+    timer.stop();
+    LOG("path generation time : " << timer.elapsed().wall * 1e-9 << " sec");
+
+    // fill fx buffer and ir state buffer
+
+    timer.start();
+    Size nTimes = sgd->getGrid()->dates().size() + 1;
+    result->fxBuffer.assign(model->components(CrossAssetModel::AssetType::FX),
+                            std::vector<std::vector<Real>>(nTimes, std::vector<Real>(samples)));
+    result->irStateBuffer.assign(model->components(CrossAssetModel::AssetType::IR),
+                                 std::vector<std::vector<Real>>(nTimes, std::vector<Real>(samples)));
+    for (Size k = 0; k < result->fxBuffer.size(); ++k) {
+        Size state = model->pIdx(CrossAssetModel::AssetType::FX, k);
+        for (Size j = 0; j < sgd->getGrid()->timeGrid().size(); ++j) {
+            for (Size i = 0; i < samples; ++i)
+                result->fxBuffer[k][j][i] = std::exp(result->pathValue(state, j, i));
+        }
+    }
+    for (Size k = 0; k < result->irStateBuffer.size(); ++k) {
+        Size state = model->pIdx(CrossAssetModel::AssetType::IR, k);
+        for (Size j = 0; j < sgd->getGrid()->timeGrid().size(); ++j) {
+            for (Size i = 0; i < samples; ++i)
+                result->irStateBuffer[k][j][i] = result->pathValue(state, j, i);
+        }
+    }
+
+    result->allTimes.assign(result->pathTimes.size(), true);
+    result->valuationTimes.resize(result->pathTimes.size());
+    result->closeOutTimes.resize(result->pathTimes.size());
+    for (Size i = 0; i < result->pathTimes.size(); ++i) {
+        result->valuationTimes[i] = sgd->getGrid()->isValuationDate()[i];
+        result->closeOutTimes[i] = sgd->getGrid()->isCloseOutDate()[i];
+    }
+    timer.stop();
+    LOG("buffer time          : " << timer.elapsed().wall * 1e-9 << " sec");
+
+    return result;
+}
+
+void writeAggregationScenarioData(const boost::shared_ptr<QuantExt::CrossAssetModel>& model,
+                                  const boost::shared_ptr<ore::data::Market>& market,
+                                  const boost::shared_ptr<ore::analytics::ScenarioGeneratorData>& sgd,
+                                  const std::vector<string>& aggDataIndices,
+                                  const std::vector<string>& aggDataCurrencies, const Size aggDataNumberCreditStates,
+                                  const boost::shared_ptr<ore::analytics::AggregationScenarioData>& asd,
+                                  const AmcPathData& pathData, const Size samples) {
+
+    boost::timer::cpu_timer timer;
+
+    // base currency is the base currency of the cam
+
+    Currency baseCurrency = model->irlgm1f(0)->currency();
 
     // prepare for asd writing
 
+    LOG("Collect information for aggregation scenario data...");
     std::vector<Size> asdCurrencyIndex; // FX Spots
     std::vector<string> asdCurrencyCode;
     std::vector<boost::shared_ptr<LgmImpliedYtsFwdFwdCorrected>> asdIndexCurve; // Ibor Indices
     std::vector<boost::shared_ptr<Index>> asdIndex;
     std::vector<Size> asdIndexIndex;
     std::vector<string> asdIndexName;
-    if (asd != nullptr) {
-        LOG("Collect information for aggregation scenario data...");
-        // fx spots
-        for (auto const& c : aggDataCurrencies) {
-            Currency cur = parseCurrency(c);
-            if (cur == baseCurrency)
-                continue;
-            Size ccyIndex = model->ccyIndex(cur);
-            asdCurrencyIndex.push_back(ccyIndex);
-            asdCurrencyCode.push_back(c);
+    // fx spots
+    for (auto const& c : aggDataCurrencies) {
+        Currency cur = parseCurrency(c);
+        if (cur == baseCurrency)
+            continue;
+        Size ccyIndex = model->ccyIndex(cur);
+        asdCurrencyIndex.push_back(ccyIndex);
+        asdCurrencyCode.push_back(c);
+    }
+    // ibor indices
+    for (auto const& i : aggDataIndices) {
+        boost::shared_ptr<IborIndex> tmp;
+        try {
+            tmp = *market->iborIndex(i);
+        } catch (const std::exception& e) {
+            ALOG("index \"" << i << "\" not found in market, skipping. (" << e.what() << ")");
         }
-        // ibor indices
-        for (auto const& i : aggDataIndices) {
-            boost::shared_ptr<IborIndex> tmp;
-            try {
-                tmp = *market->iborIndex(i);
-            } catch (const std::exception& e) {
-                ALOG("index \"" << i << "\" not found in market, skipping. (" << e.what() << ")");
+        Size ccyIndex = model->ccyIndex(tmp->currency());
+        asdIndexCurve.push_back(
+            boost::make_shared<LgmImpliedYtsFwdFwdCorrected>(model->lgm(ccyIndex), tmp->forwardingTermStructure()));
+        asdIndex.push_back(tmp->clone(Handle<YieldTermStructure>(asdIndexCurve.back())));
+        asdIndexIndex.push_back(ccyIndex);
+        asdIndexName.push_back(i);
+    }
+
+    // write aggregation scenario data, TODO this seems relatively slow, can we speed it up using LgmVectorised
+
+    LOG("Write ASD...");
+    for (Size i = 0; i < samples; ++i) {
+        Size dateIndex = 0;
+        for (Size k = 1; k < sgd->getGrid()->timeGrid().size(); ++k) {
+            // only write asd on valuation dates
+            if (!sgd->getGrid()->isValuationDate()[k - 1])
+                continue;
+            // set numeraire
+            asd->set(dateIndex, i,
+                     model->numeraire(0, sgd->getGrid()->timeGrid()[k],
+                                      pathData.pathValue(model->pIdx(CrossAssetModel::AssetType::IR, 0), k, i)),
+                     AggregationScenarioDataType::Numeraire);
+            // set fx spots
+            for (Size j = 0; j < asdCurrencyIndex.size(); ++j) {
+                asd->set(dateIndex, i, fx(pathData.fxBuffer, asdCurrencyIndex[j], k, i),
+                         AggregationScenarioDataType::FXSpot, asdCurrencyCode[j]);
+            }
+            // set index fixings
+            Date d = sgd->getGrid()->dates()[k - 1];
+            for (Size j = 0; j < asdIndex.size(); ++j) {
+                asdIndexCurve[j]->move(d, state(pathData.irStateBuffer, asdIndexIndex[j], k, i));
+                auto index = asdIndex[j];
+                if (auto fb = boost::dynamic_pointer_cast<FallbackIborIndex>(asdIndex[j])) {
+                    // proxy fallback ibor index by its rfr index's fixing
+                    index = fb->rfrIndex();
+                }
+                asd->set(dateIndex, i, index->fixing(index->fixingCalendar().adjust(d)),
+                         AggregationScenarioDataType::IndexFixing, asdIndexName[j]);
+            }
+            // set credit states
+            for (Size j = 0; j < aggDataNumberCreditStates; ++j) {
+                asd->set(dateIndex, i,
+                         pathData.pathValue(model->pIdx(CrossAssetModel::AssetType::CrState, j), k, i),
+                         AggregationScenarioDataType::CreditState, std::to_string(j));
             }
-            Size ccyIndex = model->ccyIndex(tmp->currency());
-            asdIndexCurve.push_back(
-                boost::make_shared<LgmImpliedYtsFwdFwdCorrected>(model->lgm(ccyIndex), tmp->forwardingTermStructure()));
-            asdIndex.push_back(tmp->clone(Handle<YieldTermStructure>(asdIndexCurve.back())));
-            asdIndexIndex.push_back(ccyIndex);
-            asdIndexName.push_back(i);
+            ++dateIndex;
         }
-    } else {
-        LOG("No asd object set, won't write aggregation scenario data...");
     }
+    timer.stop();
+    LOG("asd time             : " << timer.elapsed().wall * 1e-9 << " sec");
+}
 
-    // extract AMC calculators, fees and some other infos we need from the ore wrapper
+// the amc calculators of a trade, composite trades have one calculator per component
 
-    LOG("Extract AMC Calculators...");
-    std::vector<boost::shared_ptr<AmcCalculator>> amcCalculators;
-    std::vector<Size> tradeId;
-    std::vector<std::string> tradeLabel, tradeType;
+struct AmcTradeCalculators {
+    std::vector<boost::shared_ptr<AmcCalculator>> calculators;
     std::vector<Real> effectiveMultiplier;
     std::vector<Size> currencyIndex;
-    std::vector<std::vector<std::tuple<Size, Real, QuantLib::Date>>> tradeFees;
-    timer.start();
-    Size progressCounter = 0;
+    std::vector<std::vector<std::tuple<Size, Real, QuantLib::Date>>> fees;
+};
+
+AmcTradeCalculators extractAmcCalculators(const std::pair<std::string, boost::shared_ptr<Trade>>& trade,
+                                          const boost::shared_ptr<QuantExt::CrossAssetModel>& model) {
+
+    AmcTradeCalculators result;
 
-    auto extractAmcCalculator = [&amcCalculators, &tradeId, &tradeLabel, &tradeType, &effectiveMultiplier,
-                                 &currencyIndex, &tradeFees, &model,
-                                 &outputCube](const std::pair<std::string, boost::shared_ptr<Trade>>& trade,
-                                              boost::shared_ptr<AmcCalculator> amcCalc, Real multiplier, bool addFees) {
+    auto addAmcCalculator = [&result, &trade, &model](boost::shared_ptr<AmcCalculator> amcCalc, Real multiplier,
+                                                     bool addFees) {
         LOG("AMCCalculator extracted for \"" << trade.first << "\"");
-        amcCalculators.push_back(amcCalc);
-        effectiveMultiplier.push_back(multiplier);
-        currencyIndex.push_back(model->ccyIndex(amcCalc->npvCurrency()));
-        if (auto id = outputCube->idsAndIndexes().find(trade.first); id != outputCube->idsAndIndexes().end()) {
-            tradeId.push_back(id->second);
-        } else {
-            QL_FAIL("AMCValuationEngine: trade id '" << trade.first
-                                                    << "' is not present in output cube - internal error.");
-        }
-        tradeLabel.push_back(trade.first);
-        tradeType.push_back(trade.second->tradeType());
-        tradeFees.push_back({});
+        result.calculators.push_back(amcCalc);
+        result.effectiveMultiplier.push_back(multiplier);
+        result.currencyIndex.push_back(model->ccyIndex(amcCalc->npvCurrency()));
+        result.fees.push_back({});
         if (addFees) {
             for (Size i = 0; i < trade.second->instrument()->additionalInstruments().size(); ++i) {
                 if (auto p = boost::dynamic_pointer_cast<QuantExt::Payment>(
                         trade.second->instrument()->additionalInstruments()[i])) {
-                    tradeFees.back().push_back(std::make_tuple(model->ccyIndex(p->currency()), p->cashFlow()->amount(),
-                                                               p->cashFlow()->date()));
+                    result.fees.back().push_back(std::make_tuple(model->ccyIndex(p->currency()),
+                                                                 p->cashFlow()->amount(), p->cashFlow()->date()));
                 } else {
                     ALOG(StructuredTradeErrorMessage(trade.second, "Additional instrument is ignored in AMC simulation",
                                                      "only QuantExt::Payment is handled as additional instrument."));
@@ -238,284 +342,228 @@ void runCoreEngine(const boost::shared_ptr<ore::data::Portfolio>& portfolio,
         }
     };
 
-    for (auto const& trade : portfolio->trades()) {
-        boost::shared_ptr<AmcCalculator> amcCalc;
-        try {
-            auto inst = trade.second->instrument()->qlInstrument(true);
-            Real multiplier = trade.second->instrument()->multiplier() *
-                trade.second->instrument()->multiplier2();
-
-            // handle composite trades
-            if (auto cInst = boost::dynamic_pointer_cast<CompositeInstrument>(inst)) {
-                auto addResults = cInst->additionalResults();
-                std::vector<Real> multipliers;
-                while (true) {
-                    std::stringstream ss;
-                    ss << multipliers.size() + 1 << "_multiplier";
-                    if (addResults.find(ss.str()) == addResults.end())
-                        break;
-                    multipliers.push_back(inst->result<Real>(ss.str()));
-                }
-                std::vector<boost::shared_ptr<AmcCalculator>> amcCalcs;
-                for (Size cmpIdx = 0; cmpIdx < multipliers.size(); ++cmpIdx) {
-                    std::stringstream ss;
-                    ss << cmpIdx + 1 << "_amcCalculator";
-                    if (addResults.find(ss.str()) != addResults.end()) {
-                        amcCalcs.push_back(inst->result<boost::shared_ptr<AmcCalculator>>(ss.str()));
-                    }
-                }
-                QL_REQUIRE(amcCalcs.size() == multipliers.size(),
-                           "Did not find amc calculators for all components of composite trade.");
-                for (Size cmpIdx = 0; cmpIdx < multipliers.size(); ++cmpIdx) {
-                    extractAmcCalculator(trade, amcCalc, multiplier * multipliers[cmpIdx], cmpIdx == 0);
-                }
-                continue;
-            }
-
-            // handle non-composite trades
-            amcCalc = inst->result<boost::shared_ptr<AmcCalculator>>("amcCalculator");
-            extractAmcCalculator(trade, amcCalc, multiplier, true);
-
-        } catch (const std::exception& e) {
-            ALOG(StructuredTradeErrorMessage(trade.second, "Error building trade for AMC simulation", e.what()));
+    auto inst = trade.second->instrument()->qlInstrument(true);
+    Real multiplier = trade.second->instrument()->multiplier() * trade.second->instrument()->multiplier2();
+
+    // handle composite trades
+    if (auto cInst = boost::dynamic_pointer_cast<CompositeInstrument>(inst)) {
+        auto addResults = cInst->additionalResults();
+        std::vector<Real> multipliers;
+        while (true) {
+            std::stringstream ss;
+            ss << multipliers.size() + 1 << "_multiplier";
+            if (addResults.find(ss.str()) == addResults.end())
+                break;
+            multipliers.push_back(inst->result<Real>(ss.str()));
         }
-        progressIndicator->updateProgress(++progressCounter, portfolio->size() + 1);
-    }
-
-    timer.stop();
-    calibrationTime += timer.elapsed().wall * 1e-9;
-    LOG("Extracted " << amcCalculators.size() << " AMCCalculators for " << portfolio->size() << " source trades");
-
-    // set up buffers for fx rates and ir states that we need below for the runs against interface 1 and 2
-    // we set these buffers up on the full grid (i.e. valuation + close-out dates, also including the T0 date)
-
-    std::vector<std::vector<std::vector<Real>>> fxBuffer(
-        model->components(CrossAssetModel::AssetType::FX),
-        std::vector<std::vector<Real>>(sgd->getGrid()->dates().size() + 1, std::vector<Real>(outputCube->samples())));
-    std::vector<std::vector<std::vector<Real>>> irStateBuffer(
-        model->components(CrossAssetModel::AssetType::IR),
-        std::vector<std::vector<Real>>(sgd->getGrid()->dates().size() + 1, std::vector<Real>(outputCube->samples())));
-
-    // set up cache for paths
-
-    auto process = model->stateProcess();
-    Size nStates = process->size();
-    QL_REQUIRE(sgd->getGrid()->timeGrid().size() > 0, "AMCValuationEngine: empty time grid given");
-    std::vector<Real> pathTimes(std::next(sgd->getGrid()->timeGrid().begin(), 1), sgd->getGrid()->timeGrid().end());
-    std::vector<std::vector<RandomVariable>> paths(
-        pathTimes.size(), std::vector<RandomVariable>(nStates, RandomVariable(outputCube->samples())));
-
-    // fill fx buffer, ir state buffer and write ASD
-
-    auto pathGenerator = makeMultiPathGenerator(sgd->sequenceType(), process, sgd->getGrid()->timeGrid(), sgd->seed(),
-                                                sgd->ordering(), sgd->directionIntegers());
-
-    LOG("Write ASD, fill internal fx and irState buffers...");
-
-    for (Size i = 0; i < outputCube->samples(); ++i) {
-        timer.start();
-        const auto& path = pathGenerator->next().value;
-        timer.stop();
-        pathGenTime += timer.elapsed().wall * 1e-9;
-
-        // populate fx and ir state buffers, populate cached paths for interface 2
-
-        timer.start();
-        for (Size k = 0; k < fxBuffer.size(); ++k) {
-            for (Size j = 0; j < sgd->getGrid()->timeGrid().size(); ++j) {
-                fxBuffer[k][j][i] = std::exp(path[model->pIdx(CrossAssetModel::AssetType::FX, k)][j]);
+        std::vector<boost::shared_ptr<AmcCalculator>> amcCalcs;
+        for (Size cmpIdx = 0; cmpIdx < multipliers.size(); ++cmpIdx) {
+            std::stringstream ss;
+            ss << cmpIdx + 1 << "_amcCalculator";
+            if (addResults.find(ss.str()) != addResults.end()) {
+                amcCalcs.push_back(inst->result<boost::shared_ptr<AmcCalculator>>(ss.str()));
             }
         }
-        for (Size k = 0; k < irStateBuffer.size(); ++k) {
-            for (Size j = 0; j < sgd->getGrid()->timeGrid().size(); ++j) {
-                irStateBuffer[k][j][i] = path[model->pIdx(CrossAssetModel::AssetType::IR, k)][j];
-            }
-        }
-
-        for (Size k = 0; k < nStates; ++k) {
-            for (Size j = 0; j < pathTimes.size(); ++j) {
-                paths[j][k].set(i, path[k][j + 1]);
-            }
-        }
-        timer.stop();
-        bufferTime += timer.elapsed().wall * 1e-9;
-
-        // write aggregation scenario data, TODO this seems relatively slow, can we speed it up using LgmVectorised
-
-        if (asd != nullptr) {
-            timer.start();
-            Size dateIndex = 0;
-            for (Size k = 1; k < sgd->getGrid()->timeGrid().size(); ++k) {
-                // only write asd on valuation dates
-                if (!sgd->getGrid()->isValuationDate()[k - 1])
-                    continue;
-                // set numeraire
-                asd->set(dateIndex, i, model->numeraire(0, path[0].time(k), path[0][k]),
-                         AggregationScenarioDataType::Numeraire);
-                // set fx spots
-                for (Size j = 0; j < asdCurrencyIndex.size(); ++j) {
-                    asd->set(dateIndex, i, fx(fxBuffer, asdCurrencyIndex[j], k, i), AggregationScenarioDataType::FXSpot,
-                             asdCurrencyCode[j]);
-                }
-                // set index fixings
-                Date d = sgd->getGrid()->dates()[k - 1];
-                for (Size j = 0; j < asdIndex.size(); ++j) {
-                    asdIndexCurve[j]->move(d, state(irStateBuffer, asdIndexIndex[j], k, i));
-                    auto index = asdIndex[j];
-                    if (auto fb = boost::dynamic_pointer_cast<FallbackIborIndex>(asdIndex[j])) {
-                        // proxy fallback ibor index by its rfr index's fixing
-                        index = fb->rfrIndex();
-                    }
-                    asd->set(dateIndex, i, index->fixing(index->fixingCalendar().adjust(d)),
-                             AggregationScenarioDataType::IndexFixing, asdIndexName[j]);
-                }
-                // set credit states
-                for (Size j = 0; j < aggDataNumberCreditStates; ++j) {
-                    asd->set(dateIndex, i, path[model->pIdx(CrossAssetModel::AssetType::CrState, j)][k],
-                             AggregationScenarioDataType::CreditState, std::to_string(j));
-                }
-                ++dateIndex;
-            }
-            timer.stop();
-            asdTime += timer.elapsed().wall * 1e-9;
+        QL_REQUIRE(amcCalcs.size() == multipliers.size(),
+                   "Did not find amc calculators for all components of composite trade.");
+        for (Size cmpIdx = 0; cmpIdx < multipliers.size(); ++cmpIdx) {
+            addAmcCalculator(amcCalcs[cmpIdx], multiplier * multipliers[cmpIdx], cmpIdx == 0);
         }
+        return result;
     }
 
-    // Run AmcCalculators
+    // handle non-composite trades
+    addAmcCalculator(inst->result<boost::shared_ptr<AmcCalculator>>("amcCalculator"), multiplier, true);
+    return result;
+}
 
-    LOG("Run simulation...");
+// the values of a trade on the cube grid, values[d][j] holds the values of all samples for depth d and date j
 
-    // set up vectors indicating valuation times, close-out times and all times
+struct AmcTradeValues {
+    Real t0 = 0.0;
+    std::vector<std::vector<std::vector<Real>>> values;
+};
 
-    std::vector<bool> allTimes(pathTimes.size(), true);
-    std::vector<bool> valuationTimes(pathTimes.size()), closeOutTimes(pathTimes.size());
-    for (Size i = 0; i < pathTimes.size(); ++i) {
-        valuationTimes[i] = sgd->getGrid()->isValuationDate()[i];
-        closeOutTimes[i] = sgd->getGrid()->isCloseOutDate()[i];
-    }
+AmcTradeValues valueTrade(const AmcTradeCalculators& calcs, const std::string& tradeLabel,
+                          const std::string& tradeType, const boost::shared_ptr<QuantExt::CrossAssetModel>& model,
+                          const boost::shared_ptr<ore::analytics::ScenarioGeneratorData>& sgd,
+                          const AmcPathData& pathData, const Size samples, const Size numDates) {
 
-    // loop over amc calculators, get result and populate cube
+    // the paths are only read by the calculators, so the threads share them
 
-    timer.start();
-    for (Size j = 0; j < amcCalculators.size(); ++j) {
-        auto resFee = feeContributions(j, sgd, model->irModel(0)->termStructure()->referenceDate(),
-                                       outputCube->samples(), tradeFees, model, fxBuffer, irStateBuffer);
+    const auto& paths = pathData.paths;
+    const auto& pathTimes = pathData.pathTimes;
+    const auto& fxBuffer = pathData.fxBuffer;
+    const auto& irStateBuffer = pathData.irStateBuffer;
+
+    AmcTradeValues result;
+    result.values.assign(sgd->withCloseOutLag() ? 2 : 1,
+                         std::vector<std::vector<Real>>(numDates, std::vector<Real>(samples, 0.0)));
+
+    for (Size j = 0; j < calcs.calculators.size(); ++j) {
+        const Size ccy = calcs.currencyIndex[j];
+        const Real multiplier = calcs.effectiveMultiplier[j];
+        auto resFee = feeContributions(calcs.fees[j], sgd, model->irModel(0)->termStructure()->referenceDate(),
+                                       samples, model, fxBuffer, irStateBuffer);
 
         if (!sgd->withCloseOutLag()) {
             // no close-out lag, fill depth 0 with npv on path
-            auto res = simulatePathInterface2(amcCalculators[j], pathTimes, paths, allTimes, false, tradeLabel[j],
-                                              tradeType[j]);
-            Real v = outputCube->getT0(tradeId[j], 0);
-            outputCube->setT0(v + res[0].at(0) * fx(fxBuffer, currencyIndex[j], 0, 0) *
-                                      numRatio(model, irStateBuffer, currencyIndex[j], 0, 0.0, 0) *
-                                      effectiveMultiplier[j] +
-                                  resFee[0][0],
-                              tradeId[j], 0);
+            auto res = simulatePathInterface2(calcs.calculators[j], pathTimes, paths, pathData.allTimes, false,
+                                              tradeLabel, tradeType);
+            result.t0 += res[0].at(0) * fx(fxBuffer, ccy, 0, 0) * numRatio(model, irStateBuffer, ccy, 0, 0.0, 0) *
+                             multiplier +
+                         resFee[0][0];
             for (Size k = 1; k < res.size(); ++k) {
                 Real t = sgd->getGrid()->timeGrid()[k];
-                for (Size i = 0; i < outputCube->samples(); ++i) {
-                    Real v = outputCube->get(tradeId[j], k - 1, i, 0);
-                    outputCube->set(v + res[k][i] * fx(fxBuffer, currencyIndex[j], k, i) *
-                                            numRatio(model, irStateBuffer, currencyIndex[j], k, t, i) *
-                                            effectiveMultiplier[j] +
-                                        resFee[k][i],
-                                    tradeId[j], k - 1, i, 0);
+                auto& v = result.values[0][k - 1];
+                for (Size i = 0; i < samples; ++i) {
+                    v[i] += res[k][i] * fx(fxBuffer, ccy, k, i) * numRatio(model, irStateBuffer, ccy, k, t, i) *
+                                multiplier +
+                            resFee[k][i];
                 }
             }
         } else {
             // with close-out lag, fill depth 0 with valuation date npvs, depth 1 with (inflated) close-out npvs
             if (sgd->withMporStickyDate()) {
                 // sticky date mpor mode. simulate the valuation times...
-                auto res = simulatePathInterface2(amcCalculators[j], pathTimes, paths, valuationTimes, false,
-                                                  tradeLabel[j], tradeType[j]);
+                auto res = simulatePathInterface2(calcs.calculators[j], pathTimes, paths, pathData.valuationTimes,
+                                                  false, tradeLabel, tradeType);
                 // ... and then the close-out times, but times moved to the valuation times
-                auto resLag = simulatePathInterface2(amcCalculators[j], pathTimes, paths, closeOutTimes, true,
-                                                     tradeLabel[j], tradeType[j]);
-                Real v = outputCube->getT0(tradeId[j], 0);
-                outputCube->setT0(v + res[0].at(0) * fx(fxBuffer, currencyIndex[j], 0, 0) *
-                                          numRatio(model, irStateBuffer, currencyIndex[j], 0, 0.0, 0) *
-                                          effectiveMultiplier[j] +
-                                      resFee[0][0],
-                                  tradeId[j], 0);
+                auto resLag = simulatePathInterface2(calcs.calculators[j], pathTimes, paths, pathData.closeOutTimes,
+                                                     true, tradeLabel, tradeType);
+                result.t0 += res[0].at(0) * fx(fxBuffer, ccy, 0, 0) *
+                                 numRatio(model, irStateBuffer, ccy, 0, 0.0, 0) * multiplier +
+                             resFee[0][0];
                 int dateIndex = -1;
                 for (Size k = 0; k < sgd->getGrid()->dates().size(); ++k) {
                     Real t = sgd->getGrid()->timeGrid()[k + 1];
                     Real tm = sgd->getGrid()->timeGrid()[k];
                     if (sgd->getGrid()->isCloseOutDate()[k]) {
                         QL_REQUIRE(dateIndex >= 0, "first date in grid must be a valuation date");
-                        for (Size i = 0; i < outputCube->samples(); ++i) {
-                            Real v = outputCube->get(tradeId[j], dateIndex, i, 1);
-                            outputCube->set(v + resLag[dateIndex + 1][i] * fx(fxBuffer, currencyIndex[j], k + 1, i) *
-                                                    num(model, irStateBuffer, currencyIndex[j], k + 1, tm, i) *
-                                                    effectiveMultiplier[j] +
-                                                resFee[dateIndex + 1][i],
-                                            tradeId[j], dateIndex, i, 1);
+                        auto& v = result.values[1][dateIndex];
+                        for (Size i = 0; i < samples; ++i) {
+                            v[i] += resLag[dateIndex + 1][i] * fx(fxBuffer, ccy, k + 1, i) *
+                                        num(model, irStateBuffer, ccy, k + 1, tm, i) * multiplier +
+                                    resFee[dateIndex + 1][i];
                         }
                     }
                     if (sgd->getGrid()->isValuationDate()[k]) {
                         ++dateIndex;
-                        for (Size i = 0; i < outputCube->samples(); ++i) {
-                            Real v = outputCube->get(tradeId[j], dateIndex, i, 1);
-                            outputCube->set(v + res[dateIndex + 1][i] * fx(fxBuffer, currencyIndex[j], k + 1, i) *
-                                                    numRatio(model, irStateBuffer, currencyIndex[j], k + 1, t, i) *
-                                                    effectiveMultiplier[j] +
-                                                resFee[dateIndex + 1][i],
-                                            tradeId[j], dateIndex, i, 0);
+                        auto& v = result.values[0][dateIndex];
+                        for (Size i = 0; i < samples; ++i) {
+                            v[i] += res[dateIndex + 1][i] * fx(fxBuffer, ccy, k + 1, i) *
+                                        numRatio(model, irStateBuffer, ccy, k + 1, t, i) * multiplier +
+                                    resFee[dateIndex + 1][i];
                         }
                     }
                 }
             } else {
                 // actual date mpor mode: simulate all times in one go
-                auto res = simulatePathInterface2(amcCalculators[j], pathTimes, paths, allTimes, false, tradeLabel[j],
-                                                  tradeType[j]);
-                Real v = outputCube->getT0(tradeId[j], 0);
-                outputCube->setT0(v + res[0].at(0) * fx(fxBuffer, currencyIndex[j], 0, 0) *
-                                      numRatio(model, irStateBuffer, currencyIndex[j], 0, 0.0, 0) *
-                                      effectiveMultiplier[j],
-                                  tradeId[j], 0);
+                auto res = simulatePathInterface2(calcs.calculators[j], pathTimes, paths, pathData.allTimes, false,
+                                                  tradeLabel, tradeType);
+                result.t0 += res[0].at(0) * fx(fxBuffer, ccy, 0, 0) *
+                             numRatio(model, irStateBuffer, ccy, 0, 0.0, 0) * multiplier;
                 int dateIndex = -1;
                 for (Size k = 1; k < res.size(); ++k) {
                     Real t = sgd->getGrid()->timeGrid()[k];
                     if (sgd->getGrid()->isCloseOutDate()[k - 1]) {
                         QL_REQUIRE(dateIndex >= 0, "first date in grid must be a valuation date");
-                        for (Size i = 0; i < outputCube->samples(); ++i) {
-                            Real v = outputCube->get(tradeId[j], dateIndex, i, 1);
-                            outputCube->set(v + res[k][i] * fx(fxBuffer, currencyIndex[j], k, i) *
-                                                    num(model, irStateBuffer, currencyIndex[j], k, t, i) *
-                                                    effectiveMultiplier[j] +
-                                                resFee[k][i],
-                                            tradeId[j], dateIndex, i, 1);
+                        auto& v = result.values[1][dateIndex];
+                        for (Size i = 0; i < samples; ++i) {
+                            v[i] += res[k][i] * fx(fxBuffer, ccy, k, i) * num(model, irStateBuffer, ccy, k, t, i) *
+                                        multiplier +
+                                    resFee[k][i];
                         }
                     }
                     if (sgd->getGrid()->isValuationDate()[k - 1]) {
                         ++dateIndex;
-                        for (Size i = 0; i < outputCube->samples(); ++i) {
-                            Real v = outputCube->get(tradeId[j], dateIndex, i, 0);
-                            outputCube->set(v + res[k][i] * fx(fxBuffer, currencyIndex[j], k, i) *
-                                                    numRatio(model, irStateBuffer, currencyIndex[j], k, t, i) *
-                                                    effectiveMultiplier[j] +
-                                                resFee[k][i],
-                                            tradeId[j], dateIndex, i, 0);
+                        auto& v = result.values[0][dateIndex];
+                        for (Size i = 0; i < samples; ++i) {
+                            v[i] += res[k][i] * fx(fxBuffer, ccy, k, i) *
+                                        numRatio(model, irStateBuffer, ccy, k, t, i) * multiplier +
+                                    resFee[k][i];
                         }
                     }
                 }
             }
         }
-        progressIndicator->updateProgress(++progressCounter, portfolio->size() + 1);
+    }
+
+    return result;
+}
+
+/* extract the amc calculators of a built trade, simulate them on the paths and write the results to the cube, the
+   cube writes are serialised via cubeMutex if given, so that several threads can share one output cube */
+
+void processTrade(const std::pair<std::string, boost::shared_ptr<Trade>>& trade,
+                  const boost::shared_ptr<QuantExt::CrossAssetModel>& model,
+                  const boost::shared_ptr<ore::analytics::ScenarioGeneratorData>& sgd, const AmcPathData& pathData,
+                  const boost::shared_ptr<NPVCube>& outputCube, std::mutex* cubeMutex = nullptr) {
+
+    auto id = outputCube->idsAndIndexes().find(trade.first);
+    QL_REQUIRE(id != outputCube->idsAndIndexes().end(),
+               "AMCValuationEngine: trade id '" << trade.first << "' is not present in output cube - internal error.");
+
+    AmcTradeCalculators calcs;
+    try {
+        calcs = extractAmcCalculators(trade, model);
+    } catch (const std::exception& e) {
+        ALOG(StructuredTradeErrorMessage(trade.second, "Error building trade for AMC simulation", e.what()));
+        return;
+    }
+
+    AmcTradeValues values = valueTrade(calcs, trade.first, trade.second->tradeType(), model, sgd, pathData,
+                                       outputCube->samples(), outputCube->numDates());
+
+    std::unique_lock<std::mutex> lock;
+    if (cubeMutex)
+        lock = std::unique_lock<std::mutex>(*cubeMutex);
+    outputCube->setT0(values.t0, id->second, 0);
+    for (Size d = 0; d < values.values.size(); ++d) {
+        for (Size j = 0; j < values.values[d].size(); ++j)
+            outputCube->setSamples(values.values[d][j], id->second, j, d);
+    }
+}
+
+void runCoreEngine(const boost::shared_ptr<ore::data::Portfolio>& portfolio,
+                   const boost::shared_ptr<QuantExt::CrossAssetModel>& model,
+                   const boost::shared_ptr<ore::data::Market>& market,
+                   const boost::shared_ptr<ore::analytics::ScenarioGeneratorData>& sgd,
+                   const std::vector<string>& aggDataIndices, const std::vector<string>& aggDataCurrencies,
+                   const Size aggDataNumberCreditStates, boost::shared_ptr<ore::analytics::AggregationScenarioData> asd,
+                   boost::shared_ptr<NPVCube> outputCube, boost::shared_ptr<ProgressIndicator> progressIndicator) {
+
+    progressIndicator->updateProgress(0, portfolio->size());
+
+    boost::timer::cpu_timer timer, timerTotal;
+    timerTotal.start();
+
+    // generate the paths and write ASD
+
+    auto pathData = generatePaths(model, sgd, outputCube->samples());
+
+    if (asd != nullptr) {
+        writeAggregationScenarioData(model, market, sgd, aggDataIndices, aggDataCurrencies, aggDataNumberCreditStates,
+                                     asd, *pathData, outputCube->samples());
+    } else {
+        LOG("No asd object set, won't write aggregation scenario data...");
+    }
+
+    // Run AmcCalculators, trade by trade
+
+    LOG("Run simulation...");
+
+    timer.start();
+    Size progressCounter = 0;
+    for (auto const& trade : portfolio->trades()) {
+        processTrade(trade, model, sgd, *pathData, outputCube);
+        progressIndicator->updateProgress(++progressCounter, portfolio->size());
     }
     timer.stop();
-    valuationTime += timer.elapsed().wall * 1e-9;
-
-    totalTime = timerTotal.elapsed().wall * 1e-9;
-    residualTime = totalTime - (calibrationTime + pathGenTime + valuationTime + asdTime + bufferTime);
-    LOG("calibration time     : " << calibrationTime << " sec");
-    LOG("asd time             : " << asdTime << " sec");
-    LOG("buffer time          : " << bufferTime << " sec");
-    LOG("path generation time : " << pathGenTime << " sec");
-    LOG("valuation time       : " << valuationTime << " sec");
-    LOG("residual time        : " << residualTime << " sec");
-    LOG("total time           : " << totalTime << " sec");
-    LOG("AMCValuationEngine finished for one of possibly multiple threads.");
+
+    LOG("valuation time       : " << timer.elapsed().wall * 1e-9 << " sec");
+    LOG("total time           : " << timerTotal.elapsed().wall * 1e-9 << " sec");
+    LOG("AMCValuationEngine finished.");
 } // runCoreEngine()
 
 } // namespace
@@ -627,10 +675,6 @@ void AMCValuationEngine::buildCube(const boost::shared_ptr<ore::data::Portfolio>
 
     QL_REQUIRE(portfolio->size() > 0, "AMCValuationEngine::buildCube: empty portfolio");
 
-    // split portfolio into nThreads parts (just distribute the trades assuming all are approximately expensive)
-
-    LOG("Splitting portfolio.");
-
     Size eff_nThreads = std::min(portfolio->size(), nThreads_);
 
     LOG("portfolio size = " << portfolio->size());
@@ -639,29 +683,17 @@ void AMCValuationEngine::buildCube(const boost::shared_ptr<ore::data::Portfolio>
 
     QL_REQUIRE(eff_nThreads > 0, "effective threads are zero, this is not allowed.");
 
-    std::vector<boost::shared_ptr<ore::data::Portfolio>> portfolios;
-    for (Size i = 0; i < eff_nThreads; ++i)
-        portfolios.push_back(boost::make_shared<ore::data::Portfolio>());
+    /* output the trades into strings, one single-trade portfolio per trade, so that the worker threads can load them
+       from there; the threads take the trades from a shared queue, so that expensive trades do not delay a thread
+       that got assigned a fixed slice of the portfolio */
 
-    Size portfolioIndex = 0;
+    std::vector<std::string> tradesAsString;
     for (auto const& t : portfolio->trades()) {
-        portfolios[portfolioIndex]->add(t.second);
-        if (++portfolioIndex >= eff_nThreads)
-            portfolioIndex = 0;
-    }
-
-    // output the portfolios into strings so that the worker threads can load them from there
-
-    std::vector<std::string> portfoliosAsString;
-    for (auto const& p : portfolios) {
-        portfoliosAsString.emplace_back(p->toXMLString());
-    }
-
-    // log info on the portfolio split
-
-    for (Size i = 0; i < eff_nThreads; ++i) {
-        LOG("Portfolio #" << i << " number of trades       : " << portfolios[i]->size());
+        ore::data::Portfolio p;
+        p.add(t.second);
+        tradesAsString.emplace_back(p.toXMLString());
     }
+    std::atomic<Size> nextTrade(0);
 
     // build loaders for each thread as clones of the original one
 
@@ -670,14 +702,14 @@ void AMCValuationEngine::buildCube(const boost::shared_ptr<ore::data::Portfolio>
     for (Size i = 0; i < eff_nThreads; ++i)
         loaders.push_back(boost::make_shared<ore::data::ClonedLoader>(today_, loader_));
 
-    // build nThreads mini-cubes to which each thread writes its results
+    // build the result cube to which all threads write their results, the writes are serialised via cubeMutex
 
-    LOG("Build " << eff_nThreads << " mini result cubes...");
+    LOG("Build result cube...");
     miniCubes_.clear();
-    for (Size i = 0; i < eff_nThreads; ++i) {
-        miniCubes_.push_back(
-            cubeFactory_(today_, portfolios[i]->ids(), scenarioGeneratorData_->getGrid()->valuationDates(), nSamples_));
-    }
+    miniCubes_.push_back(
+        cubeFactory_(today_, portfolio->ids(), scenarioGeneratorData_->getGrid()->valuationDates(), nSamples_));
+    auto outputCube = miniCubes_.front();
+    std::mutex cubeMutex;
 
     // precompute sim dates
 
@@ -686,22 +718,25 @@ void AMCValuationEngine::buildCube(const boost::shared_ptr<ore::data::Portfolio>
             ? scenarioGeneratorData_->getGrid()->dates()
             : scenarioGeneratorData_->getGrid()->valuationDates();
 
-    // build progress indicator consolidating the results from the threads
+    /* the paths are generated once by thread 0 and then shared read-only with the other threads, which wait for them
+       after they have built their market and model; all threads use the same model data and market data, so that the
+       paths generated by thread 0 are valid for the models of the other threads as well */
 
-    auto progressIndicator =
-        boost::make_shared<ore::analytics::MultiThreadedProgressIndicator>(this->progressIndicators());
+    std::promise<boost::shared_ptr<AmcPathData>> pathDataPromise;
+    std::shared_future<boost::shared_ptr<AmcPathData>> pathDataFuture = pathDataPromise.get_future().share();
 
-    // create the thread pool with eff_nThreads and queue size = eff_nThreads as well
+    /* the threads take the trades from a shared queue, so there is no per thread total to report against, instead
+       the threads update a single progress counter over all trades */
 
-    // LOG("Create thread pool with " << eff_nThreads);
-    // ctpl::thread_pool threadPool(eff_nThreads);
+    std::mutex progressMutex;
+    Size progressCounter = 0;
 
     // create the jobs and push them to the pool
 
     using resultType = int;
     std::vector<std::future<resultType>> results(eff_nThreads);
 
-    std::vector<std::thread> jobs; // not needed if thread pool is used
+    std::vector<std::thread> jobs;
 
     // get obs mode of main thread, so that we can set this mode in the worker threads below
 
@@ -709,7 +744,8 @@ void AMCValuationEngine::buildCube(const boost::shared_ptr<ore::data::Portfolio>
 
     for (Size i = 0; i < eff_nThreads; ++i) {
 
-        auto job = [this, obsMode, &portfoliosAsString, &loaders, &simDates, &progressIndicator](int id) -> resultType {
+        auto job = [this, obsMode, &tradesAsString, &nextTrade, &loaders, &simDates, &outputCube, &cubeMutex,
+                    &pathDataPromise, &pathDataFuture, &progressMutex, &progressCounter](int id) -> resultType {
             // set thread local singletons
 
             QuantLib::Settings::instance().evaluationDate() = today_;
@@ -718,6 +754,7 @@ void AMCValuationEngine::buildCube(const boost::shared_ptr<ore::data::Portfolio>
             LOG("Start thread " << id);
 
             int rc;
+            bool pathDataPublished = false;
 
             try {
 
@@ -736,10 +773,23 @@ void AMCValuationEngine::buildCube(const boost::shared_ptr<ore::data::Portfolio>
 
                 auto cam = *modelBuilder.model();
 
-                // build portfolio against init market
+                // generate the paths and write asd (thread id 0 only), or wait for the paths from thread id 0
+
+                boost::shared_ptr<AmcPathData> pathData;
+                if (id == 0) {
+                    pathData = generatePaths(cam, scenarioGeneratorData_, nSamples_);
+                    if (asd_ != nullptr) {
+                        writeAggregationScenarioData(cam, initMarket, scenarioGeneratorData_, aggDataIndices_,
+                                                     aggDataCurrencies_, aggDataNumberCreditStates_, asd_, *pathData,
+                                                     nSamples_);
+                    }
+                    pathDataPromise.set_value(pathData);
+                    pathDataPublished = true;
+                } else {
+                    pathData = pathDataFuture.get();
+                }
 
-                auto portfolio = boost::make_shared<ore::data::Portfolio>();
-                portfolio->fromXMLString(portfoliosAsString[id]);
+                // set up the engine factory against the init market
 
                 boost::shared_ptr<EngineData> edCopy = boost::make_shared<EngineData>(*engineData_);
                 edCopy->globalParameters()["GenerateAdditionalResults"] = "false";
@@ -752,12 +802,17 @@ void AMCValuationEngine::buildCube(const boost::shared_ptr<ore::data::Portfolio>
                     edCopy, initMarket, configurations, referenceData_, iborFallbackConfig_,
                     EngineBuilderFactory::instance().generateAmcEngineBuilders(cam, simDates), true);
 
-                portfolio->build(engineFactory, "amc-val-engine", true);
+                // take trades from the queue, build and value them
 
-                // run core engine code (asd is written for thread id 0 only)
-
-                runCoreEngine(portfolio, cam, initMarket, scenarioGeneratorData_, aggDataIndices_, aggDataCurrencies_,
-                              aggDataNumberCreditStates_, id == 0 ? asd_ : nullptr, miniCubes_[id], progressIndicator);
+                for (Size t = nextTrade++; t < tradesAsString.size(); t = nextTrade++) {
+                    auto portfolio = boost::make_shared<ore::data::Portfolio>();
+                    portfolio->fromXMLString(tradesAsString[t]);
+                    portfolio->build(engineFactory, "amc-val-engine", true);
+                    for (auto const& trade : portfolio->trades())
+                        processTrade(trade, cam, scenarioGeneratorData_, *pathData, outputCube, &cubeMutex);
+                    std::lock_guard<std::mutex> lock(progressMutex);
+                    updateProgress(++progressCounter, tradesAsString.size());
+                }
 
                 // return code 0 = ok
 
@@ -773,6 +828,11 @@ void AMCValuationEngine::buildCube(const boost::shared_ptr<ore::data::Portfolio>
                                                                      "",
                                                                      e.what()));
                 rc = 1;
+
+                // do not leave the other threads waiting for the paths
+
+                if (id == 0 && !pathDataPublished)
+                    pathDataPromise.set_exception(std::current_exception());
             }
 
             // exit
@@ -780,16 +840,12 @@ void AMCValuationEngine::buildCube(const boost::shared_ptr<ore::data::Portfolio>
             return rc;
         };
 
-        // results[i] = threadPool.push(job);
-
-        // not needed if thread pool is used
         std::packaged_task<resultType(int)> task(job);
         results[i] = task.get_future();
         std::thread thread(std::move(task), i);
         jobs.emplace_back(std::move(thread));
     }
 
-    // not needed if thread pool is used
     for (auto& t : jobs)
         t.join();
 
@@ -804,11 +860,6 @@ void AMCValuationEngine::buildCube(const boost::shared_ptr<ore::data::Portfolio>
                                              << ". Check for structured errors from 'AMCValuationEngine'.");
     }
 
-    // stop the thread pool, wait for unfinished jobs
-
-    // LOG("Stop thread pool");
-    // threadPool.stop(true);
-
     LOG("Finished multi-threaded AMCValuationEngine run.");
 }
 
@@ -74,7 +74,8 @@ public:
     //! build cube in multi threaded run
     void buildCube(const boost::shared_ptr<ore::data::Portfolio>& portfolio);
 
-    // result output cubes for multi threaded runs (mini-cubes, one per thread)
+    /* result output cubes for multi threaded runs, all threads write to one cube shared between them, so that this
+       vector holds a single cube */
     std::vector<boost::shared_ptr<ore::analytics::NPVCube>> outputCubes() const { return miniCubes_; }
 
     //! Set aggregation data
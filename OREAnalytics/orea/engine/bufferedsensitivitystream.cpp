@@ -26,18 +26,21 @@ BufferedSensitivityStream::BufferedSensitivityStream(const boost::shared_ptr<Sen
 
 SensitivityRecord BufferedSensitivityStream::next() {
     if (index_ == QuantLib::Null<Size>()) {
-        buffer_.push_back(stream_->next());
-        return buffer_.back();
+        nextCalled_ = true;
+        SensitivityRecord sr = stream_->next();
+        if (sr)
+            buffer_.add(sr);
+        return sr;
     }
     if (index_ < buffer_.size()) {
-        return buffer_[index_++];
+        return buffer_.record(index_++);
     }
     return {};
 }
 
 void BufferedSensitivityStream::reset() {
     // if next() was never called, we do not switch to the buffered mode
-    if (!buffer_.empty())
+    if (nextCalled_)
         index_ = 0;
 }
 
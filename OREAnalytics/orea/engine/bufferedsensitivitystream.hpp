@@ -22,11 +22,13 @@
 
 #pragma once
 
+#include <orea/engine/sensitivityrecordtable.hpp>
 #include <orea/engine/sensitivitystream.hpp>
 
 namespace ore {
 namespace analytics {
 
+/*! The records are buffered in a SensitivityRecordTable, i.e. trade ids and risk factor keys are stored once only */
 class BufferedSensitivityStream : public SensitivityStream {
 public:
     explicit BufferedSensitivityStream(const boost::shared_ptr<SensitivityStream>& stream);
@@ -35,8 +37,9 @@ public:
 
 private:
     boost::shared_ptr<SensitivityStream> stream_;
-    std::vector<SensitivityRecord> buffer_;
+    SensitivityRecordTable buffer_;
     QuantLib::Size index_ = QuantLib::Null<QuantLib::Size>();
+    bool nextCalled_ = false;
 };
 
 } // namespace analytics
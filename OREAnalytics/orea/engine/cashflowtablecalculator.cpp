@@ -0,0 +1,248 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/engine/cashflowtablecalculator.hpp>
+
+#include <ored/utilities/log.hpp>
+
+#include <ql/cashflows/fixedratecoupon.hpp>
+#include <ql/cashflows/iborcoupon.hpp>
+#include <ql/cashflows/simplecashflow.hpp>
+#include <ql/settings.hpp>
+
+#include <algorithm>
+#include <typeinfo>
+
+namespace ore {
+namespace analytics {
+
+using namespace QuantLib;
+
+Size CashflowTableNPVCalculator::curve(const Handle<YieldTermStructure>& ts) {
+    auto c = curveIndex_.find(ts.currentLink().get());
+    if (c != curveIndex_.end())
+        return c->second;
+    curveIndex_[ts.currentLink().get()] = curves_.size();
+    curves_.push_back(CurveGrid{ts, {}, {}, 0.0, {}});
+    return curves_.size() - 1;
+}
+
+bool CashflowTableNPVCalculator::buildTable(Size tradeIndex, const boost::shared_ptr<Trade>& trade,
+                                            const boost::shared_ptr<SimMarket>& simMarket, std::vector<Flow>& flows,
+                                            std::vector<std::pair<Size, Date>>& curveDates) {
+    static const std::set<std::string> tradeTypes = {"Swap", "CrossCurrencySwap", "FxForward"};
+    if (tradeTypes.count(trade->tradeType()) == 0 || trade->instrument()->isOption() ||
+        !trade->instrument()->additionalInstruments().empty() || trade->legs().empty() ||
+        trade->legs().size() != trade->legCurrencies().size() || trade->legs().size() != trade->legPayers().size())
+        return false;
+
+    for (Size l = 0; l < trade->legs().size(); ++l) {
+        const std::string& ccy = trade->legCurrencies()[l];
+        auto c = legCcyIndex_.find(ccy);
+        if (c == legCcyIndex_.end()) {
+            c = legCcyIndex_.insert(std::make_pair(ccy, legCcyQuotes_.size())).first;
+            legCcyQuotes_.push_back(simMarket->fxRate(ccy + baseCcyCode_));
+        }
+        Size discountCurve = curve(simMarket->discountCurve(ccy));
+        Real weight = (trade->legPayers()[l] ? -1.0 : 1.0) * trade->instrument()->multiplier();
+        for (auto const& cf : trade->legs()[l]) {
+            Flow f;
+            f.trade = tradeIndex;
+            f.cashflow = cf;
+            f.weight = weight;
+            f.ccy = c->second;
+            f.discountCurve = discountCurve;
+            const std::type_info& type = typeid(*cf);
+            if (type == typeid(SimpleCashFlow) || type == typeid(Redemption) || type == typeid(AmortizingPayment) ||
+                type == typeid(FixedRateCoupon)) {
+                f.amount = cf->amount();
+            } else if (type == typeid(IborCoupon)) {
+                auto cpn = boost::static_pointer_cast<IborCoupon>(cf);
+                if (cpn->isInArrears() || cpn->iborIndex()->forwardingTermStructure().empty())
+                    return false;
+                f.amount = cpn->nominal() * cpn->accrualPeriod();
+                f.index = cpn->iborIndex();
+                f.gearing = cpn->gearing();
+                f.spread = cpn->spread();
+                f.fixingDate = cpn->fixingDate();
+                f.forwardCurve = curve(f.index->forwardingTermStructure());
+                f.spanningTime = cpn->spanningTime();
+                curveDates.push_back(std::make_pair(f.forwardCurve, cpn->fixingValueDate()));
+                curveDates.push_back(std::make_pair(f.forwardCurve, cpn->fixingEndDate()));
+            } else {
+                return false;
+            }
+            curveDates.push_back(std::make_pair(discountCurve, cf->date()));
+            flows.push_back(f);
+        }
+    }
+    return true;
+}
+
+void CashflowTableNPVCalculator::init(const boost::shared_ptr<Portfolio>& portfolio,
+                                      const boost::shared_ptr<SimMarket>& simMarket) {
+    NPVCalculator::init(portfolio, simMarket);
+    DLOG("init CashflowTableNPVCalculator");
+
+    tableTrade_.assign(portfolio->size(), false);
+    validated_.assign(portfolio->size(), false);
+    tableNpv_.assign(portfolio->size(), 0.0);
+    tableError_.assign(portfolio->size(), std::string());
+    flows_.clear();
+    curves_.clear();
+    curveIndex_.clear();
+    legCcyQuotes_.clear();
+    legCcyIndex_.clear();
+
+    // extract the cashflow tables and collect the curve dates
+
+    std::vector<std::pair<Size, Date>> curveDates;
+    Size i = 0;
+    for (auto const& [tradeId, trade] : portfolio->trades()) {
+        std::vector<Flow> flows;
+        std::vector<std::pair<Size, Date>> dates;
+        try {
+            tableTrade_[i] = buildTable(i, trade, simMarket, flows, dates);
+        } catch (const std::exception& e) {
+            DLOG("CashflowTableNPVCalculator: can not build cashflow table for trade " << tradeId << ": " << e.what());
+            tableTrade_[i] = false;
+        }
+        if (tableTrade_[i]) {
+            flows_.insert(flows_.end(), flows.begin(), flows.end());
+            curveDates.insert(curveDates.end(), dates.begin(), dates.end());
+        }
+        ++i;
+    }
+
+    // the sorted, unique dates per curve and the positions of the flow dates
+
+    std::vector<std::set<Date>> curveDateSets(curves_.size());
+    for (auto const& [c, d] : curveDates)
+        curveDateSets[c].insert(d);
+    for (Size c = 0; c < curves_.size(); ++c) {
+        curves_[c].dates.assign(curveDateSets[c].begin(), curveDateSets[c].end());
+        curves_[c].values.resize(curves_[c].dates.size());
+    }
+    auto pos = [this](Size c, const Date& d) {
+        const auto& dates = curves_[c].dates;
+        return static_cast<Size>(std::distance(dates.begin(), std::lower_bound(dates.begin(), dates.end(), d)));
+    };
+    for (auto& f : flows_) {
+        f.payPos = pos(f.discountCurve, f.cashflow->date());
+        if (f.index) {
+            auto cpn = boost::static_pointer_cast<IborCoupon>(f.cashflow);
+            f.valuePos = pos(f.forwardCurve, cpn->fixingValueDate());
+            f.endPos = pos(f.forwardCurve, cpn->fixingEndDate());
+        }
+    }
+
+    legFxRates_.resize(legCcyQuotes_.size());
+    tablesValid_ = false;
+
+    DLOG("CashflowTableNPVCalculator: " << std::count(tableTrade_.begin(), tableTrade_.end(), true) << " out of "
+                                        << portfolio->size() << " trades priced from " << flows_.size()
+                                        << " cashflows on " << curves_.size() << " curves");
+}
+
+void CashflowTableNPVCalculator::initScenario() {
+    NPVCalculator::initScenario();
+    tablesValid_ = false;
+}
+
+void CashflowTableNPVCalculator::evaluateTables() {
+    Date today = Settings::instance().evaluationDate();
+
+    for (Size i = 0; i < legCcyQuotes_.size(); ++i)
+        legFxRates_[i] = legCcyQuotes_[i]->value();
+
+    // evaluate each curve once on its date grid, dates before today are not needed
+
+    for (auto& c : curves_) {
+        c.error.clear();
+        try {
+            c.todayValue = c.curve->discount(today);
+            for (Size k = 0; k < c.dates.size(); ++k)
+                c.values[k] = c.dates[k] < today ? Null<Real>() : c.curve->discount(c.dates[k]);
+        } catch (const std::exception& e) {
+            c.error = e.what();
+        }
+    }
+
+    // sum up the discounted flows per trade
+
+    std::fill(tableNpv_.begin(), tableNpv_.end(), 0.0);
+    std::fill(tableError_.begin(), tableError_.end(), std::string());
+    for (auto const& f : flows_) {
+        if (!tableError_[f.trade].empty())
+            continue;
+        const Date& payDate = f.cashflow->date();
+        if (payDate < today || (payDate == today && f.cashflow->hasOccurred(today)))
+            continue;
+        try {
+            const CurveGrid& dc = curves_[f.discountCurve];
+            QL_REQUIRE(dc.error.empty(), "discount curve: " << dc.error);
+            Real amount = f.amount;
+            if (f.index) {
+                Real fixing;
+                if (f.fixingDate < today || (f.fixingDate == today && f.index->hasHistoricalFixing(today))) {
+                    fixing = f.index->fixing(f.fixingDate);
+                } else {
+                    const CurveGrid& fc = curves_[f.forwardCurve];
+                    QL_REQUIRE(fc.error.empty(), "forwarding curve: " << fc.error);
+                    fixing = (fc.values[f.valuePos] / fc.values[f.endPos] - 1.0) / f.spanningTime;
+                }
+                amount *= f.gearing * fixing + f.spread;
+            }
+            tableNpv_[f.trade] += f.weight * amount * dc.values[f.payPos] / dc.todayValue * legFxRates_[f.ccy];
+        } catch (const std::exception& e) {
+            tableError_[f.trade] = e.what();
+        }
+    }
+
+    tablesValid_ = true;
+}
+
+Real CashflowTableNPVCalculator::npv(Size tradeIndex, const boost::shared_ptr<Trade>& trade,
+                                     const boost::shared_ptr<SimMarket>& simMarket) {
+    if (!tableTrade_[tradeIndex])
+        return NPVCalculator::npv(tradeIndex, trade, simMarket);
+
+    if (!tablesValid_)
+        evaluateTables();
+    QL_REQUIRE(tableError_[tradeIndex].empty(), "cashflow table pricing failed: " << tableError_[tradeIndex]);
+    Real npv = tableNpv_[tradeIndex] / simMarket->numeraire();
+
+    // validate the table against the QuantLib instrument on first use
+
+    if (!validated_[tradeIndex]) {
+        validated_[tradeIndex] = true;
+        Real qlNpv = NPVCalculator::npv(tradeIndex, trade, simMarket);
+        if (std::abs(npv - qlNpv) > tolerance_ * std::max(1.0, std::abs(qlNpv))) {
+            WLOG("CashflowTableNPVCalculator: cashflow table npv " << npv << " does not match npv " << qlNpv
+                                                                   << " for trade " << trade->id()
+                                                                   << ", the trade is priced via its instrument");
+            tableTrade_[tradeIndex] = false;
+            return qlNpv;
+        }
+    }
+
+    return npv;
+}
+
+} // namespace analytics
+} // namespace ore
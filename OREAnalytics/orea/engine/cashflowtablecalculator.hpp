@@ -0,0 +1,112 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file engine/cashflowtablecalculator.hpp
+    \brief npv calculator pricing linear trades from a cashflow table
+    \ingroup simulation
+*/
+
+#pragma once
+
+#include <orea/engine/valuationcalculator.hpp>
+
+#include <ql/cashflow.hpp>
+#include <ql/indexes/iborindex.hpp>
+
+namespace ore {
+namespace analytics {
+
+//! CashflowTableNPVCalculator
+/*! Prices linear trades (swaps, cross currency swaps and fx forwards with fixed amount, fixed rate and plain ibor
+    coupon legs) from a cashflow table that is extracted once in init(), instead of calling the QuantLib pricing
+    engines for each scenario.
+
+    After each scenario update the discount and forwarding curves are evaluated once on the union of the dates
+    required by all tables and the table npvs of all trades are computed in one pass. Trades that do not qualify
+    are priced as in NPVCalculator.
+
+    The first npv of each trade, i.e. usually the T0 npv, is computed both from the table and via the QuantLib
+    instrument. If the relative difference exceeds the given tolerance, a warning is logged and the trade is priced
+    via the QuantLib instrument from then on. See NPVCalculator for the conventions of the stored npvs. */
+class CashflowTableNPVCalculator : public NPVCalculator {
+public:
+    //! base ccy, index to write to and tolerance for the validation against the QuantLib npv
+    CashflowTableNPVCalculator(const std::string& baseCcyCode, Size index = 0, Real tolerance = 1.0E-8)
+        : NPVCalculator(baseCcyCode, index), tolerance_(tolerance) {}
+
+    Real npv(Size tradeIndex, const boost::shared_ptr<Trade>& trade,
+             const boost::shared_ptr<SimMarket>& simMarket) override;
+
+    void init(const boost::shared_ptr<Portfolio>& portfolio, const boost::shared_ptr<SimMarket>& simMarket) override;
+    void initScenario() override;
+
+    //! Does the trade use the table pricing?
+    bool usesTable(Size tradeIndex) const { return tableTrade_.at(tradeIndex); }
+
+private:
+    // a curve and the dates on which it is evaluated in each scenario
+    struct CurveGrid {
+        Handle<YieldTermStructure> curve;
+        std::vector<Date> dates;
+        std::vector<Real> values;
+        Real todayValue;
+        std::string error;
+    };
+
+    // a row of the cashflow table
+    struct Flow {
+        Size trade;
+        boost::shared_ptr<QuantLib::CashFlow> cashflow;
+        // leg sign times instrument multiplier
+        Real weight;
+        // index into legCcyQuotes_
+        Size ccy;
+        Size discountCurve, payPos;
+        // fixed amount, or nominal times accrual period for ibor coupons
+        Real amount;
+        // ibor coupons only, index is null otherwise
+        boost::shared_ptr<QuantLib::IborIndex> index;
+        Real gearing, spread;
+        Date fixingDate;
+        Size forwardCurve, valuePos, endPos;
+        Time spanningTime;
+    };
+
+    bool buildTable(Size tradeIndex, const boost::shared_ptr<Trade>& trade,
+                    const boost::shared_ptr<SimMarket>& simMarket, std::vector<Flow>& flows,
+                    std::vector<std::pair<Size, Date>>& curveDates);
+    Size curve(const Handle<YieldTermStructure>& ts);
+    void evaluateTables();
+
+    Real tolerance_;
+
+    std::vector<bool> tableTrade_, validated_;
+    std::vector<Flow> flows_;
+    std::vector<CurveGrid> curves_;
+    std::map<const YieldTermStructure*, Size> curveIndex_;
+    std::vector<Handle<Quote>> legCcyQuotes_;
+    std::vector<Real> legFxRates_;
+    std::map<std::string, Size> legCcyIndex_;
+
+    bool tablesValid_ = false;
+    std::vector<Real> tableNpv_;
+    std::vector<std::string> tableError_;
+};
+
+} // namespace analytics
+} // namespace ore
@@ -22,6 +22,7 @@
 
 #include <orea/cube/jointnpvcube.hpp>
 #include <orea/cube/inmemorycube.hpp>
+#include <orea/cube/pnlaggregationcube.hpp>
 
 #include <boost/range/adaptor/indexed.hpp>
 
@@ -48,7 +49,7 @@ HistoricalPnlGenerator::HistoricalPnlGenerator(
     const set<std::pair<string, boost::shared_ptr<QuantExt::ModelBuilder>>>& modelBuilders, bool dryRun)
     : useSingleThreadedEngine_(true), portfolio_(portfolio), simMarket_(simMarket), hisScenGen_(hisScenGen),
       cube_(cube), dryRun_(dryRun),
-      npvCalculator_([&baseCurrency]() -> std::vector<boost::shared_ptr<ValuationCalculator>> {
+      npvCalculator_([baseCurrency]() -> std::vector<boost::shared_ptr<ValuationCalculator>> {
           return {boost::make_shared<NPVCalculator>(baseCurrency)};
       }) {
 
@@ -88,7 +89,7 @@ HistoricalPnlGenerator::HistoricalPnlGenerator(
       nThreads_(nThreads), today_(today), loader_(loader), curveConfigs_(curveConfigs),
       todaysMarketParams_(todaysMarketParams), configuration_(configuration), simMarketData_(simMarketData),
       referenceData_(referenceData), iborFallbackConfig_(iborFallbackConfig), dryRun_(dryRun), context_(context),
-      npvCalculator_([&baseCurrency]() -> std::vector<boost::shared_ptr<ValuationCalculator>> {
+      npvCalculator_([baseCurrency]() -> std::vector<boost::shared_ptr<ValuationCalculator>> {
           return {boost::make_shared<NPVCalculator>(baseCurrency)};
       }) {}
 
@@ -128,6 +129,104 @@ void HistoricalPnlGenerator::generateCube(const boost::shared_ptr<ScenarioFilter
     DLOG("Historical P&L cube generated");
 }
 
+void HistoricalPnlGenerator::generatePnl(const boost::shared_ptr<ScenarioFilter>& filter,
+                                         const map<string, set<string>>& groups) {
+
+    DLOG("Generating historical P&L for " << groups.size() << " groups, " << portfolio_->size() << " trades and "
+                                          << hisScenGen_->numScenarios() << " scenarios.");
+
+    groupPnl_.clear();
+    excludedTrades_.clear();
+    for (const auto& g : groups)
+        groupPnl_[g.first] = vector<Real>(hisScenGen_->numScenarios(), 0.0);
+
+    auto cubeFactory = [&groups](const Date& asof, const set<string>& ids, const vector<Date>& dates,
+                                 const Size samples) -> boost::shared_ptr<NPVCube> {
+        return boost::make_shared<PnlAggregationCube>(asof, ids, dates, samples, groups);
+    };
+
+    auto portfolio = portfolio_;
+    while (!portfolio->trades().empty()) {
+
+        vector<boost::shared_ptr<NPVCube>> cubes;
+
+        if (useSingleThreadedEngine_) {
+            valuationEngine_->unregisterAllProgressIndicators();
+            for (auto const& i : this->progressIndicators()) {
+                i->reset();
+                valuationEngine_->registerProgressIndicator(i);
+            }
+            hisScenGen_->reset();
+            simMarket_->filter() = filter;
+            simMarket_->reset();
+            simMarket_->scenarioGenerator() = hisScenGen_;
+            hisScenGen_->baseScenario() = simMarket_->baseScenario();
+            cubes.push_back(cubeFactory(simMarket_->asofDate(), portfolio->ids(),
+                                        vector<Date>(1, simMarket_->asofDate()), hisScenGen_->numScenarios()));
+            valuationEngine_->buildCube(portfolio, cubes.back(), npvCalculator_(), true, nullptr, nullptr, {},
+                                        dryRun_);
+        } else {
+            MultiThreadedValuationEngine engine(
+                nThreads_, today_, boost::make_shared<ore::analytics::DateGrid>(), hisScenGen_->numScenarios(),
+                loader_, hisScenGen_, engineData_, curveConfigs_, todaysMarketParams_, configuration_, simMarketData_,
+                false, false, filter, referenceData_, iborFallbackConfig_, true, true, cubeFactory, {}, {}, context_);
+            for (auto const& i : this->progressIndicators()) {
+                i->reset();
+                engine.registerProgressIndicator(i);
+            }
+            engine.buildCube(portfolio, npvCalculator_, {}, true, dryRun_);
+            cubes = engine.outputCubes();
+        }
+
+        // the values of trades with errors can not be backed out of the group totals, so we value again without them
+
+        set<string> removed;
+        for (const auto& c : cubes) {
+            auto cube = boost::dynamic_pointer_cast<PnlAggregationCube>(c);
+            QL_REQUIRE(cube, "HistoricalPnlGenerator::generatePnl(): expected PnlAggregationCube");
+            removed.insert(cube->removedIds().begin(), cube->removedIds().end());
+        }
+
+        if (removed.empty()) {
+            for (const auto& c : cubes) {
+                auto cube = boost::static_pointer_cast<PnlAggregationCube>(c);
+                for (auto& [group, pnl] : groupPnl_) {
+                    vector<Real> p = cube->pnl(group);
+                    for (Size s = 0; s < pnl.size(); ++s)
+                        pnl[s] += p[s];
+                }
+            }
+            break;
+        }
+
+        ALOG("HistoricalPnlGenerator: " << removed.size()
+                                        << " trades with valuation errors are excluded, generating P&L again");
+        excludedTrades_.insert(removed.begin(), removed.end());
+        auto reduced = boost::make_shared<Portfolio>();
+        for (const auto& [id, trade] : portfolio->trades()) {
+            if (removed.find(id) == removed.end())
+                reduced->add(trade);
+        }
+        portfolio = reduced;
+    }
+
+    DLOG("Historical P&L generated");
+}
+
+vector<Real> HistoricalPnlGenerator::groupPnl(const string& group, const TimePeriod& period) const {
+    auto p = groupPnl_.find(group);
+    QL_REQUIRE(p != groupPnl_.end(), "HistoricalPnlGenerator::groupPnl(): no P&L for group '" << group << "'");
+    vector<Real> pnls;
+    pnls.reserve(p->second.size());
+    for (Size s = 0; s < p->second.size(); ++s) {
+        if (period.contains(hisScenGen_->startDates()[s]) && period.contains(hisScenGen_->endDates()[s]))
+            pnls.push_back(p->second[s]);
+    }
+    return pnls;
+}
+
+vector<Real> HistoricalPnlGenerator::groupPnl(const string& group) const { return groupPnl(group, timePeriod()); }
+
 vector<Real> HistoricalPnlGenerator::pnl(const TimePeriod& period, const set<pair<string, Size>>& tradeIds) const {
 
     // Create result with enough space
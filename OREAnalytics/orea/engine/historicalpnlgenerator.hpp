@@ -48,6 +48,11 @@ namespace analytics {
 
     In the calculation of P&L, the class allows the scenario shifts to be filtered and also the
     trades to be filtered.
+
+    For large portfolios and long look back periods, generatePnl() accumulates the P&L of given
+    groups of trades (e.g. portfolios) directly while the scenarios are valued, without storing
+    the trade level NPV cube. P&L vectors by risk class are obtained by calling generatePnl() with
+    the corresponding scenario filter, in the same way as for generateCube().
 */
 class HistoricalPnlGenerator : public ore::data::ProgressReporter {
 public:
@@ -86,6 +91,28 @@ public:
     */
     void generateCube(const boost::shared_ptr<ScenarioFilter>& filter);
 
+    /*! Generate the historical P&L of each group of trades in \p groups (group name to trade ids) on
+        each of the scenarios provided by the historical scenario generator, with the given \p filter
+        applied. Only the group level P&L is kept, no trade level cube is stored. Trades with errors
+        during the valuation are excluded and the P&L is regenerated without them, see
+        excludedTrades().
+    */
+    void generatePnl(const boost::shared_ptr<ScenarioFilter>& filter,
+                     const std::map<std::string, std::set<std::string>>& groups);
+
+    /*! Return a vector of historical P&L values of the given \p group restricted to scenarios falling
+        in \p period. The P&L values are taken from the last call to generatePnl.
+    */
+    std::vector<QuantLib::Real> groupPnl(const std::string& group, const ore::data::TimePeriod& period) const;
+
+    /*! Return a vector of historical P&L values of the given \p group for all scenarios generated by
+        the historical scenario generator. The P&L values are taken from the last call to generatePnl.
+    */
+    std::vector<QuantLib::Real> groupPnl(const std::string& group) const;
+
+    //! Trades excluded from the group P&L in the last call to generatePnl because of valuation errors
+    const std::set<std::string>& excludedTrades() const { return excludedTrades_; }
+
     /*! Return a vector of historical portfolio P&L values restricted to scenarios
         falling in \p period and restricted to the given \p tradeIds. The P&L values
         are calculated from the last cube generated by generateCube.
@@ -172,6 +199,10 @@ private:
 
     std::function<std::vector<boost::shared_ptr<ValuationCalculator>>()> npvCalculator_;
 
+    // results of generatePnl
+    std::map<std::string, std::vector<QuantLib::Real>> groupPnl_;
+    std::set<std::string> excludedTrades_;
+
     //! Get the index of the as of date in the cube.
     QuantLib::Size indexAsof() const;
 };
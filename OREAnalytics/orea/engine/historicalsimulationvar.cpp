@@ -18,29 +18,35 @@
 
 #include <orea/engine/historicalsimulationvar.hpp>
 
-#include <boost/accumulators/accumulators.hpp>
-#include <boost/accumulators/statistics.hpp>
-#include <boost/accumulators/statistics/tail_quantile.hpp>
+#include <ql/errors.hpp>
 
-using namespace boost::accumulators;
+#include <algorithm>
+#include <cmath>
+#include <functional>
 
 namespace ore {
 namespace analytics {
 
-QuantLib::Real HistoricalSimulationVarCalculator::var(QuantLib::Real confidence, const bool isCall, 
-    const set<pair<string, Size>>& tradeIds) {
-
-    // Use boost to calculate the quantile based on confidence_
-    Size c = static_cast<Size>(std::floor(pnls_.size() * (1.0 - confidence) + 0.5)) + 2;
-    typedef accumulator_set<double, stats<boost::accumulators::tag::tail_quantile<boost::accumulators::right>>>
-        accumulator;
-    accumulator acc(boost::accumulators::tag::tail<boost::accumulators::right>::cache_size = c);
-
-    for (const auto& pnl : pnls_) {
-        acc(isCall ? pnl : -pnl);
-    }
+QuantLib::Real historicalSimulationQuantile(const std::vector<QuantLib::Real>& pnls, QuantLib::Real confidence,
+                                            const bool isCall) {
+    QL_REQUIRE(!pnls.empty(), "historicalSimulationQuantile(): no P&L values given");
+    QL_REQUIRE(confidence >= 0.0 && confidence <= 1.0,
+               "historicalSimulationQuantile(): confidence (" << confidence << ") must be in [0,1]");
+
+    // The quantile is the n-th largest value with n = ceil(N * (1 - confidence)), as for the right tail quantile
+    // of boost's accumulators. We select it in linear time instead of sorting or caching the tail.
+    std::vector<QuantLib::Real> v(pnls.size());
+    std::transform(pnls.begin(), pnls.end(), v.begin(),
+                   [isCall](QuantLib::Real p) { return isCall ? p : -p; });
+    Size n = static_cast<Size>(std::ceil(v.size() * (1.0 - confidence)));
+    n = std::min(std::max<Size>(n, 1), v.size());
+    std::nth_element(v.begin(), v.begin() + (n - 1), v.end(), std::greater<QuantLib::Real>());
+    return v[n - 1];
+}
 
-    return quantile(acc, quantile_probability = confidence);
+QuantLib::Real HistoricalSimulationVarCalculator::var(QuantLib::Real confidence, const bool isCall,
+                                                      const set<pair<string, Size>>& tradeIds) {
+    return historicalSimulationQuantile(pnls_, confidence, isCall);
 }
 
 } // namespace analytics
@@ -48,6 +48,12 @@ using QuantLib::Matrix;
 
 typedef std::pair<RiskFactorKey, RiskFactorKey> CrossPair;
 
+/*! Quantile of a historical P&L vector at the given confidence level, i.e. the n-th largest P&L (or loss, if
+    isCall is false) with n = ceil(N * (1 - confidence)). The quantile is found by selection, so that the cost
+    is linear in the number of P&L values. */
+QuantLib::Real historicalSimulationQuantile(const std::vector<QuantLib::Real>& pnls, QuantLib::Real confidence,
+                                            const bool isCall = true);
+
 class HistoricalSimulationVarCalculator : public VarCalculator {
 public:
     HistoricalSimulationVarCalculator(const std::vector<QuantLib::Real>& pnls) : pnls_(pnls) {}
@@ -0,0 +1,375 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/engine/multiprocessvaluationengine.hpp>
+
+#include <orea/scenario/scenariosimmarketplus.hpp>
+
+#include <orea/app/structuredanalyticserror.hpp>
+#include <orea/cube/sharedmemorycube.hpp>
+
+#include <ored/marketdata/todaysmarket.hpp>
+#include <ored/portfolio/enginefactory.hpp>
+
+#include <boost/timer/timer.hpp>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace ore {
+namespace analytics {
+
+using QuantLib::Size;
+
+namespace {
+
+// the aggregation scenario data keys written by ScenarioSimMarket::updateAsd()
+std::vector<std::pair<AggregationScenarioDataType, std::string>>
+aggregationScenarioDataKeys(const ScenarioSimMarketParameters& parameters) {
+    std::vector<std::pair<AggregationScenarioDataType, std::string>> keys;
+    for (auto const& i : parameters.additionalScenarioDataIndices())
+        keys.push_back(std::make_pair(AggregationScenarioDataType::IndexFixing, i));
+    for (auto const& c : parameters.additionalScenarioDataCcys()) {
+        if (c != parameters.baseCcy())
+            keys.push_back(std::make_pair(AggregationScenarioDataType::FXSpot, c));
+    }
+    for (Size i = 0; i < parameters.additionalScenarioDataNumberOfCreditStates(); ++i)
+        keys.push_back(std::make_pair(AggregationScenarioDataType::CreditState, std::to_string(i)));
+    for (auto const& n : parameters.additionalScenarioDataSurvivalWeights()) {
+        keys.push_back(std::make_pair(AggregationScenarioDataType::SurvivalWeight, n));
+        keys.push_back(std::make_pair(AggregationScenarioDataType::RecoveryRate, n));
+    }
+    keys.push_back(std::make_pair(AggregationScenarioDataType::Numeraire, std::string()));
+    return keys;
+}
+
+/* aggregation scenario data for a fixed set of keys stored in a SharedMemoryBlock, so that the values written by a
+   worker process are visible in the calling process */
+class SharedMemoryAggregationScenarioData : public AggregationScenarioData {
+public:
+    SharedMemoryAggregationScenarioData(Size dimDates, Size dimSamples,
+                                        const std::vector<std::pair<AggregationScenarioDataType, std::string>>& keys)
+        : dimDates_(dimDates), dimSamples_(dimSamples) {
+        for (auto const& k : keys) {
+            if (keyIndex_.insert(std::make_pair(k, keys_.size())).second)
+                keys_.push_back(k);
+        }
+        Size n = keys_.size() * dimDates_ * dimSamples_;
+        block_ = std::make_unique<SharedMemoryBlock>(n * sizeof(Real));
+        data_ = static_cast<Real*>(block_->data());
+        std::fill(data_, data_ + n, 0.0);
+    }
+
+    Size dimDates() const override { return dimDates_; }
+    Size dimSamples() const override { return dimSamples_; }
+
+    bool has(const AggregationScenarioDataType& type, const string& qualifier = "") const override {
+        return keyIndex_.find(std::make_pair(type, qualifier)) != keyIndex_.end();
+    }
+
+    Real get(Size dateIndex, Size sampleIndex, const AggregationScenarioDataType& type,
+             const string& qualifier = "") const override {
+        return data_[index(dateIndex, sampleIndex, type, qualifier)];
+    }
+
+    void set(Size dateIndex, Size sampleIndex, Real value, const AggregationScenarioDataType& type,
+             const string& qualifier = "") override {
+        data_[index(dateIndex, sampleIndex, type, qualifier)] = value;
+    }
+
+    std::vector<std::pair<AggregationScenarioDataType, std::string>> keys() const override { return keys_; }
+
+private:
+    Size index(Size dateIndex, Size sampleIndex, const AggregationScenarioDataType& type,
+               const string& qualifier) const {
+        QL_REQUIRE(dateIndex < dimDates_, "dateIndex (" << dateIndex << ") out of range 0..." << dimDates_ - 1);
+        QL_REQUIRE(sampleIndex < dimSamples_,
+                   "sampleIndex (" << sampleIndex << ") out of range 0..." << dimSamples_ - 1);
+        auto k = keyIndex_.find(std::make_pair(type, qualifier));
+        QL_REQUIRE(k != keyIndex_.end(),
+                   "SharedMemoryAggregationScenarioData: no storage for " << type << " '" << qualifier << "'");
+        return (k->second * dimDates_ + dateIndex) * dimSamples_ + sampleIndex;
+    }
+
+    Size dimDates_, dimSamples_;
+    std::vector<std::pair<AggregationScenarioDataType, std::string>> keys_;
+    std::map<std::pair<AggregationScenarioDataType, std::string>, Size> keyIndex_;
+    std::unique_ptr<SharedMemoryBlock> block_;
+    Real* data_;
+};
+
+} // namespace
+
+MultiProcessValuationEngine::MultiProcessValuationEngine(
+    const Size nProcesses, const QuantLib::Date& today, const boost::shared_ptr<ore::data::DateGrid>& dateGrid,
+    const Size nSamples, const boost::shared_ptr<ore::data::Loader>& loader,
+    const boost::shared_ptr<ore::analytics::ScenarioGenerator>& scenarioGenerator,
+    const boost::shared_ptr<ore::data::EngineData>& engineData,
+    const boost::shared_ptr<ore::data::CurveConfigurations>& curveConfigs,
+    const boost::shared_ptr<ore::data::TodaysMarketParameters>& todaysMarketParams, const std::string& configuration,
+    const boost::shared_ptr<ore::analytics::ScenarioSimMarketParameters>& simMarketData,
+    const bool useSpreadedTermStructures, const bool cacheSimData,
+    const boost::shared_ptr<ore::analytics::ScenarioFilter>& scenarioFilter,
+    const boost::shared_ptr<ore::data::ReferenceDataManager>& referenceData,
+    const ore::data::IborFallbackConfig& iborFallbackConfig, const bool handlePseudoCurrenciesTodaysMarket,
+    const bool handlePseudoCurrenciesSimMarket, const Size cubeDepth, const bool doublePrecision,
+    const bool cptyCubes, const std::string& dvaName, const std::string& context)
+    : nProcesses_(nProcesses), today_(today), dateGrid_(dateGrid), nSamples_(nSamples), loader_(loader),
+      scenarioGenerator_(scenarioGenerator), engineData_(engineData), curveConfigs_(curveConfigs),
+      todaysMarketParams_(todaysMarketParams), configuration_(configuration), simMarketData_(simMarketData),
+      useSpreadedTermStructures_(useSpreadedTermStructures), cacheSimData_(cacheSimData),
+      scenarioFilter_(scenarioFilter), referenceData_(referenceData), iborFallbackConfig_(iborFallbackConfig),
+      handlePseudoCurrenciesTodaysMarket_(handlePseudoCurrenciesTodaysMarket),
+      handlePseudoCurrenciesSimMarket_(handlePseudoCurrenciesSimMarket), cubeDepth_(cubeDepth),
+      doublePrecision_(doublePrecision), cptyCubes_(cptyCubes), dvaName_(dvaName), context_(context) {
+
+    QL_REQUIRE(nProcesses_ != 0, "MultiProcessValuationEngine: nProcesses must be > 0");
+
+    // worker processes are created by fork() and write their results to shared memory
+
+    QL_REQUIRE(SharedMemoryBlock::shared(), "MultiProcessValuationEngine is not supported on this platform.");
+}
+
+void MultiProcessValuationEngine::setAggregationScenarioData(
+    const boost::shared_ptr<AggregationScenarioData>& aggregationScenarioData) {
+    aggregationScenarioData_ = aggregationScenarioData;
+}
+
+boost::shared_ptr<NPVCube> MultiProcessValuationEngine::createCube(const std::set<std::string>& ids,
+                                                                   const std::vector<QuantLib::Date>& dates,
+                                                                   Size depth) const {
+    if (doublePrecision_)
+        return boost::make_shared<DoublePrecisionSharedMemoryCube>(today_, ids, dates, nSamples_, depth, 0.0);
+    else
+        return boost::make_shared<SinglePrecisionSharedMemoryCube>(today_, ids, dates, nSamples_, depth, 0.0f);
+}
+
+void MultiProcessValuationEngine::runWorker(
+    Size id, const std::string& portfolioXml,
+    const std::function<std::vector<boost::shared_ptr<ore::analytics::ValuationCalculator>>()>& calculators,
+    const std::function<std::vector<boost::shared_ptr<ore::analytics::CounterpartyCalculator>>()>& cptyCalculators,
+    bool mporStickyDate, bool dryRun, const boost::shared_ptr<AggregationScenarioData>& aggregationScenarioData) {
+
+    QuantLib::Settings::instance().evaluationDate() = today_;
+
+    // the worker has its own copy of the scenario generator, start from the first path
+
+    scenarioGenerator_->reset();
+
+    // build todays market
+
+    boost::shared_ptr<ore::data::Market> initMarket = boost::make_shared<ore::data::TodaysMarket>(
+        today_, todaysMarketParams_, loader_, curveConfigs_, true, true, true, referenceData_, false,
+        iborFallbackConfig_, false, handlePseudoCurrenciesTodaysMarket_);
+
+    // build sim market
+
+    boost::shared_ptr<ore::analytics::ScenarioSimMarket> simMarket =
+        boost::make_shared<ore::analytics::ScenarioSimMarketPlus>(
+            initMarket, simMarketData_, configuration_, *curveConfigs_, *todaysMarketParams_, true,
+            useSpreadedTermStructures_, cacheSimData_, false, iborFallbackConfig_, handlePseudoCurrenciesSimMarket_);
+    simMarket->scenarioGenerator() = scenarioGenerator_;
+    if (scenarioFilter_)
+        simMarket->filter() = scenarioFilter_;
+    if (aggregationScenarioData)
+        simMarket->aggregationScenarioData() = aggregationScenarioData;
+
+    // build portfolio against sim market
+
+    auto portfolio = boost::make_shared<ore::data::Portfolio>();
+    portfolio->fromXMLString(portfolioXml);
+    auto engineFactory = boost::make_shared<ore::data::EngineFactory>(
+        engineData_, simMarket, std::map<ore::data::MarketContext, string>(), referenceData_, iborFallbackConfig_);
+    portfolio->build(engineFactory, context_, true);
+
+    // build the mini-cube in shared memory
+
+    auto valEngine = boost::make_shared<ore::analytics::ValuationEngine>(today_, dateGrid_, simMarket,
+                                                                         engineFactory->modelBuilders());
+    valEngine->buildCube(portfolio, miniCubes_[id], calculators(), mporStickyDate, nullptr, miniCptyCubes_[id],
+                         cptyCalculators ? cptyCalculators()
+                                         : std::vector<boost::shared_ptr<CounterpartyCalculator>>(),
+                         dryRun);
+}
+
+void MultiProcessValuationEngine::buildCube(
+    const boost::shared_ptr<ore::data::Portfolio>& portfolio,
+    const std::function<std::vector<boost::shared_ptr<ore::analytics::ValuationCalculator>>()>& calculators,
+    const std::function<std::vector<boost::shared_ptr<ore::analytics::CounterpartyCalculator>>()>& cptyCalculators,
+    bool mporStickyDate, bool dryRun) {
+
+#if defined(_WIN32) || defined(_WIN64)
+    QL_FAIL("MultiProcessValuationEngine is not supported on this platform.");
+#else
+
+    boost::timer::cpu_timer timer;
+
+    LOG("MultiProcessValuationEngine::buildCube() was called");
+
+    // split the portfolio into nProcesses parts, the trades are distributed round robin in the order of their
+    // average pricing time if available, so that each part gets a similar share of expensive trades
+
+    Size eff_nProcesses = std::min(portfolio->size(), nProcesses_);
+
+    LOG("portfolio size = " << portfolio->size());
+    LOG("nProcesses     = " << nProcesses_);
+    LOG("eff nProcesses = " << eff_nProcesses);
+
+    QL_REQUIRE(eff_nProcesses > 0, "effective processes are zero, this is not allowed.");
+
+    std::vector<std::pair<std::string, double>> timings;
+    for (auto const& [tid, t] : portfolio->trades()) {
+        timings.push_back(std::make_pair(
+            tid, t->getNumberOfPricings() != 0
+                     ? t->getCumulativePricingTime() / static_cast<double>(t->getNumberOfPricings())
+                     : 0.0));
+    }
+    std::stable_sort(timings.begin(), timings.end(),
+                     [](const std::pair<std::string, double>& p1, const std::pair<std::string, double>& p2) {
+                         return p1.second > p2.second;
+                     });
+
+    std::vector<boost::shared_ptr<ore::data::Portfolio>> portfolios;
+    for (Size i = 0; i < eff_nProcesses; ++i)
+        portfolios.push_back(boost::make_shared<ore::data::Portfolio>());
+    for (Size i = 0; i < timings.size(); ++i)
+        portfolios[i % eff_nProcesses]->add(portfolio->get(timings[i].first));
+
+    std::vector<std::string> portfoliosAsString;
+    for (auto const& p : portfolios)
+        portfoliosAsString.emplace_back(p->toXMLString());
+
+    // build the mini-cubes in shared memory before forking, so that the workers can write to them
+
+    LOG("Build " << eff_nProcesses << " mini result cubes in shared memory...");
+    miniCubes_.clear();
+    miniCptyCubes_.clear();
+    for (Size i = 0; i < eff_nProcesses; ++i) {
+        LOG("Portfolio #" << i << " number of trades : " << portfolios[i]->size());
+        miniCubes_.push_back(createCube(portfolios[i]->ids(), dateGrid_->valuationDates(), cubeDepth_));
+        if (cptyCubes_) {
+            auto ids = portfolios[i]->counterparties();
+            if (!dvaName_.empty())
+                ids.insert(dvaName_);
+            miniCptyCubes_.push_back(createCube(ids, dateGrid_->dates(), 1));
+        } else {
+            miniCptyCubes_.push_back(nullptr);
+        }
+    }
+
+    /* the first worker writes the aggregation scenario data to shared memory, which is copied to the given container
+       once the workers are done, all workers simulate the same paths */
+
+    boost::shared_ptr<AggregationScenarioData> sharedAggregationScenarioData;
+    if (aggregationScenarioData_) {
+        sharedAggregationScenarioData = boost::make_shared<SharedMemoryAggregationScenarioData>(
+            aggregationScenarioData_->dimDates(), aggregationScenarioData_->dimSamples(),
+            aggregationScenarioDataKeys(*simMarketData_));
+    }
+
+    // fork the workers
+
+    std::vector<pid_t> pids;
+    std::string forkError;
+    for (Size i = 0; i < eff_nProcesses; ++i) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            forkError = std::strerror(errno);
+            break;
+        }
+        if (pid == 0) {
+            // worker process, never returns
+            int rc = 1;
+            try {
+                ore::data::Log::instance().setPid(static_cast<int>(getpid()));
+                LOG("Start worker process " << i);
+                runWorker(i, portfoliosAsString[i], calculators, cptyCalculators, mporStickyDate, dryRun,
+                          i == 0 ? sharedAggregationScenarioData : nullptr);
+                LOG("Worker process " << i << " successfully finished.");
+                rc = 0;
+            } catch (const std::exception& e) {
+                ALOG(ore::analytics::StructuredAnalyticsErrorMessage("Multiprocess Valuation Engine", "", e.what()));
+            } catch (...) {
+                ALOG(ore::analytics::StructuredAnalyticsErrorMessage("Multiprocess Valuation Engine", "",
+                                                                     "unknown error"));
+            }
+            _exit(rc);
+        }
+        DLOG("Forked worker process " << i << " with pid " << pid);
+        pids.push_back(pid);
+    }
+
+    // wait for the workers, a worker that crashed does not affect the others
+
+    std::vector<std::string> errors;
+    if (!forkError.empty())
+        errors.push_back("fork failed after " + std::to_string(pids.size()) + " processes: " + forkError);
+    for (Size i = 0; i < pids.size(); ++i) {
+        int status = 0;
+        pid_t rc;
+        do {
+            rc = waitpid(pids[i], &status, 0);
+        } while (rc < 0 && errno == EINTR);
+        if (rc < 0)
+            errors.push_back("waitpid failed for process " + std::to_string(i) + ": " + std::strerror(errno));
+        else if (WIFSIGNALED(status))
+            errors.push_back("process " + std::to_string(i) + " was terminated by signal " +
+                             std::to_string(WTERMSIG(status)));
+        else if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+            errors.push_back("process " + std::to_string(i) + " exited with return code " +
+                             std::to_string(WIFEXITED(status) ? WEXITSTATUS(status) : -1));
+        updateProgress(i + 1, eff_nProcesses);
+    }
+
+    if (!errors.empty()) {
+        std::ostringstream msg;
+        for (auto const& e : errors)
+            msg << (msg.tellp() > 0 ? "; " : "") << e;
+        QL_FAIL("MultiProcessValuationEngine: " << msg.str()
+                                                << ". Check for structured errors from 'Multiprocess Valuation Engine'.");
+    }
+
+    if (sharedAggregationScenarioData) {
+        for (auto const& [type, qualifier] : sharedAggregationScenarioData->keys()) {
+            for (Size d = 0; d < sharedAggregationScenarioData->dimDates(); ++d) {
+                for (Size s = 0; s < sharedAggregationScenarioData->dimSamples(); ++s)
+                    aggregationScenarioData_->set(d, s, sharedAggregationScenarioData->get(d, s, type, qualifier),
+                                                  type, qualifier);
+            }
+        }
+    }
+
+    LOG("MultiProcessValuationEngine::buildCube() successfully finished, timings: "
+        << static_cast<double>(timer.elapsed().wall) / 1.0E9 << "s Wall, "
+        << static_cast<double>(timer.elapsed().user) / 1.0E9 << "s User, "
+        << static_cast<double>(timer.elapsed().system) / 1.0E9 << "s System.");
+#endif
+}
+
+} // namespace analytics
+} // namespace ore
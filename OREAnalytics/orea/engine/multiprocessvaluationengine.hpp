@@ -0,0 +1,132 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file engine/multiprocessvaluationengine.hpp
+    \brief multi-process valuation engine
+    \ingroup engine
+*/
+
+#pragma once
+
+#include <orea/engine/valuationengine.hpp>
+#include <orea/scenario/aggregationscenariodata.hpp>
+#include <orea/scenario/scenariogenerator.hpp>
+#include <orea/scenario/scenariosimmarket.hpp>
+#include <orea/scenario/scenariosimmarketparameters.hpp>
+
+#include <ored/configuration/curveconfigurations.hpp>
+#include <ored/marketdata/loader.hpp>
+
+namespace ore {
+namespace analytics {
+
+//! Valuation engine building the cube in forked worker processes
+/*! The portfolio is split into nProcesses slices. For each slice a mini-cube is allocated in shared memory (see
+    SharedMemoryCube) and a worker process is forked, which builds today's market, the simulation market and the
+    slice portfolio and runs a ValuationEngine writing directly into the mini-cube. The mini-cubes can be joined
+    without copying using a JointNPVCube.
+
+    In contrast to the MultiThreadedValuationEngine no QL_ENABLE_SESSIONS build is required, the workers do not share
+    singletons, observers or allocators and an abnormal termination of a worker (e.g. a crash in a pricer) is reported
+    as an error in the calling process. The engine is only available on POSIX systems and buildCube() should be
+    called while no other threads are running in the calling process. If aggregation scenario data is set, the first
+    worker writes it to shared memory and the calling process copies it into the given container. */
+class MultiProcessValuationEngine : public ore::data::ProgressReporter {
+public:
+    MultiProcessValuationEngine(
+        const QuantLib::Size nProcesses, const QuantLib::Date& today,
+        const boost::shared_ptr<ore::analytics::DateGrid>& dateGrid, const QuantLib::Size nSamples,
+        const boost::shared_ptr<ore::data::Loader>& loader,
+        const boost::shared_ptr<ore::analytics::ScenarioGenerator>& scenarioGenerator,
+        const boost::shared_ptr<ore::data::EngineData>& engineData,
+        const boost::shared_ptr<ore::data::CurveConfigurations>& curveConfigs,
+        const boost::shared_ptr<ore::data::TodaysMarketParameters>& todaysMarketParams,
+        const std::string& configuration,
+        const boost::shared_ptr<ore::analytics::ScenarioSimMarketParameters>& simMarketData,
+        const bool useSpreadedTermStructures = false, const bool cacheSimData = false,
+        const boost::shared_ptr<ore::analytics::ScenarioFilter>& scenarioFilter =
+            boost::make_shared<ore::analytics::ScenarioFilter>(),
+        const boost::shared_ptr<ore::data::ReferenceDataManager>& referenceData = nullptr,
+        const ore::data::IborFallbackConfig& iborFallbackConfig = ore::data::IborFallbackConfig::defaultConfig(),
+        const bool handlePseudoCurrenciesTodaysMarket = true, const bool handlePseudoCurrenciesSimMarket = true,
+        const QuantLib::Size cubeDepth = 1, const bool doublePrecision = false, const bool cptyCubes = false,
+        const std::string& dvaName = "", const std::string& context = "unspecified");
+
+    // can be optionally called to set the agg scen data (which is done in the ssm for single-threaded runs)
+    void setAggregationScenarioData(const boost::shared_ptr<AggregationScenarioData>& aggregationScenarioData);
+
+    /* analoguous to buildCube() in the multi-threaded engine, results are retrieved using below methods
+       if no cptyCalculators is given a function returning an empty vector of calculators will be used */
+    void
+    buildCube(const boost::shared_ptr<ore::data::Portfolio>& portfolio,
+              const std::function<std::vector<boost::shared_ptr<ore::analytics::ValuationCalculator>>()>& calculators,
+              const std::function<std::vector<boost::shared_ptr<ore::analytics::CounterpartyCalculator>>()>&
+                  cptyCalculators = {},
+              bool mporStickyDate = true, bool dryRun = false);
+
+    // result output cubes (mini-cubes in shared memory, one per process)
+    std::vector<boost::shared_ptr<ore::analytics::NPVCube>> outputCubes() const { return miniCubes_; }
+
+    // result cpty cubes (null, if cptyCubes is false), the ids are the slice counterparties and the dva name
+    std::vector<boost::shared_ptr<ore::analytics::NPVCube>> outputCptyCubes() const { return miniCptyCubes_; }
+
+private:
+    // build and run the valuation engine for slice id, called in the worker process
+    void runWorker(Size id, const std::string& portfolioXml,
+                   const std::function<std::vector<boost::shared_ptr<ore::analytics::ValuationCalculator>>()>&
+                       calculators,
+                   const std::function<std::vector<boost::shared_ptr<ore::analytics::CounterpartyCalculator>>()>&
+                       cptyCalculators,
+                   bool mporStickyDate, bool dryRun,
+                   const boost::shared_ptr<AggregationScenarioData>& aggregationScenarioData);
+
+    boost::shared_ptr<ore::analytics::NPVCube> createCube(const std::set<std::string>& ids,
+                                                         const std::vector<QuantLib::Date>& dates, Size depth) const;
+
+    QuantLib::Size nProcesses_;
+    QuantLib::Date today_;
+    boost::shared_ptr<ore::data::DateGrid> dateGrid_;
+    QuantLib::Size nSamples_;
+    boost::shared_ptr<ore::data::Loader> loader_;
+    boost::shared_ptr<ore::analytics::ScenarioGenerator> scenarioGenerator_;
+    boost::shared_ptr<ore::data::EngineData> engineData_;
+    boost::shared_ptr<ore::data::CurveConfigurations> curveConfigs_;
+    boost::shared_ptr<ore::data::TodaysMarketParameters> todaysMarketParams_;
+    std::string configuration_;
+    boost::shared_ptr<ore::analytics::ScenarioSimMarketParameters> simMarketData_;
+    bool useSpreadedTermStructures_;
+    bool cacheSimData_;
+    boost::shared_ptr<ore::analytics::ScenarioFilter> scenarioFilter_;
+    boost::shared_ptr<ore::data::ReferenceDataManager> referenceData_;
+    ore::data::IborFallbackConfig iborFallbackConfig_;
+    bool handlePseudoCurrenciesTodaysMarket_;
+    bool handlePseudoCurrenciesSimMarket_;
+    QuantLib::Size cubeDepth_;
+    bool doublePrecision_;
+    bool cptyCubes_;
+    std::string dvaName_;
+    std::string context_;
+
+    boost::shared_ptr<AggregationScenarioData> aggregationScenarioData_;
+
+    std::vector<boost::shared_ptr<ore::analytics::NPVCube>> miniCubes_;
+    std::vector<boost::shared_ptr<ore::analytics::NPVCube>> miniCptyCubes_;
+};
+
+} // namespace analytics
+} // namespace ore
@@ -23,6 +23,7 @@
 #include <orea/app/structuredanalyticserror.hpp>
 #include <orea/cube/inmemorycube.hpp>
 #include <orea/engine/observationmode.hpp>
+#include <orea/engine/pricingprofiler.hpp>
 #include <orea/scenario/clonedscenariogenerator.hpp>
 
 #include <ored/marketdata/clonedloader.hpp>
@@ -254,17 +255,25 @@ void MultiThreadedValuationEngine::buildCube(
     std::vector<std::map<std::string, std::pair<std::size_t, boost::timer::nanosecond_type>>> workerPricingStats(
         eff_nThreads);
 
+    // pricing profiles collected in worker threads
+    std::vector<PricingProfile> workerProfiles(eff_nThreads);
+
     // get obs mode of main thread, so that we can set this mode in the worker threads below
     ore::analytics::ObservationMode::Mode obsMode = ore::analytics::ObservationMode::instance().mode();
 
+    // same for the profiling switch
+    bool profiling = PricingProfiler::instance().enabled();
+
     for (Size i = 0; i < eff_nThreads; ++i) {
 
-        auto job = [this, obsMode, dryRun, &calculators, &cptyCalculators, mporStickyDate, &portfoliosAsString,
-                    &scenarioGenerators, &loaders, &workerPricingStats, &progressIndicator](int id) -> resultType {
+        auto job = [this, obsMode, profiling, dryRun, &calculators, &cptyCalculators, mporStickyDate,
+                    &portfoliosAsString, &scenarioGenerators, &loaders, &workerPricingStats, &workerProfiles,
+                    &progressIndicator](int id) -> resultType {
             // set thread local singletons
 
             QuantLib::Settings::instance().evaluationDate() = today_;
             ore::analytics::ObservationMode::instance().setMode(obsMode);
+            PricingProfiler::instance().setEnabled(profiling);
 
             LOG("Start thread " << id);
 
@@ -330,6 +339,8 @@ void MultiThreadedValuationEngine::buildCube(
                     workerPricingStats[id][tid] =
                         std::make_pair(t->getNumberOfPricings(), t->getCumulativePricingTime());
 
+                workerProfiles[id] = valEngine->pricingProfile();
+
                 // return code 0 = ok
 
                 LOG("Thread " << id << " successfully finished.");
@@ -398,6 +409,16 @@ void MultiThreadedValuationEngine::buildCube(
         t->resetPricingStats(n, d);
     }
 
+    // add the worker pricing profiles to the profile of the main thread
+
+    if (profiling) {
+        PricingProfile profile;
+        for (auto const& p : workerProfiles)
+            profile.merge(p);
+        profile.log("MultiThreadedValuationEngine");
+        PricingProfiler::instance().add(profile);
+    }
+
     // log timings and return the result mini-cubes
 
     LOG("MultiThreadedValuationEngine::buildCube() successfully finished, timings: "
@@ -41,7 +41,9 @@ private:
 
 public:
     //! Allowable mode mode
-    enum class Mode { None, Disable, Defer, Unregister };
+    /*! In mode Targeted the scenario sim market applies scenarios with notifications disabled and then updates only
+        the term structures built on the sim data quotes that changed, see ScenarioSimMarket::updateScenario() */
+    enum class Mode { None, Disable, Defer, Unregister, Targeted };
 
     Mode mode() { return mode_; }
 
@@ -56,6 +58,8 @@ public:
             mode_ = Mode::Defer;
         else if (s == "Unregister")
             mode_ = Mode::Unregister;
+        else if (s == "Targeted")
+            mode_ = Mode::Targeted;
         else {
             QL_FAIL("Invalid ObserverMode string " << s);
         }
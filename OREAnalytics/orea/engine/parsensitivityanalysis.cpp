@@ -23,12 +23,14 @@
 #include <orea/app/structuredanalyticserror.hpp>
 #include <orea/engine/observationmode.hpp>
 #include <orea/engine/valuationengine.hpp>
+#include <orea/scenario/scenario.hpp>
 #include <orea/scenario/simplescenariofactory.hpp>
 #include <orea/scenario/sensitivityscenariodata.hpp>
 #include <orea/engine/parsensitivityanalysis.hpp>
 #include <ored/utilities/indexparser.hpp>
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/marketdata.hpp>
+#include <ored/utilities/parsers.hpp>
 #include <ored/utilities/to_string.hpp>
 #include <ored/marketdata/inflationcurve.hpp>
 #include <ql/cashflows/indexedcashflow.hpp>
@@ -64,6 +66,13 @@
 #include <qle/pricingengines/inflationcapfloorengines.hpp>
 #include <qle/math/blockmatrixinverse.hpp>
 
+#include <boost/algorithm/string.hpp>
+
+#include <atomic>
+#include <exception>
+#include <fstream>
+#include <future>
+
 using namespace QuantLib;
 using namespace QuantExt;
 using namespace std;
@@ -692,9 +701,58 @@ void writeSensitivity(const RiskFactorKey& a, const RiskFactorKey& b, const Real
     parSensi[std::make_pair(a, b)] = value;
     DLOG("ParInstrument Sensi " << a << " w.r.t. " << b << " " << setprecision(6) << value);
 }
+
+// remove todays fixings from relevant indices for the lifetime of this object
+struct TodaysFixingsRemover {
+    TodaysFixingsRemover(const std::set<std::string>& names) : today_(Settings::instance().evaluationDate()) {
+        Date today = Settings::instance().evaluationDate();
+        for (auto const& n : names) {
+            TimeSeries<Real> t = IndexManager::instance().getHistory(n);
+            if (t[today] != Null<Real>()) {
+                DLOG("removing todays fixing (" << std::setprecision(6) << t[today] << ") from " << n);
+                savedFixings_.insert(std::make_pair(n, t[today]));
+                t[today] = Null<Real>();
+                IndexManager::instance().setHistory(n, t);
+            }
+        }
+    }
+    ~TodaysFixingsRemover() {
+        for (auto const& p : savedFixings_) {
+            TimeSeries<Real> t = IndexManager::instance().getHistory(p.first);
+            t[today_] = p.second;
+            IndexManager::instance().setHistory(p.first, t);
+            DLOG("restored todays fixing (" << std::setprecision(6) << p.second << ") for " << p.first);
+        }
+    }
+    const Date today_;
+    std::set<std::pair<std::string, Real>> savedFixings_;
+};
+
+boost::shared_ptr<ShiftScenarioGenerator> shiftScenarioGenerator(const boost::shared_ptr<ScenarioSimMarket>& simMarket) {
+    auto scenarioGenerator = boost::dynamic_pointer_cast<ShiftScenarioGenerator>(simMarket->scenarioGenerator());
+    QL_REQUIRE(scenarioGenerator, "ParSensitivityAnalysis: sim market requires a ShiftScenarioGenerator");
+    return scenarioGenerator;
+}
+
+// the par sensitivities, par and raw keys with non-zero entries computed by one thread
+struct ParSensitivityResults {
+    ParSensitivityAnalysis::ParContainer parSensi;
+    std::set<RiskFactorKey> parKeysNonZero, rawKeysNonZero;
+};
+
+// the configured shift type and size of a raw risk factor, the par sensitivities in the Jacobi cache depend on them
+std::pair<std::string, Real> configuredShift(const SensitivityScenarioData& data, const RiskFactorKey& key) {
+    const auto& shiftData = data.shiftData(key.keytype, key.name);
+    return std::make_pair(shiftData.shiftType, shiftData.shiftSize);
+}
 } // namespace
 
 void ParSensitivityAnalysis::computeParInstrumentSensitivities(const boost::shared_ptr<ScenarioSimMarket>& simMarket) {
+    computeParInstrumentSensitivities(1, [&simMarket](Size) { return simMarket; });
+}
+
+void ParSensitivityAnalysis::computeParInstrumentSensitivities(
+    Size nThreads, const std::function<boost::shared_ptr<ScenarioSimMarket>(Size)>& simMarketBuilder) {
 
     LOG("Cache base scenario par rates and flat vols");
 
@@ -706,37 +764,21 @@ void ParSensitivityAnalysis::computeParInstrumentSensitivities(const boost::shar
             DLOG("Relevant risk factor " << rf);
     }
 
+#ifndef QL_ENABLE_SESSIONS
+    if (nThreads > 1) {
+        WLOG("ParSensitivityAnalysis: multi-threaded computation requires a build with QL_ENABLE_SESSIONS = ON, "
+             "using one thread");
+        nThreads = 1;
+    }
+#endif
+
+    boost::shared_ptr<ScenarioSimMarket> simMarket = simMarketBuilder(0);
+
     // remove todays fixings from relevant indices for the scope of this method
-    struct TodaysFixingsRemover {
-        TodaysFixingsRemover(const std::set<std::string>& names) : today_(Settings::instance().evaluationDate()) {
-            Date today = Settings::instance().evaluationDate();
-            for (auto const& n : names) {
-                TimeSeries<Real> t = IndexManager::instance().getHistory(n);
-                if (t[today] != Null<Real>()) {
-                    DLOG("removing todays fixing (" << std::setprecision(6) << t[today] << ") from " << n);
-                    savedFixings_.insert(std::make_pair(n, t[today]));
-                    t[today] = Null<Real>();
-                    IndexManager::instance().setHistory(n, t);
-                }
-            }
-        }
-        ~TodaysFixingsRemover() {
-            for (auto const& p : savedFixings_) {
-                TimeSeries<Real> t = IndexManager::instance().getHistory(p.first);
-                t[today_] = p.second;
-                IndexManager::instance().setHistory(p.first, t);
-                DLOG("restored todays fixing (" << std::setprecision(6) << p.second << ") for " << p.first);
-            }
-        }
-        const Date today_;
-        std::set<std::pair<std::string, Real>> savedFixings_;
-    };
     TodaysFixingsRemover fixingRemover(removeTodaysFixingIndices_);
 
     // We must have a ShiftScenarioGenerator
-    boost::shared_ptr<ScenarioGenerator> simMarketScenGen = simMarket->scenarioGenerator();
-    boost::shared_ptr<ShiftScenarioGenerator> scenarioGenerator = 
-        boost::dynamic_pointer_cast<ShiftScenarioGenerator>(simMarketScenGen);
+    boost::shared_ptr<ShiftScenarioGenerator> scenarioGenerator = shiftScenarioGenerator(simMarket);
     
     simMarket->reset();
     scenarioGenerator->reset();
@@ -747,6 +789,177 @@ void ParSensitivityAnalysis::computeParInstrumentSensitivities(const boost::shar
     createParInstruments(simMarket);
 
     map<RiskFactorKey, Real> parRatesBase, parCapVols; // for both ir and yoy caps
+    computeBaseValues(simMarket, parRatesBase, parCapVols);
+
+    LOG("Caching base scenario par rates and float vols done.");
+
+    /****************************************************************
+     * Discount curve instrument fair rate sensitivity to zero shifts
+     * Index curve instrument fair rate sensitivity to zero shifts
+     * Cap/Floor flat vol sensitivity to optionlet vol shifts
+     *
+     * Step 3:
+     * - Apply all single up-shift scenarios,
+     * - Compute respective fair par rates and flat vols
+     * - Compute par rate / flat vol sensitivities
+     */
+    LOG("Compute par rate and flat vol sensitivities");
+
+    vector<ShiftScenarioGenerator::ScenarioDescription> desc = scenarioGenerator->scenarioDescriptions();
+    QL_REQUIRE(desc.size() == scenarioGenerator->samples(), "descriptions size " << desc.size() <<
+        " does not match samples " << scenarioGenerator->samples());
+
+    std::set<RiskFactorKey> parKeysCheck, parKeysNonZero;
+    std::set<RiskFactorKey> rawKeysCheck, rawKeysNonZero;
+
+    for (auto const& p : parHelpers_) {
+	parKeysCheck.insert(p.first);
+    }
+
+    for(auto const& p: parCaps_) {
+	parKeysCheck.insert(p.first);
+    }
+
+    for(auto const& p: parYoYCaps_) {
+	parKeysCheck.insert(p.first);
+    }
+
+    // collect the relevant scenarios grouped by curve, each group is processed as one task
+
+    std::vector<std::vector<Size>> tasks;
+    std::map<std::pair<RiskFactorKey::KeyType, std::string>, Size> taskIndex;
+    for (Size i = 1; i < scenarioGenerator->samples(); ++i) {
+
+        // use single "UP" shift scenarios only, use only scenarios relevant for par instruments,
+        // use relevant scenarios only, if specified
+        // ignore risk factor types that have been disabled
+        if (desc[i].type() != ShiftScenarioGenerator::ScenarioDescription::Type::Up ||
+            !isParType(desc[i].key1().keytype) || typesDisabled_.count(desc[i].key1().keytype) == 1 ||
+            !(relevantRiskFactors_.empty() || relevantRiskFactors_.find(desc[i].key1()) != relevantRiskFactors_.end()))
+            continue;
+
+        rawKeysCheck.insert(desc[i].key1());
+
+        auto t = taskIndex.insert(
+            std::make_pair(std::make_pair(desc[i].key1().keytype, desc[i].key1().name), tasks.size()));
+        if (t.second)
+            tasks.push_back(std::vector<Size>());
+        tasks[t.first->second].push_back(i);
+    }
+
+    // reuse the cached par sensitivities if the base values are close enough to the cached ones
+
+    std::map<RiskFactorKey, Real> baseValues(parRatesBase);
+    baseValues.insert(parCapVols.begin(), parCapVols.end());
+    jacobiFromCache_ = !jacobiCacheFile_.empty() && readJacobiCache(baseValues, rawKeysCheck);
+    if (jacobiFromCache_) {
+        LOG("Par rate and flat vol sensitivities read from " << jacobiCacheFile_);
+        return;
+    }
+
+    // process the tasks, the scenario generator is moved forward to the scenarios of a task without applying the
+    // scenarios in between. This relies on the delta scenarios being applied relative to the base scenario: a
+    // ScenarioSimMarketPlus resets the quotes shifted by the previously applied scenario to their base values, and a
+    // plain ScenarioSimMarket sets all quotes, since a delta scenario has the keys of its base scenario
+
+    std::atomic<Size> nextTask(0);
+    auto processTasks = [this, &tasks, &nextTask, &desc](
+                            ParSensitivityAnalysis& analysis, const boost::shared_ptr<ScenarioSimMarket>& market,
+                            const boost::shared_ptr<ShiftScenarioGenerator>& generator,
+                            const std::map<RiskFactorKey, Real>& ratesBase, const std::map<RiskFactorKey, Real>& capVols,
+                            ParSensitivityResults& results) {
+        Size pos = 1; // the base scenario was applied
+        for (Size t = nextTask++; t < tasks.size(); t = nextTask++) {
+            for (auto i : tasks[t]) {
+                if (pos > i) {
+                    generator->reset();
+                    pos = 0;
+                }
+                for (; pos < i; ++pos)
+                    generator->next(asof_);
+                market->update(asof_);
+                ++pos;
+                analysis.computeScenarioSensitivities(market, desc[i].key1(), ratesBase, capVols, results.parSensi,
+                                                      results.parKeysNonZero, results.rawKeysNonZero);
+            }
+        }
+    };
+
+    nThreads = std::max<Size>(std::min(nThreads, tasks.size()), 1);
+    std::vector<ParSensitivityResults> results(nThreads);
+    std::vector<std::exception_ptr> errors(nThreads);
+
+    // the worker threads reprice copies of the par instruments on their own sim markets
+
+    ObservationMode::Mode obsMode = ObservationMode::instance().mode();
+    auto worker = [this, &simMarketBuilder, &processTasks, &results, &errors, obsMode](Size id) {
+        Settings::instance().evaluationDate() = asof_;
+        ObservationMode::instance().setMode(obsMode);
+        try {
+            boost::shared_ptr<ScenarioSimMarket> market = simMarketBuilder(id);
+            TodaysFixingsRemover remover(removeTodaysFixingIndices_);
+            boost::shared_ptr<ShiftScenarioGenerator> generator = shiftScenarioGenerator(market);
+            market->reset();
+            generator->reset();
+            market->update(asof_);
+            ParSensitivityAnalysis analysis(*this);
+            analysis.createParInstruments(market);
+            map<RiskFactorKey, Real> ratesBase, capVols;
+            analysis.computeBaseValues(market, ratesBase, capVols);
+            processTasks(analysis, market, generator, ratesBase, capVols, results[id]);
+        } catch (...) {
+            errors[id] = std::current_exception();
+        }
+    };
+
+    if (nThreads > 1)
+        LOG("Process " << tasks.size() << " curves on " << nThreads << " threads");
+    std::vector<std::future<void>> workers;
+    for (Size id = 1; id < nThreads; ++id)
+        workers.push_back(std::async(std::launch::async, worker, id));
+    try {
+        processTasks(*this, simMarket, scenarioGenerator, parRatesBase, parCapVols, results[0]);
+    } catch (...) {
+        errors[0] = std::current_exception();
+    }
+    for (auto& w : workers)
+        w.get();
+    for (auto const& e : errors)
+        if (e)
+            std::rethrow_exception(e);
+
+    for (auto const& r : results) {
+        for (auto const& s : r.parSensi)
+            parSensi_[s.first] = s.second;
+        parKeysNonZero.insert(r.parKeysNonZero.begin(), r.parKeysNonZero.end());
+        rawKeysNonZero.insert(r.rawKeysNonZero.begin(), r.rawKeysNonZero.end());
+    }
+
+    // check for
+    // a) par instruments which have no sensitivity to any of the risk factors
+    // b) risk factors w.r.t. which no par instrument has a sensitivity
+    std::set<RiskFactorKey> parKeysZero, rawKeysZero;
+    std::set_difference(parKeysCheck.begin(), parKeysCheck.end(), parKeysNonZero.begin(), parKeysNonZero.end(),
+                        std::inserter(parKeysZero, parKeysZero.begin()));
+    std::set_difference(rawKeysCheck.begin(), rawKeysCheck.end(), rawKeysNonZero.begin(), rawKeysNonZero.end(),
+                        std::inserter(rawKeysZero, rawKeysZero.begin()));
+    for (auto const& k : parKeysZero) {
+        WLOG("Found par instrument which has no sensitivity to any of the risk factors: \"" << k << "\"");
+    }
+    for (auto const& k : rawKeysZero) {
+        WLOG("Found risk factor w.r.t. which no par instrument has a sensitivity: \"" << k << "\"");
+    }
+
+    if (!jacobiCacheFile_.empty())
+        writeJacobiCache(baseValues, rawKeysCheck);
+
+    LOG("Computing par rate and flat vol sensitivities done");
+
+} // namespace sensitivity
+
+void ParSensitivityAnalysis::computeBaseValues(const boost::shared_ptr<ScenarioSimMarket>& simMarket,
+                                               map<RiskFactorKey, Real>& parRatesBase,
+                                               map<RiskFactorKey, Real>& parCapVols) {
 
     for (auto& p : parHelpers_) {
         try {
@@ -800,209 +1013,248 @@ void ParSensitivityAnalysis::computeParInstrumentSensitivities(const boost::shar
         // Populate zero and par shift size for the current risk factor
         populateShiftSizes(c.first, parVol, simMarket);
     }
+}
 
-    LOG("Caching base scenario par rates and float vols done.");
+void ParSensitivityAnalysis::computeScenarioSensitivities(const boost::shared_ptr<ScenarioSimMarket>& simMarket,
+                                                          const RiskFactorKey& rawKey,
+                                                          const map<RiskFactorKey, Real>& parRatesBase,
+                                                          const map<RiskFactorKey, Real>& parCapVols,
+                                                          ParContainer& parSensi, set<RiskFactorKey>& parKeysNonZero,
+                                                          set<RiskFactorKey>& rawKeysNonZero) {
 
-    /****************************************************************
-     * Discount curve instrument fair rate sensitivity to zero shifts
-     * Index curve instrument fair rate sensitivity to zero shifts
-     * Cap/Floor flat vol sensitivity to optionlet vol shifts
-     *
-     * Step 3:
-     * - Apply all single up-shift scenarios,
-     * - Compute respective fair par rates and flat vols
-     * - Compute par rate / flat vol sensitivities
-     */
-    LOG("Compute par rate and flat vol sensitivities");
+    // Since we are not using ValuationEngine we need to manually perform the trade updates here
+    // TODO - explore means of utilising valuation engine
+    if (ObservationMode::instance().mode() == ObservationMode::Mode::Disable) {
+        for (auto it : parHelpers_)
+            it.second->deepUpdate();
+        for (auto it : parCaps_)
+            it.second->deepUpdate();
+        for (auto it : parYoYCaps_)
+            it.second->deepUpdate();
+    }
 
-    vector<ShiftScenarioGenerator::ScenarioDescription> desc = scenarioGenerator->scenarioDescriptions();
-    QL_REQUIRE(desc.size() == scenarioGenerator->samples(), "descriptions size " << desc.size() <<
-        " does not match samples " << scenarioGenerator->samples());
+    // Get the absolute shift size and skip if close to zero
 
-    std::set<RiskFactorKey> parKeysCheck, parKeysNonZero;
-    std::set<RiskFactorKey> rawKeysCheck, rawKeysNonZero;
+    Real shiftSize = getShiftSize(rawKey, sensitivityData_, simMarket);
 
-    for (auto const& p : parHelpers_) {
-	parKeysCheck.insert(p.first);
+    if (close_enough(shiftSize, 0.0)) {
+        ALOG("Shift size for " << rawKey << " is zero, skipping");
+        return;
     }
 
-    for(auto const& p: parCaps_) {
-	parKeysCheck.insert(p.first);
-    }
+    // process par helpers
 
-    for(auto const& p: parYoYCaps_) {
-	parKeysCheck.insert(p.first);
-    }
-
-    for (Size i = 1; i < scenarioGenerator->samples(); ++i) {
+    for (auto const& p : parHelpers_) {
 
-        simMarket->update(asof_);
+        // skip if par helper has no sensi to zero risk factor (except the special treatment below kicks in)
 
-        // use single "UP" shift scenarios only, use only scenarios relevant for par instruments,
-        // use relevant scenarios only, if specified
-        // ignore risk factor types that have been disabled
-        if (desc[i].type() != ShiftScenarioGenerator::ScenarioDescription::Type::Up ||
-            !isParType(desc[i].key1().keytype) || typesDisabled_.count(desc[i].key1().keytype) == 1 ||
-            !(relevantRiskFactors_.empty() || relevantRiskFactors_.find(desc[i].key1()) != relevantRiskFactors_.end()))
+        if (p.second->isCalculated() &&
+            (p.first.keytype != RiskFactorKey::KeyType::SurvivalProbability || p.first != rawKey))
             continue;
 
-        // Since we are not using ValuationEngine we need to manually perform the trade updates here
-        // TODO - explore means of utilising valuation engine
-        if (ObservationMode::instance().mode() == ObservationMode::Mode::Disable) {
-            for (auto it : parHelpers_)
-                it.second->deepUpdate();
-            for (auto it : parCaps_)
-                it.second->deepUpdate();
-            for (auto it : parYoYCaps_)
-                it.second->deepUpdate();
-        }
+        // compute fair and base quotes
 
-        rawKeysCheck.insert(desc[i].key1());
+        Real fair = impliedQuote(p.second);
+        auto base = parRatesBase.find(p.first);
+        QL_REQUIRE(base != parRatesBase.end(), "internal error: did not find parRatesBase[" << p.first << "]");
 
-        // Get the absolute shift size and skip if close to zero
+        Real tmp = (fair - base->second) / shiftSize;
 
-        Real shiftSize = getShiftSize(desc[i].key1(), sensitivityData_, simMarket);
-
-        if (close_enough(shiftSize, 0.0)) {
-            ALOG("Shift size for " << desc[i].key1() << " is zero, skipping");
-            continue;
-        }
+        // special treatments for certain risk factors
 
-        // process par helpers
+        // for curves with survival probabilities going to zero quickly we might see a sensitivity
+        // that is close to zero, which we sanitise here in order to prevent the Jacobi matrix
+        // getting ill-conditioned or even singular
 
-        for (auto const& p : parHelpers_) {
+        if (p.first.keytype == RiskFactorKey::KeyType::SurvivalProbability && p.first == rawKey &&
+            std::abs(tmp) < 0.01) {
+            WLOG("Setting Diagonal Default Curve Sensi " << p.first << " w.r.t. " << rawKey
+                                                         << " to 0.01 (got " << tmp << ")");
+            tmp = 0.01;
+        }
 
-            // skip if par helper has no sensi to zero risk factor (except the special treatment below kicks in)
+        // YoY diagnoal entries are 1.0
 
-            if (p.second->isCalculated() &&
-                (p.first.keytype != RiskFactorKey::KeyType::SurvivalProbability || p.first != desc[i].key1()))
-                continue;
+        if (p.first.keytype == RiskFactorKey::KeyType::YoYInflationCurve && p.first == rawKey &&
+            close_enough(tmp, 0.0)) {
+            tmp = 1.0;
+        }
 
-            // compute fair and base quotes
+        // write sensitivity
 
-            Real fair = impliedQuote(p.second);
-            auto base = parRatesBase.find(p.first);
-            QL_REQUIRE(base != parRatesBase.end(), "internal error: did not find parRatesBase[" << p.first << "]");
+        writeSensitivity(p.first, rawKey, tmp, parSensi, parKeysNonZero, rawKeysNonZero);
+    }
 
-            Real tmp = (fair - base->second) / shiftSize;
+    // process par caps
 
-            // special treatments for certain risk factors
+    for (auto const& p : parCaps_) {
 
-            // for curves with survival probabilities going to zero quickly we might see a sensitivity
-            // that is close to zero, which we sanitise here in order to prevent the Jacobi matrix
-            // getting ill-conditioned or even singular
+        if (p.second->isCalculated() && p.first != rawKey)
+            continue;
 
-            if (p.first.keytype == RiskFactorKey::KeyType::SurvivalProbability && p.first == desc[i].key1() &&
-                std::abs(tmp) < 0.01) {
-                WLOG("Setting Diagonal Default Curve Sensi " << p.first << " w.r.t. " << desc[i].key1()
-                                                             << " to 0.01 (got " << tmp << ")");
-                tmp = 0.01;
-            }
+        Handle<OptionletVolatilityStructure> ovs = simMarket->capFloorVol(p.first.name, marketConfiguration_);
+        auto yts = parCapsYts_.find(p.first);
+        QL_REQUIRE(yts != parCapsYts_.end(), "internal error: did not find parCapYts[" << p.first << "]");
 
-            // YoY diagnoal entries are 1.0
+        Real price = p.second->NPV();
+        Real fair = impliedVolatility<QuantLib::CapFloor>(*p.second, price, yts->second, 0.01,
+                                                          ovs->volatilityType(), ovs->displacement());
+        auto base = parCapVols.find(p.first);
+        QL_REQUIRE(base != parCapVols.end(), "internal error: did not find parCapVols[" << p.first << "]");
 
-            if (p.first.keytype == RiskFactorKey::KeyType::YoYInflationCurve && p.first == desc[i].key1() &&
-                close_enough(tmp, 0.0)) {
-                tmp = 1.0;
-            }
+        Real tmp = (fair - base->second) / shiftSize;
 
-            // write sensitivity
+        // ensure Jacobi matrix is regular and not (too) ill-conditioned, this is necessary because
+        // a) the shift size used to compute dpar / dzero might be close to zero and / or
+        // b) the implied vol calculation has numerical inaccuracies
 
-            writeSensitivity(p.first, desc[i].key1(), tmp, parSensi_, parKeysNonZero, rawKeysNonZero);
+        if (p.first == rawKey && std::abs(tmp) < 0.01) {
+            WLOG("Setting Diagonal CapFloorVol Sensi " << p.first << " w.r.t. " << rawKey
+                                                       << " to 0.01 (got " << tmp << ")");
+            tmp = 0.01;
         }
 
-        // process par caps
+        // write sensitivity
 
-        for (auto const& p : parCaps_) {
-
-            if (p.second->isCalculated() && p.first != desc[i].key1())
-                continue;
-
-            Handle<OptionletVolatilityStructure> ovs = simMarket->capFloorVol(p.first.name, marketConfiguration_);
-            auto yts = parCapsYts_.find(p.first);
-            QL_REQUIRE(yts != parCapsYts_.end(), "internal error: did not find parCapYts[" << p.first << "]");
-
-            Real price = p.second->NPV();
-            Real fair = impliedVolatility<QuantLib::CapFloor>(*p.second, price, yts->second, 0.01,
-                                                              ovs->volatilityType(), ovs->displacement());
-            auto base = parCapVols.find(p.first);
-            QL_REQUIRE(base != parCapVols.end(), "internal error: did not find parCapVols[" << p.first << "]");
-
-            Real tmp = (fair - base->second) / shiftSize;
+        writeSensitivity(p.first, rawKey, tmp, parSensi, parKeysNonZero, rawKeysNonZero);
+    }
 
-            // ensure Jacobi matrix is regular and not (too) ill-conditioned, this is necessary because
-            // a) the shift size used to compute dpar / dzero might be close to zero and / or
-            // b) the implied vol calculation has numerical inaccuracies
+    // process par yoy caps
 
-            if (p.first == desc[i].key1() && std::abs(tmp) < 0.01) {
-                WLOG("Setting Diagonal CapFloorVol Sensi " << p.first << " w.r.t. " << desc[i].key1()
-                                                           << " to 0.01 (got " << tmp << ")");
-                tmp = 0.01;
-            }
+    for (auto const& p : parYoYCaps_) {
 
-            // write sensitivity
+        if (p.second->isCalculated() && p.first != rawKey)
+            continue;
 
-            writeSensitivity(p.first, desc[i].key1(), tmp, parSensi_, parKeysNonZero, rawKeysNonZero);
+        Handle<QuantExt::YoYOptionletVolatilitySurface> ovs =
+            simMarket->yoyCapFloorVol(p.first.name, marketConfiguration_);
+        auto yts = parYoYCapsYts_.find(p.first);
+        auto index = parYoYCapsIndex_.find(p.first);
+        QL_REQUIRE(yts != parYoYCapsYts_.end(), "internal error: did not find parYoYCapsYts[" << p.first << "]");
+        QL_REQUIRE(index != parYoYCapsIndex_.end(),
+                   "internal error: did not find parYoYCapsIndex[" << p.first << "]");
+
+        Real price = p.second->NPV();
+        Real fair = impliedVolatility<QuantLib::YoYInflationCapFloor, QuantLib::YoYInflationIndex>(
+            *p.second, price, yts->second, 0.01, ovs->volatilityType(), ovs->displacement(), index->second);
+        auto base = parCapVols.find(p.first);
+        QL_REQUIRE(base != parCapVols.end(), "internal error: did not find parCapVols[" << p.first << "]");
+
+        Real tmp = (fair - base->second) / shiftSize;
+
+        // ensure Jacobi matrix is regular and not (too) ill-conditioned, this is necessary because
+        // a) the shift size used to compute dpar / dzero might be close to zero and / or
+        // b) the implied vol calculation has numerical inaccuracies
+
+        if (p.first == rawKey && std::abs(tmp) < 0.01) {
+            WLOG("Setting Diagonal CapFloorVol Sensi " << p.first << " w.r.t. " << rawKey
+                                                       << " to 0.01 (got " << tmp << ")");
+            tmp = 0.01;
         }
 
-        // process par yoy caps
+        // write sensitivity
 
-        for (auto const& p : parYoYCaps_) {
+        writeSensitivity(p.first, rawKey, tmp, parSensi, parKeysNonZero, rawKeysNonZero);
+    }
+}
 
-            if (p.second->isCalculated() && p.first != desc[i].key1())
+bool ParSensitivityAnalysis::readJacobiCache(const map<RiskFactorKey, Real>& baseValues,
+                                             const set<RiskFactorKey>& rawKeys) {
+    std::ifstream file(jacobiCacheFile_);
+    if (!file.is_open()) {
+        LOG("Jacobi cache " << jacobiCacheFile_ << " not found, compute par rate and flat vol sensitivities");
+        return false;
+    }
+    try {
+        Date cachedAsof;
+        map<RiskFactorKey, Real> cachedBaseValues;
+        map<RiskFactorKey, std::pair<std::string, Real>> cachedShifts;
+        ParContainer cachedParSensi;
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.empty() || line[0] == '#')
                 continue;
-
-            Handle<QuantExt::YoYOptionletVolatilitySurface> ovs =
-                simMarket->yoyCapFloorVol(p.first.name, marketConfiguration_);
-            auto yts = parYoYCapsYts_.find(p.first);
-            auto index = parYoYCapsIndex_.find(p.first);
-            QL_REQUIRE(yts != parYoYCapsYts_.end(), "internal error: did not find parYoYCapsYts[" << p.first << "]");
-            QL_REQUIRE(index != parYoYCapsIndex_.end(),
-                       "internal error: did not find parYoYCapsIndex[" << p.first << "]");
-
-            Real price = p.second->NPV();
-            Real fair = impliedVolatility<QuantLib::YoYInflationCapFloor, QuantLib::YoYInflationIndex>(
-                *p.second, price, yts->second, 0.01, ovs->volatilityType(), ovs->displacement(), index->second);
-            auto base = parCapVols.find(p.first);
-            QL_REQUIRE(base != parCapVols.end(), "internal error: did not find parCapVols[" << p.first << "]");
-
-            Real tmp = (fair - base->second) / shiftSize;
-
-            // ensure Jacobi matrix is regular and not (too) ill-conditioned, this is necessary because
-            // a) the shift size used to compute dpar / dzero might be close to zero and / or
-            // b) the implied vol calculation has numerical inaccuracies
-
-            if (p.first == desc[i].key1() && std::abs(tmp) < 0.01) {
-                WLOG("Setting Diagonal CapFloorVol Sensi " << p.first << " w.r.t. " << desc[i].key1()
-                                                           << " to 0.01 (got " << tmp << ")");
-                tmp = 0.01;
+            std::vector<std::string> tokens;
+            boost::split(tokens, line, boost::is_any_of(","));
+            if (tokens[0] == "Asof" && tokens.size() == 2)
+                cachedAsof = parseDate(tokens[1]);
+            else if (tokens[0] == "Base" && tokens.size() == 3)
+                cachedBaseValues[parseRiskFactorKey(tokens[1])] = parseReal(tokens[2]);
+            else if (tokens[0] == "Raw" && tokens.size() == 4)
+                cachedShifts[parseRiskFactorKey(tokens[1])] = std::make_pair(tokens[2], parseReal(tokens[3]));
+            else if (tokens[0] == "Sensi" && tokens.size() == 4)
+                cachedParSensi[std::make_pair(parseRiskFactorKey(tokens[1]), parseRiskFactorKey(tokens[2]))] =
+                    parseReal(tokens[3]);
+            else
+                QL_FAIL("invalid line '" << line << "'");
+        }
+        if (cachedAsof != asof_) {
+            LOG("Jacobi cache was written for asof " << cachedAsof << ", not " << asof_ << ", refresh");
+            return false;
+        }
+        if (cachedShifts.size() != rawKeys.size()) {
+            LOG("Jacobi cache was written for different shift scenarios, refresh");
+            return false;
+        }
+        for (auto const& key : rawKeys) {
+            auto c = cachedShifts.find(key);
+            auto shift = configuredShift(sensitivityData_, key);
+            if (c == cachedShifts.end() || c->second.first != shift.first ||
+                !close_enough(c->second.second, shift.second)) {
+                LOG("Jacobi cache was written for different shift scenarios or shift sizes, refresh");
+                return false;
             }
-
-            // write sensitivity
-
-            writeSensitivity(p.first, desc[i].key1(), tmp, parSensi_, parKeysNonZero, rawKeysNonZero);
         }
+        if (cachedBaseValues.size() != baseValues.size()) {
+            LOG("Jacobi cache was written for different par instruments, refresh");
+            return false;
+        }
+        Real maxDiff = 0.0;
+        for (auto const& [key, value] : baseValues) {
+            auto c = cachedBaseValues.find(key);
+            if (c == cachedBaseValues.end()) {
+                LOG("Jacobi cache was written for different par instruments, refresh");
+                return false;
+            }
+            maxDiff = std::max(maxDiff, std::abs(value - c->second));
+        }
+        if (maxDiff > jacobiCacheTolerance_) {
+            LOG("Par rates and flat vols moved by up to " << maxDiff << " since the Jacobi cache was written, tolerance "
+                                                         << jacobiCacheTolerance_ << ", refresh");
+            return false;
+        }
+        LOG("Par rates and flat vols moved by up to " << maxDiff << " since the Jacobi cache was written, tolerance "
+                                                     << jacobiCacheTolerance_ << ", reuse cached sensitivities");
+        for (auto const& s : cachedParSensi)
+            parSensi_[s.first] = s.second;
+        return true;
+    } catch (const std::exception& e) {
+        WLOG("Could not read Jacobi cache " << jacobiCacheFile_ << ": " << e.what());
+        return false;
+    }
+}
 
-    } // end of loop over samples
-
-    // check for
-    // a) par instruments which have no sensitivity to any of the risk factors
-    // b) risk factors w.r.t. which no par instrument has a sensitivity
-    std::set<RiskFactorKey> parKeysZero, rawKeysZero;
-    std::set_difference(parKeysCheck.begin(), parKeysCheck.end(), parKeysNonZero.begin(), parKeysNonZero.end(),
-                        std::inserter(parKeysZero, parKeysZero.begin()));
-    std::set_difference(rawKeysCheck.begin(), rawKeysCheck.end(), rawKeysNonZero.begin(), rawKeysNonZero.end(),
-                        std::inserter(rawKeysZero, rawKeysZero.begin()));
-    for (auto const& k : parKeysZero) {
-        WLOG("Found par instrument which has no sensitivity to any of the risk factors: \"" << k << "\"");
+void ParSensitivityAnalysis::writeJacobiCache(const map<RiskFactorKey, Real>& baseValues,
+                                              const set<RiskFactorKey>& rawKeys) const {
+    std::ofstream file(jacobiCacheFile_);
+    if (!file.is_open()) {
+        WLOG("Could not write Jacobi cache " << jacobiCacheFile_);
+        return;
     }
-    for (auto const& k : rawKeysZero) {
-        WLOG("Found risk factor w.r.t. which no par instrument has a sensitivity: \"" << k << "\"");
+    file << "#ParSensitivityJacobi\n" << std::setprecision(17);
+    file << "Asof," << to_string(asof_) << "\n";
+    for (auto const& [key, value] : baseValues)
+        file << "Base," << key << "," << value << "\n";
+    for (auto const& key : rawKeys) {
+        auto shift = configuredShift(sensitivityData_, key);
+        file << "Raw," << key << "," << shift.first << "," << shift.second << "\n";
     }
-
-    LOG("Computing par rate and flat vol sensitivities done");
-
-} // namespace sensitivity
+    for (auto const& [keys, value] : parSensi_) {
+        if (rawKeys.count(keys.second) == 1)
+            file << "Sensi," << keys.first << "," << keys.second << "," << value << "\n";
+    }
+    LOG("Par rate and flat vol sensitivities written to " << jacobiCacheFile_);
+}
 
 void ParSensitivityAnalysis::alignPillars() {
     LOG("Align simulation market pillars to actual latest relevant dates of par instruments");
@@ -2127,7 +2379,7 @@ set<RiskFactorKey::KeyType> ParSensitivityAnalysis::parTypes_ = {
 };
 
 ParSensitivityConverter::ParSensitivityConverter(const ParSensitivityAnalysis::ParContainer& parSensitivities,
-    const map<RiskFactorKey, pair<Real, Real>>& shiftSizes) {
+    const map<RiskFactorKey, pair<Real, Real>>& shiftSizes, const std::string& cacheFile) {
     
     // Populate the set of par keys (rows of Jacobi) and raw zero keys (columns of Jacobi)
     for (auto parEntry : parSensitivities) {
@@ -2182,6 +2434,11 @@ ParSensitivityConverter::ParSensitivityConverter(const ParSensitivityAnalysis::P
         << parSensitivities.size() << " ("
         << 100.0 * static_cast<Real>(parSensitivities.size()) / static_cast<Real>(n_par * n_raw) << "%)");
 
+    if (!cacheFile.empty() && readConversionMatrixCache(cacheFile, parSensitivities)) {
+        LOG("Inverse of transposed Jacobi matrix read from " << cacheFile);
+        return;
+    }
+
     LOG("Populating block indices");
     vector<Size> blockIndices;
     pair<RiskFactorKey::KeyType, string> previousGroup(RiskFactorKey::KeyType::None, "");
@@ -2331,6 +2588,64 @@ ParSensitivityConverter::ParSensitivityConverter(const ParSensitivityAnalysis::P
     for (Size j = 0; j < jacobi_transp.size1(); ++j) {
         DLOG(right << setw(7) << j << setw(20) << jacobi_transp(j, j) << setw(20) << jacobi_transp_inv_(j, j));
     }
+
+    if (!cacheFile.empty())
+        writeConversionMatrixCache(cacheFile, parSensitivities);
+}
+
+bool ParSensitivityConverter::readConversionMatrixCache(const std::string& fileName,
+                                                        const ParSensitivityAnalysis::ParContainer& parSensitivities) {
+    std::ifstream file(fileName);
+    if (!file.is_open())
+        return false;
+    try {
+        ParSensitivityAnalysis::ParContainer cachedParSensi;
+        Size n = rawKeys_.size();
+        SparseMatrix inverse(n, n);
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.empty() || line[0] == '#')
+                continue;
+            std::vector<std::string> tokens;
+            boost::split(tokens, line, boost::is_any_of(","));
+            QL_REQUIRE(tokens.size() == 4, "invalid line '" << line << "'");
+            if (tokens[0] == "Jacobi") {
+                cachedParSensi[std::make_pair(parseRiskFactorKey(tokens[1]), parseRiskFactorKey(tokens[2]))] =
+                    parseReal(tokens[3]);
+            } else if (tokens[0] == "Inverse") {
+                Size i = parseInteger(tokens[1]), j = parseInteger(tokens[2]);
+                QL_REQUIRE(i < n && j < n, "inverse entry (" << i << "," << j << ") out of range");
+                inverse(i, j) = parseReal(tokens[3]);
+            } else {
+                QL_FAIL("invalid line '" << line << "'");
+            }
+        }
+        if (cachedParSensi != parSensitivities) {
+            LOG("Conversion matrix cache " << fileName << " was written for a different Jacobi matrix, refresh");
+            return false;
+        }
+        jacobi_transp_inv_ = inverse;
+        return true;
+    } catch (const std::exception& e) {
+        WLOG("Could not read conversion matrix cache " << fileName << ": " << e.what());
+        return false;
+    }
+}
+
+void ParSensitivityConverter::writeConversionMatrixCache(
+    const std::string& fileName, const ParSensitivityAnalysis::ParContainer& parSensitivities) const {
+    std::ofstream file(fileName);
+    if (!file.is_open()) {
+        WLOG("Could not write conversion matrix cache " << fileName);
+        return;
+    }
+    file << "#ParSensitivityConversionMatrix\n" << std::setprecision(17);
+    for (auto const& [keys, value] : parSensitivities)
+        file << "Jacobi," << keys.first << "," << keys.second << "," << value << "\n";
+    for (auto it1 = jacobi_transp_inv_.begin1(); it1 != jacobi_transp_inv_.end1(); ++it1)
+        for (auto it2 = it1.begin(); it2 != it1.end(); ++it2)
+            file << "Inverse," << it2.index1() << "," << it2.index2() << "," << *it2 << "\n";
+    LOG("Inverse of transposed Jacobi matrix written to " << fileName);
 }
 
 boost::numeric::ublas::vector<Real>
@@ -38,6 +38,7 @@
 
 #include <boost/numeric/ublas/vector.hpp>
 
+#include <functional>
 #include <map>
 #include <set>
 #include <tuple>
@@ -71,6 +72,27 @@ public:
     //! Compute par instrument sensitivities
     void computeParInstrumentSensitivities(const boost::shared_ptr<ore::analytics::ScenarioSimMarket>& simMarket);
 
+    /*! Compute par instrument sensitivities on \p nThreads threads. The shift scenarios are grouped by curve and the
+        groups are distributed over the threads. Each thread reprices the par instruments on its own simulation market,
+        which is built by \p simMarketBuilder called in that thread with the thread index (0 being the calling thread).
+        The markets must carry a ShiftScenarioGenerator producing the same scenarios. More than one thread requires a
+        build with QL_ENABLE_SESSIONS = ON, otherwise the computation falls back to the calling thread. */
+    void computeParInstrumentSensitivities(
+        const QuantLib::Size nThreads,
+        const std::function<boost::shared_ptr<ore::analytics::ScenarioSimMarket>(QuantLib::Size)>& simMarketBuilder);
+
+    /*! Reuse the par sensitivities written to \p fileName by an earlier computation. They are reused if they were
+        computed for the same asof, par instruments, shift scenarios and shift sizes and none of the base par rates
+        and flat vols has moved by more than \p tolerance (absolute) since then. Otherwise the par instruments are
+        repriced under the shift scenarios as usual and the file is rewritten. */
+    void setJacobiCache(const std::string& fileName, QuantLib::Real tolerance) {
+        jacobiCacheFile_ = fileName;
+        jacobiCacheTolerance_ = tolerance;
+    }
+
+    //! Were the par sensitivities of the last computation read from the Jacobi cache?
+    bool jacobiFromCache() const { return jacobiFromCache_; }
+
     //! Return computed par sensitivities. Empty if they have not been computed yet.
     const ParContainer& parSensitivities() const {
         return parSensi_;
@@ -108,6 +130,27 @@ private:
     //! Create par instruments
     void createParInstruments(const boost::shared_ptr<ore::analytics::ScenarioSimMarket>& simMarket);
 
+    //! Imply the base par rates and flat vols of the par instruments and populate the shift sizes
+    void computeBaseValues(const boost::shared_ptr<ore::analytics::ScenarioSimMarket>& simMarket,
+                           std::map<ore::analytics::RiskFactorKey, QuantLib::Real>& parRatesBase,
+                           std::map<ore::analytics::RiskFactorKey, QuantLib::Real>& parCapVols);
+
+    //! Reprice the par instruments under the scenario applied to \p simMarket shifting \p rawKey
+    void computeScenarioSensitivities(const boost::shared_ptr<ore::analytics::ScenarioSimMarket>& simMarket,
+                                      const ore::analytics::RiskFactorKey& rawKey,
+                                      const std::map<ore::analytics::RiskFactorKey, QuantLib::Real>& parRatesBase,
+                                      const std::map<ore::analytics::RiskFactorKey, QuantLib::Real>& parCapVols,
+                                      ParContainer& parSensi, std::set<ore::analytics::RiskFactorKey>& parKeysNonZero,
+                                      std::set<ore::analytics::RiskFactorKey>& rawKeysNonZero);
+
+    //! Read the par sensitivities from the Jacobi cache, returns false if they can not be reused
+    bool readJacobiCache(const std::map<ore::analytics::RiskFactorKey, QuantLib::Real>& baseValues,
+                         const std::set<ore::analytics::RiskFactorKey>& rawKeys);
+
+    //! Write the par sensitivities to the Jacobi cache
+    void writeJacobiCache(const std::map<ore::analytics::RiskFactorKey, QuantLib::Real>& baseValues,
+                          const std::set<ore::analytics::RiskFactorKey>& rawKeys) const;
+
     //! Create Deposit for implying par rate sensitivity from zero rate sensitivity
     std::pair<boost::shared_ptr<QuantLib::Instrument>, Date>
     makeDeposit(const boost::shared_ptr<ore::data::Market>& market,
@@ -233,6 +276,11 @@ private:
 
     // ql index names for which we want to remove today's fixing for the purpose of the par sensi calculation
     std::set<std::string> removeTodaysFixingIndices_;
+
+    //! Jacobi cache file, tolerance for the base par rates / flat vols and whether the last run used it
+    std::string jacobiCacheFile_;
+    QuantLib::Real jacobiCacheTolerance_ = 0.0;
+    bool jacobiFromCache_ = false;
 };
 
 //! ParSensitivityConverter class
@@ -271,9 +319,13 @@ class ParSensitivityConverter {
 public:
     /*! Constructor where \p parSensitivities is the par rate sensitivities w.r.t. zero shifts \p shiftSizes gives 
         the absolute zero and par shift sizes for each risk factor key.
+
+        If \p cacheFile is given, the inverse of the transposed Jacobian is read from this file if it was written
+        for the same Jacobi matrix, otherwise the inverse is computed and written to the file.
     */
     ParSensitivityConverter(const ParSensitivityAnalysis::ParContainer& parSensitivities,
-        const std::map<ore::analytics::RiskFactorKey, std::pair<QuantLib::Real, QuantLib::Real>>& shiftSizes);
+        const std::map<ore::analytics::RiskFactorKey, std::pair<QuantLib::Real, QuantLib::Real>>& shiftSizes,
+        const std::string& cacheFile = std::string());
 
     //! Inspectors
     //@{
@@ -299,6 +351,13 @@ public:
     void writeConversionMatrix(ore::data::Report& reportOut) const;
 
 private:
+    //! Read the inverse from \p fileName if it was written for \p parSensitivities
+    bool readConversionMatrixCache(const std::string& fileName,
+                                   const ParSensitivityAnalysis::ParContainer& parSensitivities);
+    //! Write \p parSensitivities and the inverse to \p fileName
+    void writeConversionMatrixCache(const std::string& fileName,
+                                    const ParSensitivityAnalysis::ParContainer& parSensitivities) const;
+
     std::set<ore::analytics::RiskFactorKey> rawKeys_;
     std::set<ore::analytics::RiskFactorKey> parKeys_;
     // transposed inverse Jacobian, i.e. the matrix we use for the zero-par conversion effectively
@@ -0,0 +1,102 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/engine/pricingprofiler.hpp>
+#include <ored/utilities/log.hpp>
+
+#include <ql/errors.hpp>
+
+#include <algorithm>
+#include <iomanip>
+
+namespace ore {
+namespace analytics {
+
+void PricingProfile::add(Category category, const std::string& name, boost::timer::nanosecond_type wallTime,
+                         QuantLib::Size count) {
+    auto& entries = entries_[category];
+    auto e = entries.find(name);
+    if (e == entries.end())
+        e = entries.emplace(name, Entry()).first;
+    e->second.count += count;
+    e->second.wallTime += wallTime;
+}
+
+void PricingProfile::merge(const PricingProfile& profile) {
+    for (auto const& [category, entries] : profile.entries_)
+        for (auto const& [name, e] : entries)
+            add(category, name, e.wallTime, e.count);
+}
+
+std::vector<std::pair<std::string, PricingProfile::Entry>> PricingProfile::ranked(Category category) const {
+    std::vector<std::pair<std::string, Entry>> res;
+    auto c = entries_.find(category);
+    if (c == entries_.end())
+        return res;
+    res.assign(c->second.begin(), c->second.end());
+    std::stable_sort(res.begin(), res.end(),
+                     [](const std::pair<std::string, Entry>& x, const std::pair<std::string, Entry>& y) {
+                         return x.second.wallTime > y.second.wallTime;
+                     });
+    return res;
+}
+
+boost::timer::nanosecond_type PricingProfile::totalWallTime(Category category) const {
+    boost::timer::nanosecond_type total = 0;
+    auto c = entries_.find(category);
+    if (c != entries_.end())
+        for (auto const& [name, e] : c->second)
+            total += e.wallTime;
+    return total;
+}
+
+void PricingProfile::log(const std::string& label, QuantLib::Size top) const {
+    if (empty())
+        return;
+    LOG("Pricing profile " << label << ":");
+    for (auto const& [category, entries] : entries_) {
+        double total = static_cast<double>(totalWallTime(category));
+        auto r = ranked(category);
+        LOG("  " << category << ": " << r.size() << " entries, " << std::fixed << std::setprecision(3) << total * 1E-9
+                 << " sec");
+        for (QuantLib::Size i = 0; i < std::min(top, r.size()); ++i) {
+            LOG("    " << std::left << std::setw(40) << r[i].first << std::right << std::setw(12) << std::fixed
+                       << std::setprecision(3) << r[i].second.wallTime * 1E-9 << " sec " << std::setw(10)
+                       << r[i].second.count << " calls " << std::setw(6) << std::setprecision(1)
+                       << (total > 0.0 ? 100.0 * r[i].second.wallTime / total : 0.0) << "%");
+        }
+    }
+}
+
+std::ostream& operator<<(std::ostream& out, const PricingProfile::Category& c) {
+    switch (c) {
+    case PricingProfile::Category::Trade:
+        return out << "Trade";
+    case PricingProfile::Category::TradeType:
+        return out << "TradeType";
+    case PricingProfile::Category::Calculator:
+        return out << "Calculator";
+    case PricingProfile::Category::Phase:
+        return out << "Phase";
+    default:
+        QL_FAIL("PricingProfile::Category (" << static_cast<int>(c) << ") not covered");
+    }
+}
+
+} // namespace analytics
+} // namespace ore
@@ -0,0 +1,103 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/engine/pricingprofiler.hpp
+    \brief Wall time and call count profile of a valuation run
+    \ingroup engine
+*/
+
+#pragma once
+
+#include <ql/patterns/singleton.hpp>
+#include <ql/types.hpp>
+
+#include <boost/timer/timer.hpp>
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ore {
+namespace analytics {
+
+//! Wall time and call count profile
+/*! Collects the wall time and number of calls spent per trade, trade type, valuation calculator and
+    market update phase. The valuation engine fills one profile per buildCube() run.
+    \ingroup engine
+*/
+class PricingProfile {
+public:
+    enum class Category { Trade, TradeType, Calculator, Phase };
+
+    struct Entry {
+        QuantLib::Size count = 0;
+        boost::timer::nanosecond_type wallTime = 0;
+    };
+
+    //! Add wall time (in nanoseconds) and a number of calls to an entry
+    void add(Category category, const std::string& name, boost::timer::nanosecond_type wallTime,
+             QuantLib::Size count = 1);
+    //! Add all entries of another profile to this one
+    void merge(const PricingProfile& profile);
+    void clear() { entries_.clear(); }
+    bool empty() const { return entries_.empty(); }
+
+    //! All entries, by category and name
+    const std::map<Category, std::map<std::string, Entry>>& entries() const { return entries_; }
+    //! Entries of a category ranked by descending wall time
+    std::vector<std::pair<std::string, Entry>> ranked(Category category) const;
+    //! Total wall time of a category
+    boost::timer::nanosecond_type totalWallTime(Category category) const;
+
+    //! Log the top entries of each category
+    void log(const std::string& label, QuantLib::Size top = 10) const;
+
+private:
+    std::map<Category, std::map<std::string, Entry>> entries_;
+};
+
+std::ostream& operator<<(std::ostream& out, const PricingProfile::Category& c);
+
+//! Global pricing profiler
+/*! Holds the switch to enable profiling and the profile accumulated over all runs. Profiling
+    is disabled by default, so that the valuation engine does not pay for the timers.
+    \ingroup engine
+*/
+class PricingProfiler : public QuantLib::Singleton<PricingProfiler> {
+    friend class QuantLib::Singleton<PricingProfiler>;
+
+private:
+    PricingProfiler() = default;
+
+public:
+    bool enabled() const { return enabled_; }
+    void setEnabled(bool b) { enabled_ = b; }
+
+    //! Profile accumulated over all runs since the last reset
+    const PricingProfile& profile() const { return profile_; }
+    void add(const PricingProfile& profile) { profile_.merge(profile); }
+    void reset() { profile_.clear(); }
+
+private:
+    bool enabled_ = false;
+    PricingProfile profile_;
+};
+
+} // namespace analytics
+} // namespace ore
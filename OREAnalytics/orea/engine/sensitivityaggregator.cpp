@@ -24,8 +24,10 @@
 using ore::analytics::ScenarioFilter;
 using std::function;
 using std::map;
+using std::pair;
 using std::set;
 using std::string;
+using std::vector;
 
 namespace ore {
 namespace analytics {
@@ -35,6 +37,9 @@ SensitivityAggregator::SensitivityAggregator(const map<string, set<pair<string,
 
     // Initialise the category functions
     for (const auto& kv : setCategories_) {
+        auto& trades = categoryTrades_[kv.first];
+        for (const auto& t : kv.second)
+            trades.insert(t.first);
         categories_[kv.first] = bind(&SensitivityAggregator::inCategory, this, std::placeholders::_1, kv.first);
     }
 
@@ -53,6 +58,17 @@ void SensitivityAggregator::aggregate(SensitivityStream& ss, const boost::shared
     // Ensure at start of stream
     ss.reset();
 
+    // The categories and their aggregated records, the membership of the current trade ID
+    vector<pair<const function<bool(string)>*, Aggregation*>> categories;
+    vector<string> categoryNames;
+    for (const auto& kv : categories_) {
+        categories.push_back(std::make_pair(&kv.second, &aggRecords_[kv.first]));
+        categoryNames.push_back(kv.first);
+    }
+    vector<bool> member(categories.size(), false);
+    string tradeId;
+    bool first = true;
+
     // Loop over stream's records
     while (SensitivityRecord sr = ss.next()) {
         // Skip this record if the risk factor is not in the filter
@@ -61,16 +77,24 @@ void SensitivityAggregator::aggregate(SensitivityStream& ss, const boost::shared
         if (sr.isCrossGamma() && (!filter->allow(sr.key_1) || !filter->allow(sr.key_2)))
             continue;
 
+        // Records usually come in blocks per trade, evaluate the categories once per block
+        if (first || sr.tradeId != tradeId) {
+            first = false;
+            tradeId = sr.tradeId;
+            for (Size c = 0; c < categories.size(); ++c)
+                member[c] = (*categories[c].first)(tradeId);
+        }
+
         // "Blank out" trade ID before adding
-        string tradeId = sr.tradeId;
         sr.tradeId = "";
+        std::uint64_t id = (static_cast<std::uint64_t>(keys_.intern(sr.key_1)) << 32) | keys_.intern(sr.key_2);
 
         // Update aggRecords_ for each category
-        for (const auto& kv : categories_) {
+        for (Size c = 0; c < categories.size(); ++c) {
             // Check if the sensitivity record's trade ID is in the category
-            if (kv.second(tradeId)) {
-                DLOG("Updating aggregated sensitivities for category " << kv.first << " with record: " << sr);
-                add(sr, aggRecords_[kv.first]);
+            if (member[c]) {
+                DLOG("Updating aggregated sensitivities for category " << categoryNames[c] << " with record: " << sr);
+                add(sr, id, *categories[c].second);
             }
         }
     }
@@ -90,14 +114,22 @@ const set<SensitivityRecord>& SensitivityAggregator::sensitivities(const string&
     QL_REQUIRE(it != aggRecords_.end(),
                "The category " << category << " was not used in the construction of the SensitivityAggregator");
 
-    return it->second;
+    const Aggregation& agg = it->second;
+    if (!agg.sortedValid) {
+        agg.sorted = set<SensitivityRecord>(agg.records.begin(), agg.records.end());
+        agg.sortedValid = true;
+    }
+    return agg.sorted;
 }
 
 void SensitivityAggregator::generateDeltaGamma(const string& category, map<RiskFactorKey, Real>& deltas,
     map<CrossPair, Real>& gammas) {
 
-    auto srs = sensitivities(category);
-    for (const auto& sr : srs) {
+    auto it = aggRecords_.find(category);
+    QL_REQUIRE(it != aggRecords_.end(),
+               "The category " << category << " was not used in the construction of the SensitivityAggregator");
+
+    for (const auto& sr : it->second.records) {
         if (!sr.isCrossGamma()) {
             QL_REQUIRE(deltas.count(sr.key_1) == 0,
                        "Duplicate sensitivity entry for risk factor key " << sr.key_1 << " in the set");
@@ -122,31 +154,31 @@ void SensitivityAggregator::generateDeltaGamma(const string& category, map<RiskF
 }
 
 void SensitivityAggregator::init() {
-    // Add an empty set for each of the categories
+    // Add an empty aggregation for each of the categories
     for (const auto& kv : categories_) {
-        aggRecords_[kv.first] = {};
+        aggRecords_[kv.first] = Aggregation();
     }
 }
 
-void SensitivityAggregator::add(SensitivityRecord& sr, set<SensitivityRecord>& records) {
+void SensitivityAggregator::add(const SensitivityRecord& sr, std::uint64_t id, Aggregation& records) {
     // Try to insert sr. This will only pass if sr is not there already.
-    auto p = records.insert(sr);
-    if (!p.second) {
-        // If sr is already in the set, update it.
-        p.first->baseNpv += sr.baseNpv;
-        p.first->delta += sr.delta;
-        p.first->gamma += sr.gamma;
+    auto p = records.index.insert(std::make_pair(id, records.records.size()));
+    if (p.second) {
+        records.records.push_back(sr);
+    } else {
+        // If sr is already there, update it.
+        SensitivityRecord& r = records.records[p.first->second];
+        r.baseNpv += sr.baseNpv;
+        r.delta += sr.delta;
+        r.gamma += sr.gamma;
     }
+    records.sortedValid = false;
 }
 
 bool SensitivityAggregator::inCategory(const string& tradeId, const string& category) const {
-    QL_REQUIRE(setCategories_.count(category), "The category " << category << " is not valid");
-    auto tradeIds = setCategories_.at(category);
-    for (auto it = tradeIds.begin(); it != tradeIds.end(); ++it) {
-        if (it->first == tradeId)
-            return true;
-    }
-    return false;
+    auto it = categoryTrades_.find(category);
+    QL_REQUIRE(it != categoryTrades_.end(), "The category " << category << " is not valid");
+    return it->second.count(tradeId) > 0;
 }
 
 } // namespace analytics
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <orea/engine/sensitivityrecordtable.hpp>
 #include <orea/engine/sensitivitystream.hpp>
 #include <orea/scenario/scenariosimmarket.hpp>
 
@@ -29,13 +30,17 @@
 #include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace ore {
 namespace analytics {
 
 /*! Class for aggregating SensitivityRecords.
 
-    The SensitivityRecords are aggregated according to categories of predefined trade IDs.
+    The SensitivityRecords are aggregated according to categories of predefined trade IDs. The risk factor keys are
+    interned and the records of a category are aggregated in a hash map keyed by the pair of key ids, the category
+    membership is evaluated once per block of records with the same trade ID.
 */
 class SensitivityAggregator {
 public:
@@ -83,13 +88,25 @@ private:
     std::map<std::string, std::set<std::pair<std::string, QuantLib::Size>>> setCategories_;
     //! Container for category names and their definition via functions
     std::map<std::string, std::function<bool(std::string)>> categories_;
+    //! Trade IDs per category for the categories defined via sets
+    std::map<std::string, std::unordered_set<std::string>> categoryTrades_;
+
+    //! Aggregated records of a category, the set is built on demand
+    struct Aggregation {
+        std::vector<SensitivityRecord> records;
+        std::unordered_map<std::uint64_t, QuantLib::Size> index;
+        mutable std::set<SensitivityRecord> sorted;
+        mutable bool sortedValid = false;
+    };
     //! Sensitivity records aggregated according to <code>categories_</code>
-    std::map<std::string, std::set<SensitivityRecord>> aggRecords_;
+    std::map<std::string, Aggregation> aggRecords_;
+    //! Interned risk factor keys
+    InternPool<RiskFactorKey> keys_;
 
     //! Initialise the container of aggregated records
     void init();
-    //! Add a sensitivity record to the set of aggregated \p records
-    void add(SensitivityRecord& sr, std::set<SensitivityRecord>& records);
+    //! Add a sensitivity record with key pair id \p id to the aggregated \p records
+    void add(const SensitivityRecord& sr, std::uint64_t id, Aggregation& records);
     //! Determine if the \p tradeId is in the given \p category
     bool inCategory(const std::string& tradeId, const std::string& category) const;
 };
@@ -20,7 +20,8 @@
 #include <orea/cube/sensicube.hpp>
 #include <orea/engine/sensitivityanalysis.hpp>
 #include <orea/engine/valuationengine.hpp>
-#include <orea/scenario/clonescenariofactory.hpp>
+#include <orea/scenario/deltascenariofactory.hpp>
+#include <orea/scenario/scenariosimmarketplus.hpp>
 #include <ored/portfolio/fxoption.hpp>
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/osutils.hpp>
@@ -126,7 +127,7 @@ void SensitivityAnalysis::initializeSimMarket(boost::shared_ptr<ScenarioFactory>
 
     LOG("Initialise sim market for sensitivity analysis (continueOnError=" << std::boolalpha << continueOnError_
                                                                            << ")");
-    simMarket_ = boost::make_shared<ScenarioSimMarket>(
+    simMarket_ = boost::make_shared<ScenarioSimMarketPlus>(
         market_, simMarketData_, marketConfiguration_,
         curveConfigs_ ? *curveConfigs_ : ore::data::CurveConfigurations(),
         todaysMarketParams_ ? *todaysMarketParams_ : TodaysMarketParameters(), continueOnError_,
@@ -136,8 +137,9 @@ void SensitivityAnalysis::initializeSimMarket(boost::shared_ptr<ScenarioFactory>
 
     LOG("Create scenario factory for sensitivity analysis");
     boost::shared_ptr<Scenario> baseScenario = simMarket_->baseScenario();
+    // delta scenarios only store the shifted keys and are applied incrementally by the sim market
     boost::shared_ptr<ScenarioFactory> scenarioFactory =
-        scenFact ? scenFact : boost::make_shared<CloneScenarioFactory>(baseScenario);
+        scenFact ? scenFact : boost::make_shared<DeltaScenarioFactory>(baseScenario);
     LOG("Scenario factory created for sensitivity analysis");
 
     LOG("Create scenario generator for sensitivity analysis (continueOnError=" << std::boolalpha << continueOnError_
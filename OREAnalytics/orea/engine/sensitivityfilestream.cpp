@@ -21,12 +21,17 @@
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/parsers.hpp>
 #include <ql/errors.hpp>
+#include <ql/utilities/null.hpp>
 
 #include <boost/algorithm/string.hpp>
 
+#include <cmath>
+
 using ore::analytics::deconstructFactor;
 using ore::data::parseBool;
 using ore::data::parseReal;
+using QuantLib::Null;
+using QuantLib::Real;
 using std::getline;
 using std::string;
 using std::vector;
@@ -123,5 +128,25 @@ SensitivityBufferStream::SensitivityBufferStream(const std::string& buffer, char
     setStream(stream);
 }
 
+SensitivityBinaryFileStream::SensitivityBinaryFileStream(const string& fileName) { table_.fromFile(fileName); }
+
+SensitivityRecord SensitivityBinaryFileStream::next() {
+    if (index_ < table_.size())
+        return table_.record(index_++);
+    return SensitivityRecord();
+}
+
+void SensitivityBinaryFileStream::reset() { index_ = 0; }
+
+void writeSensitivityBinaryFile(const string& fileName, SensitivityStream& ss, Real threshold) {
+    SensitivityRecordTable table;
+    ss.reset();
+    while (SensitivityRecord sr = ss.next()) {
+        if (std::fabs(sr.delta) > threshold || (sr.gamma != Null<Real>() && std::fabs(sr.gamma) > threshold))
+            table.add(sr);
+    }
+    table.toFile(fileName);
+}
+
 } // namespace analytics
 } // namespace ore
@@ -22,6 +22,7 @@
 
 #pragma once
 
+#include <orea/engine/sensitivityrecordtable.hpp>
 #include <orea/engine/sensitivitystream.hpp>
 
 #include <fstream>
@@ -76,5 +77,26 @@ public:
     SensitivityBufferStream(const std::string& buffer, char delim = ',', const std::string& comment = "#");
 };
 
+//! Class for streaming SensitivityRecords from a binary file, see SensitivityRecordTable for the format
+class SensitivityBinaryFileStream : public SensitivityStream {
+public:
+    //! Constructor providing path to binary file \p fileName, the file is read completely
+    explicit SensitivityBinaryFileStream(const std::string& fileName);
+    //! Returns the next SensitivityRecord in the stream
+    SensitivityRecord next() override;
+    //! Resets the stream so that SensitivityRecord objects can be streamed again
+    void reset() override;
+    //! The records read from the file
+    const SensitivityRecordTable& table() const { return table_; }
+
+private:
+    SensitivityRecordTable table_;
+    QuantLib::Size index_ = 0;
+};
+
+/*! Write the records of \p ss to the binary file \p fileName. As in the sensitivity report, only records with an
+    absolute delta or gamma above \p threshold are written. */
+void writeSensitivityBinaryFile(const std::string& fileName, SensitivityStream& ss, QuantLib::Real threshold = 0.0);
+
 } // namespace analytics
 } // namespace ore
@@ -0,0 +1,209 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/engine/sensitivityrecordtable.hpp>
+
+#include <ored/utilities/log.hpp>
+
+#include <cstring>
+#include <fstream>
+
+using std::string;
+using std::uint32_t;
+using std::uint64_t;
+using std::vector;
+
+namespace ore {
+namespace analytics {
+
+namespace {
+
+const char magic[8] = {'O', 'R', 'E', 'S', 'E', 'N', 'S', 'I'};
+const uint32_t version = 1;
+
+template <class T> void writeValue(std::ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <class T> T readValue(std::istream& in) {
+    T value;
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    QL_REQUIRE(in, "SensitivityRecordTable: unexpected end of input");
+    return value;
+}
+
+void writeString(std::ostream& out, const string& s) {
+    writeValue<uint32_t>(out, static_cast<uint32_t>(s.size()));
+    out.write(s.data(), s.size());
+}
+
+string readString(std::istream& in) {
+    string s(readValue<uint32_t>(in), '\0');
+    in.read(&s[0], s.size());
+    QL_REQUIRE(in, "SensitivityRecordTable: unexpected end of input");
+    return s;
+}
+
+template <class T> void writeColumn(std::ostream& out, const vector<T>& column) {
+    out.write(reinterpret_cast<const char*>(column.data()), column.size() * sizeof(T));
+}
+
+template <class T> void readColumn(std::istream& in, vector<T>& column, QuantLib::Size n, QuantLib::Size bound) {
+    column.resize(n);
+    in.read(reinterpret_cast<char*>(column.data()), n * sizeof(T));
+    QL_REQUIRE(in, "SensitivityRecordTable: unexpected end of input");
+    for (auto const& v : column)
+        QL_REQUIRE(static_cast<QuantLib::Size>(v) < bound, "SensitivityRecordTable: invalid id " << v);
+}
+
+void readColumn(std::istream& in, vector<double>& column, QuantLib::Size n) {
+    column.resize(n);
+    in.read(reinterpret_cast<char*>(column.data()), n * sizeof(double));
+    QL_REQUIRE(in, "SensitivityRecordTable: unexpected end of input");
+}
+
+} // namespace
+
+void SensitivityRecordTable::add(const SensitivityRecord& sr) {
+    trade_.push_back(tradeIds_.intern(sr.tradeId));
+    isPar_.push_back(sr.isPar ? 1 : 0);
+    key1_.push_back(keys_.intern(sr.key_1));
+    desc1_.push_back(labels_.intern(sr.desc_1));
+    shift1_.push_back(sr.shift_1);
+    key2_.push_back(keys_.intern(sr.key_2));
+    desc2_.push_back(labels_.intern(sr.desc_2));
+    shift2_.push_back(sr.shift_2);
+    currency_.push_back(labels_.intern(sr.currency));
+    baseNpv_.push_back(sr.baseNpv);
+    delta_.push_back(sr.delta);
+    gamma_.push_back(sr.gamma);
+}
+
+void SensitivityRecordTable::clear() {
+    tradeIds_.clear();
+    keys_.clear();
+    labels_.clear();
+    for (auto c : {&trade_, &key1_, &desc1_, &key2_, &desc2_, &currency_})
+        c->clear();
+    isPar_.clear();
+    for (auto c : {&shift1_, &shift2_, &baseNpv_, &delta_, &gamma_})
+        c->clear();
+}
+
+SensitivityRecord SensitivityRecordTable::record(QuantLib::Size i) const {
+    QL_REQUIRE(i < size(), "SensitivityRecordTable: record " << i << " out of range, size is " << size());
+    return SensitivityRecord(tradeIds_.value(trade_[i]), isPar_[i] != 0, keys_.value(key1_[i]),
+                             labels_.value(desc1_[i]), shift1_[i], keys_.value(key2_[i]), labels_.value(desc2_[i]),
+                             shift2_[i], labels_.value(currency_[i]), baseNpv_[i], delta_[i], gamma_[i]);
+}
+
+void SensitivityRecordTable::write(std::ostream& out) const {
+    out.write(magic, sizeof(magic));
+    writeValue(out, version);
+
+    writeValue<uint64_t>(out, tradeIds_.size());
+    for (auto const& t : tradeIds_.values())
+        writeString(out, t);
+    writeValue<uint64_t>(out, keys_.size());
+    for (auto const& k : keys_.values()) {
+        writeValue<uint32_t>(out, static_cast<uint32_t>(k.keytype));
+        writeString(out, k.name);
+        writeValue<uint64_t>(out, k.index);
+    }
+    writeValue<uint64_t>(out, labels_.size());
+    for (auto const& l : labels_.values())
+        writeString(out, l);
+
+    writeValue<uint64_t>(out, size());
+    writeColumn(out, trade_);
+    writeColumn(out, isPar_);
+    writeColumn(out, key1_);
+    writeColumn(out, desc1_);
+    writeColumn(out, shift1_);
+    writeColumn(out, key2_);
+    writeColumn(out, desc2_);
+    writeColumn(out, shift2_);
+    writeColumn(out, currency_);
+    writeColumn(out, baseNpv_);
+    writeColumn(out, delta_);
+    writeColumn(out, gamma_);
+    QL_REQUIRE(out, "SensitivityRecordTable: error writing table");
+}
+
+void SensitivityRecordTable::read(std::istream& in) {
+    clear();
+
+    char header[sizeof(magic)];
+    in.read(header, sizeof(header));
+    QL_REQUIRE(in && std::memcmp(header, magic, sizeof(magic)) == 0,
+               "SensitivityRecordTable: input is not a binary sensitivity table");
+    uint32_t v = readValue<uint32_t>(in);
+    QL_REQUIRE(v == version, "SensitivityRecordTable: version " << v << " not supported, expected " << version);
+
+    // the pools are rebuilt in file order, so that the ids in the columns remain valid
+    uint64_t n = readValue<uint64_t>(in);
+    for (uint64_t i = 0; i < n; ++i)
+        tradeIds_.intern(readString(in));
+    n = readValue<uint64_t>(in);
+    for (uint64_t i = 0; i < n; ++i) {
+        auto type = static_cast<RiskFactorKey::KeyType>(readValue<uint32_t>(in));
+        string name = readString(in);
+        keys_.intern(RiskFactorKey(type, name, readValue<uint64_t>(in)));
+    }
+    n = readValue<uint64_t>(in);
+    for (uint64_t i = 0; i < n; ++i)
+        labels_.intern(readString(in));
+
+    n = readValue<uint64_t>(in);
+    readColumn(in, trade_, n, tradeIds_.size());
+    readColumn(in, isPar_, n, 2);
+    readColumn(in, key1_, n, keys_.size());
+    readColumn(in, desc1_, n, labels_.size());
+    readColumn(in, shift1_, n);
+    readColumn(in, key2_, n, keys_.size());
+    readColumn(in, desc2_, n, labels_.size());
+    readColumn(in, shift2_, n);
+    readColumn(in, currency_, n, labels_.size());
+    readColumn(in, baseNpv_, n);
+    readColumn(in, delta_, n);
+    readColumn(in, gamma_, n);
+}
+
+void SensitivityRecordTable::toFile(const string& fileName) const {
+    std::ofstream out(fileName, std::ios::binary);
+    QL_REQUIRE(out.is_open(), "error opening file " << fileName);
+    write(out);
+    LOG("Wrote " << size() << " sensitivity records to binary file " << fileName);
+}
+
+void SensitivityRecordTable::fromFile(const string& fileName) {
+    std::ifstream in(fileName, std::ios::binary);
+    QL_REQUIRE(in.is_open(), "error opening file " << fileName);
+    read(in);
+    LOG("Read " << size() << " sensitivity records for " << tradeIds_.size() << " trades and " << keys_.size()
+                << " risk factor keys from binary file " << fileName);
+}
+
+bool SensitivityRecordTable::isBinaryFile(const string& fileName) {
+    std::ifstream in(fileName, std::ios::binary);
+    char header[sizeof(magic)];
+    return in.read(header, sizeof(header)) && std::memcmp(header, magic, sizeof(magic)) == 0;
+}
+
+} // namespace analytics
+} // namespace ore
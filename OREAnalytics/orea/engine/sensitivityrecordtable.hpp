@@ -0,0 +1,122 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/engine/sensitivityrecordtable.hpp
+    \brief Columnar storage of SensitivityRecords with interned trade ids and risk factor keys
+ */
+
+#pragma once
+
+#include <orea/engine/sensitivityrecord.hpp>
+
+#include <ql/errors.hpp>
+
+#include <boost/functional/hash.hpp>
+
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ore {
+namespace analytics {
+
+//! Pool of unique values, each value is identified by the position at which it was first added
+template <class T, class Hash = boost::hash<T>> class InternPool {
+public:
+    //! Return the id of \p value, adding it to the pool if not present yet
+    std::uint32_t intern(const T& value) {
+        auto r = index_.emplace(value, static_cast<std::uint32_t>(values_.size()));
+        if (r.second) {
+            QL_REQUIRE(values_.size() < std::numeric_limits<std::uint32_t>::max(), "InternPool: too many values");
+            values_.push_back(value);
+        }
+        return r.first->second;
+    }
+    //! The value with id \p id
+    const T& value(std::uint32_t id) const { return values_[id]; }
+    //! All values, ordered by id
+    const std::vector<T>& values() const { return values_; }
+    QuantLib::Size size() const { return values_.size(); }
+    void clear() {
+        values_.clear();
+        index_.clear();
+    }
+
+private:
+    std::vector<T> values_;
+    std::unordered_map<T, std::uint32_t, Hash> index_;
+};
+
+//! Columnar table of SensitivityRecords
+/*! Trade ids, risk factor keys, descriptions and currencies are interned, each record is stored as a row of ids and
+    numbers. This keeps large sets of sensitivities (many trades times many risk factors) compact in memory and
+    allows to write and read them in a binary file format without parsing the keys per record.
+
+    The binary format consists of a header (magic string and version), the interned trade ids, risk factor keys and
+    labels (descriptions and currencies) and then the record columns, each stored contiguously. Numbers are stored in
+    the native byte order.
+ */
+class SensitivityRecordTable {
+public:
+    //! Append the record \p sr
+    void add(const SensitivityRecord& sr);
+    //! Number of records
+    QuantLib::Size size() const { return trade_.size(); }
+    bool empty() const { return trade_.empty(); }
+    //! Remove all records and interned values
+    void clear();
+
+    //! Reconstruct the \p i -th record
+    SensitivityRecord record(QuantLib::Size i) const;
+
+    //! Interned trade ids and risk factor keys
+    const std::vector<std::string>& tradeIds() const { return tradeIds_.values(); }
+    const std::vector<RiskFactorKey>& keys() const { return keys_.values(); }
+
+    //! Ids of the trade and keys of the \p i -th record, referring to tradeIds() and keys()
+    std::uint32_t tradeIdIndex(QuantLib::Size i) const { return trade_[i]; }
+    std::uint32_t key1Index(QuantLib::Size i) const { return key1_[i]; }
+    std::uint32_t key2Index(QuantLib::Size i) const { return key2_[i]; }
+
+    //! Write the table in binary format
+    void write(std::ostream& out) const;
+    //! Replace the content of the table by a table read in binary format
+    void read(std::istream& in);
+
+    //! Write the table to the file \p fileName in binary format
+    void toFile(const std::string& fileName) const;
+    //! Replace the content of the table by the table in the file \p fileName
+    void fromFile(const std::string& fileName);
+    //! Check if \p fileName starts with the header of the binary format
+    static bool isBinaryFile(const std::string& fileName);
+
+private:
+    InternPool<std::string> tradeIds_;
+    InternPool<RiskFactorKey> keys_;
+    InternPool<std::string> labels_;
+
+    std::vector<std::uint32_t> trade_, key1_, desc1_, key2_, desc2_, currency_;
+    std::vector<std::uint8_t> isPar_;
+    std::vector<double> shift1_, shift2_, baseNpv_, delta_, gamma_;
+};
+
+} // namespace analytics
+} // namespace ore
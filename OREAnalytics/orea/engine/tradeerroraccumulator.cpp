@@ -0,0 +1,89 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/engine/tradeerroraccumulator.hpp>
+#include <ored/portfolio/structuredtradeerror.hpp>
+#include <ored/utilities/log.hpp>
+#include <ored/utilities/to_string.hpp>
+
+#include <ql/errors.hpp>
+
+#include <sstream>
+
+using namespace QuantLib;
+
+namespace ore {
+namespace analytics {
+
+void TradeErrorAccumulator::add(const Phase phase, const Size tradeIndex, const std::string& tradeId,
+                                const std::string& tradeType, const std::string& what, const Date& date,
+                                const Size sample, const std::string& label) {
+    auto r = entries_.try_emplace(std::make_pair(tradeIndex, phase));
+    if (r.second) {
+        Entry& e = r.first->second;
+        e.tradeId = tradeId;
+        e.tradeType = tradeType;
+        e.what = what;
+        e.date = date;
+        e.sample = sample;
+        e.label = label;
+    }
+}
+
+Size TradeErrorAccumulator::size(const Phase phase) const {
+    Size n = 0;
+    for (auto const& [key, e] : entries_) {
+        if (key.second == phase)
+            ++n;
+    }
+    return n;
+}
+
+void TradeErrorAccumulator::log(const std::string& context) const {
+    if (entries_.empty())
+        return;
+    ALOG(context << ": " << entries_.size() << " trade errors during simulation (" << size(Phase::T0) << " "
+                 << Phase::T0 << ", " << size(Phase::Valuation) << " " << Phase::Valuation << ", "
+                 << size(Phase::CloseOut) << " " << Phase::CloseOut << ")");
+    for (auto const& [key, e] : entries_) {
+        std::ostringstream msg;
+        if (key.second == Phase::T0) {
+            msg << "T0 valuation error: " << e.what;
+        } else {
+            msg << "date = " << ore::data::to_string(io::iso_date(e.date)) << ", sample = " << e.sample
+                << ", label = " << e.label << ": " << e.what;
+        }
+        ALOG(ore::data::StructuredTradeErrorMessage(e.tradeId, e.tradeType, "ScenarioValuation", msg.str()));
+    }
+}
+
+std::ostream& operator<<(std::ostream& out, const TradeErrorAccumulator::Phase phase) {
+    switch (phase) {
+    case TradeErrorAccumulator::Phase::T0:
+        return out << "T0";
+    case TradeErrorAccumulator::Phase::Valuation:
+        return out << "Valuation";
+    case TradeErrorAccumulator::Phase::CloseOut:
+        return out << "CloseOut";
+    default:
+        QL_FAIL("TradeErrorAccumulator: unknown phase");
+    }
+}
+
+} // namespace analytics
+} // namespace ore
@@ -0,0 +1,86 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/engine/tradeerroraccumulator.hpp
+    \brief Collects trade errors raised during scenario valuation
+    \ingroup simulation
+*/
+
+#pragma once
+
+#include <ql/time/date.hpp>
+#include <ql/types.hpp>
+#include <ql/utilities/null.hpp>
+
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+
+namespace ore {
+namespace analytics {
+
+//! Trade error accumulator
+/*! Collects the errors raised by trades during a scenario valuation run. Errors are keyed by the trade index and the
+    phase of the run (T0 valuation, valuation date or close-out date scenario), for each key the message, date, sample
+    and label of the first error are kept. No message formatting or logging takes place when an error is added, the
+    collected errors are logged in one go by log().
+
+    The class is not thread safe, it is meant to be owned by a single valuation engine instance, i.e. by one thread.
+
+    \ingroup simulation
+*/
+class TradeErrorAccumulator {
+public:
+    enum class Phase { T0, Valuation, CloseOut };
+
+    struct Entry {
+        std::string tradeId;
+        std::string tradeType;
+        std::string what;
+        QuantLib::Date date;
+        QuantLib::Size sample = QuantLib::Null<QuantLib::Size>();
+        std::string label;
+    };
+
+    //! Add an error, the date, sample and label refer to the scenario the error occurred in and are not set for T0
+    void add(const Phase phase, const QuantLib::Size tradeIndex, const std::string& tradeId,
+             const std::string& tradeType, const std::string& what, const QuantLib::Date& date = QuantLib::Date(),
+             const QuantLib::Size sample = QuantLib::Null<QuantLib::Size>(), const std::string& label = "");
+
+    //! Log a summary line prefixed by \p context and one structured trade error per collected entry
+    void log(const std::string& context) const;
+
+    void clear() { entries_.clear(); }
+    bool empty() const { return entries_.empty(); }
+    //! Number of collected entries
+    QuantLib::Size size() const { return entries_.size(); }
+    //! Number of collected entries for the given phase
+    QuantLib::Size size(const Phase phase) const;
+
+    //! Entries keyed by (trade index, phase)
+    const std::map<std::pair<QuantLib::Size, Phase>, Entry>& entries() const { return entries_; }
+
+private:
+    std::map<std::pair<QuantLib::Size, Phase>, Entry> entries_;
+};
+
+std::ostream& operator<<(std::ostream& out, const TradeErrorAccumulator::Phase phase);
+
+} // namespace analytics
+} // namespace ore
@@ -21,15 +21,17 @@
 #include <orea/simulation/simmarket.hpp>
 #include <ored/portfolio/optionwrapper.hpp>
 #include <ored/portfolio/portfolio.hpp>
-#include <ored/portfolio/structuredtradeerror.hpp>
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/parsers.hpp>
 #include <ored/utilities/progressbar.hpp>
 #include <ored/utilities/to_string.hpp>
 
+#include <boost/core/demangle.hpp>
 #include <boost/timer/timer.hpp>
 #include <ql/errors.hpp>
 
+#include <chrono>
+
 using namespace QuantLib;
 using namespace QuantExt;
 using namespace std;
@@ -40,6 +42,18 @@ using boost::timer::default_places;
 namespace ore {
 namespace analytics {
 
+namespace {
+boost::timer::nanosecond_type elapsedSince(const std::chrono::steady_clock::time_point& start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::string calculatorName(const ValuationCalculator& c) {
+    std::string name = boost::core::demangle(typeid(c).name());
+    auto pos = name.rfind("::");
+    return pos == std::string::npos ? name : name.substr(pos + 2);
+}
+} // namespace
+
 ValuationEngine::ValuationEngine(const Date& today, const boost::shared_ptr<DateGrid>& dg,
                                  const boost::shared_ptr<SimMarket>& simMarket,
                                  const set<std::pair<string, boost::shared_ptr<ModelBuilder>>>& modelBuilders)
@@ -101,10 +115,16 @@ void ValuationEngine::buildCube(const boost::shared_ptr<data::Portfolio>& portfo
     Real pricingTime = 0.0;
     Real fixingTime = 0.0;
 
+    profiling_ = PricingProfiler::instance().enabled();
+    profile_.clear();
+    calculatorNames_.clear();
+
     LOG("Initialise " << calculators.size() << " valuation calculators");
     for (auto const& c : calculators) {
         c->init(portfolio, simMarket_);
         c->initScenario();
+        if (profiling_)
+            calculatorNames_.push_back(calculatorName(*c));
     }
 
     // Loop is Samples, Dates, Trades
@@ -112,6 +132,7 @@ void ValuationEngine::buildCube(const boost::shared_ptr<data::Portfolio>& portfo
     const auto& trades = portfolio->trades();
     auto& counterparties = outputCptyCube ? outputCptyCube->idsAndIndexes() : std::map<string, Size>();
     std::vector<bool> tradeHasError(portfolio->size(), false);
+    tradeErrors_.clear();
     LOG("Initialise state objects...");
     // initialise state objects for each trade (required for path-dependent derivatives in particular)
     size_t i = 0;
@@ -124,15 +145,16 @@ void ValuationEngine::buildCube(const boost::shared_ptr<data::Portfolio>& portfo
         recalibrateModels();
 
         // T0 values
+        auto t0Start = profiling_ ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
         try {
             for (auto& calc : calculators)
                 calc->calculateT0(trade, i, simMarket_, outputCube, outputCubeNettingSet);
         } catch (const std::exception& e) {
-            string expMsg = string("T0 valuation error: ") + e.what();
-            ALOG(StructuredTradeErrorMessage(tradeId, trade->tradeType(), "ScenarioValuation",
-                                             expMsg.c_str()));
+            tradeErrors_.add(TradeErrorAccumulator::Phase::T0, i, tradeId, trade->tradeType(), e.what());
             tradeHasError[i] = true;
         }
+        if (profiling_)
+            profile_.add(PricingProfile::Category::Phase, "T0Valuation", elapsedSince(t0Start));
 
         if (om == ObservationMode::Mode::Unregister) {
             for (const Leg& leg : trade->legs()) {
@@ -195,6 +217,8 @@ void ValuationEngine::buildCube(const boost::shared_ptr<data::Portfolio>& portfo
 
                 timer.stop();
                 updateTime += timer.elapsed().wall * 1e-9;
+                if (profiling_)
+                    profile_.add(PricingProfile::Category::Phase, "MarketUpdateCloseOut", timer.elapsed().wall);
 
                 // loop over trades
                 timer.start();
@@ -208,6 +232,8 @@ void ValuationEngine::buildCube(const boost::shared_ptr<data::Portfolio>& portfo
                     tradeExercisable(true, trades);
                 timer.stop();
                 pricingTime += timer.elapsed().wall * 1e-9;
+                if (profiling_)
+                    profile_.add(PricingProfile::Category::Phase, "PricingCloseOut", timer.elapsed().wall);
             }
 
             // process a valuation date as usual
@@ -232,6 +258,8 @@ void ValuationEngine::buildCube(const boost::shared_ptr<data::Portfolio>& portfo
 
                 timer.stop();
                 updateTime += timer.elapsed().wall * 1e-9;
+                if (profiling_)
+                    profile_.add(PricingProfile::Category::Phase, "MarketUpdate", timer.elapsed().wall);
 
                 timer.start();
                 // loop over trades
@@ -241,12 +269,16 @@ void ValuationEngine::buildCube(const boost::shared_ptr<data::Portfolio>& portfo
                 runCalculators(false, counterparties, cptyCalculators, outputCptyCube, d, cubeDateIndex, sample);
                 timer.stop();
                 pricingTime += timer.elapsed().wall * 1e-9;
+                if (profiling_)
+                    profile_.add(PricingProfile::Category::Phase, "Pricing", timer.elapsed().wall);
             }
         }
 
         timer.start();
         simMarket_->fixingManager()->reset();
         fixingTime += timer.elapsed().wall * 1e-9;
+        if (profiling_)
+            profile_.add(PricingProfile::Category::Phase, "FixingReset", timer.elapsed().wall);
     }
 
     if (dryRun) {
@@ -273,6 +305,16 @@ void ValuationEngine::buildCube(const boost::shared_ptr<data::Portfolio>& portfo
                                            << "update " << updateTime << " sec "
                                            << "fixing " << fixingTime);
 
+    if (profiling_) {
+        const string& label = simMarket_->label();
+        profile_.log(label.empty() ? "ValuationEngine" : "ValuationEngine (" + label + ")");
+        PricingProfiler::instance().add(profile_);
+    }
+
+    // log the collected trade errors
+
+    tradeErrors_.log("ValuationEngine");
+
     // for trades with errors set all output cube values to zero
     i = 0;
     for (auto& [tradeId, trade] : trades) {
@@ -306,13 +348,26 @@ void ValuationEngine::runCalculators(bool isCloseOutDate, const std::map<std::st
         if (om == ObservationMode::Mode::Disable || om == ObservationMode::Mode::Unregister)
             trade->instrument()->updateQlInstruments();
         try {
-            for (auto& calc : calculators)
-                calc->calculate(trade, j, simMarket_, outputCube, outputCubeNettingSet, d, cubeDateIndex, sample,
-                                isCloseOutDate);
+            boost::timer::nanosecond_type tradeTime = 0;
+            for (Size c = 0; c < calculators.size(); ++c) {
+                auto start = profiling_ ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+                calculators[c]->calculate(trade, j, simMarket_, outputCube, outputCubeNettingSet, d, cubeDateIndex,
+                                          sample, isCloseOutDate);
+                if (profiling_) {
+                    auto dt = elapsedSince(start);
+                    profile_.add(PricingProfile::Category::Calculator, calculatorNames_[c], dt);
+                    tradeTime += dt;
+                }
+            }
+            if (profiling_) {
+                profile_.add(PricingProfile::Category::Trade, tradeIt->first, tradeTime);
+                profile_.add(PricingProfile::Category::TradeType, trade->tradeType(), tradeTime);
+            }
         } catch (const std::exception& e) {
-            string expMsg = "date = " + ore::data::to_string(io::iso_date(d)) +
-                            ", sample = " + ore::data::to_string(sample) + ", label = " + label + ": " + e.what();
-            ALOG(StructuredTradeErrorMessage(trade->id(), trade->tradeType(), "ScenarioValuation", expMsg.c_str()));
+            // only collect the error here, the errors are logged once at the end of buildCube()
+            tradeErrors_.add(isCloseOutDate ? TradeErrorAccumulator::Phase::CloseOut
+                                            : TradeErrorAccumulator::Phase::Valuation,
+                             j, trade->id(), trade->tradeType(), e.what(), d, sample, label);
             tradeHasError[j] = true;
         }
     }
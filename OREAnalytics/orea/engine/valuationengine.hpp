@@ -25,6 +25,8 @@
 
 #include <orea/cube/npvcube.hpp>
 #include <orea/engine/cptycalculator.hpp>
+#include <orea/engine/pricingprofiler.hpp>
+#include <orea/engine/tradeerroraccumulator.hpp>
 #include <orea/engine/valuationcalculator.hpp>
 #include <orea/simulation/simmarket.hpp>
 #include <ored/portfolio/portfolio.hpp>
@@ -88,6 +90,12 @@ public:
         //! Limit samples to one and fill the rest of the cube with random values
         bool dryRun = false);
 
+    //! Trade errors collected during the last buildCube() call
+    const TradeErrorAccumulator& tradeErrors() const { return tradeErrors_; }
+
+    //! Pricing profile of the last buildCube() call, empty unless the PricingProfiler is enabled
+    const PricingProfile& pricingProfile() const { return profile_; }
+
 private:
     void recalibrateModels();
     void runCalculators(bool isCloseOutDate, const std::map<std::string, boost::shared_ptr<Trade>>& trades,
@@ -105,6 +113,10 @@ private:
     boost::shared_ptr<DateGrid> dg_;
     boost::shared_ptr<analytics::SimMarket> simMarket_;
     set<std::pair<string, boost::shared_ptr<QuantExt::ModelBuilder>>> modelBuilders_;
+    TradeErrorAccumulator tradeErrors_;
+    bool profiling_ = false;
+    std::vector<std::string> calculatorNames_;
+    PricingProfile profile_;
 };
 } // namespace analytics
 } // namespace ore
@@ -45,23 +45,28 @@
 #include <orea/cube/cubecsvreader.hpp>
 #include <orea/cube/cubeinterpretation.hpp>
 #include <orea/cube/cubewriter.hpp>
+#include <orea/cube/diskcube.hpp>
 #include <orea/cube/inmemorycube.hpp>
 #include <orea/cube/jaggedcube.hpp>
 #include <orea/cube/jointnpvcube.hpp>
 #include <orea/cube/jointnpvsensicube.hpp>
 #include <orea/cube/npvcube.hpp>
 #include <orea/cube/npvsensicube.hpp>
+#include <orea/cube/pnlaggregationcube.hpp>
 #include <orea/cube/sensicube.hpp>
 #include <orea/cube/sensitivitycube.hpp>
+#include <orea/cube/sharedmemorycube.hpp>
 #include <orea/cube/sparsenpvcube.hpp>
 #include <orea/engine/amcvaluationengine.hpp>
 #include <orea/engine/bufferedsensitivitystream.hpp>
+#include <orea/engine/cashflowtablecalculator.hpp>
 #include <orea/engine/cptycalculator.hpp>
 #include <orea/engine/filteredsensitivitystream.hpp>
 #include <orea/engine/historicalpnlgenerator.hpp>
 #include <orea/engine/historicalsensipnlcalculator.hpp>
 #include <orea/engine/historicalsimulationvar.hpp>
 #include <orea/engine/mporcalculator.hpp>
+#include <orea/engine/multiprocessvaluationengine.hpp>
 #include <orea/engine/multistatenpvcalculator.hpp>
 #include <orea/engine/multithreadedvaluationengine.hpp>
 #include <orea/engine/npvrecord.hpp>
@@ -69,6 +74,7 @@
 #include <orea/engine/parametricvar.hpp>
 #include <orea/engine/parsensitivityanalysis.hpp>
 #include <orea/engine/parsensitivitycubestream.hpp>
+#include <orea/engine/pricingprofiler.hpp>
 #include <orea/engine/riskfilter.hpp>
 #include <orea/engine/sensitivityaggregator.hpp>
 #include <orea/engine/sensitivityanalysis.hpp>
@@ -77,8 +83,10 @@
 #include <orea/engine/sensitivityfilestream.hpp>
 #include <orea/engine/sensitivityinmemorystream.hpp>
 #include <orea/engine/sensitivityrecord.hpp>
+#include <orea/engine/sensitivityrecordtable.hpp>
 #include <orea/engine/sensitivitystream.hpp>
 #include <orea/engine/stresstest.hpp>
+#include <orea/engine/tradeerroraccumulator.hpp>
 #include <orea/engine/valuationcalculator.hpp>
 #include <orea/engine/valuationengine.hpp>
 #include <orea/engine/varcalculator.hpp>
@@ -117,6 +125,7 @@
 #include <orea/simm/crifloader.hpp>
 #include <orea/simm/crifrecord.hpp>
 #include <orea/simm/simmbasicnamemapper.hpp>
+#include <orea/simm/simmbucketkernel.hpp>
 #include <orea/simm/simmbucketmapper.hpp>
 #include <orea/simm/simmbucketmapperbase.hpp>
 #include <orea/simm/simmcalculator.hpp>
@@ -17,6 +17,7 @@
 */
 
 #include <boost/algorithm/string/split.hpp>
+#include <boost/functional/hash.hpp>
 #include <orea/scenario/scenario.hpp>
 #include <ored/utilities/parsers.hpp>
 #include <ql/errors.hpp>
@@ -174,5 +175,13 @@ RiskFactorKey parseRiskFactorKey(const string& str) {
     RiskFactorKey rfk(parseRiskFactorKeyType(tokens[0]), tokens[1], parseInteger(tokens[2]));
     return rfk;
 }
+
+std::size_t hash_value(const RiskFactorKey& key) {
+    std::size_t seed = 0;
+    boost::hash_combine(seed, static_cast<int>(key.keytype));
+    boost::hash_combine(seed, key.name);
+    boost::hash_combine(seed, key.index);
+    return seed;
+}
 } // namespace analytics
 } // namespace ore
@@ -121,6 +121,9 @@ std::ostream& operator<<(std::ostream& out, const RiskFactorKey& key);
 RiskFactorKey::KeyType parseRiskFactorKeyType(const string& str);
 RiskFactorKey parseRiskFactorKey(const string& str);
 
+//! Hash function for RiskFactorKey, enables boost::hash<RiskFactorKey>
+std::size_t hash_value(const RiskFactorKey& key);
+
 //-----------------------------------------------------------------------------------------------
 //! Scenario Base Class
 /*! A scenario contains a single cross asset model sample in terms of
@@ -49,7 +49,12 @@ ScenarioGeneratorBuilder::build(boost::shared_ptr<QuantExt::CrossAssetModel> mod
 
     QL_REQUIRE(initMarket != NULL, "ScenarioGeneratorBuilder: initMarket is null");
 
-    auto pathGen = pf->build(data_->sequenceType(), model->stateProcess(), data_->getGrid()->timeGrid(), data_->seed(),
+    boost::shared_ptr<PathGeneratorFactory> factory = pf;
+    if (factory == nullptr)
+        factory = boost::make_shared<BatchedMultiPathGeneratorFactory>(
+            std::max<Size>(std::min<Size>(data_->samples(), 1024), 1));
+
+    auto pathGen = factory->build(data_->sequenceType(), model->stateProcess(), data_->getGrid()->timeGrid(), data_->seed(),
                              data_->ordering(), data_->directionIntegers());
 
     return boost::make_shared<CrossAssetModelScenarioGenerator>(model, pathGen, scenarioFactory, marketConfig, asof,
@@ -59,13 +59,14 @@ public:
     //! Constructor
     ScenarioGeneratorBuilder(boost::shared_ptr<ScenarioGeneratorData> data) : data_(data) {}
 
-    //! Build function
+    /*! Build function, if no path generator factory is given, a BatchedMultiPathGeneratorFactory with a batch size
+        of at most 1024 samples is used */
     boost::shared_ptr<ScenarioGenerator>
     build(boost::shared_ptr<QuantExt::CrossAssetModel> model, boost::shared_ptr<ScenarioFactory> sf,
           boost::shared_ptr<ScenarioSimMarketParameters> marketConfig, Date asof,
           boost::shared_ptr<ore::data::Market> initMarket,
           const std::string& configuration = ore::data::Market::defaultConfiguration,
-          const boost::shared_ptr<PathGeneratorFactory>& pf = boost::make_shared<MultiPathGeneratorFactory>());
+          const boost::shared_ptr<PathGeneratorFactory>& pf = nullptr);
 
 private:
     boost::shared_ptr<ScenarioGeneratorData> data_;
@@ -2726,7 +2726,10 @@ void ScenarioSimMarket::reset() {
     cachedSimData_.clear();
     cachedSimDataActive_.clear();
     // reset term structures
-    applyScenario(baseScenario_);
+    if (ObservationMode::instance().mode() == ObservationMode::Mode::Targeted)
+        applyScenarioTargeted(baseScenario_);
+    else
+        applyScenario(baseScenario_);
     // see the comment in update() for why this is necessary...
     if (ObservationMode::instance().mode() == ObservationMode::Mode::Unregister) {
         boost::shared_ptr<QuantLib::Observable> obs = QuantLib::Settings::instance().evaluationDate();
@@ -2817,6 +2820,152 @@ void ScenarioSimMarket::applyScenario(const boost::shared_ptr<Scenario>& scenari
     }
 }
 
+boost::shared_ptr<TermStructure> ScenarioSimMarket::simDataTermStructure(const RiskFactorKey::KeyType keyType,
+                                                                         const std::string& name) const {
+    auto find = [&name](const auto& m) {
+        using P = std::decay_t<decltype(m.begin()->second.currentLink())>;
+        auto it = m.find(make_pair(Market::defaultConfiguration, name));
+        return it == m.end() ? P() : it->second.currentLink();
+    };
+    boost::shared_ptr<TermStructure> ts;
+    switch (keyType) {
+    case RiskFactorKey::KeyType::DiscountCurve:
+    case RiskFactorKey::KeyType::YieldCurve:
+    case RiskFactorKey::KeyType::DividendYield: {
+        auto it = yieldCurves_.find(make_tuple(Market::defaultConfiguration, riskFactorYieldCurve(keyType), name));
+        if (it != yieldCurves_.end())
+            ts = it->second.currentLink();
+        break;
+    }
+    case RiskFactorKey::KeyType::IndexCurve:
+        if (auto i = find(iborIndices_))
+            ts = i->forwardingTermStructure().currentLink();
+        break;
+    case RiskFactorKey::KeyType::SwaptionVolatility:
+        ts = find(swaptionCurves_);
+        break;
+    case RiskFactorKey::KeyType::YieldVolatility:
+        ts = find(yieldVolCurves_);
+        break;
+    case RiskFactorKey::KeyType::OptionletVolatility:
+        ts = find(capFloorCurves_);
+        break;
+    case RiskFactorKey::KeyType::SurvivalProbability:
+        if (auto c = find(defaultCurves_))
+            ts = c->curve().currentLink();
+        break;
+    case RiskFactorKey::KeyType::CDSVolatility:
+        ts = find(cdsVols_);
+        break;
+    case RiskFactorKey::KeyType::BaseCorrelation:
+        ts = find(baseCorrelations_);
+        break;
+    case RiskFactorKey::KeyType::FXVolatility:
+        ts = find(fxVols_);
+        break;
+    case RiskFactorKey::KeyType::EquityVolatility:
+        ts = find(equityVols_);
+        break;
+    case RiskFactorKey::KeyType::ZeroInflationCurve:
+        if (auto i = find(zeroInflationIndices_))
+            ts = i->zeroInflationTermStructure().currentLink();
+        break;
+    case RiskFactorKey::KeyType::YoYInflationCurve:
+        if (auto i = find(yoyInflationIndices_))
+            ts = i->yoyInflationTermStructure().currentLink();
+        break;
+    case RiskFactorKey::KeyType::ZeroInflationCapFloorVolatility:
+        ts = find(cpiInflationCapFloorVolatilitySurfaces_);
+        break;
+    case RiskFactorKey::KeyType::YoYInflationCapFloorVolatility:
+        ts = find(yoyCapFloorVolSurfaces_);
+        break;
+    case RiskFactorKey::KeyType::CommodityCurve:
+        if (auto i = find(commodityIndices_))
+            ts = i->priceCurve().currentLink();
+        break;
+    case RiskFactorKey::KeyType::CommodityVolatility:
+        ts = find(commodityVols_);
+        break;
+    case RiskFactorKey::KeyType::Correlation: {
+        vector<string> tokens = getCorrelationTokens(name);
+        if (tokens.size() == 2) {
+            auto it = correlationCurves_.find(make_tuple(Market::defaultConfiguration, tokens[0], tokens[1]));
+            if (it != correlationCurves_.end())
+                ts = it->second.currentLink();
+        }
+        break;
+    }
+    default:
+        // fx spots, equity spots, recovery rates, security spreads etc. are observed directly
+        break;
+    }
+    return ts;
+}
+
+void ScenarioSimMarket::applyScenarioTargeted(const boost::shared_ptr<Scenario>& scenario) {
+
+    // build the dependency index from sim data quotes to the term structures they feed on first use
+
+    if (targetedQuotes_.size() != simData_.size()) {
+        targetedQuotes_.clear();
+        targetedQuoteTs_.clear();
+        targetedTs_.clear();
+        std::map<std::pair<RiskFactorKey::KeyType, string>, Size> keyTs;
+        std::map<boost::shared_ptr<TermStructure>, Size> tsPos;
+        for (auto const& d : simData_) {
+            auto k = keyTs.find(std::make_pair(d.first.keytype, d.first.name));
+            if (k == keyTs.end()) {
+                Size pos = Null<Size>();
+                if (auto ts = simDataTermStructure(d.first.keytype, d.first.name)) {
+                    auto p = tsPos.insert(std::make_pair(ts, targetedTs_.size()));
+                    if (p.second)
+                        targetedTs_.push_back(ts);
+                    pos = p.first->second;
+                }
+                k = keyTs.insert(std::make_pair(std::make_pair(d.first.keytype, d.first.name), pos)).first;
+            }
+            targetedQuotes_.push_back(d.second);
+            targetedQuoteTs_.push_back(k->second);
+        }
+        targetedValues_.resize(targetedQuotes_.size());
+        DLOG("ScenarioSimMarket: built targeted update index for " << targetedQuotes_.size() << " quotes and "
+                                                                    << targetedTs_.size() << " term structures");
+    }
+
+    for (Size i = 0; i < targetedQuotes_.size(); ++i)
+        targetedValues_[i] = targetedQuotes_[i]->isValid() ? targetedQuotes_[i]->value() : Null<Real>();
+
+    // set the quotes without notifications
+
+    ObservableSettings::instance().disableUpdates(false);
+    try {
+        applyScenario(scenario);
+    } catch (...) {
+        ObservableSettings::instance().enableUpdates();
+        throw;
+    }
+    ObservableSettings::instance().enableUpdates();
+
+    // notify the directly observed quotes that changed and update the affected term structures once each, their
+    // observers (e.g. instruments) are notified from there
+
+    std::vector<bool> dirty(targetedTs_.size(), false);
+    for (Size i = 0; i < targetedQuotes_.size(); ++i) {
+        Real v = targetedQuotes_[i]->isValid() ? targetedQuotes_[i]->value() : Null<Real>();
+        if (v == targetedValues_[i])
+            continue;
+        if (targetedQuoteTs_[i] == Null<Size>())
+            targetedQuotes_[i]->notifyObservers();
+        else
+            dirty[targetedQuoteTs_[i]] = true;
+    }
+    for (Size j = 0; j < targetedTs_.size(); ++j) {
+        if (dirty[j])
+            targetedTs_[j]->deepUpdate();
+    }
+}
+
 void ScenarioSimMarket::preUpdate() {
     ObservationMode::Mode om = ObservationMode::instance().mode();
     if (om == ObservationMode::Mode::Disable)
@@ -2848,7 +2997,10 @@ void ScenarioSimMarket::updateScenario(const Date& d) {
                "Invalid Scenario date " << scenario->asof() << ", expected " << d);
     numeraire_ = scenario->getNumeraire();
     label_ = scenario->label();
-    applyScenario(scenario);
+    if (ObservationMode::instance().mode() == ObservationMode::Mode::Targeted)
+        applyScenarioTargeted(scenario);
+    else
+        applyScenario(scenario);
 }
 
 void ScenarioSimMarket::postUpdate(const Date& d, bool withFixings) {
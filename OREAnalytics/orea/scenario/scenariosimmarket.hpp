@@ -187,6 +187,16 @@ public:
 protected:
     virtual void applyScenario(const boost::shared_ptr<Scenario>& scenario);
 
+    /*! Apply a scenario with notifications disabled and update only the term structures built on the sim data quotes
+        that were changed by the scenario, this is used in ObservationMode::Mode::Targeted. Changed quotes that do not
+        feed into a term structure of this market notify their observers directly. */
+    void applyScenarioTargeted(const boost::shared_ptr<Scenario>& scenario);
+
+    /*! Return the term structure of this market built on the sim data quotes for the given risk factor, or a null
+        pointer if the quotes are observed directly (e.g. fx spots) or the term structure is not found */
+    boost::shared_ptr<TermStructure> simDataTermStructure(const RiskFactorKey::KeyType keyType,
+                                                          const std::string& name) const;
+
     void writeSimData(std::map<RiskFactorKey, boost::shared_ptr<SimpleQuote>>& simDataTmp,
                       std::map<RiskFactorKey, Real>& absoluteSimDataTmp);
 
@@ -230,6 +240,13 @@ protected:
     IborFallbackConfig iborFallbackConfig_;
 
     mutable boost::shared_ptr<Scenario> currentScenario_;
+
+    // dependency index for ObservationMode::Mode::Targeted, built on first use: for each sim data quote the position
+    // of the term structure it feeds in targetedTs_ (or Null<Size>() if observed directly) and its previous value
+    std::vector<boost::shared_ptr<SimpleQuote>> targetedQuotes_;
+    std::vector<Size> targetedQuoteTs_;
+    std::vector<Real> targetedValues_;
+    std::vector<boost::shared_ptr<TermStructure>> targetedTs_;
 };
 } // namespace analytics
 } // namespace ore
@@ -33,14 +33,21 @@ void ScenarioSimMarketPlus::applyScenario(const boost::shared_ptr<ore::analytics
       delta scenarios! */
 
     if (deltaScenario != nullptr) {
-        for (auto const& key : diffToBaseKeys_) {
-            auto it = simData_.find(key);
+        currentScenario_ = scenario;
+        auto delta = deltaScenario->delta();
+        // only restore the keys of the previous scenario which are not shifted again in this one, so that
+        // consecutive scenarios on the same risk factor do not notify the dependent term structures twice
+        for (auto k = diffToBaseKeys_.begin(); k != diffToBaseKeys_.end();) {
+            if (delta->has(*k) && filter_->allow(*k)) {
+                ++k;
+                continue;
+            }
+            auto it = simData_.find(*k);
             if (it != simData_.end()) {
-                it->second->setValue(baseScenario_->get(key));
+                it->second->setValue(baseScenario_->get(*k));
             }
+            k = diffToBaseKeys_.erase(k);
         }
-        diffToBaseKeys_.clear();
-        auto delta = deltaScenario->delta();
         for (auto const& key : delta->keys()) {
             auto it = simData_.find(key);
             if (it == simData_.end()) {
@@ -56,7 +63,9 @@ void ScenarioSimMarketPlus::applyScenario(const boost::shared_ptr<ore::analytics
         QL_REQUIRE(!missingPoint, "simulation data points missing from scenario, exit.");
         asof_ = scenario->asof();
     } else {
+        // a full scenario overwrites all sim data, e.g. the base scenario in reset()
         ScenarioSimMarket::applyScenario(scenario);
+        diffToBaseKeys_.clear();
     }
 }
 } // namespace analytics
@@ -28,12 +28,20 @@
 namespace ore {
 namespace analytics {
 
+//! Scenario sim market with optimised delta scenario processing
+/*! Delta scenarios are applied relative to the previously applied scenario: only the quotes shifted in the previous
+    or the current scenario are touched, all other quotes are assumed to be at their base scenario values. This
+    requires that the delta scenarios are relative to this market's base scenario, as is the case for the scenarios
+    produced by the SensitivityScenarioGenerator with a DeltaScenarioFactory.
+    \ingroup scenario
+*/
 class ScenarioSimMarketPlus : public ore::analytics::ScenarioSimMarket {
 public:
     using ScenarioSimMarket::ScenarioSimMarket;
 
 private:
     void applyScenario(const boost::shared_ptr<ore::analytics::Scenario>& scenario) override;
+    // keys for which the sim data differs from the base scenario
     std::set<ore::analytics::RiskFactorKey> diffToBaseKeys_;
 };
 
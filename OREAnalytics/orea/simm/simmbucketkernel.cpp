@@ -0,0 +1,158 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/simm/simmbucketkernel.hpp>
+
+#include <ql/errors.hpp>
+#include <ql/utilities/null.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+using QuantLib::Array;
+using QuantLib::Matrix;
+using QuantLib::Null;
+using QuantLib::Real;
+using QuantLib::Size;
+using std::vector;
+
+namespace ore {
+namespace analytics {
+
+SimmBucketKernel::SimmBucketKernel(const vector<Real>& weights, const vector<Real>& concentrationFactors,
+                                   const vector<Size>& groups, const vector<Real>& thresholds,
+                                   const Matrix& correlation)
+    : weights_(weights), concentrationFactors_(concentrationFactors), groups_(groups), thresholds_(thresholds) {
+
+    Size n = weights_.size();
+    QL_REQUIRE(concentrationFactors_.size() == n, "SimmBucketKernel: concentration factors size ("
+                                                      << concentrationFactors_.size() << ") does not match weights size ("
+                                                      << n << ")");
+    QL_REQUIRE(groups_.size() == n,
+               "SimmBucketKernel: groups size (" << groups_.size() << ") does not match weights size (" << n << ")");
+    QL_REQUIRE(correlation.rows() == n && correlation.columns() == n,
+               "SimmBucketKernel: correlation matrix is " << correlation.rows() << "x" << correlation.columns()
+                                                          << ", expected " << n << "x" << n);
+
+    Size nGroups = thresholds_.size();
+    Size firstGroup = Null<Size>();
+    for (auto& g : groups_) {
+        if (g == Null<Size>()) {
+            g = nGroups;
+            continue;
+        }
+        QL_REQUIRE(g < nGroups, "SimmBucketKernel: group " << g << " out of range, have " << nGroups << " groups");
+        if (firstGroup == Null<Size>())
+            firstGroup = g;
+        else if (g != firstGroup)
+            singleGroup_ = false;
+    }
+
+    correlation_.resize(n * n);
+    for (Size k = 0; k < n; ++k) {
+        for (Size l = 0; l < n; ++l)
+            correlation_[k * n + l] = k == l ? 1.0 : correlation[k][l];
+    }
+}
+
+Real SimmBucketKernel::compute(const Real* amounts, Real& sumWeightedSensis, vector<Real>& cr, vector<Real>& ws,
+                               vector<Real>& f) const {
+
+    Size n = weights_.size();
+    Size nGroups = thresholds_.size();
+
+    // concentration risk per group, the last entry is for the factors without group
+    std::fill(cr.begin(), cr.end(), 0.0);
+    for (Size k = 0; k < n; ++k)
+        cr[groups_[k]] += concentrationFactors_[k] * amounts[k];
+    for (Size g = 0; g < nGroups; ++g)
+        cr[g] = std::max(1.0, std::sqrt(std::abs(cr[g]) / thresholds_[g]));
+    cr[nGroups] = 1.0;
+
+    // weighted sensitivities
+    sumWeightedSensis = 0.0;
+    for (Size k = 0; k < n; ++k) {
+        ws[k] = weights_[k] * amounts[k] * cr[groups_[k]];
+        sumWeightedSensis += ws[k];
+    }
+
+    // quadratic form ws^T (rho * f) ws
+    Real k2 = 0.0;
+    if (singleGroup_) {
+        for (Size k = 0; k < n; ++k) {
+            const Real* rho = &correlation_[k * n];
+            Real tmp = 0.0;
+            for (Size l = 0; l < n; ++l)
+                tmp += rho[l] * ws[l];
+            k2 += ws[k] * tmp;
+        }
+    } else {
+        Size m = nGroups + 1;
+        for (Size g = 0; g < m; ++g) {
+            for (Size h = 0; h < m; ++h) {
+                f[g * m + h] = g == h || g == nGroups || h == nGroups
+                                   ? 1.0
+                                   : std::min(cr[g], cr[h]) / std::max(cr[g], cr[h]);
+            }
+        }
+        for (Size k = 0; k < n; ++k) {
+            const Real* rho = &correlation_[k * n];
+            const Real* fk = &f[groups_[k] * m];
+            Real tmp = 0.0;
+            for (Size l = 0; l < n; ++l)
+                tmp += rho[l] * fk[groups_[l]] * ws[l];
+            k2 += ws[k] * tmp;
+        }
+    }
+
+    return std::sqrt(std::max(k2, 0.0));
+}
+
+Real SimmBucketKernel::margin(const Real* amounts, Real& sumWeightedSensis, Real* concentrationRisk,
+                              Real* weightedSensis) const {
+    Size m = thresholds_.size() + 1;
+    vector<Real> cr(m), ws(weights_.size()), f(m * m);
+    Real k = compute(amounts, sumWeightedSensis, cr, ws, f);
+    if (concentrationRisk)
+        std::copy(cr.begin(), cr.end() - 1, concentrationRisk);
+    if (weightedSensis)
+        std::copy(ws.begin(), ws.end(), weightedSensis);
+    return k;
+}
+
+void SimmBucketKernel::margins(const Matrix& amounts, Array& margins, Array& sumWeightedSensis,
+                               Matrix* concentrationRisk) const {
+    QL_REQUIRE(amounts.columns() == weights_.size(), "SimmBucketKernel: amounts have "
+                                                         << amounts.columns() << " columns, expected "
+                                                         << weights_.size());
+    Size rows = amounts.rows();
+    Size m = thresholds_.size() + 1;
+    margins = Array(rows);
+    sumWeightedSensis = Array(rows);
+    if (concentrationRisk)
+        *concentrationRisk = Matrix(rows, thresholds_.size());
+    vector<Real> cr(m), ws(weights_.size()), f(m * m);
+    for (Size i = 0; i < rows; ++i) {
+        margins[i] = compute(amounts.row_begin(i), sumWeightedSensis[i], cr, ws, f);
+        if (concentrationRisk)
+            std::copy(cr.begin(), cr.end() - 1, concentrationRisk->row_begin(i));
+    }
+}
+
+} // namespace analytics
+} // namespace ore
@@ -0,0 +1,96 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/simm/simmbucketkernel.hpp
+    \brief Compiled weighted sensitivity aggregation within a SIMM bucket
+*/
+
+#pragma once
+
+#include <ql/math/array.hpp>
+#include <ql/math/matrix.hpp>
+#include <ql/types.hpp>
+
+#include <vector>
+
+namespace ore {
+namespace analytics {
+
+/*! Compiled representation of the risk factors within a SIMM bucket
+
+    The risk factors are identified by their position \f$k = 0, \ldots, K-1\f$, the risk weights and correlations
+    are tabulated once, so that the bucket margin can be computed for any number of sensitivity vectors without
+    looking up the SIMM configuration again. Given the amounts \f$s_k\f$ the kernel computes
+
+    - the concentration risk per concentration group \f$g\f$
+      \f$ CR_g = \max\left(1, \sqrt{\left|\sum_{k \in g} c_k s_k\right| / T_g}\right) \f$
+    - the weighted sensitivities \f$ WS_k = w_k s_k CR_{g(k)} \f$
+    - the bucket margin \f$ K = \sqrt{\max\left(0, \sum_{k,l} \rho_{k,l} f_{k,l} WS_k WS_l\right)} \f$
+      with \f$ f_{k,l} = \min(CR_{g(k)}, CR_{g(l)}) / \max(CR_{g(k)}, CR_{g(l)}) \f$
+
+    where \f$w_k\f$ is the risk weight including any \f$\sigma_k\f$ and historical volatility ratio, \f$c_k\f$
+    is the contribution of the factor to the concentration sum and \f$T_g\f$ the concentration threshold. Factors
+    without a concentration group (group \c Null<Size>()) have a concentration risk of one and \f$f_{k,l} = 1\f$
+    for any other factor \f$l\f$, as have factors in the same group.
+*/
+class SimmBucketKernel {
+public:
+    SimmBucketKernel() = default;
+    /*! \param weights              risk weights \f$w_k\f$
+        \param concentrationFactors contributions \f$c_k\f$ to the concentration sum of the factor's group
+        \param groups               concentration group of each factor or \c Null<Size>()
+        \param thresholds           concentration threshold \f$T_g\f$ for each group
+        \param correlation          correlations \f$\rho_{k,l}\f$, the diagonal is ignored
+    */
+    SimmBucketKernel(const std::vector<QuantLib::Real>& weights,
+                     const std::vector<QuantLib::Real>& concentrationFactors, const std::vector<QuantLib::Size>& groups,
+                     const std::vector<QuantLib::Real>& thresholds, const QuantLib::Matrix& correlation);
+
+    //! Number of risk factors
+    QuantLib::Size size() const { return weights_.size(); }
+    //! Number of concentration groups
+    QuantLib::Size groups() const { return thresholds_.size(); }
+
+    /*! Returns the bucket margin \f$K\f$ for the amounts given in factor order and sets \p sumWeightedSensis to
+        \f$\sum_k WS_k\f$. If given, the concentration risk per group and the weighted sensitivities are written to
+        \p concentrationRisk and \p weightedSensis. */
+    QuantLib::Real margin(const QuantLib::Real* amounts, QuantLib::Real& sumWeightedSensis,
+                          QuantLib::Real* concentrationRisk = nullptr, QuantLib::Real* weightedSensis = nullptr) const;
+
+    /*! Batch version, each row of \p amounts is one sensitivity vector, e.g. per scenario or date. The output
+        arrays are resized to the number of rows, \p concentrationRisk to rows x groups if given. */
+    void margins(const QuantLib::Matrix& amounts, QuantLib::Array& margins, QuantLib::Array& sumWeightedSensis,
+                 QuantLib::Matrix* concentrationRisk = nullptr) const;
+
+private:
+    QuantLib::Real compute(const QuantLib::Real* amounts, QuantLib::Real& sumWeightedSensis,
+                           std::vector<QuantLib::Real>& concentrationRisk, std::vector<QuantLib::Real>& weightedSensis,
+                           std::vector<QuantLib::Real>& f) const;
+
+    std::vector<QuantLib::Real> weights_, concentrationFactors_;
+    // group per factor, factors without group are mapped to the additional group groups()
+    std::vector<QuantLib::Size> groups_;
+    std::vector<QuantLib::Real> thresholds_;
+    // correlation with unit diagonal, row major
+    std::vector<QuantLib::Real> correlation_;
+    // true if there is at most one group, then f = 1 everywhere
+    bool singleGroup_ = true;
+};
+
+} // namespace analytics
+} // namespace ore
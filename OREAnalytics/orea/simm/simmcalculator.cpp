@@ -18,6 +18,7 @@
 
 #include <orea/simm/crifrecord.hpp>
 #include <orea/simm/crifloader.hpp>
+#include <orea/simm/simmbucketkernel.hpp>
 #include <orea/simm/simmcalculator.hpp>
 #include <orea/simm/utilities.hpp>
 
@@ -41,6 +42,7 @@ using std::pair;
 using std::set;
 using std::sqrt;
 using std::string;
+using std::vector;
 
 using ore::data::checkCurrency;
 using ore::data::NettingSetDetails;
@@ -48,7 +50,10 @@ using ore::data::Market;
 using ore::data::to_string;
 using ore::data::parseBool;
 using QuantLib::close_enough;
+using QuantLib::Matrix;
+using QuantLib::Null;
 using QuantLib::Real;
+using QuantLib::Size;
 
 namespace ore {
 namespace analytics {
@@ -491,101 +496,35 @@ pair<map<string, Real>, bool> SimmCalculator::irDeltaMargin(const NettingSetDeta
                                            << inflationCount);
         auto itInflation = ssQualifierIndex.find(make_tuple(nettingSetDetails, pc, RiskType::Inflation, qualifier));
 
-        // One pass to get the concentration risk for this qualifier
-        // Note: XccyBasis is not included in the calculation of concentration risk and the XccyBasis sensitivity
-        //       is not scaled by it
+        // Collect the amounts in factor order: IRCurve tenors, then Inflation and XccyBasis, if any
+        vector<const CrifRecord*> irRecords;
+        vector<Real> amounts;
+        string key = to_string(RiskType::IRCurve) + '|' + qualifier;
         for (auto it = pIrQualifier.first; it != pIrQualifier.second; ++it) {
-            concentrationRisk[qualifier] += it->amountUsd;
+            irRecords.push_back(&*it);
+            amounts.push_back(it->amountUsd);
+            key += '|' + it->label1 + '|' + it->label2;
         }
-        // Add inflation sensitivity to the concentration risk
         if (itInflation != ssQualifierIndex.end()) {
-            concentrationRisk[qualifier] += itInflation->amountUsd;
-        }
-        // Divide by the concentration risk threshold
-        concentrationRisk[qualifier] /= simmConfiguration_->concentrationThreshold(RiskType::IRCurve, qualifier);
-        // Final concentration risk amount
-        concentrationRisk[qualifier] = max(1.0, sqrt(std::abs(concentrationRisk[qualifier])));
-
-        // Calculate the delta margin piece for this qualifier i.e. $K_b$ from SIMM docs
-        for (auto itOuter = pIrQualifier.first; itOuter != pIrQualifier.second; ++itOuter) {
-            // Risk weight i.e. $RW_k$ from SIMM docs
-            Real rwOuter = simmConfiguration_->weight(RiskType::IRCurve, qualifier, itOuter->label1);
-            // Weighted sensitivity i.e. $WS_{k,i}$ from SIMM docs
-            Real wsOuter = rwOuter * itOuter->amountUsd * concentrationRisk[qualifier];
-            // Update weighted sensitivity sum
-            sumWeightedSensis[qualifier] += wsOuter;
-            // Add diagonal element to delta margin
-            deltaMargin[qualifier] += wsOuter * wsOuter;
-            // Add the cross elements to the delta margin
-            for (auto itInner = pIrQualifier.first; itInner != itOuter; ++itInner) {
-                // Label2 level correlation i.e. $\phi_{i,j}$ from SIMM docs
-                Real subCurveCorr = simmConfiguration_->correlation(RiskType::IRCurve, qualifier, "", itOuter->label2,
-                                                                    RiskType::IRCurve, qualifier, "", itInner->label2);
-                // Label1 level correlation i.e. $\rho_{k,l}$ from SIMM docs
-                Real tenorCorr = simmConfiguration_->correlation(RiskType::IRCurve, qualifier, itOuter->label1, "",
-                                                                 RiskType::IRCurve, qualifier, itInner->label1, "");
-                // Add cross element to delta margin
-                Real rwInner = simmConfiguration_->weight(RiskType::IRCurve, qualifier, itInner->label1);
-                Real wsInner = rwInner * itInner->amountUsd * concentrationRisk[qualifier];
-                deltaMargin[qualifier] += 2 * subCurveCorr * tenorCorr * wsOuter * wsInner;
-            }
+            amounts.push_back(itInflation->amountUsd);
+            key += "|Inflation|" + itInflation->label1;
         }
-
-        // Add the Inflation component, if any
-        Real wsInflation = 0.0;
-        if (itInflation != ssQualifierIndex.end()) {
-            // Risk weight
-            Real rwInflation = simmConfiguration_->weight(RiskType::Inflation, qualifier, itInflation->label1);
-            // Weighted sensitivity
-            wsInflation = rwInflation * itInflation->amountUsd * concentrationRisk[qualifier];
-            // Update weighted sensitivity sum
-            sumWeightedSensis[qualifier] += wsInflation;
-            // Add diagonal element to delta margin
-            deltaMargin[qualifier] += wsInflation * wsInflation;
-            // Add the cross elements (Inflation with IRCurve tenors) to the delta margin
-            // Correlation (know that Label1 and Label2 do not matter)
-            Real corr = simmConfiguration_->correlation(RiskType::IRCurve, qualifier, "", "", RiskType::Inflation,
-                                                        qualifier, "", "");
-            for (auto it = pIrQualifier.first; it != pIrQualifier.second; ++it) {
-                // Add cross element to delta margin
-                Real rw = simmConfiguration_->weight(RiskType::IRCurve, qualifier, it->label1);
-                Real ws = rw * it->amountUsd * concentrationRisk[qualifier];
-                deltaMargin[qualifier] += 2 * corr * ws * wsInflation;
-            }
-        }
-
-        // Add the XccyBasis component, if any
         if (itXccy != ssQualifierIndex.end()) {
-            // Risk weight
-            Real rwXccy = simmConfiguration_->weight(RiskType::XCcyBasis, qualifier, itXccy->label1);
-            // Weighted sensitivity (no concentration risk here)
-            Real wsXccy = rwXccy * itXccy->amountUsd;
-            // Update weighted sensitivity sum
-            sumWeightedSensis[qualifier] += wsXccy;
-            // Add diagonal element to delta margin
-            deltaMargin[qualifier] += wsXccy * wsXccy;
-            // Add the cross elements (XccyBasis with IRCurve tenors) to the delta margin
-            // Correlation (know that Label1 and Label2 do not matter)
-            Real corr = simmConfiguration_->correlation(RiskType::IRCurve, qualifier, "", "", RiskType::XCcyBasis,
-                                                        qualifier, "", "");
-            for (auto it = pIrQualifier.first; it != pIrQualifier.second; ++it) {
-                // Add cross element to delta margin
-                Real rw = simmConfiguration_->weight(RiskType::IRCurve, qualifier, it->label1, calculationCcy_);
-                Real ws = rw * it->amountUsd * concentrationRisk[qualifier];
-                deltaMargin[qualifier] += 2 * corr * ws * wsXccy;
-            }
-
-            // Inflation vs. XccyBasis cross component if any
-            if (itInflation != ssQualifierIndex.end()) {
-                // Correlation (know that Label1 and Label2 do not matter)
-                Real corr = simmConfiguration_->correlation(RiskType::Inflation, qualifier, "", "", RiskType::XCcyBasis,
-                                                            qualifier, "", "");
-                deltaMargin[qualifier] += 2 * corr * wsInflation * wsXccy;
-            }
+            amounts.push_back(itXccy->amountUsd);
+            key += "|XCcyBasis|" + itXccy->label1;
         }
 
-        // Finally have the value of $K_b$
-        deltaMargin[qualifier] = sqrt(max(deltaMargin[qualifier], 0.0));
+        const SimmBucketKernel& kernel = bucketKernel(key, [&]() {
+            return irDeltaKernel(qualifier, irRecords, itInflation == ssQualifierIndex.end() ? nullptr : &*itInflation,
+                                 itXccy == ssQualifierIndex.end() ? nullptr : &*itXccy);
+        });
+
+        // The delta margin for this qualifier i.e. $K_b$ from SIMM docs, and its concentration risk
+        // Note: XccyBasis is not included in the calculation of concentration risk and the XccyBasis sensitivity
+        //       is not scaled by it
+        Real cr;
+        deltaMargin[qualifier] = kernel.margin(amounts.data(), sumWeightedSensis[qualifier], &cr);
+        concentrationRisk[qualifier] = cr;
     }
 
     // Now calculate final IR delta margin by aggregating across currencies
@@ -961,8 +900,6 @@ pair<map<string, Real>, bool> SimmCalculator::margin(const NettingSetDetails& ne
     map<string, Real> bucketMargin;
     // The sum of the weighted sensitivities for each bucket i.e. $\sum_{k=1}^{K} WS_{k}$ from SIMM docs
     map<string, Real> sumWeightedSensis;
-    // The historical volatility ratio for the risk type - will be 1.0 if not applicable
-    Real hvr = simmConfiguration_->historicalVolatilityRatio(rt);
 
     // Loop over the buckets
     for (const auto& kv : buckets) {
@@ -971,90 +908,38 @@ pair<map<string, Real>, bool> SimmCalculator::margin(const NettingSetDetails& ne
         // Initialise sumWeightedSensis here to ensure it is not empty in the later calculations
         sumWeightedSensis[bucket] = 0.0;
 
-        // Get the concentration risk for each qualifier in current bucket i.e. $CR_k$ from SIMM docs
-        map<string, Real> concentrationRisk;
-        for (const auto& qualifier : buckets.at(bucket)) {
-
-            // Do not include Risk_FX components in the calculation currency in the SIMM calculation
-            if (rt == RiskType::FX && qualifier == calculationCcy_) {
-                if (!quiet_) {
-                    DLOG("Not calculating concentration risk for qualifier "
-                         << qualifier << " of risk type " << rt
-                         << " since the qualifier equals the SIMM calculation currency " << calculationCcy_);
-                }
-                continue;
-            }
-
-            // Pair of iterators to start and end of sensitivities with current qualifier
-            auto pQualifier = ssQualifierIndex.equal_range(make_tuple(nettingSetDetails, pc, rt, bucket, qualifier));
-
-            // One pass to get the concentration risk for this qualifier
-            for (auto it = pQualifier.first; it != pQualifier.second; ++it) {
-                // Get the sigma value if applicable - returns 1.0 if not applicable
-                Real sigma = simmConfiguration_->sigma(rt, it->qualifier, it->label1, calculationCcy_);
-                concentrationRisk[qualifier] += it->amountUsd * sigma * hvr;
-            }
-            // Divide by the concentration risk threshold
-            concentrationRisk[qualifier] /= simmConfiguration_->concentrationThreshold(rt, qualifier);
-            // Final concentration risk amount
-            concentrationRisk[qualifier] = max(1.0, sqrt(std::abs(concentrationRisk[qualifier])));
-        }
-
-        // Calculate the margin component for the current bucket
-        // Pair of iterators to start and end of sensitivities within current bucket
+        // Collect the sensitivities within current bucket in factor order
+        // Do not include Risk_FX components in the calculation currency in the SIMM calculation
+        vector<const CrifRecord*> records;
+        vector<Real> amounts;
+        string key = to_string(rt) + '|' + bucket;
         auto pBucket = ssBucketIndex.equal_range(make_tuple(nettingSetDetails, pc, rt, bucket));
-        for (auto itOuter = pBucket.first; itOuter != pBucket.second; ++itOuter) {
-            // Do not include Risk_FX components in the calculation currency in the SIMM calculation
-            if (rt == RiskType::FX && itOuter->qualifier == calculationCcy_) {
+        for (auto it = pBucket.first; it != pBucket.second; ++it) {
+            if (rt == RiskType::FX && it->qualifier == calculationCcy_) {
                 if (!quiet_) {
-                    DLOG("Skipping qualifier " << itOuter->qualifier << " of risk type " << rt
+                    DLOG("Skipping qualifier " << it->qualifier << " of risk type " << rt
                                                << " since the qualifier equals the SIMM calculation currency "
                                                << calculationCcy_);
                 }
                 continue;
             }
-            // Risk weight i.e. $RW_k$ from SIMM docs
-            Real rwOuter = simmConfiguration_->weight(rt, itOuter->qualifier, itOuter->label1, calculationCcy_);
-            // Get the sigma value if applicable - returns 1.0 if not applicable
-            Real sigmaOuter = simmConfiguration_->sigma(rt, itOuter->qualifier, itOuter->label1, calculationCcy_);
-            // Weighted sensitivity i.e. $WS_{k}$ from SIMM docs
-            Real wsOuter = rwOuter * (itOuter->amountUsd * sigmaOuter * hvr) * concentrationRisk[itOuter->qualifier];
-            // Update weighted sensitivity sum
-            sumWeightedSensis[bucket] += wsOuter;
-            // Add diagonal element to bucket margin
-            bucketMargin[bucket] += wsOuter * wsOuter;
-            // Add the cross elements to the bucket margin
-            for (auto itInner = pBucket.first; itInner != itOuter; ++itInner) {
-                // Do not include Risk_FX components in the calculation currency in the SIMM calculation
-                if (rt == RiskType::FX && itInner->qualifier == calculationCcy_) {
-                    if (!quiet_) {
-                        DLOG("Skipping qualifier " << itInner->qualifier << " of risk type " << rt
-                                                   << " since the qualifier equals the SIMM calculation currency "
-                                                   << calculationCcy_);
-                    }
-                    continue;
-                }
-                // Correlation, $\rho_{k,l}$ in the SIMM docs
-                Real corr = simmConfiguration_->correlation(rt, itOuter->qualifier, itOuter->label1, itOuter->label2,
-                                                            rt, itInner->qualifier, itInner->label1, itInner->label2,
-                                                            calculationCcy_);
-                // $f_{k,l}$ from the SIMM docs
-                Real f = min(concentrationRisk.at(itOuter->qualifier), concentrationRisk.at(itInner->qualifier)) /
-                         max(concentrationRisk.at(itOuter->qualifier), concentrationRisk.at(itInner->qualifier));
-                // Add cross element to delta margin
-                Real sigmaInner = simmConfiguration_->sigma(rt, itInner->qualifier, itInner->label1, calculationCcy_);
-                Real rwInner = simmConfiguration_->weight(rt, itInner->qualifier, itInner->label1, calculationCcy_);
-                Real wsInner =
-                    rwInner * (itInner->amountUsd * sigmaInner * hvr) * concentrationRisk[itInner->qualifier];
-                bucketMargin[bucket] += 2 * corr * f * wsOuter * wsInner;
-            }
-            // For FX risk class, results are broken down by qualifier, i.e. currency, instead of bucket, which is not used for Risk_FX
-            if (riskClassIsFX)
-                bucketMargins[itOuter->qualifier] += wsOuter;
+            records.push_back(&*it);
+            amounts.push_back(it->amountUsd);
+            key += '|' + it->qualifier + '|' + it->label1 + '|' + it->label2;
         }
 
-        // Finally have the value of $K_b$
-        bucketMargin[bucket] = sqrt(max(bucketMargin[bucket], 0.0));
+        const SimmBucketKernel& kernel = bucketKernel(key, [&]() { return marginKernel(rt, records); });
+
+        // The margin for the current bucket i.e. $K_b$ from SIMM docs, the concentration risk $CR_k$ is applied
+        // per qualifier within the bucket
+        vector<Real> weightedSensis(records.size());
+        bucketMargin[bucket] = kernel.margin(amounts.data(), sumWeightedSensis[bucket], nullptr, weightedSensis.data());
+
+        // For FX risk class, results are broken down by qualifier, i.e. currency, instead of bucket, which is not used for Risk_FX
+        if (riskClassIsFX) {
+            for (Size k = 0; k < records.size(); ++k)
+                bucketMargins[records[k]->qualifier] += weightedSensis[k];
+        }
     }
 
     // If there is a "Residual" bucket entry store it separately
@@ -1703,6 +1588,116 @@ void SimmCalculator::addCrifRecord(const CrifRecord& crifRecord, const bool enfo
     }
 }
 
+const SimmBucketKernel& SimmCalculator::bucketKernel(const string& key,
+                                                     const std::function<SimmBucketKernel()>& build) const {
+    auto k = bucketKernels_.find(key);
+    if (k == bucketKernels_.end())
+        k = bucketKernels_.insert(make_pair(key, build())).first;
+    return k->second;
+}
+
+SimmBucketKernel SimmCalculator::irDeltaKernel(const string& qualifier, const vector<const CrifRecord*>& irRecords,
+                                               const CrifRecord* inflation, const CrifRecord* xccy) const {
+
+    Size nIr = irRecords.size();
+    Size n = nIr + (inflation ? 1 : 0) + (xccy ? 1 : 0);
+    vector<Real> weights(n), concentrationFactors(n, 1.0);
+    vector<Size> groups(n, 0);
+    Matrix correlation(n, n, 0.0);
+
+    // Intern the tenors (label1) and sub curves (label2), so that the correlations are looked up once per pair of
+    // labels rather than once per pair of sensitivities
+    map<string, Size> tenorIds, subCurveIds;
+    vector<Size> tenor(nIr), subCurve(nIr);
+    for (Size k = 0; k < nIr; ++k) {
+        weights[k] = simmConfiguration_->weight(RiskType::IRCurve, qualifier, irRecords[k]->label1);
+        tenor[k] = tenorIds.insert(make_pair(irRecords[k]->label1, tenorIds.size())).first->second;
+        subCurve[k] = subCurveIds.insert(make_pair(irRecords[k]->label2, subCurveIds.size())).first->second;
+    }
+    // Label1 level correlation i.e. $\rho_{k,l}$ from SIMM docs
+    Matrix tenorCorr(tenorIds.size(), tenorIds.size(), 0.0);
+    for (const auto& o : tenorIds)
+        for (const auto& i : tenorIds)
+            tenorCorr[o.second][i.second] = simmConfiguration_->correlation(RiskType::IRCurve, qualifier, o.first, "",
+                                                                            RiskType::IRCurve, qualifier, i.first, "");
+    // Label2 level correlation i.e. $\phi_{i,j}$ from SIMM docs
+    Matrix subCurveCorr(subCurveIds.size(), subCurveIds.size(), 0.0);
+    for (const auto& o : subCurveIds)
+        for (const auto& i : subCurveIds)
+            subCurveCorr[o.second][i.second] = simmConfiguration_->correlation(
+                RiskType::IRCurve, qualifier, "", o.first, RiskType::IRCurve, qualifier, "", i.first);
+    for (Size k = 0; k < nIr; ++k)
+        for (Size l = 0; l < nIr; ++l)
+            correlation[k][l] = subCurveCorr[subCurve[k]][subCurve[l]] * tenorCorr[tenor[k]][tenor[l]];
+
+    // Inflation is part of the concentration risk, correlation with the IRCurve tenors does not depend on the labels
+    Size idx = nIr;
+    Size inflationIdx = Null<Size>();
+    if (inflation) {
+        inflationIdx = idx++;
+        weights[inflationIdx] = simmConfiguration_->weight(RiskType::Inflation, qualifier, inflation->label1);
+        Real corr =
+            simmConfiguration_->correlation(RiskType::IRCurve, qualifier, "", "", RiskType::Inflation, qualifier, "", "");
+        for (Size k = 0; k < nIr; ++k)
+            correlation[k][inflationIdx] = correlation[inflationIdx][k] = corr;
+    }
+
+    // XccyBasis is not part of the concentration risk and not scaled by it
+    if (xccy) {
+        Size xccyIdx = idx++;
+        weights[xccyIdx] = simmConfiguration_->weight(RiskType::XCcyBasis, qualifier, xccy->label1);
+        concentrationFactors[xccyIdx] = 0.0;
+        groups[xccyIdx] = Null<Size>();
+        Real corr =
+            simmConfiguration_->correlation(RiskType::IRCurve, qualifier, "", "", RiskType::XCcyBasis, qualifier, "", "");
+        for (Size k = 0; k < nIr; ++k)
+            correlation[k][xccyIdx] = correlation[xccyIdx][k] = corr;
+        if (inflation) {
+            corr = simmConfiguration_->correlation(RiskType::Inflation, qualifier, "", "", RiskType::XCcyBasis,
+                                                   qualifier, "", "");
+            correlation[inflationIdx][xccyIdx] = correlation[xccyIdx][inflationIdx] = corr;
+        }
+    }
+
+    return SimmBucketKernel(weights, concentrationFactors, groups,
+                            {simmConfiguration_->concentrationThreshold(RiskType::IRCurve, qualifier)}, correlation);
+}
+
+SimmBucketKernel SimmCalculator::marginKernel(const RiskType& rt, const vector<const CrifRecord*>& records) const {
+
+    Size n = records.size();
+    vector<Real> weights(n), concentrationFactors(n), thresholds;
+    vector<Size> groups(n);
+    Matrix correlation(n, n, 0.0);
+
+    // The historical volatility ratio for the risk type - will be 1.0 if not applicable
+    Real hvr = simmConfiguration_->historicalVolatilityRatio(rt);
+
+    // The concentration risk is computed per qualifier
+    map<string, Size> qualifierIds;
+    for (Size k = 0; k < n; ++k) {
+        const CrifRecord& r = *records[k];
+        // Risk weight i.e. $RW_k$ and the sigma value if applicable - returns 1.0 if not applicable
+        Real rw = simmConfiguration_->weight(rt, r.qualifier, r.label1, calculationCcy_);
+        Real sigma = simmConfiguration_->sigma(rt, r.qualifier, r.label1, calculationCcy_);
+        weights[k] = rw * sigma * hvr;
+        concentrationFactors[k] = sigma * hvr;
+        auto q = qualifierIds.insert(make_pair(r.qualifier, qualifierIds.size()));
+        if (q.second)
+            thresholds.push_back(simmConfiguration_->concentrationThreshold(rt, r.qualifier));
+        groups[k] = q.first->second;
+        // Correlation, $\rho_{k,l}$ in the SIMM docs
+        for (Size l = 0; l < k; ++l) {
+            const CrifRecord& ri = *records[l];
+            correlation[k][l] = correlation[l][k] =
+                simmConfiguration_->correlation(rt, r.qualifier, r.label1, r.label2, rt, ri.qualifier, ri.label1,
+                                                ri.label2, calculationCcy_);
+        }
+    }
+
+    return SimmBucketKernel(weights, concentrationFactors, groups, thresholds, correlation);
+}
+
 Real SimmCalculator::lambda(Real theta) const {
     // Use boost inverse normal here as opposed to QL. Using QL inverse normal
     // will cause the ISDA SIMM unit tests to fail
@@ -24,9 +24,11 @@
 
 #include <orea/simm/crifrecord.hpp>
 #include <orea/simm/crifloader.hpp>
+#include <orea/simm/simmbucketkernel.hpp>
 #include <orea/simm/simmresults.hpp>
 #include <ored/marketdata/market.hpp>
 
+#include <functional>
 #include <map>
 
 namespace ore {
@@ -149,6 +151,23 @@ private:
 
     std::map<SimmSide, set<string>> finalTradeIds_;
 
+    /*! Compiled bucket kernels, i.e. the tabulated risk weights and correlations, keyed on the risk type, the
+        bucket or qualifier and the risk factors in the bucket. Netting sets, regulations and sides with the same
+        risk factors share a kernel. */
+    mutable std::map<std::string, SimmBucketKernel> bucketKernels_;
+
+    //! Return the cached bucket kernel for the given key, \p build is called if there is none
+    const SimmBucketKernel& bucketKernel(const std::string& key, const std::function<SimmBucketKernel()>& build) const;
+
+    /*! Build the kernel for the IR delta margin of a single currency from its IRCurve sensitivities and
+        optional Inflation and XccyBasis sensitivities */
+    SimmBucketKernel irDeltaKernel(const std::string& qualifier, const std::vector<const CrifRecord*>& irRecords,
+                                   const CrifRecord* inflation, const CrifRecord* xccy) const;
+
+    //! Build the kernel for the delta or vega margin within a bucket for the given risk type
+    SimmBucketKernel marginKernel(const SimmConfiguration::RiskType& rt,
+                                  const std::vector<const CrifRecord*>& records) const;
+
     //! Calculate the Interest Rate delta margin component for the given portfolio and product class
     std::pair<std::map<std::string, QuantLib::Real>, bool>
     irDeltaMargin(const ore::data::NettingSetDetails& nettingSetDetails, const SimmConfiguration::ProductClass& pc,
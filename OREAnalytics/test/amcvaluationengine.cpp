@@ -0,0 +1,143 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <orea/cube/inmemorycube.hpp>
+#include <orea/engine/amcvaluationengine.hpp>
+#include <orea/scenario/scenariogeneratordata.hpp>
+#include <ored/configuration/conventions.hpp>
+#include <ored/configuration/curveconfigurations.hpp>
+#include <ored/marketdata/csvloader.hpp>
+#include <ored/marketdata/todaysmarket.hpp>
+#include <ored/marketdata/todaysmarketparameters.hpp>
+#include <ored/model/crossassetmodelbuilder.hpp>
+#include <ored/model/crossassetmodeldata.hpp>
+#include <ored/portfolio/enginedata.hpp>
+#include <ored/portfolio/enginefactory.hpp>
+#include <ored/portfolio/portfolio.hpp>
+#include <oret/datapaths.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <test/oreatoplevelfixture.hpp>
+
+using namespace std;
+using namespace QuantLib;
+using namespace ore::data;
+using namespace ore::analytics;
+using namespace boost::unit_test_framework;
+
+namespace {
+
+// market data and configuration is taken from the examples
+const string examples = "../../../../Examples/Input/";
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(AMCValuationEngineTest)
+
+#ifdef QL_ENABLE_SESSIONS
+BOOST_AUTO_TEST_CASE(testMultiThreadedCube) {
+
+    BOOST_TEST_MESSAGE("Testing multi-threaded vs single-threaded AMC cube with sticky close-out date...");
+
+    Date asof(5, February, 2016);
+    Settings::instance().evaluationDate() = asof;
+
+    auto conventions = boost::make_shared<Conventions>();
+    conventions->fromFile(examples + "conventions.xml");
+    InstrumentConventions::instance().setConventions(conventions);
+    auto curveConfigs = boost::make_shared<CurveConfigurations>();
+    curveConfigs->fromFile(examples + "curveconfig.xml");
+    auto todaysMarketParams = boost::make_shared<TodaysMarketParameters>();
+    todaysMarketParams->fromFile(examples + "todaysmarket.xml");
+    auto loader =
+        boost::make_shared<CSVLoader>(examples + "market_20160205_flat.txt", examples + "fixings_20160205.txt", true);
+
+    auto sgd = boost::make_shared<ScenarioGeneratorData>();
+    sgd->fromFile(TEST_INPUT_FILE("simulation.xml"));
+    BOOST_REQUIRE(sgd->withCloseOutLag() && sgd->withMporStickyDate());
+    auto camData = boost::make_shared<CrossAssetModelData>();
+    camData->fromFile(TEST_INPUT_FILE("simulation.xml"));
+    auto engineData = boost::make_shared<EngineData>();
+    engineData->fromFile(TEST_INPUT_FILE("pricingengine.xml"));
+    auto portfolio = boost::make_shared<Portfolio>();
+    portfolio->fromFile(TEST_INPUT_FILE("portfolio.xml"));
+
+    const string config = Market::defaultConfiguration;
+    const vector<Date>& dates = sgd->getGrid()->valuationDates();
+    const Size samples = sgd->samples();
+
+    // single-threaded run, the model and trades are set up as in the threads of the multi-threaded run
+
+    auto market = boost::make_shared<TodaysMarket>(asof, todaysMarketParams, loader, curveConfigs, true, true, true);
+    CrossAssetModelBuilder modelBuilder(market, camData, config, config, config, config, config, config, false, true,
+                                        "", SalvagingAlgorithm::None, "amc test cam building");
+    auto model = *modelBuilder.model();
+
+    auto edCopy = boost::make_shared<EngineData>(*engineData);
+    edCopy->globalParameters()["GenerateAdditionalResults"] = "false";
+    edCopy->globalParameters()["RunType"] = "NPV";
+    map<MarketContext, string> configurations{{MarketContext::irCalibration, config},
+                                              {MarketContext::fxCalibration, config},
+                                              {MarketContext::pricing, config}};
+    portfolio->build(boost::make_shared<EngineFactory>(
+        edCopy, market, configurations, nullptr, IborFallbackConfig::defaultConfig(),
+        EngineBuilderFactory::instance().generateAmcEngineBuilders(model, dates), true));
+    BOOST_REQUIRE_EQUAL(portfolio->size(), 2);
+
+    boost::shared_ptr<NPVCube> cube =
+        boost::make_shared<DoublePrecisionInMemoryCubeN>(asof, portfolio->ids(), dates, samples, 2);
+    AMCValuationEngine engine(model, sgd, market, {}, {}, 0);
+    engine.buildCube(portfolio, cube);
+
+    // multi-threaded run, the threads take the trades from a shared queue and value them on shared paths
+
+    AMCValuationEngine mtEngine(
+        2, asof, samples, loader, sgd, {}, {}, 0, camData, engineData, curveConfigs, todaysMarketParams, config, config,
+        config, config, config, config, nullptr, IborFallbackConfig::defaultConfig(), true,
+        [](const Date& asof, const std::set<string>& ids, const vector<Date>& dates, const Size samples) {
+            return boost::make_shared<DoublePrecisionInMemoryCubeN>(asof, ids, dates, samples, 2);
+        });
+    mtEngine.buildCube(portfolio);
+    BOOST_REQUIRE_EQUAL(mtEngine.outputCubes().size(), 1);
+    auto mtCube = mtEngine.outputCubes().front();
+
+    BOOST_REQUIRE(mtCube->idsAndIndexes() == cube->idsAndIndexes());
+    Real maxDiff = 0.0;
+    for (auto const& [id, i] : cube->idsAndIndexes()) {
+        maxDiff = std::max(maxDiff, std::abs(mtCube->getT0(i) - cube->getT0(i)));
+        Real maxCloseOutValue = 0.0;
+        for (Size j = 0; j < dates.size(); ++j) {
+            for (Size k = 0; k < samples; ++k) {
+                for (Size d = 0; d < 2; ++d)
+                    maxDiff = std::max(maxDiff, std::abs(mtCube->get(i, j, k, d) - cube->get(i, j, k, d)));
+                maxCloseOutValue = std::max(maxCloseOutValue, std::abs(cube->get(i, j, k, 1)));
+            }
+        }
+        // the close-out values on the sticky dates are written, for the composite trade as well
+        BOOST_CHECK_MESSAGE(maxCloseOutValue > 1.0, "no close-out values for trade " << id);
+    }
+    BOOST_TEST_MESSAGE("max abs difference multi-threaded vs single-threaded cube " << maxDiff);
+    BOOST_CHECK_SMALL(maxDiff, 1E-6);
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
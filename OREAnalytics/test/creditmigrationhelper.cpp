@@ -0,0 +1,165 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <numeric>
+#include <orea/aggregation/creditmigrationhelper.hpp>
+#include <orea/cube/inmemorycube.hpp>
+#include <orea/scenario/aggregationscenariodata.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <qle/math/matrixfunctions.hpp>
+#include <test/oreatoplevelfixture.hpp>
+
+using namespace QuantLib;
+using namespace ore::data;
+using namespace ore::analytics;
+using namespace boost::unit_test_framework;
+
+namespace {
+
+// a trade that is only used to map issuers and counterparties to trade and netting set ids
+class TestTrade : public Trade {
+public:
+    TestTrade(const std::string& id, const std::string& issuer, const Envelope& env) : Trade("TestTrade", env) {
+        this->id() = id;
+        issuer_ = issuer;
+    }
+    void build(const boost::shared_ptr<EngineFactory>&) override {}
+};
+
+// Moody's average rating transition matrix of all corporates 1980-1999, cf. QuantExt's transition matrix test
+Matrix transitionMatrix() {
+    // clang-format off
+    Real transDataRaw[] = {
+        0.8588, 0.0976, 0.0048, 0.0000, 0.0003, 0.0000, 0.0000, 0.0000,
+        0.0092, 0.8487, 0.0964, 0.0036, 0.0015, 0.0002, 0.0000, 0.0004,
+        0.0008, 0.0224, 0.8624, 0.0609, 0.0077, 0.0021, 0.0000, 0.0002,
+        0.0008, 0.0037, 0.0602, 0.7916, 0.0648, 0.0130, 0.0011, 0.0019,
+        0.0003, 0.0008, 0.0046, 0.0402, 0.7676, 0.0788, 0.0047, 0.0140,
+        0.0001, 0.0004, 0.0016, 0.0053, 0.0586, 0.7607, 0.0274, 0.0660,
+        0.0000, 0.0000, 0.0000, 0.0100, 0.0279, 0.0538, 0.5674, 0.2535,
+        0.0000, 0.0000, 0.0000, 0.0000, 0.0000, 0.0000, 0.0000, 1.0000
+    };
+    // clang-format on
+    return Matrix(8, 8, transDataRaw, transDataRaw + 64);
+}
+
+// computes the pnl distribution on the given number of threads for a small synthetic cube
+std::vector<Array> pnlDistributions(const std::string& evaluation, const std::vector<Size>& threads) {
+
+    Date asof(5, Feb, 2016);
+    std::vector<Date> dates = {asof + 1 * Years, asof + 2 * Years};
+    Size samples = 300, states = 8;
+    // depth: npv, cashflow, npvs by credit state
+    Size cubeIndexCashflows = 1, cubeIndexStateNpvs = 2;
+
+    auto parameters = boost::make_shared<CreditSimulationParameters>();
+    parameters->transitionMatrix()["TM"] = transitionMatrix();
+    parameters->entities() = {"ISSUER", "CPTY"};
+    parameters->factorLoadings() = {Array(1, 0.4), Array(1, 0.6)};
+    parameters->transitionMatrices() = {"TM", "TM"};
+    parameters->initialStates() = {3, 4};
+    parameters->marketRisk() = true;
+    parameters->creditRisk() = true;
+    parameters->zeroMarketPnl() = false;
+    parameters->evaluation() = evaluation;
+    parameters->doubleDefault() = false;
+    parameters->seed() = 42;
+    parameters->paths() = 50;
+    parameters->creditMode() = "Migration";
+    parameters->loanExposureMode() = "Value";
+    parameters->nettingSetIds() = {"NS"};
+
+    std::map<std::string, boost::shared_ptr<Trade>> trades;
+    trades["BOND"] = boost::make_shared<TestTrade>("BOND", "ISSUER", Envelope("OTHER", "NS"));
+    trades["SWAP"] = boost::make_shared<TestTrade>("SWAP", "", Envelope("CPTY", "NS"));
+
+    auto cube = boost::make_shared<InMemoryCubeN<double>>(asof, std::set<std::string>{"BOND", "SWAP"}, dates, samples,
+                                                          cubeIndexStateNpvs + states);
+    auto nettedCube = boost::make_shared<InMemoryCubeN<double>>(asof, std::set<std::string>{"NS"}, dates, samples, 1);
+    auto aggData = boost::make_shared<InMemoryAggregationScenarioData>(dates.size(), samples);
+
+    cube->setT0(100.0, "BOND");
+    cube->setT0(5.0, "SWAP");
+    for (Size d = 0; d < dates.size(); ++d) {
+        for (Size s = 0; s < samples; ++s) {
+            Real x = std::sin(1.0 + d + 0.37 * s);
+            aggData->set(d, s, std::sqrt(d + 1.0) * x, AggregationScenarioDataType::CreditState, "0");
+            cube->set(100.0 + 10.0 * x, 0, d, s, 0);
+            cube->set(2.0, 0, d, s, cubeIndexCashflows);
+            for (Size j = 0; j < states; ++j)
+                cube->set(100.0 + 10.0 * x - 5.0 * j, 0, d, s, cubeIndexStateNpvs + j);
+            cube->set(5.0 + 20.0 * x, 1, d, s, 0);
+            cube->set(0.5, 1, d, s, cubeIndexCashflows);
+            nettedCube->set(5.0 + 20.0 * x, 0, d, s, 0);
+        }
+    }
+
+    CreditMigrationHelper helper(parameters, cube, nettedCube, aggData, cubeIndexCashflows, cubeIndexStateNpvs, -200.0,
+                                 200.0, 100, Matrix(1, 1, 1.0), "EUR");
+    helper.build(trades);
+
+    std::vector<Array> result;
+    for (auto t : threads) {
+        parameters->threads() = t;
+        result.push_back(helper.pnlDistribution(1));
+    }
+    return result;
+}
+
+void testThreads(const std::string& evaluation) {
+    std::vector<Array> dist = pnlDistributions(evaluation, {1, 2, 4});
+    BOOST_CHECK(std::accumulate(dist[0].begin(), dist[0].end(), 0.0) > 0.0);
+    for (Size t = 1; t < dist.size(); ++t) {
+        BOOST_REQUIRE_EQUAL(dist[t].size(), dist[0].size());
+        for (Size i = 0; i < dist[0].size(); ++i)
+            BOOST_CHECK_EQUAL(dist[t][i], dist[0][i]);
+    }
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(CreditMigrationHelperTest)
+
+BOOST_AUTO_TEST_CASE(testPnlDistributionThreadsAnalytic) {
+
+    if (!QuantExt::supports_Expm() || !QuantExt::supports_Logm()) {
+        BOOST_CHECK(true);
+        return;
+    }
+
+    BOOST_TEST_MESSAGE("Testing credit migration pnl distribution on several threads (Analytic)...");
+    testThreads("Analytic");
+}
+
+BOOST_AUTO_TEST_CASE(testPnlDistributionThreadsTerminalSimulation) {
+
+    if (!QuantExt::supports_Expm() || !QuantExt::supports_Logm()) {
+        BOOST_CHECK(true);
+        return;
+    }
+
+    BOOST_TEST_MESSAGE("Testing credit migration pnl distribution on several threads (TerminalSimulation)...");
+    testThreads("TerminalSimulation");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -18,10 +18,15 @@
 
 #include <boost/filesystem.hpp>
 #include <boost/test/unit_test.hpp>
+#include <future>
 #include <orea/cube/inmemorycube.hpp>
 #include <orea/cube/cube_io.hpp>
+#include <orea/cube/diskcube.hpp>
 #include <orea/cube/npvcube.hpp>
 #include <orea/cube/jaggedcube.hpp>
+#include <orea/cube/pnlaggregationcube.hpp>
+#include <orea/cube/sharedmemorycube.hpp>
+#include <orea/engine/historicalsimulationvar.hpp>
 #include <orea/engine/filteredsensitivitystream.hpp>
 #include <orea/engine/observationmode.hpp>
 #include <orea/engine/parametricvar.hpp>
@@ -55,6 +60,11 @@
 #include <oret/toplevelfixture.hpp>
 #include <test/oreatoplevelfixture.hpp>
 
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 using namespace ore::analytics;
 using namespace boost::unit_test_framework;
 using std::string;
@@ -111,6 +121,23 @@ void testCube(NPVCube& cube, const std::string& cubeName, Real tolerance) {
     // All done
 }
 
+void testCubeSetSamples(NPVCube& cube, Real tolerance) {
+    // write each (i,j,d) slice in one go, the result must be the same as setting the values one by one
+    for (Size i = 0; i < cube.numIds(); ++i) {
+        for (Size j = 0; j < cube.numDates(); ++j) {
+            for (Size d = 0; d < cube.depth(); ++d) {
+                vector<Real> values(cube.samples());
+                for (Size k = 0; k < cube.samples(); ++k)
+                    values[k] = i * 1000000.0 + j + k / 1000000.0 + d * 3;
+                cube.setSamples(values, i, j, d);
+            }
+        }
+    }
+    checkCube(cube, tolerance);
+    BOOST_CHECK_THROW(cube.setSamples(vector<Real>(cube.samples() + 1), 0, 0, 0), std::exception);
+    BOOST_CHECK_THROW(cube.setSamples(vector<Real>(cube.samples()), cube.numIds(), 0, 0), std::exception);
+}
+
 template <class T>
 void testCubeFileIO(NPVCube& cube, const std::string& cubeName, Real tolerance, bool doublePrecision) {
 
@@ -459,6 +486,106 @@ BOOST_AUTO_TEST_CASE(testDoublePrecisionInMemoryCubeFileNIO) {
     testCubeFileIO<DoublePrecisionInMemoryCubeN>(c, "DoublePrecisionInMemoryCubeN", 1e-14, true);
 }
 
+BOOST_AUTO_TEST_CASE(testSharedMemoryCube) {
+    std::set<string> ids{string("id1"), string("id2"), string("id3")};
+    vector<Date> dates(20, Date());
+    Size samples = 50;
+    SinglePrecisionSharedMemoryCube c1(Date(), ids, dates, samples, 1);
+    testCube(c1, "SinglePrecisionSharedMemoryCube", 1e-5);
+    DoublePrecisionSharedMemoryCube c2(Date(), ids, dates, samples, 4);
+    testCube(c2, "DoublePrecisionSharedMemoryCube", 1e-14);
+    c2.setT0(42.0, 2, 3);
+    BOOST_CHECK_EQUAL(c2.getT0(2, 3), 42.0);
+    checkCube(c2, 1e-14);
+
+#if !defined(_WIN32) && !defined(_WIN64)
+    // values written by a forked process are visible in the parent process
+    BOOST_TEST_MESSAGE("Testing shared memory cube with forked process");
+    DoublePrecisionSharedMemoryCube c3(Date(), ids, dates, samples, 2);
+    pid_t pid = fork();
+    BOOST_REQUIRE(pid >= 0);
+    if (pid == 0) {
+        initCube(c3);
+        _exit(0);
+    }
+    int status = 0;
+    BOOST_REQUIRE_EQUAL(waitpid(pid, &status, 0), pid);
+    BOOST_REQUIRE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    checkCube(c3, 1e-14);
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(testDiskCube) {
+    std::set<string> ids{string("id1"), string("id2"), string("id3")};
+    vector<Date> dates(20, Date());
+    Size samples = 50;
+    std::string path;
+    {
+        // the budget holds a few tiles only, so that tiles are written to and read from disk
+        DoublePrecisionDiskCube c(Date(), ids, dates, samples, 2, 8000);
+        path = c.tileDirectory();
+        BOOST_CHECK(boost::filesystem::exists(path));
+        BOOST_CHECK_EQUAL(c.idBlockSize(), 1);
+        BOOST_CHECK_EQUAL(c.sampleBlockSize(), 4);
+        testCube(c, "DoublePrecisionDiskCube", 1e-14);
+        BOOST_CHECK(c.tilesInMemory() <= c.maxTilesInMemory());
+        BOOST_CHECK(c.tileWrites() > 0);
+        BOOST_CHECK(c.tileReads() > 0);
+        c.setT0(42.0, 2, 1);
+        BOOST_CHECK_EQUAL(c.getT0(2, 1), 42.0);
+    }
+    BOOST_CHECK(!boost::filesystem::exists(path));
+
+    SinglePrecisionDiskCube c2(Date(), ids, dates, samples, 1, 4000, 2, 7);
+    BOOST_CHECK_EQUAL(c2.idBlockSize(), 2);
+    BOOST_CHECK_EQUAL(c2.sampleBlockSize(), 7);
+    testCube(c2, "SinglePrecisionDiskCube", 1e-5);
+}
+
+BOOST_AUTO_TEST_CASE(testDiskCubeConcurrentReads) {
+    BOOST_TEST_MESSAGE("Testing concurrent reads from a disk cube");
+    std::set<string> ids{string("id1"), string("id2"), string("id3")};
+    vector<Date> dates(20, Date());
+    Size samples = 50;
+    // a few tiles only, so that the readers evict and load tiles of each other
+    DoublePrecisionDiskCube c(Date(), ids, dates, samples, 2, 8000);
+    initCube(c);
+    // each reader sums the cube in a different order
+    auto sum = [&c](Size offset) {
+        Real s = 0.0;
+        for (Size n = 0; n < c.numIds() * c.samples(); ++n) {
+            Size m = (n + offset) % (c.numIds() * c.samples());
+            for (Size j = 0; j < c.numDates(); ++j)
+                for (Size d = 0; d < c.depth(); ++d)
+                    s += c.get(m % c.numIds(), j, m / c.numIds(), d);
+        }
+        return s;
+    };
+    Real expected = sum(0);
+    vector<std::future<Real>> results;
+    for (Size t = 0; t < 4; ++t)
+        results.push_back(std::async(std::launch::async, sum, 37 * t));
+    for (auto& r : results)
+        BOOST_CHECK_CLOSE(r.get(), expected, 1e-10);
+    BOOST_CHECK(c.tilesInMemory() <= c.maxTilesInMemory());
+}
+
+BOOST_AUTO_TEST_CASE(testCubeSetSamples) {
+    BOOST_TEST_MESSAGE("Testing bulk write of samples to cubes");
+    std::set<string> ids{string("id1"), string("id2"), string("id3")};
+    vector<Date> dates(20, Date());
+    Size samples = 50;
+    SinglePrecisionInMemoryCube c1(Date(), ids, dates, samples);
+    testCubeSetSamples(c1, 1e-5);
+    DoublePrecisionInMemoryCubeN c2(Date(), ids, dates, samples, 3);
+    testCubeSetSamples(c2, 1e-14);
+    DoublePrecisionSharedMemoryCube c3(Date(), ids, dates, samples, 2);
+    testCubeSetSamples(c3, 1e-14);
+    // default implementation in NPVCube
+    DoublePrecisionDiskCube c4(Date(), ids, dates, samples, 2, 8000);
+    testCubeSetSamples(c4, 1e-14);
+}
+
 BOOST_AUTO_TEST_CASE(testInMemoryCubeGetSetbyDateID) {
     std::set<string> ids = {"id1", "id2", "id3"}; // the overlap doesn't matter
     Date today = Date::todaysDate();
@@ -537,6 +664,56 @@ BOOST_AUTO_TEST_CASE(testDoublePrecisionJaggedCube) {
     IndexManager::instance().clearHistories();
 }
 
+BOOST_AUTO_TEST_CASE(testPnlAggregationCube) {
+
+    BOOST_TEST_MESSAGE("Testing P&L aggregation cube...");
+
+    Date today(15, December, 2016);
+    std::set<string> ids = {"T1", "T2", "T3", "T4"};
+    std::map<string, std::set<string>> groups = {{"P1", {"T1", "T2"}}, {"P2", {"T2", "T3", "T5"}}, {"All", ids}};
+    Size samples = 250;
+
+    PnlAggregationCube cube(today, ids, {today}, samples, groups);
+    DoublePrecisionInMemoryCube reference(today, ids, {today}, samples);
+    for (Size i = 0; i < ids.size(); ++i) {
+        cube.setT0(10.0 * (i + 1), i);
+        reference.setT0(10.0 * (i + 1), i);
+        for (Size s = 0; s < samples; ++s) {
+            Real v = 10.0 * (i + 1) + std::sin(static_cast<Real>(s * (i + 1)));
+            cube.set(v, i, 0, s);
+            reference.set(v, i, 0, s);
+        }
+    }
+
+    BOOST_CHECK_EQUAL(cube.groups().size(), 3);
+    BOOST_CHECK_CLOSE(cube.t0("P2"), 50.0, 1E-10);
+    for (const auto& [group, groupIds] : groups) {
+        std::vector<Real> pnl = cube.pnl(group);
+        BOOST_REQUIRE_EQUAL(pnl.size(), samples);
+        for (Size s = 0; s < samples; ++s) {
+            Real expected = 0.0;
+            for (const auto& id : groupIds) {
+                if (ids.count(id) > 0)
+                    expected += reference.get(id, today, s) - reference.getT0(id);
+            }
+            BOOST_CHECK_SMALL(pnl[s] - expected, 1E-10);
+        }
+    }
+    BOOST_CHECK_THROW(cube.get(0, 0, 0), QuantLib::Error);
+
+    cube.remove(2);
+    BOOST_CHECK(cube.removedIds() == std::set<string>({"T3"}));
+
+    // the quantile found by selection equals the one found by sorting
+    std::vector<Real> pnl = cube.pnl("All");
+    std::vector<Real> sorted(pnl);
+    std::sort(sorted.begin(), sorted.end(), std::greater<Real>());
+    BOOST_CHECK_EQUAL(historicalSimulationQuantile(pnl, 0.99), sorted[2]);
+    BOOST_CHECK_EQUAL(historicalSimulationQuantile(pnl, 0.975), sorted[6]);
+    BOOST_CHECK_EQUAL(historicalSimulationQuantile(pnl, 0.99, false), -*(sorted.end() - 3));
+    BOOST_CHECK_EQUAL(HistoricalSimulationVarCalculator(pnl).var(0.99), sorted[2]);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
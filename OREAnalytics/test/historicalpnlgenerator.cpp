@@ -0,0 +1,162 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <orea/cube/inmemorycube.hpp>
+#include <orea/engine/historicalpnlgenerator.hpp>
+#include <orea/scenario/historicalscenariogenerator.hpp>
+#include <orea/scenario/historicalscenarioloader.hpp>
+#include <orea/scenario/scenariosimmarket.hpp>
+#include <orea/scenario/simplescenario.hpp>
+#include <orea/scenario/simplescenariofactory.hpp>
+#include <ored/portfolio/instrumentwrapper.hpp>
+#include <ored/portfolio/portfolio.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <ql/instrument.hpp>
+#include <ql/time/calendars/target.hpp>
+#include <test/oreatoplevelfixture.hpp>
+#include <test/testmarket.hpp>
+#include <test/testportfolio.hpp>
+
+using namespace std;
+using namespace QuantLib;
+using namespace ore::data;
+using namespace ore::analytics;
+using namespace boost::unit_test_framework;
+
+namespace {
+
+// an instrument with zero NPV that fails from the given pricing on
+class FailingInstrument : public Instrument {
+public:
+    explicit FailingInstrument(Size failFrom) : failFrom_(failFrom) {}
+    bool isExpired() const override { return false; }
+    void calculate() const override {
+        QL_REQUIRE(++calls_ < failFrom_, "FailingInstrument: pricing " << calls_ << " fails");
+        NPV_ = 0.0;
+    }
+
+private:
+    Size failFrom_;
+    mutable Size calls_ = 0;
+};
+
+class FailingTrade : public Trade {
+public:
+    FailingTrade(const string& id, Size failFrom) : Trade("Failing"), failFrom_(failFrom) { this->id() = id; }
+    void build(const boost::shared_ptr<EngineFactory>&) override {
+        instrument_ = boost::make_shared<VanillaInstrument>(boost::make_shared<FailingInstrument>(failFrom_));
+        npvCurrency_ = notionalCurrency_ = "EUR";
+        notional_ = 1.0;
+        maturity_ = Settings::instance().evaluationDate() + 1 * Years;
+    }
+
+private:
+    Size failFrom_;
+};
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(HistoricalPnlGeneratorTest)
+
+BOOST_AUTO_TEST_CASE(testGeneratePnl) {
+
+    BOOST_TEST_MESSAGE("Testing HistoricalPnlGenerator::generatePnl() vs generateCube()...");
+
+    SavedSettings backup;
+    Date today(14, April, 2016);
+    Settings::instance().evaluationDate() = today;
+
+    testsuite::TestConfigurationObjects::setConventions();
+    auto market = boost::make_shared<testsuite::TestMarket>(today);
+    auto simMarketData = testsuite::TestConfigurationObjects::setupSimMarketData5();
+    auto simMarket = boost::make_shared<ScenarioSimMarket>(market, simMarketData);
+
+    auto engineData = boost::make_shared<EngineData>();
+    engineData->model("Swap") = "DiscountedCashflows";
+    engineData->engine("Swap") = "DiscountingSwapEngine";
+    auto portfolio = boost::make_shared<Portfolio>();
+    portfolio->add(testsuite::buildSwap("S1", "EUR", true, 10000000.0, 0, 10, 0.03, 0.00, "1Y", "30/360", "6M",
+                                        "A360", "EUR-EURIBOR-6M"));
+    portfolio->add(testsuite::buildSwap("S2", "EUR", false, 5000000.0, 0, 5, 0.02, 0.00, "1Y", "30/360", "6M", "A360",
+                                        "EUR-EURIBOR-6M"));
+    // fails on the second scenario, after its T0 and first scenario values were added to the group totals
+    portfolio->add(boost::make_shared<FailingTrade>("F", 3));
+    portfolio->build(boost::make_shared<EngineFactory>(engineData, simMarket));
+
+    // daily scenarios with small multiplicative moves of all risk factors
+    const Size numDates = 8;
+    Calendar cal = TARGET();
+    auto loader = boost::make_shared<HistoricalScenarioLoader>();
+    auto base = simMarket->baseScenario();
+    Date d = cal.advance(today, -static_cast<Integer>(numDates), Days);
+    for (Size i = 0; i < numDates; ++i, d = cal.advance(d, 1, Days)) {
+        auto s = boost::make_shared<SimpleScenario>(d, "", 1.0);
+        Size k = 0;
+        for (auto const& key : base->keys())
+            s->add(key, base->get(key) * (1.0 + 0.001 * std::sin(1.0 + i + 0.1 * k++)));
+        loader->historicalScenarios().push_back(s);
+        loader->dates().push_back(d);
+    }
+    auto hsg = boost::make_shared<HistoricalScenarioGenerator>(loader, boost::make_shared<SimpleScenarioFactory>(),
+                                                               cal, nullptr, 1);
+    hsg->baseScenario() = base;
+    BOOST_REQUIRE(hsg->numScenarios() > 2);
+
+    auto cube = boost::make_shared<DoublePrecisionInMemoryCube>(today, portfolio->ids(), vector<Date>(1, today),
+                                                               hsg->numScenarios());
+    HistoricalPnlGenerator generator("EUR", portfolio, simMarket, hsg, cube);
+
+    map<string, set<string>> groups = {{"G1", {"S1", "F"}}, {"G2", {"S1", "S2"}}, {"G3", {"F"}}};
+    generator.generatePnl(nullptr, groups);
+
+    // the failing trade is excluded and the P&L regenerated without it
+    BOOST_CHECK(generator.excludedTrades() == set<string>({"F"}));
+
+    // the failing trade is removed from the trade level cube, i.e. its P&L is zero
+    generator.generateCube(nullptr);
+    set<pair<string, Size>> s1, s1s2;
+    for (auto const& p : generator.tradeIdIndexPairs()) {
+        if (p.first == "S1")
+            s1.insert(p);
+        if (p.first != "F")
+            s1s2.insert(p);
+    }
+    BOOST_REQUIRE_EQUAL(s1s2.size(), 2);
+
+    vector<Real> expected1 = generator.pnl(s1), expected2 = generator.pnl(s1s2);
+    vector<Real> pnl1 = generator.groupPnl("G1"), pnl2 = generator.groupPnl("G2"), pnl3 = generator.groupPnl("G3");
+    BOOST_REQUIRE_EQUAL(pnl1.size(), hsg->numScenarios());
+    BOOST_REQUIRE_EQUAL(pnl1.size(), expected1.size());
+    BOOST_REQUIRE_EQUAL(pnl2.size(), expected2.size());
+    BOOST_REQUIRE_EQUAL(pnl3.size(), hsg->numScenarios());
+    for (Size i = 0; i < pnl1.size(); ++i) {
+        BOOST_CHECK_SMALL(pnl1[i] - expected1[i], 1E-6);
+        BOOST_CHECK_SMALL(pnl2[i] - expected2[i], 1E-6);
+        BOOST_CHECK_EQUAL(pnl3[i], 0.0);
+    }
+    BOOST_CHECK(std::any_of(pnl2.begin(), pnl2.end(), [](Real x) { return std::abs(x) > 1.0; }));
+
+    BOOST_CHECK_THROW(generator.groupPnl("G4"), QuantLib::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,169 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <orea/cube/inmemorycube.hpp>
+#include <orea/cube/jointnpvcube.hpp>
+#include <orea/engine/multiprocessvaluationengine.hpp>
+#include <orea/engine/valuationcalculator.hpp>
+#include <orea/engine/valuationengine.hpp>
+#include <orea/scenario/aggregationscenariodata.hpp>
+#include <orea/scenario/scenariogeneratorbuilder.hpp>
+#include <orea/scenario/scenariogeneratordata.hpp>
+#include <orea/scenario/scenariosimmarketplus.hpp>
+#include <orea/scenario/simplescenariofactory.hpp>
+#include <ored/configuration/conventions.hpp>
+#include <ored/configuration/curveconfigurations.hpp>
+#include <ored/marketdata/csvloader.hpp>
+#include <ored/marketdata/todaysmarket.hpp>
+#include <ored/marketdata/todaysmarketparameters.hpp>
+#include <ored/model/crossassetmodelbuilder.hpp>
+#include <ored/model/crossassetmodeldata.hpp>
+#include <ored/portfolio/enginedata.hpp>
+#include <ored/portfolio/enginefactory.hpp>
+#include <ored/portfolio/portfolio.hpp>
+#include <oret/datapaths.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <test/oreatoplevelfixture.hpp>
+
+using namespace std;
+using namespace QuantLib;
+using namespace ore::data;
+using namespace ore::analytics;
+using namespace boost::unit_test_framework;
+
+namespace {
+
+// market data and configuration is taken from the examples
+const string examples = "../../../../Examples/Input/";
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(MultiProcessValuationEngineTest)
+
+#if !defined(_WIN32) && !defined(_WIN64)
+BOOST_AUTO_TEST_CASE(testMultiProcessCube) {
+
+    BOOST_TEST_MESSAGE("Testing multi-process vs single-threaded cube and aggregation scenario data...");
+
+    Date asof(5, February, 2016);
+    Settings::instance().evaluationDate() = asof;
+
+    auto conventions = boost::make_shared<Conventions>();
+    conventions->fromFile(examples + "conventions.xml");
+    InstrumentConventions::instance().setConventions(conventions);
+    auto curveConfigs = boost::make_shared<CurveConfigurations>();
+    curveConfigs->fromFile(examples + "curveconfig.xml");
+    auto todaysMarketParams = boost::make_shared<TodaysMarketParameters>();
+    todaysMarketParams->fromFile(examples + "todaysmarket.xml");
+    auto loader =
+        boost::make_shared<CSVLoader>(examples + "market_20160205_flat.txt", examples + "fixings_20160205.txt", true);
+    auto engineData = boost::make_shared<EngineData>();
+    engineData->fromFile(examples + "pricingengine.xml");
+
+    auto sgd = boost::make_shared<ScenarioGeneratorData>();
+    sgd->fromFile(TEST_INPUT_FILE("simulation.xml"));
+    auto camData = boost::make_shared<CrossAssetModelData>();
+    camData->fromFile(TEST_INPUT_FILE("simulation.xml"));
+    auto simMarketData = boost::make_shared<ScenarioSimMarketParameters>();
+    simMarketData->fromFile(TEST_INPUT_FILE("simulation.xml"));
+
+    const string config = Market::defaultConfiguration;
+    auto grid = sgd->getGrid();
+    const Size samples = sgd->samples();
+
+    auto market = boost::make_shared<TodaysMarket>(asof, todaysMarketParams, loader, curveConfigs, true, true, true);
+    CrossAssetModelBuilder modelBuilder(market, camData, config, config, config, config, config, config);
+    auto model = *modelBuilder.model();
+    auto scenarioGenerator = [&sgd, &model, &simMarketData, &asof, &market, &config]() {
+        return ScenarioGeneratorBuilder(sgd).build(model, boost::make_shared<SimpleScenarioFactory>(), simMarketData,
+                                                   asof, market, config);
+    };
+
+    auto calculators = []() {
+        return vector<boost::shared_ptr<ValuationCalculator>>{boost::make_shared<NPVCalculator>("EUR")};
+    };
+
+    // single-threaded run, the sim market is set up as in the worker processes
+
+    auto simMarket = boost::make_shared<ScenarioSimMarketPlus>(market, simMarketData, config, *curveConfigs,
+                                                               *todaysMarketParams, true);
+    simMarket->scenarioGenerator() = scenarioGenerator();
+    auto asd = boost::make_shared<InMemoryAggregationScenarioData>(grid->valuationDates().size(), samples);
+    simMarket->aggregationScenarioData() = asd;
+
+    auto portfolio = boost::make_shared<Portfolio>();
+    portfolio->fromFile(TEST_INPUT_FILE("portfolio.xml"));
+    portfolio->build(boost::make_shared<EngineFactory>(engineData, simMarket));
+    BOOST_REQUIRE_EQUAL(portfolio->size(), 2);
+
+    auto cube = boost::make_shared<DoublePrecisionInMemoryCube>(asof, portfolio->ids(), grid->valuationDates(),
+                                                               samples);
+    ValuationEngine engine(asof, grid, simMarket);
+    engine.buildCube(portfolio, cube, calculators());
+
+    // multi-process run, one process per trade
+
+    auto mpPortfolio = boost::make_shared<Portfolio>();
+    mpPortfolio->fromFile(TEST_INPUT_FILE("portfolio.xml"));
+    auto mpAsd = boost::make_shared<InMemoryAggregationScenarioData>(grid->valuationDates().size(), samples);
+
+    MultiProcessValuationEngine mpEngine(2, asof, grid, samples, loader, scenarioGenerator(), engineData, curveConfigs,
+                                         todaysMarketParams, config, simMarketData, false, false,
+                                         boost::make_shared<ScenarioFilter>(), nullptr,
+                                         IborFallbackConfig::defaultConfig(), true, true, 1, true);
+    mpEngine.setAggregationScenarioData(mpAsd);
+    mpEngine.buildCube(mpPortfolio, calculators);
+    BOOST_REQUIRE_EQUAL(mpEngine.outputCubes().size(), 2);
+    JointNPVCube mpCube(mpEngine.outputCubes(), mpPortfolio->ids());
+
+    BOOST_REQUIRE(mpCube.idsAndIndexes() == cube->idsAndIndexes());
+    Real maxDiff = 0.0;
+    for (auto const& [id, i] : cube->idsAndIndexes()) {
+        maxDiff = std::max(maxDiff, std::abs(mpCube.getT0(i) - cube->getT0(i)));
+        for (Size j = 0; j < grid->valuationDates().size(); ++j) {
+            for (Size k = 0; k < samples; ++k)
+                maxDiff = std::max(maxDiff, std::abs(mpCube.get(i, j, k) - cube->get(i, j, k)));
+        }
+    }
+    BOOST_TEST_MESSAGE("max abs difference multi-process vs single-threaded cube " << maxDiff);
+    BOOST_CHECK_SMALL(maxDiff, 1E-6);
+
+    // the aggregation scenario data is written by the first worker and copied back by the engine
+
+    BOOST_REQUIRE(asd->has(AggregationScenarioDataType::Numeraire));
+    BOOST_REQUIRE(asd->has(AggregationScenarioDataType::IndexFixing, "EUR-EONIA"));
+    BOOST_REQUIRE(mpAsd->keys() == asd->keys());
+    Real maxAsdDiff = 0.0;
+    for (auto const& [type, qualifier] : asd->keys()) {
+        for (Size j = 0; j < asd->dimDates(); ++j) {
+            for (Size k = 0; k < asd->dimSamples(); ++k)
+                maxAsdDiff =
+                    std::max(maxAsdDiff, std::abs(mpAsd->get(j, k, type, qualifier) - asd->get(j, k, type, qualifier)));
+        }
+    }
+    BOOST_TEST_MESSAGE("max abs difference multi-process vs single-threaded aggregation scenario data " << maxAsdDiff);
+    BOOST_CHECK_SMALL(maxAsdDiff, 1E-10);
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -47,14 +47,19 @@
 #include <ored/portfolio/swap.hpp>
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/osutils.hpp>
+#include <ored/utilities/to_string.hpp>
 #include <oret/toplevelfixture.hpp>
 #include <ql/math/randomnumbers/mt19937uniformrng.hpp>
 #include <ql/time/calendars/target.hpp>
 #include <ql/time/date.hpp>
 #include <ql/time/daycounters/actualactual.hpp>
+#include <qle/cashflows/overnightindexedcoupon.hpp>
 #include <qle/methods/multipathgeneratorbase.hpp>
 #include <test/oreatoplevelfixture.hpp>
 
+#include <algorithm>
+#include <functional>
+
 using namespace std;
 using namespace QuantLib;
 using namespace QuantExt;
@@ -351,6 +356,101 @@ void simulation(string dateGridString, bool checkFixings) {
     }
 }
 
+void oisFixingCache() {
+    SavedSettings backup;
+
+    Date today = Date(14, April, 2016);
+    Settings::instance().evaluationDate() = today;
+    boost::shared_ptr<DateGrid> dg = boost::make_shared<DateGrid>("12,1M");
+    Size samples = 5;
+
+    boost::shared_ptr<Market> initMarket = boost::make_shared<TestMarket>(today);
+
+    // EUR only simulation, the EUR-EONIA fixings are backfilled by the fixing manager
+    boost::shared_ptr<analytics::ScenarioSimMarketParameters> parameters(new analytics::ScenarioSimMarketParameters());
+    parameters->baseCcy() = "EUR";
+    parameters->setDiscountCurveNames({"EUR"});
+    parameters->setYieldCurveTenors("",
+                                    {1 * Months, 6 * Months, 1 * Years, 2 * Years, 5 * Years, 10 * Years, 20 * Years});
+    parameters->setIndices({"EUR-EONIA"});
+    parameters->interpolation() = "LogLinear";
+
+    std::vector<boost::shared_ptr<IrModelData>> irConfigs;
+    irConfigs.push_back(boost::make_shared<IrLgmData>(
+        "EUR", CalibrationType::None, LgmData::ReversionType::HullWhite, LgmData::VolatilityType::Hagan, false,
+        ParamType::Constant, vector<Time>(), vector<Real>{0.02}, false, ParamType::Constant, vector<Time>(),
+        vector<Real>{0.01}));
+    boost::shared_ptr<CrossAssetModelData> config(boost::make_shared<CrossAssetModelData>(
+        irConfigs, std::vector<boost::shared_ptr<FxBsData>>(), map<CorrelationKey, Handle<Quote>>()));
+    boost::shared_ptr<QuantExt::CrossAssetModel> model = *CrossAssetModelBuilder(initMarket, config).model();
+
+    boost::shared_ptr<QuantExt::MultiPathGeneratorBase> pathGen =
+        boost::make_shared<MultiPathGeneratorMersenneTwister>(model->stateProcess(), dg->timeGrid(), 42, false);
+    boost::shared_ptr<analytics::ScenarioSimMarket> simMarket =
+        boost::make_shared<analytics::ScenarioSimMarket>(initMarket, parameters);
+    simMarket->scenarioGenerator() = boost::make_shared<CrossAssetModelScenarioGenerator>(
+        model, pathGen, boost::make_shared<SimpleScenarioFactory>(), parameters, today, dg, initMarket);
+
+    // OIS swap that started before today, so that its first coupon has historical and simulated fixings
+    boost::shared_ptr<EngineData> data = boost::make_shared<EngineData>();
+    data->model("Swap") = "DiscountedCashflows";
+    data->engine("Swap") = "DiscountingSwapEngine";
+    boost::shared_ptr<EngineFactory> factory = boost::make_shared<EngineFactory>(data, simMarket);
+
+    Calendar cal = TARGET();
+    Date startDate = cal.adjust(today - 2 * Months);
+    Date endDate = cal.adjust(startDate + 2 * Years);
+    ScheduleData floatSchedule(ScheduleRules(to_string(startDate), to_string(endDate), "3M", "TARGET", "MF", "MF",
+                                             "Forward"));
+    ScheduleData fixedSchedule(ScheduleRules(to_string(startDate), to_string(endDate), "1Y", "TARGET", "MF", "MF",
+                                             "Forward"));
+    LegData fixedLeg(boost::make_shared<FixedLegData>(vector<double>(1, 0.02)), true, "EUR", fixedSchedule, "30/360",
+                     vector<double>(1, 1000000));
+    LegData floatingLeg(boost::make_shared<FloatingLegData>("EUR-EONIA", 0, true, vector<double>(1, 0.0)), false,
+                        "EUR", floatSchedule, "ACT/360", vector<double>(1, 1000000));
+    boost::shared_ptr<Trade> swap(new data::Swap(Envelope("CP"), floatingLeg, fixedLeg));
+    swap->id() = "OIS_SWAP";
+    boost::shared_ptr<Portfolio> portfolio(new Portfolio());
+    portfolio->add(swap);
+    portfolio->build(factory);
+
+    vector<boost::shared_ptr<QuantExt::OvernightIndexedCoupon>> coupons;
+    for (auto const& leg : swap->legs()) {
+        for (auto const& cf : leg) {
+            if (auto c = boost::dynamic_pointer_cast<QuantExt::OvernightIndexedCoupon>(cf))
+                coupons.push_back(c);
+        }
+    }
+    BOOST_REQUIRE_EQUAL(coupons.size(), 8);
+
+    // run the market updates as in the valuation engine and compare the coupon rates, which use the cached past
+    // fixings, with the rates of new coupons, which read all past fixings from the index
+    simMarket->fixingManager()->initialise(portfolio, simMarket);
+    vector<Real> simulatedRates;
+    for (Size sample = 0; sample < samples; ++sample) {
+        for (auto const& d : dg->dates()) {
+            simMarket->preUpdate();
+            simMarket->updateDate(d);
+            simMarket->updateScenario(d);
+            simMarket->postUpdate(d, true);
+            for (auto const& c : coupons) {
+                if (c->accrualStartDate() >= d)
+                    continue;
+                auto expected = boost::make_shared<QuantExt::OvernightIndexedCoupon>(
+                    c->date(), c->nominal(), c->accrualStartDate(), c->accrualEndDate(), c->overnightIndex());
+                BOOST_CHECK_CLOSE(c->rate(), expected->rate(), 1E-10);
+            }
+        }
+        // the second coupon is fixed on simulated fixings only
+        simulatedRates.push_back(coupons[1]->rate());
+        simMarket->fixingManager()->reset();
+    }
+    simMarket->reset();
+
+    BOOST_CHECK(std::adjacent_find(simulatedRates.begin(), simulatedRates.end(), std::not_equal_to<Real>()) !=
+                simulatedRates.end());
+}
+
 BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
 
 BOOST_AUTO_TEST_SUITE(ObservationModeTest)
@@ -377,6 +477,14 @@ BOOST_AUTO_TEST_CASE(testDisableLong) {
     simulation("11,1Y", true);
 }
 
+BOOST_AUTO_TEST_CASE(testDisableOisFixingCache) {
+    ObservationMode::instance().setMode(ObservationMode::Mode::Disable);
+    setConventions();
+
+    BOOST_TEST_MESSAGE("Testing Observation Mode Disable, cached OIS past fixings across fixing updates and resets");
+    oisFixingCache();
+}
+
 BOOST_AUTO_TEST_CASE(testNone) {
     ObservationMode::instance().setMode(ObservationMode::Mode::None);
     setConventions();
@@ -428,6 +536,31 @@ BOOST_AUTO_TEST_CASE(testDefer) {
     simulation("10,1Y", true);
 }
 
+BOOST_AUTO_TEST_CASE(testDeferOisFixingCache) {
+    ObservationMode::instance().setMode(ObservationMode::Mode::Defer);
+    setConventions();
+
+    BOOST_TEST_MESSAGE("Testing Observation Mode Defer, cached OIS past fixings across fixing updates and resets");
+    oisFixingCache();
+}
+
+BOOST_AUTO_TEST_CASE(testTargeted) {
+    ObservationMode::instance().setMode(ObservationMode::Mode::Targeted);
+    setConventions();
+
+    BOOST_TEST_MESSAGE("Testing Observation Mode Targeted, Long Grid, No Fixing Checks");
+    simulation("11,1Y", false);
+
+    BOOST_TEST_MESSAGE("Testing Observation Mode Targeted, Long Grid, With Fixing Checks");
+    simulation("11,1Y", true);
+
+    BOOST_TEST_MESSAGE("Testing Observation Mode Targeted, Short Grid, No Fixing Checks");
+    simulation("10,1Y", false);
+
+    BOOST_TEST_MESSAGE("Testing Observation Mode Targeted, Short Grid, With Fixing Checks");
+    simulation("10,1Y", true);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,305 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/test/unit_test.hpp>
+#include <orea/app/oreapp.hpp>
+#include <orea/app/parameters.hpp>
+#include <ored/report/inmemoryreport.hpp>
+#include <ored/utilities/xmlutils.hpp>
+#include <oret/datapaths.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <sstream>
+#include <test/oreatoplevelfixture.hpp>
+
+using namespace std;
+using namespace QuantLib;
+using namespace ore::data;
+using namespace ore::analytics;
+using namespace boost::unit_test_framework;
+
+namespace {
+
+const string examples = "../../../../Examples/Input/";
+
+typedef map<string, map<string, string>> AnalyticsParams;
+
+// ORE parameters for the portfolios in the test input directory, the market data and configuration is taken from the
+// examples
+boost::shared_ptr<Parameters> parameters(const string& portfolioFiles, const AnalyticsParams& analytics,
+                                         const map<string, string>& setup = {}) {
+    map<string, string> setupParams = {{"asofDate", "2016-02-05"},
+                                       {"inputPath", TEST_INPUT},
+                                       {"outputPath", TEST_OUTPUT},
+                                       {"logFile", "log.txt"},
+                                       {"logMask", "31"},
+                                       {"marketDataFile", examples + "market_20160205_flat.txt"},
+                                       {"fixingDataFile", examples + "fixings_20160205.txt"},
+                                       {"implyTodaysFixings", "Y"},
+                                       {"curveConfigFile", examples + "curveconfig.xml"},
+                                       {"conventionsFile", examples + "conventions.xml"},
+                                       {"marketConfigFile", examples + "todaysmarket.xml"},
+                                       {"pricingEnginesFile", examples + "pricingengine.xml"},
+                                       {"portfolioFile", portfolioFiles},
+                                       {"observationModel", "None"},
+                                       {"continueOnError", "false"},
+                                       {"calendarAdjustment", examples + "calendaradjustment.xml"},
+                                       {"currencyConfiguration", examples + "currencies.xml"}};
+    for (auto const& [k, v] : setup)
+        setupParams[k] = v;
+
+    auto group = [](const map<string, string>& params) {
+        string xml;
+        for (auto const& [k, v] : params)
+            xml += "<Parameter name=\"" + k + "\">" + v + "</Parameter>";
+        return xml;
+    };
+    string xml = "<ORE><Setup>" + group(setupParams) +
+                 "</Setup><Markets>"
+                 "<Parameter name=\"lgmcalibration\">libor</Parameter>"
+                 "<Parameter name=\"fxcalibration\">libor</Parameter>"
+                 "<Parameter name=\"eqcalibration\">libor</Parameter>"
+                 "<Parameter name=\"pricing\">libor</Parameter>"
+                 "<Parameter name=\"simulation\">libor</Parameter>"
+                 "</Markets><Analytics>";
+    for (auto const& [type, params] : analytics)
+        xml += "<Analytic type=\"" + type + "\">" + group(params) + "</Analytic>";
+    xml += "</Analytics></ORE>";
+
+    XMLDocument doc;
+    doc.fromXMLString(xml);
+    auto params = boost::make_shared<Parameters>();
+    params->fromXML(doc.getFirstNode("ORE"));
+    return params;
+}
+
+// simulation and xva analytics, the xva analytic loads the cubes of a previous run if the simulation is not active
+AnalyticsParams xvaAnalytics(bool simulate, const map<string, string>& xva = {}) {
+    map<string, string> simulationParams = {{"active", simulate ? "Y" : "N"},
+                                            {"simulationConfigFile", "simulation.xml"},
+                                            {"pricingEnginesFile", examples + "pricingengine.xml"},
+                                            {"baseCurrency", "EUR"},
+                                            {"observationModel", "Disable"}};
+    if (simulate) {
+        simulationParams["cubeFile"] = "cube.csv.gz";
+        simulationParams["aggregationScenarioDataFileName"] = "scenariodata.csv.gz";
+    }
+
+    map<string, string> xvaParams = {{"active", "Y"},          {"csaFile", "netting.xml"},
+                                     {"cubeFile", "cube.csv.gz"}, {"scenarioFile", "scenariodata.csv.gz"},
+                                     {"baseCurrency", "EUR"},     {"exposureProfiles", "N"},
+                                     {"exposureProfilesByTrade", "N"}, {"quantile", "0.95"},
+                                     {"calculationType", "Symmetric"}, {"allocationMethod", "None"},
+                                     {"marginalAllocationLimit", "1.0"}, {"exerciseNextBreak", "N"},
+                                     {"cva", "Y"},                {"dva", "N"},
+                                     {"dvaName", "BANK"},         {"fva", "N"},
+                                     {"colva", "N"},              {"collateralFloor", "N"}};
+    for (auto const& [k, v] : xva)
+        xvaParams[k] = v;
+
+    return {{"simulation", simulationParams}, {"xva", xvaParams}};
+}
+
+boost::shared_ptr<InMemoryReport> report(OREApp& app, const string& type, const string& name) {
+    auto& reports = app.getAnalytic(type)->reports()[type];
+    auto r = reports.find(name);
+    return r == reports.end() ? nullptr : r->second;
+}
+
+// value in the netting set level row of an xva report
+Real nettingSetValue(const boost::shared_ptr<InMemoryReport>& report, const string& nettingSetId,
+                     const string& column) {
+    BOOST_REQUIRE(report);
+    Size n = Null<Size>(), c = Null<Size>(), t = Null<Size>();
+    for (Size i = 0; i < report->columns(); ++i) {
+        if (report->header(i) == "NettingSetId")
+            n = i;
+        else if (report->header(i) == "TradeId")
+            t = i;
+        else if (report->header(i) == column)
+            c = i;
+    }
+    BOOST_REQUIRE(n != Null<Size>() && c != Null<Size>());
+    for (Size j = 0; j < report->rows(); ++j) {
+        if (report->stringValue(j, n) == nettingSetId && (t == Null<Size>() || report->stringValue(j, t).empty()))
+            return boost::get<Real>(report->value(j, c));
+    }
+    BOOST_FAIL("no row for netting set " << nettingSetId);
+    return Null<Real>();
+}
+
+// npv of a trade in an npv report
+Real tradeNpv(const boost::shared_ptr<InMemoryReport>& report, const string& tradeId) {
+    BOOST_REQUIRE(report);
+    Size t = Null<Size>(), c = Null<Size>();
+    for (Size i = 0; i < report->columns(); ++i) {
+        if (report->header(i) == "TradeId")
+            t = i;
+        else if (report->header(i) == "NPV(Base)")
+            c = i;
+    }
+    BOOST_REQUIRE(t != Null<Size>() && c != Null<Size>());
+    for (Size j = 0; j < report->rows(); ++j) {
+        if (report->stringValue(j, t) == tradeId)
+            return boost::get<Real>(report->value(j, c));
+    }
+    BOOST_FAIL("no row for trade " << tradeId);
+    return Null<Real>();
+}
+
+// run the service on the given commands and return the response lines
+vector<string> serve(OREApp& app, const string& commands) {
+    std::istringstream in(commands);
+    std::ostringstream out;
+    app.serve(in, out);
+    vector<string> responses;
+    std::istringstream lines(out.str());
+    for (string line; std::getline(lines, line);)
+        responses.push_back(line);
+    return responses;
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::OreaTopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(OREAppTest)
+
+BOOST_AUTO_TEST_CASE(testPreTradeXva) {
+
+    BOOST_TEST_MESSAGE("Testing pre-trade XVA on loaded cubes vs a full simulation of all trades...");
+
+    // reference: simulate the existing trades and the candidate together
+
+    Real cva;
+    {
+        OREApp app(parameters("portfolio.xml,pretrade.xml", xvaAnalytics(true)));
+        app.run();
+        cva = nettingSetValue(report(app, "XVA", "xva"), "CPTY_A", "CVA");
+    }
+
+    // simulate the existing trades only, this overwrites the cubes of the reference run
+
+    Real baseCva;
+    {
+        OREApp app(parameters("portfolio.xml", xvaAnalytics(true)));
+        app.run();
+        baseCva = nettingSetValue(report(app, "XVA", "xva"), "CPTY_A", "CVA");
+    }
+
+    BOOST_TEST_MESSAGE("CPTY_A CVA without candidate " << baseCva << ", with candidate " << cva);
+    BOOST_CHECK(std::abs(cva - baseCva) > 1.0);
+
+    // the candidate is simulated on the paths of the loaded cube, only its netting set is post-processed
+
+    vector<map<string, string>> setups = {{{"nThreads", "1"}}};
+#ifdef QL_ENABLE_SESSIONS
+    setups.push_back({{"nThreads", "2"}});
+#endif
+    for (auto const& setup : setups) {
+        BOOST_TEST_MESSAGE("Pre-trade run with nThreads = " << setup.at("nThreads"));
+        OREApp app(
+            parameters("portfolio.xml", xvaAnalytics(false, {{"preTradePortfolioFile", "pretrade.xml"}}), setup));
+        app.run();
+        auto preTrade = report(app, "XVA", "xva_pretrade");
+        BOOST_REQUIRE(preTrade);
+        BOOST_CHECK_EQUAL(preTrade->rows(), 1);
+        BOOST_CHECK_CLOSE(nettingSetValue(preTrade, "CPTY_A", "BaseCVA"), baseCva, 1E-6);
+        BOOST_CHECK_CLOSE(nettingSetValue(preTrade, "CPTY_A", "CVA"), cva, 1E-6);
+        BOOST_CHECK_CLOSE(nettingSetValue(preTrade, "CPTY_A", "MarginalCVA"), cva - baseCva, 1E-4);
+    }
+
+    // the workers of the multi-process engine do not populate the market cube, the run fails explicitly
+
+    {
+        OREApp app(parameters("portfolio.xml", xvaAnalytics(false, {{"preTradePortfolioFile", "pretrade.xml"}}),
+                              {{"nProcesses", "2"}}));
+        app.run();
+        BOOST_CHECK(!report(app, "XVA", "xva_pretrade"));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testServe) {
+
+    BOOST_TEST_MESSAGE("Testing the service mode with warm markets and trades vs a cold start...");
+
+    const AnalyticsParams npv = {{"npv", {{"active", "Y"}, {"baseCurrency", "EUR"}, {"outputFileName", "npv.csv"}}}};
+
+    // batch run on the unchanged market
+
+    Real npvA;
+    {
+        OREApp app(parameters("portfolio.xml", npv));
+        app.run();
+        npvA = tradeNpv(report(app, "NPV", "npv"), "Swap_A");
+    }
+
+    // quote and trade changes between runs on the warm market and trades, failing commands do not end the service
+
+    Real warmA, warmC;
+    {
+        OREApp app(parameters("portfolio.xml", npv));
+        auto responses = serve(app, "RUN\n"
+                                    "# comment\n"
+                                    "QUOTE IR_SWAP/RATE/EUR/2D/6M/10Y 0.025\n"
+                                    "TRADES pretrade.xml\n"
+                                    "RUN NPV\n"
+                                    "REMOVE Swap_B\n"
+                                    "REMOVE Swap_B\n"
+                                    "RUN EXPOSURE\n"
+                                    "UNKNOWN\n"
+                                    "RUN NPV\n"
+                                    "QUIT\n"
+                                    "RUN NPV\n");
+        vector<string> expected = {"OK", "OK", "OK 1", "OK", "OK", "ERROR", "ERROR", "ERROR", "OK", "OK"};
+        BOOST_REQUIRE_EQUAL(responses.size(), expected.size());
+        for (Size i = 0; i < expected.size(); ++i) {
+            BOOST_TEST_MESSAGE("response " << i << ": " << responses[i]);
+            BOOST_CHECK(boost::starts_with(responses[i], expected[i] + " ") || responses[i] == expected[i]);
+        }
+        BOOST_CHECK_EQUAL(responses[2], "OK 1");
+        BOOST_CHECK_EQUAL(responses.back(), "OK");
+        auto r = report(app, "NPV", "npv");
+        BOOST_REQUIRE(r);
+        BOOST_CHECK_EQUAL(r->rows(), 2);
+        warmA = tradeNpv(r, "Swap_A");
+        warmC = tradeNpv(r, "Swap_C");
+    }
+
+    // cold start on the changed quote and trades
+
+    {
+        OREApp app(parameters("portfolio.xml", npv));
+        auto responses = serve(app, "QUOTE IR_SWAP/RATE/EUR/2D/6M/10Y 0.025\n"
+                                    "TRADES pretrade.xml\n"
+                                    "REMOVE Swap_B\n"
+                                    "RUN\n");
+        BOOST_REQUIRE_EQUAL(responses.size(), 4);
+        BOOST_CHECK(boost::starts_with(responses.back(), "OK"));
+        auto r = report(app, "NPV", "npv");
+        BOOST_TEST_MESSAGE("Swap_A npv " << npvA << ", after quote change " << tradeNpv(r, "Swap_A") << ", warm "
+                                         << warmA);
+        BOOST_CHECK(std::abs(tradeNpv(r, "Swap_A") - npvA) > 1.0);
+        BOOST_CHECK_CLOSE(warmA, tradeNpv(r, "Swap_A"), 1E-8);
+        BOOST_CHECK_CLOSE(warmC, tradeNpv(r, "Swap_C"), 1E-8);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,607 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file test/orebench.cpp
+    \brief Standalone performance benchmarks for the analytics stack
+
+    Runs parametrised workloads (cube build, AMC cube build, sensitivities, historical VaR, exposure post-processing)
+    on the test market and a random swap portfolio, and writes the timings as JSON. If a baseline file from a
+    previous run is given, the timings are compared against it and the program exits with a non-zero code if one
+    of the workloads got slower than the given tolerance allows.
+
+    Example:
+
+        ore-bench --workload cube --trades 100 --samples 500 --dates 40 --threads 4 --output bench.json
+        ore-bench --workload all --baseline bench_release.json --tolerance 0.15
+*/
+
+#include <orea/aggregation/exposurecalculator.hpp>
+#include <orea/cube/cubeinterpretation.hpp>
+#include <orea/cube/inmemorycube.hpp>
+#include <orea/engine/amcvaluationengine.hpp>
+#include <orea/engine/historicalpnlgenerator.hpp>
+#include <orea/engine/observationmode.hpp>
+#include <orea/engine/sensitivityanalysis.hpp>
+#include <orea/engine/valuationcalculator.hpp>
+#include <orea/engine/valuationengine.hpp>
+#include <orea/scenario/historicalscenariogenerator.hpp>
+#include <orea/scenario/historicalscenarioloader.hpp>
+#include <orea/scenario/scenariogeneratorbuilder.hpp>
+#include <orea/scenario/scenariosimmarket.hpp>
+#include <orea/scenario/scenariosimmarketparameters.hpp>
+#include <orea/scenario/simplescenario.hpp>
+#include <orea/scenario/simplescenariofactory.hpp>
+#include <ored/model/crossassetmodelbuilder.hpp>
+#include <ored/model/crossassetmodeldata.hpp>
+#include <ored/model/fxbsdata.hpp>
+#include <ored/model/irlgmdata.hpp>
+#include <ored/portfolio/builders/swap.hpp>
+#include <ored/portfolio/portfolio.hpp>
+#include <ored/utilities/initbuilders.hpp>
+#include <ored/utilities/osutils.hpp>
+#include <ored/utilities/parsers.hpp>
+#include <ored/utilities/to_string.hpp>
+
+#include <ql/math/distributions/normaldistribution.hpp>
+#include <ql/math/randomnumbers/inversecumulativerng.hpp>
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+#include <ql/quotes/simplequote.hpp>
+#include <ql/time/calendars/target.hpp>
+
+#include <test/testmarket.hpp>
+#include <test/testportfolio.hpp>
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/timer/timer.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <set>
+
+using namespace QuantLib;
+using namespace QuantExt;
+using namespace ore::data;
+using namespace ore::analytics;
+using std::string;
+using std::vector;
+
+namespace {
+
+struct BenchmarkConfig {
+    std::set<string> workloads;
+    Size trades = 100;
+    Size samples = 100;
+    Size dates = 40;
+    Size threads = 1;
+    Size repeat = 1;
+    string observationMode = "None";
+    string output;
+    string baseline;
+    Real tolerance = 0.1;
+};
+
+struct BenchmarkResult {
+    string workload;
+    Size trades, samples, dates, threads;
+    string observationMode;
+    //! best wall time over the repetitions in seconds
+    Real time;
+    //! work units per second, see unit
+    Real throughput;
+    string unit;
+    unsigned long long peakRss;
+
+    //! identifies the workload and its parameters in a baseline file
+    string key() const;
+};
+
+//! only the cube workload runs on several threads and under the configured observation mode
+bool usesThreadsAndObservationMode(const string& workload) { return workload == "cube"; }
+
+/* the thread count and observation mode are only part of the key if the workload uses them, so that a baseline
+   compares runs that differ in a setting only where that setting has an effect */
+string BenchmarkResult::key() const {
+    std::ostringstream oss;
+    oss << workload << "/trades=" << trades << "/samples=" << samples << "/dates=" << dates;
+    if (usesThreadsAndObservationMode(workload))
+        oss << "/threads=" << threads << "/obs=" << observationMode;
+    return oss.str();
+}
+
+const Date benchmarkDate(14, April, 2016);
+const string baseCcy = "EUR";
+const vector<string> currencies = {"EUR", "USD", "GBP"};
+const std::map<string, string> indices = {
+    {"EUR", "EUR-EURIBOR-6M"}, {"USD", "USD-LIBOR-3M"}, {"GBP", "GBP-LIBOR-6M"}};
+
+//! Random vanilla swap portfolio, only trades with i % stride == offset are kept, so that threads can share the work
+boost::shared_ptr<Portfolio> buildPortfolio(Size size, Size offset = 0, Size stride = 1) {
+    auto portfolio = boost::make_shared<Portfolio>();
+    MersenneTwisterUniformRng rng(42);
+    for (Size i = 0; i < size; ++i) {
+        const string& ccy = currencies[rng.nextInt32() % currencies.size()];
+        Size term = 2 + rng.nextInt32() % 29;
+        Real rate = (10 + rng.nextInt32() % 390) / 10000.0;
+        bool isPayer = rng.nextInt32() % 2 == 0;
+        if (i % stride != offset)
+            continue;
+        string floatFreq = ccy == "USD" ? "3M" : "6M";
+        portfolio->add(testsuite::buildSwap("Trade_" + std::to_string(i + 1), ccy, isPayer, 1000000.0, 0, term, rate,
+                                            0.0, "1Y", "30/360", floatFreq, "A360", indices.at(ccy)));
+    }
+    return portfolio;
+}
+
+boost::shared_ptr<ScenarioSimMarketParameters> simulationParameters() {
+    auto parameters = boost::make_shared<ScenarioSimMarketParameters>();
+    parameters->baseCcy() = baseCcy;
+    parameters->ccys() = currencies;
+    parameters->setDiscountCurveNames(currencies);
+    parameters->setYieldCurveTenors("", {1 * Months, 6 * Months, 1 * Years, 2 * Years, 5 * Years, 10 * Years,
+                                         20 * Years, 30 * Years});
+    vector<string> idx;
+    for (auto const& [ccy, index] : indices)
+        idx.push_back(index);
+    parameters->setIndices(idx);
+    parameters->interpolation() = "LogLinear";
+    parameters->setSimulateSwapVols(false);
+    parameters->setSimulateFXVols(false);
+    parameters->setFxCcyPairs({"USDEUR", "GBPEUR"});
+    return parameters;
+}
+
+boost::shared_ptr<CrossAssetModelData> crossAssetModelData() {
+    vector<string> expiries = {"1Y", "2Y", "3Y", "5Y", "7Y", "10Y", "15Y", "20Y", "30Y"};
+    vector<string> terms(expiries.size(), "5Y");
+    vector<string> strikes(expiries.size(), "ATM");
+    vector<boost::shared_ptr<IrModelData>> irConfigs;
+    for (auto const& ccy : currencies) {
+        irConfigs.push_back(boost::make_shared<IrLgmData>(
+            ccy, CalibrationType::Bootstrap, LgmData::ReversionType::HullWhite, LgmData::VolatilityType::Hagan, false,
+            ParamType::Constant, vector<Time>(), vector<Real>{0.03}, true, ParamType::Piecewise, vector<Time>(),
+            vector<Real>{0.01}, 0.0, 1.0, expiries, terms, strikes));
+    }
+    vector<string> fxExpiries = {"1Y", "2Y", "3Y", "5Y", "7Y", "10Y"};
+    vector<string> fxStrikes(fxExpiries.size(), "ATMF");
+    vector<boost::shared_ptr<FxBsData>> fxConfigs;
+    for (auto const& ccy : currencies) {
+        if (ccy != baseCcy)
+            fxConfigs.push_back(boost::make_shared<FxBsData>(ccy, baseCcy, CalibrationType::Bootstrap, true,
+                                                             ParamType::Piecewise, vector<Time>(),
+                                                             vector<Real>{0.15}, fxExpiries, fxStrikes));
+    }
+    std::map<CorrelationKey, Handle<Quote>> corr;
+    CorrelationFactor eur{CrossAssetModel::AssetType::IR, "EUR", 0};
+    CorrelationFactor usd{CrossAssetModel::AssetType::IR, "USD", 0};
+    corr[std::make_pair(eur, usd)] = Handle<Quote>(boost::make_shared<SimpleQuote>(0.6));
+    return boost::make_shared<CrossAssetModelData>(irConfigs, fxConfigs, corr);
+}
+
+//! Everything the simulation workloads need, built against the test market
+struct Simulation {
+    explicit Simulation(const BenchmarkConfig& config) {
+        Settings::instance().evaluationDate() = benchmarkDate;
+        market = boost::make_shared<testsuite::TestMarket>(benchmarkDate);
+        grid = boost::make_shared<DateGrid>(std::to_string(config.dates) + ",3M");
+        parameters = simulationParameters();
+        model = *CrossAssetModelBuilder(market, crossAssetModelData()).model();
+        sgd = boost::make_shared<ScenarioGeneratorData>();
+        sgd->setGrid(grid);
+        sgd->samples() = config.samples;
+        sgd->seed() = 42;
+        sgd->sequenceType() = SobolBrownianBridge;
+    }
+    boost::shared_ptr<ScenarioSimMarket> simMarket() const {
+        auto sm = boost::make_shared<ScenarioSimMarket>(market, parameters);
+        sm->scenarioGenerator() = ScenarioGeneratorBuilder(sgd).build(
+            model, boost::make_shared<SimpleScenarioFactory>(), parameters, benchmarkDate, market);
+        return sm;
+    }
+    boost::shared_ptr<Market> market;
+    boost::shared_ptr<DateGrid> grid;
+    boost::shared_ptr<ScenarioSimMarketParameters> parameters;
+    boost::shared_ptr<CrossAssetModel> model;
+    boost::shared_ptr<ScenarioGeneratorData> sgd;
+};
+
+boost::shared_ptr<EngineData> discountingEngineData() {
+    auto data = boost::make_shared<EngineData>();
+    data->model("Swap") = "DiscountedCashflows";
+    data->engine("Swap") = "DiscountingSwapEngine";
+    return data;
+}
+
+double seconds(const boost::timer::cpu_timer& timer) { return timer.elapsed().wall * 1E-9; }
+
+// cube build with the classic valuation engine, the portfolio is split across threads
+Real runCube(const BenchmarkConfig& config, boost::shared_ptr<NPVCube>* result = nullptr,
+             boost::shared_ptr<Portfolio>* resultPortfolio = nullptr) {
+    if (config.threads > 1) {
+#ifndef QL_ENABLE_SESSIONS
+        QL_FAIL("ore-bench: threads > 1 requires a build with QL_ENABLE_SESSIONS = ON");
+#endif
+    }
+    Size nThreads = std::max<Size>(1, std::min(config.threads, config.trades));
+    ObservationMode::Mode om = ObservationMode::instance().mode();
+    std::vector<std::promise<void>> ready(nThreads);
+    std::promise<void> go;
+    std::shared_future<void> start = go.get_future().share();
+    std::vector<boost::shared_ptr<NPVCube>> cubes(nThreads);
+    std::vector<boost::shared_ptr<Portfolio>> portfolios(nThreads);
+    Real singleThreadTime = 0.0;
+
+    auto job = [&config, &ready, &start, &cubes, &portfolios, &singleThreadTime, nThreads, om](Size id) {
+        // the setup happens in each thread, since the QuantLib singletons are session-local
+        boost::shared_ptr<Portfolio> portfolio;
+        boost::shared_ptr<NPVCube> cube;
+        boost::shared_ptr<ValuationEngine> engine;
+        try {
+            ObservationMode::instance().setMode(om);
+            Simulation sim(config);
+            auto simMarket = sim.simMarket();
+            portfolio = buildPortfolio(config.trades, id, nThreads);
+            portfolio->build(boost::make_shared<EngineFactory>(discountingEngineData(), simMarket));
+            cube = boost::make_shared<DoublePrecisionInMemoryCube>(benchmarkDate, portfolio->ids(), sim.grid->dates(),
+                                                                  config.samples);
+            engine = boost::make_shared<ValuationEngine>(benchmarkDate, sim.grid, simMarket);
+        } catch (...) {
+            // hand the error to the main thread, which would otherwise wait for this thread forever
+            ready[id].set_exception(std::current_exception());
+            return;
+        }
+        ready[id].set_value();
+        // throws if the setup failed in another thread
+        start.get();
+        boost::timer::cpu_timer timer;
+        engine->buildCube(portfolio, cube, {boost::make_shared<NPVCalculator>(baseCcy)});
+        if (nThreads == 1)
+            singleThreadTime = seconds(timer);
+        cubes[id] = cube;
+        portfolios[id] = portfolio;
+    };
+
+    if (nThreads == 1) {
+        // run in the main thread, so that the results can be post-processed in the same session
+        go.set_value();
+        job(0);
+        // rethrows a setup error
+        ready[0].get_future().get();
+        if (result)
+            *result = cubes[0];
+        if (resultPortfolio)
+            *resultPortfolio = portfolios[0];
+        return singleThreadTime;
+    }
+    std::vector<std::future<void>> results;
+    for (Size i = 0; i < nThreads; ++i)
+        results.push_back(std::async(std::launch::async, job, i));
+    std::exception_ptr setupError;
+    for (auto& r : ready) {
+        try {
+            r.get_future().get();
+        } catch (...) {
+            if (!setupError)
+                setupError = std::current_exception();
+        }
+    }
+    if (setupError) {
+        // release the threads that are waiting for the start signal, then report the first setup error
+        go.set_exception(setupError);
+        for (auto& r : results)
+            r.wait();
+        std::rethrow_exception(setupError);
+    }
+    boost::timer::cpu_timer timer;
+    go.set_value();
+    for (auto& r : results)
+        r.get();
+    timer.stop();
+    return seconds(timer);
+}
+
+// cube build with the AMC valuation engine
+Real runAmc(const BenchmarkConfig& config) {
+    Simulation sim(config);
+    auto data = boost::make_shared<EngineData>();
+    data->model("Swap") = "CrossAssetModel";
+    data->engine("Swap") = "AMC";
+    std::map<string, string> engineParameters = {{"Training.Sequence", "MersenneTwisterAntithetic"},
+                                                 {"Training.Seed", "42"},
+                                                 {"Training.Samples", "10000"},
+                                                 {"Training.BasisFunction", "Monomial"},
+                                                 {"Training.BasisFunctionOrder", "6"},
+                                                 {"Pricing.Sequence", "SobolBrownianBridge"},
+                                                 {"Pricing.Seed", "17"},
+                                                 {"Pricing.Samples", "0"},
+                                                 {"BrownianBridgeOrdering", "Steps"},
+                                                 {"SobolDirectionIntegers", "JoeKuoD7"},
+                                                 {"MinObsDate", "true"}};
+    data->engineParameters("Swap") = engineParameters;
+    auto portfolio = buildPortfolio(config.trades);
+    portfolio->build(boost::make_shared<EngineFactory>(
+        data, sim.market, std::map<MarketContext, string>(), nullptr, IborFallbackConfig::defaultConfig(),
+        std::vector<boost::shared_ptr<EngineBuilder>>{
+            boost::make_shared<CamAmcSwapEngineBuilder>(sim.model, sim.grid->dates())},
+        true));
+    auto cube = boost::make_shared<DoublePrecisionInMemoryCube>(benchmarkDate, portfolio->ids(), sim.grid->dates(),
+                                                               config.samples);
+    AMCValuationEngine engine(sim.model, sim.sgd, sim.market, {}, {}, 0);
+    boost::timer::cpu_timer timer;
+    engine.buildCube(portfolio, cube);
+    timer.stop();
+    return seconds(timer);
+}
+
+// delta / gamma sensitivities on the 5 currency sensitivity setup of the test suite
+Real runSensitivities(const BenchmarkConfig& config, Size& numScenarios) {
+    Settings::instance().evaluationDate() = benchmarkDate;
+    auto market = boost::make_shared<testsuite::TestMarket>(benchmarkDate);
+    auto portfolio = buildPortfolio(config.trades);
+    auto sa = boost::make_shared<SensitivityAnalysis>(
+        portfolio, market, Market::defaultConfiguration, discountingEngineData(),
+        testsuite::TestConfigurationObjects::setupSimMarketData5(),
+        testsuite::TestConfigurationObjects::setupSensitivityScenarioData5(), false);
+    boost::timer::cpu_timer timer;
+    sa->generateSensitivities();
+    timer.stop();
+    numScenarios = sa->scenarioGenerator()->samples();
+    return seconds(timer);
+}
+
+// historical P&L generation on synthetic 10 day scenarios and a 99% VaR from the resulting P&L vector
+Real runHistoricalVar(const BenchmarkConfig& config) {
+    Settings::instance().evaluationDate() = benchmarkDate;
+    auto market = boost::make_shared<testsuite::TestMarket>(benchmarkDate);
+    auto simMarket = boost::make_shared<ScenarioSimMarket>(market, simulationParameters());
+    auto portfolio = buildPortfolio(config.trades);
+    portfolio->build(boost::make_shared<EngineFactory>(discountingEngineData(), simMarket));
+
+    // one scenario per business day, the generator produces samples mpor days apart
+    const Size mporDays = 10;
+    Calendar cal = TARGET();
+    auto loader = boost::make_shared<HistoricalScenarioLoader>();
+    auto base = simMarket->baseScenario();
+    InverseCumulativeRng<MersenneTwisterUniformRng, InverseCumulativeNormal> rng(MersenneTwisterUniformRng(42));
+    Date d = cal.advance(benchmarkDate, -static_cast<Integer>(config.samples + mporDays), Days);
+    for (Size i = 0; i < config.samples + mporDays; ++i, d = cal.advance(d, 1, Days)) {
+        auto s = boost::make_shared<SimpleScenario>(d, "", 1.0);
+        for (auto const& k : base->keys())
+            s->add(k, base->get(k) * std::exp(0.01 * rng.next().value));
+        loader->historicalScenarios().push_back(s);
+        loader->dates().push_back(d);
+    }
+    auto hsg = boost::make_shared<HistoricalScenarioGenerator>(loader, boost::make_shared<SimpleScenarioFactory>(),
+                                                               cal, nullptr, mporDays);
+    hsg->baseScenario() = base;
+    auto cube = boost::make_shared<DoublePrecisionInMemoryCube>(benchmarkDate, portfolio->ids(),
+                                                               vector<Date>(1, benchmarkDate), hsg->numScenarios());
+    HistoricalPnlGenerator generator(baseCcy, portfolio, simMarket, hsg, cube);
+
+    boost::timer::cpu_timer timer;
+    generator.generateCube(nullptr);
+    vector<Real> pnl = generator.pnl();
+    std::sort(pnl.begin(), pnl.end());
+    Real var = pnl.empty() ? 0.0 : -pnl[static_cast<Size>(0.01 * pnl.size())];
+    timer.stop();
+    std::clog << "historical VaR (99%) = " << var << std::endl;
+    return seconds(timer);
+}
+
+// trade and netting set exposure aggregation on a simulated cube
+Real runPostProcess(const BenchmarkConfig& config) {
+    BenchmarkConfig single = config;
+    single.threads = 1;
+    boost::shared_ptr<NPVCube> cube;
+    boost::shared_ptr<Portfolio> portfolio;
+    runCube(single, &cube, &portfolio);
+    auto market = boost::make_shared<testsuite::TestMarket>(benchmarkDate);
+    auto interpretation = boost::make_shared<CubeInterpretation>(false, false);
+    ExposureCalculator calculator(portfolio, cube, interpretation, market, false, baseCcy,
+                                  Market::defaultConfiguration, 0.95, CollateralExposureHelper::NoLag, false, false);
+    boost::timer::cpu_timer timer;
+    calculator.build();
+    timer.stop();
+    return seconds(timer);
+}
+
+BenchmarkResult run(const string& workload, const BenchmarkConfig& config) {
+    // the other workloads run on one thread with observation mode None, the result reports the settings used
+    bool configured = usesThreadsAndObservationMode(workload);
+    BenchmarkResult r{workload,
+                      config.trades,
+                      config.samples,
+                      config.dates,
+                      configured ? config.threads : 1,
+                      configured ? config.observationMode : "None",
+                      0.0,
+                      0.0,
+                      "",
+                      0};
+    ObservationMode::instance().setMode(r.observationMode);
+    // number of work units processed by one run
+    Real units = 0.0;
+    Real best = QL_MAX_REAL;
+    for (Size i = 0; i < config.repeat; ++i) {
+        Real t;
+        if (workload == "cube" || workload == "amc") {
+            t = workload == "cube" ? runCube(config) : runAmc(config);
+            units = static_cast<Real>(config.trades * config.samples * config.dates);
+            r.unit = "npvs/sec";
+        } else if (workload == "sensi") {
+            Size numScenarios = 0;
+            t = runSensitivities(config, numScenarios);
+            units = static_cast<Real>(config.trades * numScenarios);
+            r.unit = "trade scenarios/sec";
+        } else if (workload == "var") {
+            t = runHistoricalVar(config);
+            units = static_cast<Real>(config.trades * config.samples);
+            r.unit = "trade scenarios/sec";
+        } else if (workload == "postprocess") {
+            t = runPostProcess(config);
+            units = static_cast<Real>(config.trades * config.samples * config.dates);
+            r.unit = "npvs/sec";
+        } else {
+            QL_FAIL("ore-bench: unknown workload '" << workload << "'");
+        }
+        best = std::min(best, t);
+    }
+    r.time = best;
+    r.throughput = best > 0.0 ? units / best : 0.0;
+    r.peakRss = ore::data::os::getPeakMemoryUsageBytes();
+    return r;
+}
+
+void writeJson(std::ostream& out, const vector<BenchmarkResult>& results) {
+    out << "{\n  \"date\": \"" << ore::data::to_string(Date::todaysDate()) << "\",\n  \"results\": [";
+    for (Size i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {\"key\": \"" << r.key() << "\", \"workload\": \"" << r.workload
+            << "\", \"trades\": " << r.trades << ", \"samples\": " << r.samples << ", \"dates\": " << r.dates
+            << ", \"threads\": " << r.threads << ", \"observationMode\": \"" << r.observationMode
+            << "\", \"time\": " << std::setprecision(6) << r.time << ", \"throughput\": " << r.throughput
+            << ", \"unit\": \"" << r.unit << "\", \"peakRss\": " << r.peakRss << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+// returns the number of regressions
+Size compare(const vector<BenchmarkResult>& results, const string& baselineFile, Real tolerance) {
+    boost::property_tree::ptree baseline;
+    boost::property_tree::read_json(baselineFile, baseline);
+    std::map<string, Real> baselineTimes;
+    for (auto const& r : baseline.get_child("results"))
+        baselineTimes[r.second.get<string>("key")] = r.second.get<Real>("time");
+    Size regressions = 0;
+    std::cout << std::left << std::setw(60) << "Benchmark" << std::right << std::setw(12) << "Baseline"
+              << std::setw(12) << "Current" << std::setw(10) << "Change" << std::endl;
+    for (auto const& r : results) {
+        auto b = baselineTimes.find(r.key());
+        if (b == baselineTimes.end()) {
+            std::cout << std::left << std::setw(60) << r.key() << std::right << std::setw(12) << "n/a"
+                      << std::setw(12) << r.time << std::endl;
+            continue;
+        }
+        Real change = b->second > 0.0 ? r.time / b->second - 1.0 : 0.0;
+        bool regression = change > tolerance;
+        regressions += regression ? 1 : 0;
+        std::cout << std::left << std::setw(60) << r.key() << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(12) << b->second << std::setw(12) << r.time << std::setw(9) << std::setprecision(1)
+                  << 100.0 * change << "%" << (regression ? "  REGRESSION" : "") << std::endl;
+    }
+    return regressions;
+}
+
+void usage() {
+    std::cout << "usage: ore-bench [options]\n"
+              << "  --workload W          cube, amc, sensi, var, postprocess or all (repeatable, default cube)\n"
+              << "  --trades N            portfolio size (default 100)\n"
+              << "  --samples N           Monte Carlo samples / historical scenarios (default 100)\n"
+              << "  --dates N             number of quarterly simulation dates (default 40)\n"
+              << "  --threads N           worker threads for the cube workload (default 1)\n"
+              << "  --observationMode M   None, Disable, Defer, Unregister or Targeted for the cube workload\n"
+              << "                        (default None)\n"
+              << "  --repeat N            repetitions, the best time is reported (default 1)\n"
+              << "  --output F            write the JSON results to F instead of stdout\n"
+              << "  --baseline F          compare against the JSON results in F\n"
+              << "  --tolerance X         relative slowdown flagged as regression (default 0.1)\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+
+    BenchmarkConfig config;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            string arg = argv[i];
+            if (arg == "--help" || arg == "-h") {
+                usage();
+                return 0;
+            }
+            QL_REQUIRE(i + 1 < argc, "ore-bench: missing value for " << arg);
+            string value = argv[++i];
+            if (arg == "--workload") {
+                if (value == "all")
+                    config.workloads.insert({"cube", "amc", "sensi", "var", "postprocess"});
+                else
+                    config.workloads.insert(value);
+            } else if (arg == "--trades")
+                config.trades = parseInteger(value);
+            else if (arg == "--samples")
+                config.samples = parseInteger(value);
+            else if (arg == "--dates")
+                config.dates = parseInteger(value);
+            else if (arg == "--threads")
+                config.threads = parseInteger(value);
+            else if (arg == "--observationMode")
+                config.observationMode = value;
+            else if (arg == "--repeat")
+                config.repeat = parseInteger(value);
+            else if (arg == "--output")
+                config.output = value;
+            else if (arg == "--baseline")
+                config.baseline = value;
+            else if (arg == "--tolerance")
+                config.tolerance = parseReal(value);
+            else
+                QL_FAIL("ore-bench: unknown option " << arg);
+        }
+        if (config.workloads.empty())
+            config.workloads.insert("cube");
+        QL_REQUIRE(config.trades > 0 && config.samples > 0 && config.dates > 0 && config.threads > 0 &&
+                       config.repeat > 0,
+                   "ore-bench: trades, samples, dates, threads and repeat must be positive");
+
+        ore::data::initBuilders();
+        // validates the mode, each workload sets the mode it runs under
+        ObservationMode::instance().setMode(config.observationMode);
+
+        vector<BenchmarkResult> results;
+        for (auto const& w : config.workloads) {
+            std::clog << "running " << w << " ..." << std::endl;
+            results.push_back(run(w, config));
+            std::clog << "  " << results.back().time << " sec, " << results.back().throughput << " "
+                      << results.back().unit << std::endl;
+        }
+
+        if (config.output.empty()) {
+            writeJson(std::cout, results);
+        } else {
+            std::ofstream out(config.output);
+            QL_REQUIRE(out.is_open(), "ore-bench: can not open output file " << config.output);
+            writeJson(out, results);
+        }
+
+        if (!config.baseline.empty()) {
+            Size regressions = compare(results, config.baseline, config.tolerance);
+            if (regressions > 0) {
+                std::cout << regressions << " regression(s) against " << config.baseline << std::endl;
+                return 2;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
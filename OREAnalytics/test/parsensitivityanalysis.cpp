@@ -20,6 +20,8 @@
 #include <test/oreatoplevelfixture.hpp>
 #include <test/testmarket.hpp>
 #include <test/testportfolio.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
 #include <boost/timer/timer.hpp>
 #include <orea/cube/inmemorycube.hpp>
 #include <orea/cube/npvcube.hpp>
@@ -29,6 +31,7 @@
 #include <orea/engine/valuationengine.hpp>
 #include <orea/scenario/scenariosimmarket.hpp>
 #include <orea/scenario/scenariosimmarketparameters.hpp>
+#include <orea/scenario/scenariosimmarketplus.hpp>
 #include <orea/scenario/sensitivityscenariogenerator.hpp>
 #include <ored/model/lgmdata.hpp>
 #include <ored/portfolio/builders/bond.hpp>
@@ -44,6 +47,7 @@
 #include <ored/utilities/dategrid.hpp>
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/osutils.hpp>
+#include <ored/utilities/parsers.hpp>
 #include <ored/utilities/to_string.hpp>
 #include <orea/engine/parsensitivityanalysis.hpp>
 #include <orea/engine/sensitivityanalysisplus.hpp>
@@ -56,6 +60,8 @@
 #include <ql/time/date.hpp>
 #include <ql/time/daycounters/actualactual.hpp>
 
+#include <fstream>
+
 using namespace std;
 using namespace QuantLib;
 using namespace QuantExt;
@@ -1056,7 +1062,7 @@ void ParSensitivityAnalysisTest::testPortfolioZeroSensitivity() {
     IndexManager::instance().clearHistories();
 }
 
-void testParConversion(ObservationMode::Mode om) {
+void testParConversion(ObservationMode::Mode om, bool useJacobiCache = false, bool multiThreaded = false) {
 
     SavedSettings backup;
 
@@ -1165,9 +1171,96 @@ void testParConversion(ObservationMode::Mode om) {
     //     // PC, 30-07-2018, yes they should, cached results have to be updated then (postponed...)
     //     parAnalysis.alignPillars();
     //     zeroAnalysis->overrideTenors(true);
+    string jacobiCache, jacobiInverseCache;
+    if (useJacobiCache) {
+        string cache = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+        jacobiCache = cache + "_jacobi.csv";
+        jacobiInverseCache = cache + "_jacobi_inverse.csv";
+        parAnalysis.setJacobiCache(jacobiCache, 1E-8);
+    }
     parAnalysis.computeParInstrumentSensitivities(zeroAnalysis->simMarket());
-    boost::shared_ptr<ParSensitivityConverter> parConverter =
-        boost::make_shared<ParSensitivityConverter>(parAnalysis.parSensitivities(), parAnalysis.shiftSizes());
+    boost::shared_ptr<ParSensitivityConverter> parConverter = boost::make_shared<ParSensitivityConverter>(
+        parAnalysis.parSensitivities(), parAnalysis.shiftSizes(), jacobiInverseCache);
+
+    if (useJacobiCache) {
+        BOOST_CHECK(!parAnalysis.jacobiFromCache());
+        // a second run on the same market reuses the cached par sensitivities and inverse
+        ParSensitivityAnalysis cachedParAnalysis(today, simMarketData, *sensiData, "default");
+        cachedParAnalysis.alignPillars();
+        cachedParAnalysis.setJacobiCache(jacobiCache, 1E-8);
+        cachedParAnalysis.computeParInstrumentSensitivities(zeroAnalysis->simMarket());
+        BOOST_CHECK(cachedParAnalysis.jacobiFromCache());
+        BOOST_CHECK(cachedParAnalysis.parSensitivities() == parAnalysis.parSensitivities());
+        ParSensitivityConverter cachedParConverter(cachedParAnalysis.parSensitivities(),
+                                                   cachedParAnalysis.shiftSizes(), jacobiInverseCache);
+        boost::numeric::ublas::vector<Real> zeroSensi(parConverter->rawKeys().size(), 1.0);
+        auto parSensi = parConverter->convertSensitivity(zeroSensi);
+        auto cachedParSensi = cachedParConverter.convertSensitivity(zeroSensi);
+        for (Size i = 0; i < parSensi.size(); ++i)
+            BOOST_CHECK_CLOSE(cachedParSensi[i], parSensi[i], 1E-10);
+        // a cache written for another asof or other shift sizes is not reused
+        auto modifyCache = [&jacobiCache](const string& prefix, const std::function<string(const string&)>& f) {
+            vector<string> lines;
+            {
+                std::ifstream in(jacobiCache);
+                for (string line; std::getline(in, line);)
+                    lines.push_back(line);
+            }
+            auto l = std::find_if(lines.begin(), lines.end(),
+                                  [&prefix](const string& line) { return boost::starts_with(line, prefix); });
+            BOOST_REQUIRE(l != lines.end());
+            *l = f(*l);
+            std::ofstream out(jacobiCache);
+            for (auto const& line : lines)
+                out << line << "\n";
+        };
+        modifyCache("Asof,", [&today](const string&) { return "Asof," + to_string(today - 1); });
+        ParSensitivityAnalysis otherAsofParAnalysis(today, simMarketData, *sensiData, "default");
+        otherAsofParAnalysis.alignPillars();
+        otherAsofParAnalysis.setJacobiCache(jacobiCache, 1E-8);
+        otherAsofParAnalysis.computeParInstrumentSensitivities(zeroAnalysis->simMarket());
+        BOOST_CHECK(!otherAsofParAnalysis.jacobiFromCache());
+        modifyCache("Raw,", [](const string& line) {
+            vector<string> tokens;
+            boost::split(tokens, line, boost::is_any_of(","));
+            BOOST_REQUIRE_EQUAL(tokens.size(), 4);
+            return tokens[0] + "," + tokens[1] + "," + tokens[2] + "," + to_string(2.0 * parseReal(tokens[3]));
+        });
+        ParSensitivityAnalysis otherShiftParAnalysis(today, simMarketData, *sensiData, "default");
+        otherShiftParAnalysis.alignPillars();
+        otherShiftParAnalysis.setJacobiCache(jacobiCache, 1E-8);
+        otherShiftParAnalysis.computeParInstrumentSensitivities(zeroAnalysis->simMarket());
+        BOOST_CHECK(!otherShiftParAnalysis.jacobiFromCache());
+        // a negative tolerance forces a refresh
+        ParSensitivityAnalysis refreshedParAnalysis(today, simMarketData, *sensiData, "default");
+        refreshedParAnalysis.alignPillars();
+        refreshedParAnalysis.setJacobiCache(jacobiCache, -1.0);
+        refreshedParAnalysis.computeParInstrumentSensitivities(zeroAnalysis->simMarket());
+        BOOST_CHECK(!refreshedParAnalysis.jacobiFromCache());
+        BOOST_CHECK_EQUAL(refreshedParAnalysis.parSensitivities().size(), parAnalysis.parSensitivities().size());
+        boost::filesystem::remove(jacobiCache);
+        boost::filesystem::remove(jacobiInverseCache);
+    }
+    if (multiThreaded) {
+        // the other threads reprice the par instruments on their own sim markets, built in the respective thread
+        ParSensitivityAnalysis mtParAnalysis(today, simMarketData, *sensiData, "default");
+        mtParAnalysis.alignPillars();
+        mtParAnalysis.computeParInstrumentSensitivities(
+            4, [&zeroAnalysis, &simMarketData, &sensiData, today](Size id) -> boost::shared_ptr<ScenarioSimMarket> {
+                if (id == 0)
+                    return zeroAnalysis->simMarket();
+                return boost::make_shared<ScenarioSimMarketPlus>(
+                    boost::make_shared<TestMarket>(today), simMarketData, Market::defaultConfiguration,
+                    CurveConfigurations(), TodaysMarketParameters(), false, sensiData->useSpreadedTermStructures());
+            });
+        BOOST_REQUIRE_EQUAL(mtParAnalysis.parSensitivities().size(), parAnalysis.parSensitivities().size());
+        for (auto const& [keys, value] : parAnalysis.parSensitivities()) {
+            auto mt = mtParAnalysis.parSensitivities().find(keys);
+            BOOST_REQUIRE_MESSAGE(mt != mtParAnalysis.parSensitivities().end(),
+                                  "par sensitivity " << keys.first << " / " << keys.second << " not found");
+            BOOST_CHECK_CLOSE(mt->second, value, 1E-10);
+        }
+    }
     boost::shared_ptr<SensitivityCube> sensiCube = zeroAnalysis->sensiCube();
     ZeroToParCube parCube(sensiCube, parConverter);
 
@@ -1360,6 +1453,16 @@ void ParSensitivityAnalysisTest::testParConversionUnregisterObs() {
     testParConversion(ObservationMode::Mode::Unregister);
 }
 
+void ParSensitivityAnalysisTest::testParConversionJacobiCache() {
+    BOOST_TEST_MESSAGE("Testing Sensitivity Par Conversion with cached Jacobi matrix");
+    testParConversion(ObservationMode::Mode::None, true);
+}
+
+void ParSensitivityAnalysisTest::testParConversionMultiThreaded() {
+    BOOST_TEST_MESSAGE("Testing Sensitivity Par Conversion with multi-threaded par instrument repricing");
+    testParConversion(ObservationMode::Mode::None, false, true);
+}
+
 void ParSensitivityAnalysisTest::test1dZeroShifts() {
     BOOST_TEST_MESSAGE("Testing 1d shifts");
 
@@ -1604,6 +1707,18 @@ BOOST_AUTO_TEST_CASE(ParConversionUnregisterObs) {
     ParSensitivityAnalysisTest::testParConversionUnregisterObs();
 }
 
+BOOST_AUTO_TEST_CASE(ParConversionJacobiCache) {
+    BOOST_TEST_MESSAGE("Testing Par Conversion JacobiCache");
+    ParSensitivityAnalysisTest::testParConversionJacobiCache();
+}
+
+#ifdef QL_ENABLE_SESSIONS
+BOOST_AUTO_TEST_CASE(ParConversionMultiThreaded) {
+    BOOST_TEST_MESSAGE("Testing Par Conversion MultiThreaded");
+    ParSensitivityAnalysisTest::testParConversionMultiThreaded();
+}
+#endif
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -49,6 +49,10 @@ public:
     static void testParConversionDeferObs();
     //! Test par conversion of sensitivities ("Unregister" observation mode)
     static void testParConversionUnregisterObs();
+    //! Test reuse of the cached Jacobi matrix and its inverse in the par conversion
+    static void testParConversionJacobiCache();
+    //! Test that the par instrument repricing on several threads gives the single-threaded par sensitivities
+    static void testParConversionMultiThreaded();
     static boost::unit_test_framework::test_suite* suite();
 };
 } // namespace testsuite
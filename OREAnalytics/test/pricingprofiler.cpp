@@ -0,0 +1,90 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <orea/app/reportwriter.hpp>
+#include <orea/engine/pricingprofiler.hpp>
+#include <ored/report/inmemoryreport.hpp>
+#include <oret/toplevelfixture.hpp>
+
+using namespace ore::analytics;
+using namespace ore::data;
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(PricingProfilerTest)
+
+BOOST_AUTO_TEST_CASE(testRankingAndMerge) {
+
+    BOOST_TEST_MESSAGE("Testing pricing profile ranking and merging...");
+
+    using Category = PricingProfile::Category;
+
+    PricingProfile p1, p2;
+    p1.add(Category::Trade, "T1", 100);
+    p1.add(Category::Trade, "T2", 300);
+    p1.add(Category::TradeType, "Swap", 400, 2);
+    p1.add(Category::Phase, "MarketUpdate", 50);
+    p2.add(Category::Trade, "T1", 400);
+    p2.add(Category::Trade, "T3", 10);
+    p2.add(Category::TradeType, "Swap", 410, 2);
+
+    p1.merge(p2);
+
+    auto trades = p1.ranked(Category::Trade);
+    BOOST_REQUIRE_EQUAL(trades.size(), 3);
+    BOOST_CHECK_EQUAL(trades[0].first, "T1");
+    BOOST_CHECK_EQUAL(trades[0].second.count, 2);
+    BOOST_CHECK_EQUAL(trades[0].second.wallTime, 500);
+    BOOST_CHECK_EQUAL(trades[1].first, "T2");
+    BOOST_CHECK_EQUAL(trades[2].first, "T3");
+
+    BOOST_CHECK_EQUAL(p1.totalWallTime(Category::Trade), 810);
+    BOOST_CHECK_EQUAL(p1.totalWallTime(Category::TradeType), 810);
+    BOOST_CHECK_EQUAL(p1.ranked(Category::TradeType)[0].second.count, 4);
+    BOOST_CHECK(p1.ranked(Category::Calculator).empty());
+
+    InMemoryReport report;
+    ReportWriter().writePricingProfile(report, p1);
+    // one phase, one trade type and three trades
+    BOOST_CHECK_EQUAL(report.rows(), 5);
+
+    p1.clear();
+    BOOST_CHECK(p1.empty());
+}
+
+BOOST_AUTO_TEST_CASE(testProfilerSwitch) {
+
+    BOOST_TEST_MESSAGE("Testing pricing profiler switch...");
+
+    BOOST_CHECK(!PricingProfiler::instance().enabled());
+    PricingProfiler::instance().setEnabled(true);
+    PricingProfile p;
+    p.add(PricingProfile::Category::Calculator, "NPVCalculator", 10);
+    PricingProfiler::instance().add(p);
+    PricingProfiler::instance().add(p);
+    BOOST_CHECK_EQUAL(PricingProfiler::instance().profile().ranked(PricingProfile::Category::Calculator)[0].second.count,
+                      2);
+    PricingProfiler::instance().reset();
+    PricingProfiler::instance().setEnabled(false);
+    BOOST_CHECK(PricingProfiler::instance().profile().empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -23,10 +23,16 @@
 #include <orea/scenario/scenariosimmarket.hpp>
 #include <orea/scenario/simplescenario.hpp>
 #include <orea/scenario/simplescenariofactory.hpp>
+#include <ored/configuration/conventions.hpp>
+#include <ored/configuration/curveconfigurations.hpp>
+#include <ored/marketdata/csvloader.hpp>
 #include <ored/marketdata/market.hpp>
 #include <ored/marketdata/marketimpl.hpp>
+#include <ored/marketdata/todaysmarket.hpp>
+#include <ored/marketdata/todaysmarketparameters.hpp>
 #include <ored/model/calibrationinstruments/cpicapfloor.hpp>
 #include <ored/model/crossassetmodelbuilder.hpp>
+#include <ored/model/crossassetmodeldata.hpp>
 #include <ored/model/irlgmdata.hpp>
 #include <ored/portfolio/builders/swap.hpp>
 #include <ored/portfolio/swap.hpp>
@@ -66,6 +72,7 @@
 #include <ql/time/daycounters/thirty360.hpp>
 #include <test/testmarket.hpp>
 
+#include <boost/algorithm/string/predicate.hpp>
 #include <boost/timer/timer.hpp>
 
 using namespace QuantLib;
@@ -189,9 +196,8 @@ struct TestData {
         cmb.addCorrelation("INF:EUHICPXT", "IR:EUR", Handle<Quote>(boost::make_shared<SimpleQuote>(0.1)));
 
         Real tolerance = 0.0001;
-        boost::shared_ptr<CrossAssetModelData> config(
-            boost::make_shared<CrossAssetModelData>(irConfigs, fxConfigs, eqConfigs, infConfigs, crLgmConfigs,
-                                                    crCirConfigs, comConfigs, 0, cmb.correlations(), tolerance));
+        config = boost::make_shared<CrossAssetModelData>(irConfigs, fxConfigs, eqConfigs, infConfigs, crLgmConfigs,
+                                                         crCirConfigs, comConfigs, 0, cmb.correlations(), tolerance);
 
         CrossAssetModelBuilder modelBuilder(market, config);
         ccLgm = *modelBuilder.model();
@@ -478,6 +484,105 @@ BOOST_AUTO_TEST_CASE(testCrossAssetLowDiscrepancyBrownianBridge) {
     test_crossasset(true, false, true);
 }
 
+#ifdef QL_ENABLE_SESSIONS
+BOOST_AUTO_TEST_CASE(testCrossAssetModelParallelCalibration) {
+    BOOST_TEST_MESSAGE("Testing CrossAssetModelBuilder with parallel calibration...");
+    setConventions();
+
+    TestData d;
+
+    CrossAssetModelBuilder modelBuilder(d.market, d.config, Market::defaultConfiguration, Market::defaultConfiguration,
+                                        Market::defaultConfiguration, Market::defaultConfiguration,
+                                        Market::defaultConfiguration, Market::defaultConfiguration, false, false, "",
+                                        SalvagingAlgorithm::None, "unknown", 4);
+    boost::shared_ptr<QuantExt::CrossAssetModel> model = *modelBuilder.model();
+
+    // the calibrated parameters must not depend on the number of calibration threads
+    for (Size i = 0; i < 3; ++i) {
+        for (Size k = 0; k < 2; ++k) {
+            Array expected = d.ccLgm->irlgm1f(i)->parameterValues(k);
+            Array actual = model->irlgm1f(i)->parameterValues(k);
+            BOOST_REQUIRE_EQUAL(actual.size(), expected.size());
+            for (Size j = 0; j < expected.size(); ++j)
+                BOOST_CHECK_CLOSE(actual[j], expected[j], 1.0E-10);
+        }
+    }
+    for (Size i = 0; i < 2; ++i) {
+        Array expected = d.ccLgm->fxbs(i)->parameterValues(0);
+        Array actual = model->fxbs(i)->parameterValues(0);
+        BOOST_REQUIRE_EQUAL(actual.size(), expected.size());
+        for (Size j = 0; j < expected.size(); ++j)
+            BOOST_CHECK_CLOSE(actual[j], expected[j], 1.0E-10);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testCrossAssetModelParallelRecalibrationXccy) {
+    BOOST_TEST_MESSAGE("Testing CrossAssetModelBuilder parallel recalibration on xccy discount curves...");
+
+    // the Example_1 model has five LGM and four FX components, the non-EUR curves are discounted with xccy curves
+    const std::string examples = "../../../../Examples/Input/";
+    Date asof(5, February, 2016);
+    Settings::instance().evaluationDate() = asof;
+
+    auto conventions = boost::make_shared<Conventions>();
+    conventions->fromFile(examples + "conventions.xml");
+    InstrumentConventions::instance().setConventions(conventions);
+    auto curveConfigs = boost::make_shared<CurveConfigurations>();
+    curveConfigs->fromFile(examples + "curveconfig.xml");
+    auto todaysMarketParams = boost::make_shared<TodaysMarketParameters>();
+    todaysMarketParams->fromFile(examples + "todaysmarket.xml");
+    auto camData = boost::make_shared<CrossAssetModelData>();
+    camData->fromFile("../../../../Examples/Example_1/Input/simulation.xml");
+
+    // each run uses its own lazily built market, the quotes of which stay linked to the loader's quotes
+    auto calibrate = [&](Size threads) {
+        auto loader =
+            boost::make_shared<CSVLoader>(examples + "market_20160205.txt", examples + "fixings_20160205.txt", true);
+        auto market = boost::make_shared<TodaysMarket>(asof, todaysMarketParams, loader, curveConfigs, false, true,
+                                                       true, nullptr, true);
+        CrossAssetModelBuilder modelBuilder(market, camData, Market::defaultConfiguration,
+                                            Market::defaultConfiguration, Market::defaultConfiguration,
+                                            Market::defaultConfiguration, Market::defaultConfiguration,
+                                            Market::defaultConfiguration, false, false, "", SalvagingAlgorithm::None,
+                                            "unknown", threads);
+        boost::shared_ptr<QuantExt::CrossAssetModel> model = *modelBuilder.model();
+        // shift the swap and basis swap quotes, the xccy curves are recalculated lazily during the in-place recalibration
+        for (auto const& md : loader->loadQuotes(asof)) {
+            if (boost::starts_with(md->name(), "IR_SWAP/RATE/") || boost::starts_with(md->name(), "CC_BASIS_SWAP/")) {
+                auto q = boost::dynamic_pointer_cast<SimpleQuote>(*md->quote());
+                BOOST_REQUIRE(q);
+                q->setValue(q->value() + 0.0001);
+            }
+        }
+        modelBuilder.recalibrate();
+        return model;
+    };
+
+    auto expected = calibrate(1);
+    auto actual = calibrate(4);
+
+    // the calibrated parameters must be identical, not only close
+    BOOST_REQUIRE_EQUAL(actual->components(CrossAssetModel::AssetType::IR), 5);
+    BOOST_REQUIRE_EQUAL(actual->components(CrossAssetModel::AssetType::FX), 4);
+    for (Size i = 0; i < 5; ++i) {
+        for (Size k = 0; k < 2; ++k) {
+            Array e = expected->irlgm1f(i)->parameterValues(k);
+            Array a = actual->irlgm1f(i)->parameterValues(k);
+            BOOST_REQUIRE_EQUAL(a.size(), e.size());
+            for (Size j = 0; j < e.size(); ++j)
+                BOOST_CHECK_EQUAL(a[j], e[j]);
+        }
+    }
+    for (Size i = 0; i < 4; ++i) {
+        Array e = expected->fxbs(i)->parameterValues(0);
+        Array a = actual->fxbs(i)->parameterValues(0);
+        BOOST_REQUIRE_EQUAL(a.size(), e.size());
+        for (Size j = 0; j < e.size(); ++j)
+            BOOST_CHECK_EQUAL(a[j], e[j]);
+    }
+}
+#endif
+
 BOOST_AUTO_TEST_CASE(testCrossAssetSimMarket) {
     BOOST_TEST_MESSAGE("Testing CrossAssetScenarioGenerator via SimMarket (Martingale tests)...");
     setConventions();
@@ -17,8 +17,11 @@
 */
 
 #include <boost/test/unit_test.hpp>
+#include <orea/scenario/deltascenariofactory.hpp>
+#include <orea/scenario/scenariogenerator.hpp>
 #include <orea/scenario/scenariosimmarket.hpp>
 #include <orea/scenario/scenariosimmarketparameters.hpp>
+#include <orea/scenario/scenariosimmarketplus.hpp>
 #include <ored/configuration/conventions.hpp>
 #include <ored/marketdata/market.hpp>
 #include <ored/marketdata/marketimpl.hpp>
@@ -95,6 +98,19 @@ boost::shared_ptr<analytics::ScenarioSimMarketParameters> scenarioParameters() {
     parameters->setCorrelationPairs({"EUR-CMS-10Y:EUR-CMS-1Y", "USD-CMS-10Y:USD-CMS-1Y"});
     return parameters;
 }
+
+// returns a fixed sequence of scenarios
+class FixedScenarioGenerator : public analytics::ScenarioGenerator {
+public:
+    explicit FixedScenarioGenerator(const vector<boost::shared_ptr<analytics::Scenario>>& scenarios)
+        : scenarios_(scenarios), counter_(0) {}
+    boost::shared_ptr<analytics::Scenario> next(const Date&) override { return scenarios_.at(counter_++); }
+    void reset() override { counter_ = 0; }
+
+private:
+    vector<boost::shared_ptr<analytics::Scenario>> scenarios_;
+    Size counter_;
+};
 } // namespace
 
 void testFxSpot(boost::shared_ptr<ore::data::Market>& initMarket,
@@ -305,6 +321,55 @@ BOOST_AUTO_TEST_CASE(testScenarioSimMarket) {
     testToXML(parameters);
 }
 
+BOOST_AUTO_TEST_CASE(testDeltaScenarioApplication) {
+    BOOST_TEST_MESSAGE("Testing incremental application of delta scenarios in ScenarioSimMarketPlus...");
+
+    SavedSettings backup;
+
+    Date today(20, Jan, 2015);
+    Settings::instance().evaluationDate() = today;
+    boost::shared_ptr<ore::data::Market> initMarket = boost::make_shared<TestMarket>(today);
+
+    boost::shared_ptr<analytics::ScenarioSimMarketParameters> parameters = scenarioParameters();
+    convs();
+    auto simMarket = boost::make_shared<analytics::ScenarioSimMarket>(initMarket, parameters);
+    auto simMarketPlus = boost::make_shared<analytics::ScenarioSimMarketPlus>(initMarket, parameters);
+
+    // single, overlapping and empty shifts of the EUR discount curve pillars
+    auto base = simMarketPlus->baseScenario();
+    analytics::DeltaScenarioFactory factory(base);
+    vector<vector<Size>> shifts = {{0}, {1}, {1, 2}, {2}, {}, {0, 2}, {0}};
+    vector<boost::shared_ptr<analytics::Scenario>> scenarios;
+    for (auto const& pillars : shifts) {
+        auto scenario = factory.buildScenario(today);
+        for (auto i : pillars) {
+            analytics::RiskFactorKey key(analytics::RiskFactorKey::KeyType::DiscountCurve, "EUR", i);
+            scenario->add(key, base->get(key) * (1.0 - 0.001 * (i + 1)));
+        }
+        scenarios.push_back(scenario);
+    }
+    simMarket->scenarioGenerator() = boost::make_shared<FixedScenarioGenerator>(scenarios);
+    simMarketPlus->scenarioGenerator() = boost::make_shared<FixedScenarioGenerator>(scenarios);
+
+    // the plain sim market applies each scenario in full and serves as reference
+    vector<Real> times = {0.25, 0.5, 1.0, 1.5, 2.0, 5.0};
+    for (Size i = 0; i < scenarios.size(); ++i) {
+        simMarket->update(today);
+        simMarketPlus->update(today);
+        for (auto t : times) {
+            BOOST_CHECK_CLOSE(simMarketPlus->discountCurve("EUR")->discount(t),
+                              simMarket->discountCurve("EUR")->discount(t), 1.0E-10);
+        }
+    }
+
+    simMarket->reset();
+    simMarketPlus->reset();
+    for (auto t : times) {
+        BOOST_CHECK_CLOSE(simMarketPlus->discountCurve("EUR")->discount(t),
+                          simMarket->discountCurve("EUR")->discount(t), 1.0E-10);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -17,7 +17,9 @@
 */
 
 #include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
 #include <orea/engine/sensitivityaggregator.hpp>
+#include <orea/engine/sensitivityfilestream.hpp>
 #include <orea/engine/sensitivityinmemorystream.hpp>
 #include <oret/toplevelfixture.hpp>
 #include <ql/math/comparison.hpp>
@@ -28,8 +30,10 @@ using namespace std;
 
 using ore::analytics::RiskFactorKey;
 using ore::analytics::SensitivityAggregator;
+using ore::analytics::SensitivityBinaryFileStream;
 using ore::analytics::SensitivityInMemoryStream;
 using ore::analytics::SensitivityRecord;
+using ore::analytics::SensitivityRecordTable;
 using std::function;
 using std::map;
 using std::set;
@@ -240,6 +244,45 @@ BOOST_AUTO_TEST_CASE(testGeneralAggregationFunctionCategories) {
     check(expAggregationAll, res, "all_except_002");
 }
 
+BOOST_AUTO_TEST_CASE(testAggregationFromBinaryFile) {
+
+    BOOST_TEST_MESSAGE("Testing aggregation of sensitivities read from a binary file");
+
+    // Write all records to a binary file and read them back
+    SensitivityInMemoryStream ss(records.begin(), records.end());
+    string fileName = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string();
+    ore::analytics::writeSensitivityBinaryFile(fileName, ss, -1.0);
+    BOOST_CHECK(SensitivityRecordTable::isBinaryFile(fileName));
+
+    SensitivityBinaryFileStream bs(fileName);
+    BOOST_CHECK_EQUAL(bs.table().size(), records.size());
+    BOOST_CHECK_EQUAL(bs.table().tradeIds().size(), 6u);
+    auto it = records.begin();
+    while (SensitivityRecord sr = bs.next()) {
+        BOOST_REQUIRE(it != records.end());
+        BOOST_CHECK_EQUAL(sr, *it);
+        BOOST_CHECK_EQUAL(sr.desc_1, it->desc_1);
+        BOOST_CHECK_EQUAL(sr.desc_2, it->desc_2);
+        BOOST_CHECK_EQUAL(sr.shift_1, it->shift_1);
+        BOOST_CHECK_EQUAL(sr.currency, it->currency);
+        BOOST_CHECK_EQUAL(sr.baseNpv, it->baseNpv);
+        BOOST_CHECK_EQUAL(sr.delta, it->delta);
+        BOOST_CHECK_EQUAL(sr.gamma, it->gamma);
+        ++it;
+    }
+    BOOST_CHECK(it == records.end());
+
+    // Aggregate over all trades except trade_002
+    map<string, set<std::pair<std::string, QuantLib::Size>>> categories;
+    categories["all_except_002"] = {make_pair("trade_001", 0), make_pair("trade_003", 1), make_pair("trade_004", 2),
+                                    make_pair("trade_005", 3), make_pair("trade_006", 4)};
+    SensitivityAggregator sAgg(categories);
+    sAgg.aggregate(bs);
+    check(expAggregationAll, sAgg.sensitivities("all_except_002"), "all_except_002");
+
+    boost::filesystem::remove(fileName);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
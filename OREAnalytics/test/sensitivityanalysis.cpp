@@ -839,6 +839,11 @@ BOOST_AUTO_TEST_CASE(testPortfolioSensitivityUnregisterObs) {
     testPortfolioSensitivity(ObservationMode::Mode::Unregister);
 }
 
+BOOST_AUTO_TEST_CASE(testPortfolioSensitivityTargetedObs) {
+    BOOST_TEST_MESSAGE("Testing Portfolio sensitivity (Targeted observation mode)");
+    testPortfolioSensitivity(ObservationMode::Mode::Targeted);
+}
+
 void test1dShifts(bool granular) {
     BOOST_TEST_MESSAGE("Testing 1d shifts " << (granular ? "granular" : "sparse"));
 
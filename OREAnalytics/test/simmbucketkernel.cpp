@@ -0,0 +1,130 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <oret/toplevelfixture.hpp>
+#include <orea/simm/simmbucketkernel.hpp>
+
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+#include <ql/utilities/null.hpp>
+
+using namespace boost::unit_test_framework;
+using namespace QuantLib;
+using namespace ore::analytics;
+
+namespace {
+
+// straightforward evaluation of the bucket margin with pairwise loops, as in the SIMM docs
+Real referenceMargin(const std::vector<Real>& s, const std::vector<Real>& w, const std::vector<Real>& c,
+                     const std::vector<Size>& g, const std::vector<Real>& t, const Matrix& rho, Real& sumWs) {
+    Size n = s.size();
+    std::vector<Real> cr(t.size(), 0.0);
+    for (Size k = 0; k < n; ++k)
+        if (g[k] != Null<Size>())
+            cr[g[k]] += c[k] * s[k];
+    for (Size j = 0; j < t.size(); ++j)
+        cr[j] = std::max(1.0, std::sqrt(std::abs(cr[j]) / t[j]));
+    auto crk = [&](Size k) { return g[k] == Null<Size>() ? 1.0 : cr[g[k]]; };
+    std::vector<Real> ws(n);
+    sumWs = 0.0;
+    Real k2 = 0.0;
+    for (Size k = 0; k < n; ++k) {
+        ws[k] = w[k] * s[k] * crk(k);
+        sumWs += ws[k];
+        k2 += ws[k] * ws[k];
+        for (Size l = 0; l < k; ++l) {
+            Real f = g[k] == Null<Size>() || g[l] == Null<Size>()
+                         ? 1.0
+                         : std::min(crk(k), crk(l)) / std::max(crk(k), crk(l));
+            k2 += 2.0 * rho[k][l] * f * ws[k] * ws[l];
+        }
+    }
+    return std::sqrt(std::max(k2, 0.0));
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(SimmBucketKernelTest)
+
+BOOST_AUTO_TEST_CASE(testKernelAgainstPairwiseAggregation) {
+
+    BOOST_TEST_MESSAGE("Testing SIMM bucket kernel against pairwise aggregation...");
+
+    // 12 factors in 3 concentration groups and 2 factors without concentration risk
+    Size n = 14, nGroups = 3, nSets = 25;
+    MersenneTwisterUniformRng rng(42);
+
+    std::vector<Real> w(n), c(n), t(nGroups);
+    std::vector<Size> g(n);
+    Matrix rho(n, n, 0.0);
+    for (Size k = 0; k < n; ++k) {
+        w[k] = 10.0 + 100.0 * rng.nextReal();
+        c[k] = k < 12 ? 0.5 + rng.nextReal() : 0.0;
+        g[k] = k < 12 ? k % nGroups : Null<Size>();
+        for (Size l = 0; l < k; ++l)
+            rho[k][l] = rho[l][k] = 0.98 * rng.nextReal() - 0.2;
+    }
+    for (Size j = 0; j < nGroups; ++j)
+        t[j] = 1.0E4 * (1.0 + rng.nextReal());
+
+    SimmBucketKernel kernel(w, c, g, t, rho);
+    BOOST_CHECK_EQUAL(kernel.size(), n);
+    BOOST_CHECK_EQUAL(kernel.groups(), nGroups);
+
+    Matrix amounts(nSets, n);
+    for (Size i = 0; i < nSets; ++i)
+        for (Size k = 0; k < n; ++k)
+            amounts[i][k] = 1.0E6 * (rng.nextReal() - 0.5);
+
+    Array margins, sumWs;
+    Matrix cr;
+    kernel.margins(amounts, margins, sumWs, &cr);
+    BOOST_REQUIRE_EQUAL(margins.size(), nSets);
+    BOOST_REQUIRE_EQUAL(cr.rows(), nSets);
+    BOOST_REQUIRE_EQUAL(cr.columns(), nGroups);
+
+    for (Size i = 0; i < nSets; ++i) {
+        std::vector<Real> s(amounts.row_begin(i), amounts.row_end(i));
+        Real refSumWs;
+        Real ref = referenceMargin(s, w, c, g, t, rho, refSumWs);
+        BOOST_CHECK_CLOSE(margins[i], ref, 1.0E-10);
+        BOOST_CHECK_CLOSE(sumWs[i], refSumWs, 1.0E-10);
+        Real singleSumWs;
+        Real single = kernel.margin(&s[0], singleSumWs);
+        BOOST_CHECK_EQUAL(single, margins[i]);
+        BOOST_CHECK_EQUAL(singleSumWs, sumWs[i]);
+        for (Size j = 0; j < nGroups; ++j)
+            BOOST_CHECK(cr[i][j] >= 1.0);
+    }
+
+    // a single group takes the dense path
+    std::vector<Size> g1(n, 0);
+    SimmBucketKernel kernel1(w, c, g1, {t[0]}, rho);
+    for (Size i = 0; i < nSets; ++i) {
+        std::vector<Real> s(amounts.row_begin(i), amounts.row_end(i));
+        Real refSumWs, sumWs1;
+        Real ref = referenceMargin(s, w, c, g1, {t[0]}, rho, refSumWs);
+        BOOST_CHECK_CLOSE(kernel1.margin(&s[0], sumWs1), ref, 1.0E-10);
+        BOOST_CHECK_CLOSE(sumWs1, refSumWs, 1.0E-10);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
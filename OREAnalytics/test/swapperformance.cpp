@@ -20,6 +20,7 @@
 #include <boost/timer/timer.hpp>
 #include <orea/cube/inmemorycube.hpp>
 #include <orea/cube/npvcube.hpp>
+#include <orea/engine/cashflowtablecalculator.hpp>
 #include <orea/engine/filteredsensitivitystream.hpp>
 #include <orea/engine/observationmode.hpp>
 #include <orea/engine/parametricvar.hpp>
@@ -242,7 +243,7 @@ boost::shared_ptr<Portfolio> buildPortfolio(Size portfolioSize, boost::shared_pt
 }
 
 void test_performance(Size portfolioSize, ObservationMode::Mode om, double nonZeroPVRatio, vector<Real>& epe_archived,
-                      vector<Real>& ene_archived) {
+                      vector<Real>& ene_archived, bool cashflowTable = false) {
     BOOST_TEST_MESSAGE("Testing Swap Exposure Performance size=" << portfolioSize << "...");
 
     SavedSettings backup;
@@ -419,7 +420,13 @@ void test_performance(Size portfolioSize, ObservationMode::Mode om, double nonZe
     boost::shared_ptr<NPVCube> cube =
         boost::make_shared<DoublePrecisionInMemoryCube>(today, portfolio->ids(), dg->dates(), samples);
     vector<boost::shared_ptr<ValuationCalculator>> calculators;
-    calculators.push_back(boost::make_shared<NPVCalculator>(baseCcy));
+    boost::shared_ptr<CashflowTableNPVCalculator> tableCalculator;
+    if (cashflowTable) {
+        tableCalculator = boost::make_shared<CashflowTableNPVCalculator>(baseCcy);
+        calculators.push_back(tableCalculator);
+    } else {
+        calculators.push_back(boost::make_shared<NPVCalculator>(baseCcy));
+    }
     valEngine.buildCube(portfolio, cube, calculators);
     t.stop();
     double elapsed = t.elapsed().wall * 1e-9;
@@ -470,6 +477,12 @@ void test_performance(Size portfolioSize, ObservationMode::Mode om, double nonZe
     ObservationMode::instance().setMode(backupOm);
     IndexManager::instance().clearHistories();
 
+    // all swaps should have been priced from their cashflow tables
+    if (tableCalculator) {
+        for (Size i = 0; i < portfolioSize; ++i)
+            BOOST_CHECK_MESSAGE(tableCalculator->usesTable(i), "trade " << i << " not priced from cashflow table");
+    }
+
     // check results
     BOOST_CHECK_CLOSE(nonZeroPVRatio, nonZeroPerc, 0.005);
 
@@ -561,6 +574,11 @@ BOOST_AUTO_TEST_CASE(testSingleSwapPerformanceUnregisterObs) {
     test_performance(1, ObservationMode::Mode::None, 98.75, single_swap_epe_archived, single_swap_ene_archived);
 }
 
+BOOST_AUTO_TEST_CASE(testSwapPerformanceCashflowTable) {
+    BOOST_TEST_MESSAGE("Testing Swap Performance (cashflow table pricing)");
+    test_performance(100, ObservationMode::Mode::None, 70.5875, swap_epe_archived, swap_ene_archived, true);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
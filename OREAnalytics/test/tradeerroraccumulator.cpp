@@ -0,0 +1,131 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <orea/engine/tradeerroraccumulator.hpp>
+#include <ored/utilities/log.hpp>
+#include <oret/toplevelfixture.hpp>
+
+#include <ql/time/date.hpp>
+
+using namespace ore::analytics;
+using namespace ore::data;
+using QuantLib::Date;
+
+namespace {
+
+// captures the alerts logged while alive, restores the previous log state on destruction
+class LogCapture {
+public:
+    LogCapture() : enabled_(Log::instance().enabled()), mask_(Log::instance().mask()) {
+        logger_ = boost::make_shared<BufferLogger>(ORE_ALERT);
+        Log::instance().registerLogger(logger_);
+        Log::instance().setMask(ORE_ALERT);
+        Log::instance().switchOn();
+    }
+    ~LogCapture() {
+        Log::instance().removeLogger(BufferLogger::name);
+        Log::instance().setMask(mask_);
+        if (!enabled_)
+            Log::instance().switchOff();
+    }
+    std::vector<std::string> messages() {
+        std::vector<std::string> result;
+        while (logger_->hasNext())
+            result.push_back(logger_->next());
+        return result;
+    }
+
+private:
+    bool enabled_;
+    unsigned mask_;
+    boost::shared_ptr<BufferLogger> logger_;
+};
+
+bool contains(const std::string& s, const std::string& t) { return s.find(t) != std::string::npos; }
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(TradeErrorAccumulatorTest)
+
+BOOST_AUTO_TEST_CASE(testAddByPhase) {
+
+    BOOST_TEST_MESSAGE("Testing trade error accumulator keys errors by trade and phase...");
+
+    using Phase = TradeErrorAccumulator::Phase;
+
+    TradeErrorAccumulator acc;
+    BOOST_CHECK(acc.empty());
+
+    Date d1(15, QuantLib::March, 2024), d2(15, QuantLib::June, 2024);
+    acc.add(Phase::T0, 0, "T1", "Swap", "t0 failure");
+    acc.add(Phase::Valuation, 0, "T1", "Swap", "scenario failure", d1, 3, "base");
+    acc.add(Phase::Valuation, 0, "T1", "Swap", "second scenario failure", d2, 4, "base");
+    acc.add(Phase::CloseOut, 1, "T2", "FxOption", "close-out failure", d2, 7, "");
+
+    BOOST_CHECK_EQUAL(acc.size(), 3);
+    BOOST_CHECK_EQUAL(acc.size(Phase::T0), 1);
+    BOOST_CHECK_EQUAL(acc.size(Phase::Valuation), 1);
+    BOOST_CHECK_EQUAL(acc.size(Phase::CloseOut), 1);
+
+    // the first error per trade and phase is kept
+    auto const& e = acc.entries().at(std::make_pair(QuantLib::Size(0), Phase::Valuation));
+    BOOST_CHECK_EQUAL(e.tradeId, "T1");
+    BOOST_CHECK_EQUAL(e.what, "scenario failure");
+    BOOST_CHECK_EQUAL(e.date, d1);
+    BOOST_CHECK_EQUAL(e.sample, 3);
+    BOOST_CHECK_EQUAL(e.label, "base");
+    BOOST_CHECK_EQUAL(acc.entries().at(std::make_pair(QuantLib::Size(0), Phase::T0)).what, "t0 failure");
+
+    acc.clear();
+    BOOST_CHECK(acc.empty());
+    BOOST_CHECK_EQUAL(acc.size(Phase::T0), 0);
+}
+
+BOOST_AUTO_TEST_CASE(testLog) {
+
+    BOOST_TEST_MESSAGE("Testing trade error accumulator log output...");
+
+    using Phase = TradeErrorAccumulator::Phase;
+
+    LogCapture capture;
+
+    // nothing is logged for an empty accumulator
+    TradeErrorAccumulator acc;
+    acc.log("TestEngine");
+    BOOST_CHECK(capture.messages().empty());
+
+    acc.add(Phase::T0, 0, "T1", "Swap", "t0 failure");
+    acc.add(Phase::Valuation, 1, "T2", "Swap", "scenario failure", Date(15, QuantLib::March, 2024), 3, "base");
+    acc.log("TestEngine");
+
+    auto messages = capture.messages();
+    BOOST_REQUIRE_EQUAL(messages.size(), 3);
+    BOOST_CHECK(contains(messages[0], "TestEngine: 2 trade errors during simulation (1 T0, 1 Valuation, 0 CloseOut)"));
+    BOOST_CHECK(contains(messages[1], "T1"));
+    BOOST_CHECK(contains(messages[1], "ScenarioValuation"));
+    BOOST_CHECK(contains(messages[1], "T0 valuation error: t0 failure"));
+    BOOST_CHECK(contains(messages[2], "T2"));
+    BOOST_CHECK(contains(messages[2], "date = 2024-03-15, sample = 3, label = base: scenario failure"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -2469,21 +2469,30 @@ XMLNode* Conventions::toXML(XMLDocument& doc) {
 
     XMLNode* conventionsNode = doc.allocNode("Conventions");
 
-    map<string, boost::shared_ptr<Convention>>::const_iterator it;
-    for (it = data_.begin(); it != data_.end(); ++it) {
-        if (used_.find(it->first) != used_.end())
-            XMLUtils::appendNode(conventionsNode, it->second->toXML(doc));
-    }
+    // write in id order
+    std::set<string> ids;
+    for (auto const& d : data_) {
+        if (d.second.used)
+            ids.insert(d.first);
+    }
+    for (auto const& id : ids)
+        XMLUtils::appendNode(conventionsNode, data_.at(id).convention->toXML(doc));
     return conventionsNode;
 }
 
 void Conventions::clear() const {
     boost::unique_lock<boost::shared_mutex> lock(mutex_);
     data_.clear();
+    typeIndex_.clear();
+    fxIndex_.clear();
 }
 
 namespace {
 std::string flip(const std::string& id, const std::string& sep = "-") {
+    // cheap check first, only ids with an XCCY, FX or FXOPTION token are flipped
+    if (id.find("FX") == std::string::npos && id.find("XCCY") == std::string::npos)
+        return id;
+
     boost::tokenizer<boost::escaped_list_separator<char>> tokenSplit(
         id, boost::escaped_list_separator<char>("\\", sep, "\""));
     std::vector<std::string> tokens(tokenSplit.begin(), tokenSplit.end());
@@ -2504,121 +2513,127 @@ std::string flip(const std::string& id, const std::string& sep = "-") {
 }
 }
 
-boost::shared_ptr<Convention> Conventions::get(const string& id) const {
+const Conventions::Entry* Conventions::find(const string& id) const {
+    if (auto it = data_.find(id); it != data_.end())
+        return &it->second;
+    if (string flipped = flip(id); flipped != id) {
+        if (auto it = data_.find(flipped); it != data_.end())
+            return &it->second;
+    }
+    return nullptr;
+}
+
+boost::shared_ptr<Convention> Conventions::get(const string& id) const { return retrieve(id, true); }
+
+boost::shared_ptr<Convention> Conventions::retrieve(const string& id, bool throwOnError) const {
 
     {
         boost::shared_lock<boost::shared_mutex> lock(mutex_);
-        if (auto it = data_.find(id); it != data_.end()) {
-            used_.insert(id);
-            return it->second;
-        }
-        if (auto it = data_.find(flip(id)); it != data_.end()) {
-            used_.insert(flip(id));
-            return it->second;
+        if (const Entry* e = find(id)) {
+            e->used.store(true, std::memory_order_relaxed);
+            return e->convention;
         }
     }
 
     std::string type, unparsed;
     {
         boost::unique_lock<boost::shared_mutex> lock(mutex_);
+        // the convention might have been built by another thread in the meantime
+        if (const Entry* e = find(id)) {
+            e->used.store(true, std::memory_order_relaxed);
+            return e->convention;
+        }
         if (auto it = unparsed_.find(id); it != unparsed_.end()) {
             std::tie(type, unparsed) = it->second;
-            unparsed_.erase(id);
+            unparsed_.erase(it);
         } else if (auto it = unparsed_.find(flip(id)); it != unparsed_.end()) {
             std::tie(type, unparsed) = it->second;
-            unparsed_.erase(flip(id));
+            unparsed_.erase(it);
         }
     }
 
     if (unparsed.empty()) {
+        if (!throwOnError)
+            return nullptr;
         QL_FAIL("Convention '" << id << "' not found.");
     }
 
-    boost::shared_ptr<Convention> convention;
-    if (type == "Zero") {
-        convention = boost::make_shared<ZeroRateConvention>();
-    } else if (type == "Deposit") {
-        convention = boost::make_shared<DepositConvention>();
-    } else if (type == "Future") {
-        convention = boost::make_shared<FutureConvention>();
-    } else if (type == "FRA") {
-        convention = boost::make_shared<FraConvention>();
-    } else if (type == "OIS") {
-        convention = boost::make_shared<OisConvention>();
-    } else if (type == "Swap") {
-        convention = boost::make_shared<IRSwapConvention>();
-    } else if (type == "AverageOIS") {
-        convention = boost::make_shared<AverageOisConvention>();
-    } else if (type == "TenorBasisSwap") {
-        convention = boost::make_shared<TenorBasisSwapConvention>();
-    } else if (type == "TenorBasisTwoSwap") {
-        convention=boost::make_shared<TenorBasisTwoSwapConvention>();
-    } else if (type == "BMABasisSwap") {
-        convention = boost::make_shared<BMABasisSwapConvention>();
-    } else if (type == "CrossCurrencyBasis") {
-        convention=boost::make_shared<CrossCcyBasisSwapConvention>();
-    } else if (type == "CrossCurrencyFixFloat") {
-        convention=boost::make_shared<CrossCcyFixFloatSwapConvention>();
-    } else if (type == "CDS") {
-        convention=boost::make_shared<CdsConvention>();
-    } else if (type == "SwapIndex") {
-        convention=boost::make_shared<SwapIndexConvention>();
-    } else if (type == "InflationSwap") {
-        convention=boost::make_shared<InflationSwapConvention>();
-    } else if (type == "CmsSpreadOption") {
-        convention=boost::make_shared<CmsSpreadOptionConvention>();
-    } else if (type == "CommodityForward") {
-        convention = boost::make_shared<CommodityForwardConvention>();
-    } else if (type == "CommodityFuture") {
-        convention = boost::make_shared<CommodityFutureConvention>();
-    } else if (type == "FxOption") {
-        convention = boost::make_shared<FxOptionConvention>();
-    } else if (type == "ZeroInflationIndex") {
-        convention = boost::make_shared<ZeroInflationIndexConvention>();
-    } else if (type == "BondYield") {
-        convention = boost::make_shared<BondYieldConvention>();
-    } else {
-        QL_FAIL("Convention '" << id << "' has unknown type '" + type + "' not recognized.");
-    }
-
     try {
+        boost::shared_ptr<Convention> convention;
+        if (type == "Zero") {
+            convention = boost::make_shared<ZeroRateConvention>();
+        } else if (type == "Deposit") {
+            convention = boost::make_shared<DepositConvention>();
+        } else if (type == "Future") {
+            convention = boost::make_shared<FutureConvention>();
+        } else if (type == "FRA") {
+            convention = boost::make_shared<FraConvention>();
+        } else if (type == "OIS") {
+            convention = boost::make_shared<OisConvention>();
+        } else if (type == "Swap") {
+            convention = boost::make_shared<IRSwapConvention>();
+        } else if (type == "AverageOIS") {
+            convention = boost::make_shared<AverageOisConvention>();
+        } else if (type == "TenorBasisSwap") {
+            convention = boost::make_shared<TenorBasisSwapConvention>();
+        } else if (type == "TenorBasisTwoSwap") {
+            convention=boost::make_shared<TenorBasisTwoSwapConvention>();
+        } else if (type == "BMABasisSwap") {
+            convention = boost::make_shared<BMABasisSwapConvention>();
+        } else if (type == "CrossCurrencyBasis") {
+            convention=boost::make_shared<CrossCcyBasisSwapConvention>();
+        } else if (type == "CrossCurrencyFixFloat") {
+            convention=boost::make_shared<CrossCcyFixFloatSwapConvention>();
+        } else if (type == "CDS") {
+            convention=boost::make_shared<CdsConvention>();
+        } else if (type == "SwapIndex") {
+            convention=boost::make_shared<SwapIndexConvention>();
+        } else if (type == "InflationSwap") {
+            convention=boost::make_shared<InflationSwapConvention>();
+        } else if (type == "CmsSpreadOption") {
+            convention=boost::make_shared<CmsSpreadOptionConvention>();
+        } else if (type == "CommodityForward") {
+            convention = boost::make_shared<CommodityForwardConvention>();
+        } else if (type == "CommodityFuture") {
+            convention = boost::make_shared<CommodityFutureConvention>();
+        } else if (type == "FxOption") {
+            convention = boost::make_shared<FxOptionConvention>();
+        } else if (type == "ZeroInflationIndex") {
+            convention = boost::make_shared<ZeroInflationIndexConvention>();
+        } else if (type == "BondYield") {
+            convention = boost::make_shared<BondYieldConvention>();
+        } else {
+            QL_FAIL("Convention '" << id << "' has unknown type '" + type + "' not recognized.");
+        }
+
         DLOG("Building Convention " << id);
         convention->fromXMLString(unparsed);
         add(convention);
-        used_.insert(id);
+        boost::shared_lock<boost::shared_mutex> lock(mutex_);
+        data_.at(convention->id()).used.store(true, std::memory_order_relaxed);
+        return convention;
     } catch (exception& e) {
         WLOG("Convention '" << id << "' could not be built: " << e.what());
+        if (!throwOnError)
+            return nullptr;
         QL_FAIL("Convention '" << id << "' could not be built: " << e.what());
     }
-
-    return convention;
 }
 
 boost::shared_ptr<Convention> Conventions::getFxConvention(const string& ccy1, const string& ccy2) const {
     boost::shared_lock<boost::shared_mutex> lock(mutex_);
-    for (auto c : data_) {
-        auto fxCon = boost::dynamic_pointer_cast<FXConvention>(c.second);
-        if (fxCon) {
-            string source = fxCon->sourceCurrency().code();
-            string target = fxCon->targetCurrency().code();
-            if ((source == ccy1 && target == ccy2) || (target == ccy1 && source == ccy2)) {
-                used_.insert(c.first);
-                return fxCon;
-            }
-        }
+    if (auto it = fxIndex_.find(ccy1 + ccy2); it != fxIndex_.end()) {
+        const Entry& e = data_.at(it->second);
+        e.used.store(true, std::memory_order_relaxed);
+        return e.convention;
     }
     QL_FAIL("FX convention for ccys '" << ccy1 << "' and '" << ccy2 << "' not found.");
 }
 
 pair<bool, boost::shared_ptr<Convention>> Conventions::get(const string& id, const Convention::Type& type) const {
-    try {
-        auto c = get(id);
-        if (c->type() == type) {
-            used_.insert(id);
-            return std::make_pair(true, c);
-        }
-    } catch (const std::exception& e) {
-    }
+    auto c = retrieve(id, false);
+    if (c && c->type() == type)
+        return std::make_pair(true, c);
     return make_pair(false, nullptr);
 }
 
@@ -2628,10 +2643,11 @@ std::set<boost::shared_ptr<Convention>> Conventions::get(const Convention::Type&
     std::string typeStr = ore::data::to_string(type);
     {
         boost::shared_lock<boost::shared_mutex> lock(mutex_);
-        for (auto const& d : data_) {
-            if (d.second->type() == type) {
-                used_.insert(d.first);
-                result.insert(d.second);
+        if (auto t = typeIndex_.find(type); t != typeIndex_.end()) {
+            for (auto const& id : t->second) {
+                const Entry& e = data_.at(id);
+                e.used.store(true, std::memory_order_relaxed);
+                result.insert(e.convention);
             }
         }
         for (auto const& u : unparsed_) {
@@ -2645,16 +2661,7 @@ std::set<boost::shared_ptr<Convention>> Conventions::get(const Convention::Type&
     return result;
 }
 
-bool Conventions::has(const string& id) const {
-    try {
-        get(id);
-    } catch (const std::exception& e) {
-        return false;
-    }
-    boost::shared_lock<boost::shared_mutex> lock(mutex_);
-    return data_.find(id) != data_.end() || unparsed_.find(id) != unparsed_.end() ||
-           data_.find(flip(id)) != data_.end() || unparsed_.find(flip(id)) != unparsed_.end();
-}
+bool Conventions::has(const string& id) const { return retrieve(id, false) != nullptr; }
 
 bool Conventions::has(const std::string& id, const Convention::Type& type) const {
     return get(id, type).first;
@@ -2664,7 +2671,18 @@ void Conventions::add(const boost::shared_ptr<Convention>& convention) const {
     boost::unique_lock<boost::shared_mutex> lock(mutex_);
     const string& id = convention->id();
     QL_REQUIRE(data_.find(id) == data_.end(), "Convention already exists for id " << id);
-    data_[id] = convention;
+    data_.emplace(std::piecewise_construct, std::forward_as_tuple(id), std::forward_as_tuple(convention));
+    typeIndex_[convention->type()].insert(id);
+    if (auto fx = boost::dynamic_pointer_cast<FXConvention>(convention)) {
+        // index both orders of the pair, if there are several conventions for a pair the smallest id wins
+        const string& source = fx->sourceCurrency().code();
+        const string& target = fx->targetCurrency().code();
+        for (auto const& key : {source + target, target + source}) {
+            auto f = fxIndex_.insert(make_pair(key, id));
+            if (!f.second && id < f.first->second)
+                f.first->second = id;
+        }
+    }
 }
 
 std::ostream& operator<<(std::ostream& out, Convention::Type type) {
@@ -39,6 +39,9 @@
 #include <boost/thread/shared_mutex.hpp>
 #include <boost/thread/lock_types.hpp>
 
+#include <atomic>
+#include <unordered_map>
+
 namespace ore {
 namespace data {
 using ore::data::XMLNode;
@@ -151,9 +154,24 @@ public:
     //@}
 
 private:
-    mutable map<string, boost::shared_ptr<Convention>> data_;
+    struct Entry {
+        explicit Entry(const boost::shared_ptr<Convention>& convention) : convention(convention) {}
+        boost::shared_ptr<Convention> convention;
+        // set on retrieval without taking the exclusive lock, only used conventions are written by toXML()
+        mutable std::atomic<bool> used{false};
+    };
+
+    /*! Returns the convention or, if \p throwOnError is false, a nullptr if it is not found or can not be built.
+        Unparsed conventions are built on first retrieval. */
+    boost::shared_ptr<Convention> retrieve(const string& id, bool throwOnError) const;
+    //! Returns the built convention with the given id or its flipped id, requires a lock held by the caller
+    const Entry* find(const string& id) const;
+
+    // built conventions, read-optimised indices by type and FX currency pair
+    mutable std::unordered_map<string, Entry> data_;
+    mutable map<Convention::Type, std::set<string>> typeIndex_;
+    mutable std::unordered_map<string, string> fxIndex_;
     mutable map<string, std::pair<string, string>> unparsed_;
-    mutable std::set<string> used_;
     mutable boost::shared_mutex mutex_;
 };
 
@@ -22,19 +22,86 @@
 */
 
 #include <algorithm>
-#include <boost/algorithm/string.hpp>
-#include <fstream>
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <cstring>
+#include <future>
 #include <map>
 #include <ored/marketdata/csvloader.hpp>
 #include <ored/marketdata/marketdatumparser.hpp>
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/parsers.hpp>
+#include <thread>
 
 using namespace std;
 
 namespace ore {
 namespace data {
 
+namespace {
+
+// a tokenised line of a market, fixing or dividend file
+struct CsvRecord {
+    Date date;
+    string key;
+    Real value;
+    Date payDate;
+};
+
+// chunks smaller than this are not worth a separate task
+const Size minChunkSize = 1 << 20;
+
+bool isSeparator(const char c) { return c == ',' || c == ';' || c == '\t' || c == ' '; }
+bool isSpace(const char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f'; }
+
+// tokenise the lines in [begin, end), the lines are split on any of ",;\t " with adjacent separators compressed
+vector<CsvRecord> tokenise(const char* begin, const char* end, const bool dividends) {
+    vector<CsvRecord> records;
+    vector<string> tokens;
+    const char* p = begin;
+    while (p < end) {
+        const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (eol == nullptr)
+            eol = end;
+        // trim the line
+        const char* b = p;
+        const char* e = eol;
+        while (b < e && isSpace(*b))
+            ++b;
+        while (e > b && isSpace(*(e - 1)))
+            --e;
+        p = eol + 1;
+        // skip blank and comment lines
+        if (b == e || *b == '#')
+            continue;
+        tokens.clear();
+        const char* t = b;
+        for (const char* c = b; c <= e; ++c) {
+            if (c == e || isSeparator(*c)) {
+                tokens.push_back(string(t, c));
+                while (c + 1 < e && isSeparator(*(c + 1)))
+                    ++c;
+                t = c + 1;
+            }
+        }
+        // TODO: should we try, catch and log any invalid lines?
+        QL_REQUIRE(tokens.size() == 3 || tokens.size() == 4,
+                   "Invalid CSVLoader line, 3 tokens expected " << string(b, e));
+        if (tokens.size() == 4)
+            QL_REQUIRE(dividends, "CSVLoader, dataType must be of type Dividend");
+        CsvRecord r;
+        r.date = parseDate(tokens[0]);
+        r.key = tokens[1];
+        r.value = parseReal(tokens[2]);
+        r.payDate = tokens.size() == 4 ? parseDate(tokens[3]) : r.date;
+        records.push_back(std::move(r));
+    }
+    return records;
+}
+
+} // namespace
+
 CSVLoader::CSVLoader(const string& marketFilename, const string& fixingFilename, bool implyTodaysFixings)
     : CSVLoader(marketFilename, fixingFilename, "", implyTodaysFixings) {}
 
@@ -95,65 +162,59 @@ void CSVLoader::loadFile(const string& filename, DataType dataType) {
 
     Date today = QuantLib::Settings::instance().evaluationDate();
 
-    ifstream file;
-    file.open(filename.c_str());
-    QL_REQUIRE(file.is_open(), "error opening file " << filename);
-
-    while (!file.eof()) {
-        string line;
-        getline(file, line);
-        boost::trim(line);
-        // skip blank and comment lines
-        if (line.size() > 0 && line[0] != '#') {
+    QL_REQUIRE(boost::filesystem::is_regular_file(filename), "error opening file " << filename);
+    Size fileSize = boost::filesystem::file_size(filename);
+    if (fileSize == 0) {
+        LOG("CSVLoader completed processing " << filename << " (empty file)");
+        return;
+    }
 
-            vector<string> tokens;
-            boost::trim(line);
-            boost::split(tokens, line, boost::is_any_of(",;\t "), boost::token_compress_on);
+    boost::interprocess::file_mapping mapping(filename.c_str(), boost::interprocess::read_only);
+    boost::interprocess::mapped_region region(mapping, boost::interprocess::read_only);
+    const char* begin = static_cast<const char*>(region.get_address());
+    const char* end = begin + region.get_size();
+
+    // split the file into chunks at line boundaries and tokenise the chunks in parallel
+
+    Size nChunks = std::max<Size>(1, std::min<Size>(std::thread::hardware_concurrency(), fileSize / minChunkSize));
+    vector<std::future<vector<CsvRecord>>> chunks;
+    const char* chunkBegin = begin;
+    for (Size i = 0; i < nChunks && chunkBegin < end; ++i) {
+        const char* chunkEnd = i == nChunks - 1 ? end : std::min(end, begin + (i + 1) * (fileSize / nChunks));
+        if (chunkEnd < end) {
+            chunkEnd = static_cast<const char*>(memchr(chunkEnd, '\n', end - chunkEnd));
+            chunkEnd = chunkEnd == nullptr ? end : chunkEnd + 1;
+        }
+        chunks.push_back(std::async(nChunks == 1 ? std::launch::deferred : std::launch::async, &tokenise,
+                                    chunkBegin, chunkEnd, dataType == DataType::Dividend));
+        chunkBegin = chunkEnd;
+    }
 
-            // TODO: should we try, catch and log any invalid lines?
-            QL_REQUIRE(tokens.size() == 3 || tokens.size() == 4, "Invalid CSVLoader line, 3 tokens expected " << line);
-            if (tokens.size() == 4)
-                QL_REQUIRE(dataType == DataType::Dividend, "CSVLoader, dataType must be of type Dividend");
-            Date date = parseDate(tokens[0]);
-            const string& key = tokens[1];
-            Real value = parseReal(tokens[2]);
+    // process the records in file order, so that the first of several identical entries wins
 
+    for (auto& chunk : chunks) {
+        for (auto& r : chunk.get()) {
             if (dataType == DataType::Market) {
-                // process market
-                // build market datum and add to map
-                try {
-                    boost::shared_ptr<MarketDatum> md;
-                    try {
-                        md = parseMarketDatum(date, key, value);
-                    } catch (std::exception& e) {
-                        WLOG("Failed to parse MarketDatum " << key << ": " << e.what());
-                    }
-                    if (md != nullptr) {
-                        if (data_[date].insert(md).second) {
-                            TLOG("Added MarketDatum " << key);
-                        } else {
-                            WLOG("Skipped MarketDatum " << key << " - this is already present.");
-                        }
-                    }
-                } catch (std::exception& e) {
-                    WLOG("Failed to parse MarketDatum " << key << ": " << e.what());
+                // process market, the market datum is only built when requested
+                // keep duplicates, the first one that can be parsed is used
+                auto& q = data_[r.date][r.key];
+                q.values.push_back(r.value);
+                if (q.values.size() == 1) {
+                    TLOG("Added MarketDatum " << r.key);
                 }
             } else if (dataType == DataType::Fixing) {
                 // process fixings
-                if (date < today || (date == today && !implyTodaysFixings_)) {
-                    if(!fixings_.insert(Fixing(date, key, value)).second) {
-                        WLOG("Skipped Fixing " << key << "@" << QuantLib::io::iso_date(date)
+                if (r.date < today || (r.date == today && !implyTodaysFixings_)) {
+                    if (!fixings_.insert(Fixing(r.date, r.key, r.value)).second) {
+                        WLOG("Skipped Fixing " << r.key << "@" << QuantLib::io::iso_date(r.date)
                                                << " - this is already present.");
                     }
                 }
             } else if (dataType == DataType::Dividend) {
-                Date payDate = date;
-                if (tokens.size() == 4)
-                    payDate = parseDate(tokens[3]);
                 // process dividends
-                if (date <= today) {
-                    if (!dividends_.insert(QuantExt::Dividend(date, key, value, payDate)).second) {
-                        WLOG("Skipped Dividend " << key << "@" << QuantLib::io::iso_date(date)
+                if (r.date <= today) {
+                    if (!dividends_.insert(QuantExt::Dividend(r.date, r.key, r.value, r.payDate)).second) {
+                        WLOG("Skipped Dividend " << r.key << "@" << QuantLib::io::iso_date(r.date)
                                                  << " - this is already present.");
                     }
                 }
@@ -162,29 +223,60 @@ void CSVLoader::loadFile(const string& filename, DataType dataType) {
             }
         }
     }
-    file.close();
     LOG("CSVLoader completed processing " << filename);
 }
 
+boost::shared_ptr<MarketDatum> CSVLoader::datum(const Date& d, const string& name, const RawQuote& q) const {
+    boost::lock_guard<boost::mutex> lock(mutex_);
+    if (!q.parsed) {
+        for (auto const v : q.values) {
+            if (q.datum != nullptr) {
+                WLOG("Skipped MarketDatum " << name << " - this is already present.");
+                continue;
+            }
+            try {
+                q.datum = parseMarketDatum(d, name, v);
+            } catch (std::exception& e) {
+                WLOG("Failed to parse MarketDatum " << name << ": " << e.what());
+            }
+        }
+        q.parsed = true;
+    }
+    return q.datum;
+}
+
 vector<boost::shared_ptr<MarketDatum>> CSVLoader::loadQuotes(const QuantLib::Date& d) const {
     auto it = data_.find(d);
     if (it == data_.end())
         return {};
-    return std::vector<boost::shared_ptr<MarketDatum>>(it->second.begin(), it->second.end());
+    std::vector<boost::shared_ptr<MarketDatum>> result;
+    for (auto const& [name, q] : it->second) {
+        if (auto md = datum(d, name, q))
+            result.push_back(md);
+    }
+    return result;
 }
 
-boost::shared_ptr<MarketDatum> makeDummyMarketDatum(const Date& d, const std::string& name) {
-    return boost::make_shared<MarketDatum>(0.0, d, name, MarketDatum::QuoteType::NONE,
-                                           MarketDatum::InstrumentType::NONE);
+bool CSVLoader::hasQuotes(const QuantLib::Date& d) const {
+    auto it = data_.find(d);
+    if (it == data_.end())
+        return false;
+    // a date only has quotes if one of them can be parsed, usually the first one can
+    for (auto const& [name, q] : it->second) {
+        if (datum(d, name, q) != nullptr)
+            return true;
+    }
+    return false;
 }
 
-
 boost::shared_ptr<MarketDatum> CSVLoader::get(const string& name, const QuantLib::Date& d) const {
     auto it = data_.find(d);
     QL_REQUIRE(it != data_.end(), "No datum for " << name << " on date " << d);
-    auto it2 = it->second.find(makeDummyMarketDatum(d, name));
+    auto it2 = it->second.find(name);
     QL_REQUIRE(it2 != it->second.end(), "No datum for " << name << " on date " << d);
-    return *it2;
+    auto md = datum(d, name, it2->second);
+    QL_REQUIRE(md != nullptr, "No datum for " << name << " on date " << d);
+    return md;
 }
 
 std::set<boost::shared_ptr<MarketDatum>> CSVLoader::get(const std::set<std::string>& names,
@@ -194,9 +286,11 @@ std::set<boost::shared_ptr<MarketDatum>> CSVLoader::get(const std::set<std::stri
         return {};
     std::set<boost::shared_ptr<MarketDatum>> result;
     for (auto const& n : names) {
-        auto it2 = it->second.find(makeDummyMarketDatum(asof, n));
-        if (it2 != it->second.end())
-            result.insert(*it2);
+        auto it2 = it->second.find(n);
+        if (it2 != it->second.end()) {
+            if (auto md = datum(asof, n, it2->second))
+                result.insert(md);
+        }
     }
     return result;
 }
@@ -215,7 +309,7 @@ std::set<boost::shared_ptr<MarketDatum>> CSVLoader::get(const Wildcard& wildcard
     if (it == data_.end())
         return {};
     std::set<boost::shared_ptr<MarketDatum>> result;
-    std::set<boost::shared_ptr<MarketDatum>>::iterator it1, it2;
+    RawQuotes::const_iterator it1, it2;
     if (wildcard.wildcardPos() == 0) {
         // wildcard at first position => we have to search all of the data
         it1 = it->second.begin();
@@ -223,12 +317,14 @@ std::set<boost::shared_ptr<MarketDatum>> CSVLoader::get(const Wildcard& wildcard
     } else {
         // search the range matching the substring of the pattern until the wildcard
         std::string prefix = wildcard.pattern().substr(0, wildcard.wildcardPos());
-        it1 = it->second.lower_bound(makeDummyMarketDatum(asof, prefix));
-        it2 = it->second.upper_bound(makeDummyMarketDatum(asof, prefix + "\xFF"));
+        it1 = it->second.lower_bound(prefix);
+        it2 = it->second.upper_bound(prefix + "\xFF");
     }
     for (auto it = it1; it != it2; ++it) {
-        if (wildcard.isPrefix() || wildcard.matches((*it)->name()))
-            result.insert(*it);
+        if (wildcard.isPrefix() || wildcard.matches(it->first)) {
+            if (auto md = datum(asof, it->first, it->second))
+                result.insert(md);
+        }
     }
     return result;
 }
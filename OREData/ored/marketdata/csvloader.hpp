@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include <boost/thread/mutex.hpp>
 #include <map>
 #include <ored/marketdata/loader.hpp>
 
@@ -34,6 +35,11 @@ namespace data {
   Data is loaded with the call to the constructor.
   Inspectors can be called to then retrieve quotes and fixings.
 
+  The files are memory mapped and tokenised in parallel chunks. Market quotes are stored as raw (date, name, value)
+  entries, the MarketDatum objects are only built when a quote is requested, i.e. quotes that fail to parse are only
+  reported (and then ignored) when they are requested. Quotes that fail to parse are ignored as before, i.e. a later
+  valid entry with the same name is used and a date only has quotes if at least one of them can be parsed.
+
   TODO implementation has large overlap with inmemoryloader.?pp, factor this out
 
   \ingroup marketdata
@@ -87,14 +93,28 @@ public:
     std::set<Fixing> loadFixings() const override { return fixings_; }
     //! Load dividends
     std::set<QuantExt::Dividend> loadDividends() const override { return dividends_; }
+    //! check if there are quotes for a date
+    bool hasQuotes(const QuantLib::Date& d) const override;
     //@}
 
 private:
     enum class DataType { Market, Fixing, Dividend };
     void loadFile(const string&, DataType);
 
+    /*! raw market quote, the market datum is built on first access. All values given for a name are kept in file
+        order, the first one that can be parsed wins, as if the quotes were parsed when loading the file. */
+    struct RawQuote {
+        std::vector<QuantLib::Real> values;
+        mutable bool parsed = false;
+        mutable boost::shared_ptr<MarketDatum> datum;
+    };
+    typedef std::map<std::string, RawQuote> RawQuotes;
+    //! returns the market datum for a raw quote, null if none of the quote's values can be parsed
+    boost::shared_ptr<MarketDatum> datum(const QuantLib::Date& d, const std::string& name, const RawQuote& q) const;
+
     bool implyTodaysFixings_;
-    std::map<QuantLib::Date, std::set<boost::shared_ptr<MarketDatum>, SharedPtrMarketDatumComparator>> data_;
+    std::map<QuantLib::Date, RawQuotes> data_;
+    mutable boost::mutex mutex_;
     std::set<Fixing> fixings_;
     std::set<QuantExt::Dividend> dividends_;
 };
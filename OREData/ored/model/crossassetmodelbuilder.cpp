@@ -52,15 +52,25 @@
 #include <qle/pricingengines/analyticlgmswaptionengine.hpp>
 #include <qle/pricingengines/analyticxassetlgmeqoptionengine.hpp>
 
+#include <ql/cashflows/iborcoupon.hpp>
+#include <ql/indexes/indexmanager.hpp>
 #include <ql/math/optimization/levenbergmarquardt.hpp>
 #include <ql/models/shortrate/calibrationhelpers/swaptionhelper.hpp>
 #include <ql/pricingengines/swap/discountingswapengine.hpp>
 #include <ql/quotes/simplequote.hpp>
+#include <ql/settings.hpp>
 #include <ql/utilities/dataformatters.hpp>
 
 #include <boost/algorithm/string/case_conv.hpp>
 #include <boost/lexical_cast.hpp>
 
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <future>
+#include <map>
+#include <type_traits>
+
 using QuantExt::AnalyticJyCpiCapFloorEngine;
 using QuantExt::AnalyticJyYoYCapFloorEngine;
 using QuantExt::CpiCapFloorHelper;
@@ -75,13 +85,148 @@ using std::vector;
 namespace ore {
 namespace data {
 
+namespace {
+
+// the raw values of all parameters of a parametrization
+std::vector<Array> rawParameterValues(const boost::shared_ptr<QuantExt::Parametrization>& p) {
+    std::vector<Array> values;
+    for (Size k = 0; k < p->numberOfParameters(); ++k)
+        values.push_back(p->parameter(k)->params());
+    return values;
+}
+
+// set the raw values of all parameters of a parametrization
+void resetParameters(const boost::shared_ptr<QuantExt::Parametrization>& p, const std::vector<Array>& values) {
+    for (Size k = 0; k < p->numberOfParameters(); ++k)
+        for (Size j = 0; j < values[k].size(); ++j)
+            p->parameter(k)->setParam(j, values[k][j]);
+    p->update();
+}
+
+/* The session singletons the calibrations depend on. With QL_ENABLE_SESSIONS each thread has its own instances, the
+   calibration threads copy the values of the calling thread, so that e.g. today's fixings are not forecasted. */
+struct CalibrationSession {
+    CalibrationSession()
+        : evaluationDate(Settings::instance().evaluationDate()),
+          includeReferenceDateEvents(Settings::instance().includeReferenceDateEvents()),
+          includeTodaysCashFlows(Settings::instance().includeTodaysCashFlows()),
+          enforcesTodaysHistoricFixings(Settings::instance().enforcesTodaysHistoricFixings()),
+          usingAtParCoupons(QuantLib::IborCoupon::Settings::instance().usingAtParCoupons()) {
+        for (auto const& name : QuantLib::IndexManager::instance().histories())
+            fixings[name] = QuantLib::IndexManager::instance().getHistory(name);
+    }
+
+    void apply() const {
+        Settings::instance().evaluationDate() = evaluationDate;
+        Settings::instance().includeReferenceDateEvents() = includeReferenceDateEvents;
+        Settings::instance().includeTodaysCashFlows() = includeTodaysCashFlows;
+        Settings::instance().enforcesTodaysHistoricFixings() = enforcesTodaysHistoricFixings;
+        if (usingAtParCoupons)
+            QuantLib::IborCoupon::Settings::instance().createAtParCoupons();
+        else
+            QuantLib::IborCoupon::Settings::instance().createIndexedCoupons();
+        for (auto const& [name, history] : fixings)
+            QuantLib::IndexManager::instance().setHistory(name, history);
+    }
+
+    Date evaluationDate;
+    bool includeReferenceDateEvents;
+    std::decay_t<decltype(Settings::instance().includeTodaysCashFlows())> includeTodaysCashFlows;
+    bool enforcesTodaysHistoricFixings;
+    bool usingAtParCoupons;
+    std::map<std::string, QuantLib::TimeSeries<Real>> fixings;
+};
+
+void calculateCurve(const Handle<YieldTermStructure>& curve) {
+    if (curve.empty())
+        return;
+    curve->referenceDate();
+    curve->discount(1.0, true);
+}
+
+/* The IR and COM calibrations share the market's term structures (see LgmBuilder, HwBuilder and
+   CommoditySchwartzModelBuilder). These are lazy objects, which are calculated on first use, possibly from other term
+   structures (e.g. xccy discount curves), so they are calculated on the calling thread before the calibration threads
+   start, the threads then only read them. */
+void calculateCalibrationMarket(const boost::shared_ptr<Market>& market, const CrossAssetModelData& config,
+                                const std::string& irConfiguration, const std::string& comConfiguration) {
+    for (auto const& ir : config.irConfigs()) {
+        calculateCurve(market->discountCurve(ir->ccy(), irConfiguration));
+        auto lgm = boost::dynamic_pointer_cast<IrLgmData>(ir);
+        if (!lgm || !(lgm->calibrateA() || lgm->calibrateH()) || lgm->calibrationType() == CalibrationType::None)
+            continue;
+        market->swaptionVol(ir->qualifier(), irConfiguration)->smileSection(1.0, 1.0, true);
+        for (auto const& base : {market->swapIndexBase(ir->qualifier(), irConfiguration),
+                                 market->shortSwapIndexBase(ir->qualifier(), irConfiguration)}) {
+            auto index = market->swapIndex(base, irConfiguration);
+            calculateCurve(index->forwardingTermStructure());
+            calculateCurve(index->discountingTermStructure());
+        }
+    }
+    for (auto const& com : config.comConfigs()) {
+        auto curve = market->commodityPriceCurve(com->name(), comConfiguration);
+        Real price = curve->price(1.0, true);
+        market->commodityVolatility(com->name(), comConfiguration)->blackVol(1.0, price, true);
+    }
+}
+
+/* Run the tasks on up to nThreads threads, the first exception in task order is rethrown. The market shared by the
+   tasks is calculated by calculateMarket before the threads start. */
+void runCalibrationTasks(const std::vector<std::function<void()>>& tasks, Size nThreads,
+                         const std::function<void()>& calculateMarket) {
+#if !defined(QL_ENABLE_SESSIONS) || !defined(QL_ENABLE_THREAD_SAFE_OBSERVER_PATTERN)
+    /* without sessions the singletons (settings, index manager, ...) are shared between the threads, without the
+       thread-safe observer pattern the calibration helpers built in the threads register with the shared market
+       objects concurrently */
+    if (nThreads > 1) {
+        WLOG("CrossAssetModelBuilder: multi-threaded calibration requires a build with QL_ENABLE_SESSIONS = ON and "
+             "QL_ENABLE_THREAD_SAFE_OBSERVER_PATTERN = ON, using one thread");
+        nThreads = 1;
+    }
+#endif
+    nThreads = std::min(nThreads, tasks.size());
+    if (nThreads <= 1) {
+        for (auto const& t : tasks)
+            t();
+        return;
+    }
+    DLOG("Run " << tasks.size() << " calibrations on " << nThreads << " threads");
+    calculateMarket();
+    CalibrationSession session;
+    std::vector<std::exception_ptr> errors(tasks.size());
+    std::atomic<Size> nextTask(0);
+    auto worker = [&tasks, &errors, &nextTask, &session](const bool newThread) {
+        // each thread has its own session singletons, initialised from the calling thread
+        if (newThread)
+            session.apply();
+        for (Size i = nextTask++; i < tasks.size(); i = nextTask++) {
+            try {
+                tasks[i]();
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+    std::vector<std::future<void>> results;
+    for (Size t = 1; t < nThreads; ++t)
+        results.push_back(std::async(std::launch::async, worker, true));
+    worker(false);
+    for (auto& r : results)
+        r.get();
+    for (auto const& e : errors)
+        if (e)
+            std::rethrow_exception(e);
+}
+
+} // namespace
+
 CrossAssetModelBuilder::CrossAssetModelBuilder(
     const boost::shared_ptr<ore::data::Market>& market, const boost::shared_ptr<CrossAssetModelData>& config,
     const std::string& configurationLgmCalibration, const std::string& configurationFxCalibration,
     const std::string& configurationEqCalibration, const std::string& configurationInfCalibration,
     const std::string& configurationCrCalibration, const std::string& configurationFinalModel, const bool dontCalibrate,
     const bool continueOnError, const std::string& referenceCalibrationGrid, const SalvagingAlgorithm::Type salvaging,
-    const std::string& id)
+    const std::string& id, const Size calibrationThreads)
     : market_(market), config_(config), configurationLgmCalibration_(configurationLgmCalibration),
       configurationFxCalibration_(configurationFxCalibration), configurationEqCalibration_(configurationEqCalibration),
       configurationInfCalibration_(configurationInfCalibration),
@@ -89,6 +234,7 @@ CrossAssetModelBuilder::CrossAssetModelBuilder(
       configurationComCalibration_(Market::defaultConfiguration), configurationFinalModel_(configurationFinalModel),
       dontCalibrate_(dontCalibrate), continueOnError_(continueOnError),
       referenceCalibrationGrid_(referenceCalibrationGrid), salvaging_(salvaging), id_(id),
+      calibrationThreads_(calibrationThreads),
       optimizationMethod_(boost::shared_ptr<OptimizationMethod>(new LevenbergMarquardt(1E-8, 1E-8, 1E-8))),
       endCriteria_(EndCriteria(1000, 500, 1E-8, 1E-8, 1E-8)) {
     buildModel();
@@ -149,16 +295,65 @@ bool CrossAssetModelBuilder::requiresRecalibration() const {
 }
 
 void CrossAssetModelBuilder::performCalculations() const {
-    // if any of the sub models requires a recalibration, we rebuilt the model
-    // TODO we could do this more selectively
+    // if any of the sub models requires a recalibration, we recalibrate the model
     if (!dontCalibrate_ && requiresRecalibration()) {
-        // reset market observer update flag
-        marketObserver_->hasUpdated(true);
-        // the cast is a bit ugly, but we pretty much know what we are doing here
-        const_cast<CrossAssetModelBuilder*>(this)->unregisterWithSubBuilders();
-        buildModel();
-        const_cast<CrossAssetModelBuilder*>(this)->registerWithSubBuilders();
+        // reset market observer update flag, the market observer only observes the correlations
+        bool correlationsChanged = marketObserver_->hasUpdated(true);
+        if (!correlationsChanged && buildDate_ == Settings::instance().evaluationDate()) {
+            // recalibrate the components in place, this skips the components with unchanged calibration inputs
+            DLOG("Recalibrate CrossAssetModel");
+            const_cast<CrossAssetModelBuilder*>(this)->unregisterWithSubBuilders();
+            // make sure the sub builders recalculate, also if notifications are disabled
+            for (auto const& okv : subBuilders_)
+                for (auto const& ikv : okv.second)
+                    if (ikv.second->requiresRecalibration())
+                        ikv.second->update();
+            calibrateModel();
+            const_cast<CrossAssetModelBuilder*>(this)->registerWithSubBuilders();
+        } else {
+            // otherwise we rebuild the model, the cast is a bit ugly, but we pretty much know what we are doing here
+            const_cast<CrossAssetModelBuilder*>(this)->unregisterWithSubBuilders();
+            buildModel();
+            const_cast<CrossAssetModelBuilder*>(this)->registerWithSubBuilders();
+        }
+    }
+}
+
+bool CrossAssetModelBuilder::calibrationInputsChanged(const CrossAssetModel::AssetType t, const Size i,
+                                                      const vector<boost::shared_ptr<BlackCalibrationHelper>>& basket,
+                                                      const vector<Size>& irIndices, const bool updateCache) const {
+    // the option basket
+    vector<Real> times, vols, marketValues;
+    vector<std::pair<Real, Real>> timesStrikes;
+    for (auto const& h : basket) {
+        if (auto fxeq = boost::dynamic_pointer_cast<QuantExt::FxEqOptionHelper>(h)) {
+            Real time = irDiscountCurves_[0]->timeFromReference(fxeq->option()->exercise()->lastDate());
+            times.push_back(time);
+            timesStrikes.push_back(std::make_pair(time, fxeq->strike()));
+        }
+        vols.push_back(h->volatility()->value());
+        marketValues.push_back(h->marketValue());
+    }
+
+    // the discount curves and the parameters of the IR components the FX or EQ component depends on
+    vector<vector<Real>> curveData;
+    for (auto k : irIndices) {
+        vector<Real> discounts, parameters;
+        for (auto time : times)
+            discounts.push_back(irDiscountCurves_[k]->discount(time));
+        for (auto const& a : rawParameterValues(irParametrizations_[k]))
+            parameters.insert(parameters.end(), a.begin(), a.end());
+        if (auto lgm = boost::dynamic_pointer_cast<IrLgm1fParametrization>(irParametrizations_[k])) {
+            parameters.push_back(lgm->shift());
+            parameters.push_back(lgm->scaling());
+        }
+        curveData.push_back(discounts);
+        curveData.push_back(parameters);
     }
+
+    return calibrationPointCache_[std::make_pair(t, i)].hasChanged(
+        vector<vector<Real>>(1, times), curveData, vector<vector<std::pair<Real, Real>>>(1, timesStrikes),
+        {vols, marketValues}, updateCache);
 }
 
 void CrossAssetModelBuilder::buildModel() const {
@@ -217,12 +412,12 @@ void CrossAssetModelBuilder::buildModel() const {
     /*******************************************************
      * Build the IR parametrizations and calibration baskets
      */
-    std::vector<boost::shared_ptr<QuantExt::Parametrization>> irParametrizations;
-    std::vector<RelinkableHandle<YieldTermStructure>> irDiscountCurves;
+    irParametrizations_.clear();
+    irDiscountCurves_.clear();
     std::vector<std::string> currencies, regions, crNames, eqNames, infIndices, comNames;
-    std::vector<boost::shared_ptr<LgmBuilder>> lgmBuilder;
-    std::vector<boost::shared_ptr<HwBuilder>> hwBuilder;
-    std::vector<boost::shared_ptr<CommoditySchwartzModelBuilder>> csBuilder;
+    lgmBuilder_.clear();
+    hwBuilder_.clear();
+    csBuilder_.clear();
 
     for (Size i = 0; i < config_->irConfigs().size(); i++) {
         auto irConfig = config_->irConfigs()[i];
@@ -235,7 +430,7 @@ void CrossAssetModelBuilder::buildModel() const {
                                                continueOnError_, referenceCalibrationGrid_, false, id_);
             if (dontCalibrate_)
                 builder->freeze();
-            lgmBuilder.push_back(builder);
+            lgmBuilder_.push_back(builder);
             auto parametrization = builder->parametrization();
             swaptionBaskets_[i] = builder->swaptionBasket();
             QL_REQUIRE(std::find(currencies.begin(), currencies.end(), parametrization->currency().code()) ==
@@ -244,8 +439,8 @@ void CrossAssetModelBuilder::buildModel() const {
                            << parametrization->currency().code()
                            << " - are there maybe two indices with the same currency in CrossAssetModelData?");
             currencies.push_back(parametrization->currency().code());
-            irParametrizations.push_back(parametrization);
-            irDiscountCurves.push_back(builder->discountCurve());
+            irParametrizations_.push_back(parametrization);
+            irDiscountCurves_.push_back(builder->discountCurve());
             subBuilders_[CrossAssetModel::AssetType::IR][i] = builder;
             processInfo[CrossAssetModel::AssetType::IR].emplace_back(ir->ccy(), 1);
         }
@@ -258,7 +453,7 @@ void CrossAssetModelBuilder::buildModel() const {
                 config_->bootstrapTolerance(), continueOnError_, referenceCalibrationGrid_, setCalibrationInfo);
             if (dontCalibrate_)
                 builder->freeze();
-            hwBuilder.push_back(builder);
+            hwBuilder_.push_back(builder);
             auto parametrization = builder->parametrization();
             swaptionBaskets_[i] = builder->swaptionBasket();
             QL_REQUIRE(std::find(currencies.begin(), currencies.end(), parametrization->currency().code()) ==
@@ -267,30 +462,30 @@ void CrossAssetModelBuilder::buildModel() const {
                            << parametrization->currency().code()
                            << " - are there maybe two indices with the same currency in CrossAssetModelData?");
             currencies.push_back(parametrization->currency().code());
-            irParametrizations.push_back(parametrization);
-            irDiscountCurves.push_back(builder->discountCurve());
+            irParametrizations_.push_back(parametrization);
+            irDiscountCurves_.push_back(builder->discountCurve());
             subBuilders_[CrossAssetModel::AssetType::IR][i] = builder;
             processInfo[CrossAssetModel::AssetType::IR].emplace_back(ir->ccy(), parametrization->m());
         }
     }
 
-    QL_REQUIRE(irParametrizations.size() > 0, "missing IR parametrizations");
+    QL_REQUIRE(irParametrizations_.size() > 0, "missing IR parametrizations");
 
-    QuantLib::Currency domesticCcy = irParametrizations[0]->currency();
+    QuantLib::Currency domesticCcy = irParametrizations_[0]->currency();
 
     /*******************************************************
      * Build the FX parametrizations and calibration baskets
      */
-    std::vector<boost::shared_ptr<QuantExt::FxBsParametrization>> fxParametrizations;
+    fxParametrizations_.clear();
     for (Size i = 0; i < config_->fxConfigs().size(); i++) {
         DLOG("FX Parametrization " << i);
         boost::shared_ptr<FxBsData> fx = config_->fxConfigs()[i];
         QuantLib::Currency ccy = ore::data::parseCurrency(fx->foreignCcy());
         QuantLib::Currency domCcy = ore::data::parseCurrency(fx->domesticCcy());
 
-        QL_REQUIRE(ccy.code() == irParametrizations[i + 1]->currency().code(),
+        QL_REQUIRE(ccy.code() == irParametrizations_[i + 1]->currency().code(),
                    "FX parametrization currency[" << i << "]=" << ccy << " does not match IR currency[" << i + 1
-                                                  << "]=" << irParametrizations[i + 1]->currency().code());
+                                                  << "]=" << irParametrizations_[i + 1]->currency().code());
 
         QL_REQUIRE(domCcy == domesticCcy, "FX parametrization [" << i << "]=" << ccy << "/" << domCcy
                                                                  << " does not match domestic ccy " << domesticCcy);
@@ -300,7 +495,7 @@ void CrossAssetModelBuilder::buildModel() const {
         boost::shared_ptr<QuantExt::FxBsParametrization> parametrization = builder->parametrization();
 
         fxOptionBaskets_[i] = builder->optionBasket();
-        fxParametrizations.push_back(parametrization);
+        fxParametrizations_.push_back(parametrization);
         subBuilders_[CrossAssetModel::AssetType::FX][i] = builder;
         processInfo[CrossAssetModel::AssetType::FX].emplace_back(ccy.code() + domCcy.code(), 1);
     }
@@ -308,7 +503,7 @@ void CrossAssetModelBuilder::buildModel() const {
     /*******************************************************
      * Build the EQ parametrizations and calibration baskets
      */
-    std::vector<boost::shared_ptr<QuantExt::EqBsParametrization>> eqParametrizations;
+    eqParametrizations_.clear();
     for (Size i = 0; i < config_->eqConfigs().size(); i++) {
         DLOG("EQ Parametrization " << i);
         boost::shared_ptr<EqBsData> eq = config_->eqConfigs()[i];
@@ -320,14 +515,14 @@ void CrossAssetModelBuilder::buildModel() const {
             market_, eq, domesticCcy, configurationEqCalibration_, referenceCalibrationGrid_);
         boost::shared_ptr<QuantExt::EqBsParametrization> parametrization = builder->parametrization();
         eqOptionBaskets_[i] = builder->optionBasket();
-        eqParametrizations.push_back(parametrization);
+        eqParametrizations_.push_back(parametrization);
         eqNames.push_back(eqName);
         subBuilders_[CrossAssetModel::AssetType::EQ][i] = builder;
         processInfo[CrossAssetModel::AssetType::EQ].emplace_back(eqName, 1);
     }
 
     // Build the INF parametrizations and calibration baskets
-    vector<boost::shared_ptr<Parametrization>> infParameterizations;
+    infParameterizations_.clear();
     for (Size i = 0; i < config_->infConfigs().size(); i++) {
         boost::shared_ptr<InflationModelData> imData = config_->infConfigs()[i];
         DLOG("Inflation parameterisation (" << i << ") for index " << imData->index());
@@ -336,13 +531,13 @@ void CrossAssetModelBuilder::buildModel() const {
                 market_, dkData, configurationInfCalibration_, referenceCalibrationGrid_, dontCalibrate_);
             if (dontCalibrate_)
                 builder->freeze();
-            infParameterizations.push_back(builder->parametrization());
+            infParameterizations_.push_back(builder->parametrization());
             subBuilders_[CrossAssetModel::AssetType::INF][i] = builder;
             processInfo[CrossAssetModel::AssetType::INF].emplace_back(dkData->index(), 1);
         } else if (auto jyData = boost::dynamic_pointer_cast<InfJyData>(imData)) {
             boost::shared_ptr<InfJyBuilder> builder = boost::make_shared<InfJyBuilder>(
                 market_, jyData, configurationInfCalibration_, referenceCalibrationGrid_);
-            infParameterizations.push_back(builder->parameterization());
+            infParameterizations_.push_back(builder->parameterization());
             subBuilders_[CrossAssetModel::AssetType::INF][i] = builder;
             processInfo[CrossAssetModel::AssetType::INF].emplace_back(jyData->index(), 2);
         } else {
@@ -397,7 +592,7 @@ void CrossAssetModelBuilder::buildModel() const {
                    "Currency (" << comCcy << ") for commodity " << comName << " not covered by CrossAssetModelData");
         boost::shared_ptr<CommoditySchwartzModelBuilder> builder = boost::make_shared<CommoditySchwartzModelBuilder>(
             market_, com, domesticCcy, configurationComCalibration_, referenceCalibrationGrid_);
-        csBuilder.push_back(builder);
+        csBuilder_.push_back(builder);
         boost::shared_ptr<QuantExt::CommoditySchwartzParametrization> parametrization = builder->parametrization();
         comOptionBaskets_[i] = builder->optionBasket();
         comParametrizations.push_back(parametrization);
@@ -417,13 +612,13 @@ void CrossAssetModelBuilder::buildModel() const {
     }
 
     std::vector<boost::shared_ptr<QuantExt::Parametrization>> parametrizations;
-    for (Size i = 0; i < irParametrizations.size(); i++)
-        parametrizations.push_back(irParametrizations[i]);
-    for (Size i = 0; i < fxParametrizations.size(); i++)
-        parametrizations.push_back(fxParametrizations[i]);
-    for (Size i = 0; i < eqParametrizations.size(); i++)
-        parametrizations.push_back(eqParametrizations[i]);
-    parametrizations.insert(parametrizations.end(), infParameterizations.begin(), infParameterizations.end());
+    for (Size i = 0; i < irParametrizations_.size(); i++)
+        parametrizations.push_back(irParametrizations_[i]);
+    for (Size i = 0; i < fxParametrizations_.size(); i++)
+        parametrizations.push_back(fxParametrizations_[i]);
+    for (Size i = 0; i < eqParametrizations_.size(); i++)
+        parametrizations.push_back(eqParametrizations_[i]);
+    parametrizations.insert(parametrizations.end(), infParameterizations_.begin(), infParameterizations_.end());
     for (Size i = 0; i < crLgmParametrizations.size(); i++)
         parametrizations.push_back(crLgmParametrizations[i]);
     for (Size i = 0; i < crCirParametrizations.size(); i++)
@@ -433,7 +628,7 @@ void CrossAssetModelBuilder::buildModel() const {
     for (Size i = 0; i < crStateParametrizations.size(); i++)
         parametrizations.push_back(crStateParametrizations[i]);
 
-    QL_REQUIRE(fxParametrizations.size() == irParametrizations.size() - 1, "mismatch in IR/FX parametrization sizes");
+    QL_REQUIRE(fxParametrizations_.size() == irParametrizations_.size() - 1, "mismatch in IR/FX parametrization sizes");
 
     /******************************
      * Build the correlation matrix
@@ -458,26 +653,78 @@ void CrossAssetModelBuilder::buildModel() const {
                                                                 config_->discretization()));
 
     /*************************
-     * Calibrate IR components
+     * Store the initial parameters of the components calibrated on the cross asset model
      */
 
-    for (Size i = 0; i < lgmBuilder.size(); i++) {
-        DLOG("IR Calibration " << i);
-        swaptionCalibrationErrors_[i] = lgmBuilder[i]->error();
-    }
+    initialParameters_.clear();
+    calibrationPointCache_.clear();
+    for (Size i = 0; i < fxParametrizations_.size(); i++)
+        initialParameters_[std::make_pair(CrossAssetModel::AssetType::FX, i)] =
+            rawParameterValues(fxParametrizations_[i]);
+    for (Size i = 0; i < eqParametrizations_.size(); i++)
+        initialParameters_[std::make_pair(CrossAssetModel::AssetType::EQ, i)] =
+            rawParameterValues(eqParametrizations_[i]);
+    for (Size i = 0; i < infParameterizations_.size(); i++)
+        initialParameters_[std::make_pair(CrossAssetModel::AssetType::INF, i)] =
+            rawParameterValues(infParameterizations_[i]);
 
-    for (Size i = 0; i < hwBuilder.size(); i++) {
-        DLOG("IR Calibration " << i);
-        swaptionCalibrationErrors_[i] = hwBuilder[i]->error();
+    buildDate_ = Settings::instance().evaluationDate();
+
+    calibrateModel();
+
+    DLOG("Building CrossAssetModel done");
+}
+
+void CrossAssetModelBuilder::calibrateModel() const {
+
+    /*************************
+     * Calibrate IR and COM components
+     */
+
+    // the sub builders of these components calibrate their own models, so they can run in parallel
+    std::vector<Real> lgmErrors(lgmBuilder_.size()), hwErrors(hwBuilder_.size()), comErrors(csBuilder_.size());
+    std::vector<std::function<void()>> tasks;
+    for (Size i = 0; i < lgmBuilder_.size(); i++)
+        tasks.push_back([this, i, &lgmErrors]() {
+            DLOG("IR Calibration " << i);
+            lgmErrors[i] = lgmBuilder_[i]->error();
+        });
+    for (Size i = 0; i < hwBuilder_.size(); i++)
+        tasks.push_back([this, i, &hwErrors]() {
+            DLOG("IR Calibration " << i);
+            hwErrors[i] = hwBuilder_[i]->error();
+        });
+    for (Size i = 0; i < csBuilder_.size(); i++)
+        tasks.push_back([this, i, &comErrors]() {
+            DLOG("COM Calibration " << i);
+            comErrors[i] = csBuilder_[i]->error();
+        });
+    runCalibrationTasks(tasks, calibrationThreads_, [this]() {
+        calculateCalibrationMarket(market_, *config_, configurationLgmCalibration_, configurationComCalibration_);
+    });
+
+    for (Size i = 0; i < lgmBuilder_.size(); i++)
+        swaptionCalibrationErrors_[i] = lgmErrors[i];
+    for (Size i = 0; i < hwBuilder_.size(); i++)
+        swaptionCalibrationErrors_[i] = hwErrors[i];
+    for (Size i = 0; i < csBuilder_.size(); i++)
+        comOptionCalibrationErrors_[i] = comErrors[i];
+
+    // the baskets might have been rebuilt during the calibration
+    for (auto const& [i, b] : subBuilders_[CrossAssetModel::AssetType::IR]) {
+        if (auto lgm = boost::dynamic_pointer_cast<LgmBuilder>(b))
+            swaptionBaskets_[i] = lgm->swaptionBasket();
+        else if (auto hw = boost::dynamic_pointer_cast<HwBuilder>(b))
+            swaptionBaskets_[i] = hw->swaptionBasket();
     }
 
     /*************************
      * Relink LGM discount curves to curves used for FX calibration
      */
 
-    for (Size i = 0; i < irParametrizations.size(); i++) {
-        auto p = irParametrizations[i];
-        irDiscountCurves[i].linkTo(*market_->discountCurve(p->currency().code(), configurationFxCalibration_));
+    for (Size i = 0; i < irParametrizations_.size(); i++) {
+        auto p = irParametrizations_[i];
+        irDiscountCurves_[i].linkTo(*market_->discountCurve(p->currency().code(), configurationFxCalibration_));
         DLOG("Relinked discounting curve for " << p->currency().code() << " for FX calibration");
     }
 
@@ -485,7 +732,7 @@ void CrossAssetModelBuilder::buildModel() const {
      * Calibrate FX components
      */
 
-    for (Size i = 0; i < fxParametrizations.size(); i++) {
+    for (Size i = 0; i < fxParametrizations_.size(); i++) {
         boost::shared_ptr<FxBsData> fx = config_->fxConfigs()[i];
 
         if (fx->calibrationType() == CalibrationType::None || !fx->calibrateSigma()) {
@@ -496,6 +743,9 @@ void CrossAssetModelBuilder::buildModel() const {
         DLOG("FX Calibration " << i);
 
         // attach pricing engines to helpers
+        fxOptionBaskets_[i] =
+            boost::static_pointer_cast<FxBsBuilder>(subBuilders_.at(CrossAssetModel::AssetType::FX).at(i))
+                ->optionBasket();
         boost::shared_ptr<QuantExt::AnalyticCcLgmFxOptionEngine> engine =
             boost::make_shared<QuantExt::AnalyticCcLgmFxOptionEngine>(*model_, i);
         // enable caching for calibration
@@ -506,6 +756,15 @@ void CrossAssetModelBuilder::buildModel() const {
 
         if (!dontCalibrate_) {
 
+            std::vector<Size> irIndices = {0, i + 1};
+            if (!calibrationInputsChanged(CrossAssetModel::AssetType::FX, i, fxOptionBaskets_[i], irIndices, false)) {
+                DLOG("FX Calibration " << i << " skipped, calibration inputs have not changed");
+                continue;
+            }
+
+            resetParameters(fxParametrizations_[i],
+                            initialParameters_.at(std::make_pair(CrossAssetModel::AssetType::FX, i)));
+
             if (fx->calibrationType() == CalibrationType::Bootstrap && fx->sigmaParamType() == ParamType::Piecewise)
                 model_->calibrateBsVolatilitiesIterative(CrossAssetModel::AssetType::FX, i, fxOptionBaskets_[i],
                                                          *optimizationMethod_, endCriteria_);
@@ -519,7 +778,7 @@ void CrossAssetModelBuilder::buildModel() const {
                 if (fabs(fxOptionCalibrationErrors_[i]) < config_->bootstrapTolerance()) {
                     TLOGGERSTREAM("Calibration details:");
                     TLOGGERSTREAM(
-                        getCalibrationDetails(fxOptionBaskets_[i], fxParametrizations[i], irParametrizations[0]));
+                        getCalibrationDetails(fxOptionBaskets_[i], fxParametrizations_[i], irParametrizations_[0]));
                     TLOGGERSTREAM("rmse = " << fxOptionCalibrationErrors_[i]);
                 } else {
                     std::string exceptionMessage = "FX BS " + std::to_string(i) + " calibration error " +
@@ -529,12 +788,14 @@ void CrossAssetModelBuilder::buildModel() const {
                     WLOG(StructuredModelErrorMessage("Failed to calibrate FX BS Model", exceptionMessage, id_));
                     WLOGGERSTREAM("Calibration details:");
                     WLOGGERSTREAM(
-                        getCalibrationDetails(fxOptionBaskets_[i], fxParametrizations[i], irParametrizations[0]));
+                        getCalibrationDetails(fxOptionBaskets_[i], fxParametrizations_[i], irParametrizations_[0]));
                     WLOGGERSTREAM("rmse = " << fxOptionCalibrationErrors_[i]);
                     if (!continueOnError_)
                         QL_FAIL(exceptionMessage);
                 }
             }
+
+            calibrationInputsChanged(CrossAssetModel::AssetType::FX, i, fxOptionBaskets_[i], irIndices, true);
         }
     }
 
@@ -542,9 +803,9 @@ void CrossAssetModelBuilder::buildModel() const {
      * Relink LGM discount curves to curves used for EQ calibration
      */
 
-    for (Size i = 0; i < irParametrizations.size(); i++) {
-        auto p = irParametrizations[i];
-        irDiscountCurves[i].linkTo(*market_->discountCurve(p->currency().code(), configurationEqCalibration_));
+    for (Size i = 0; i < irParametrizations_.size(); i++) {
+        auto p = irParametrizations_[i];
+        irDiscountCurves_[i].linkTo(*market_->discountCurve(p->currency().code(), configurationEqCalibration_));
         DLOG("Relinked discounting curve for " << p->currency().code() << " for EQ calibration");
     }
 
@@ -552,7 +813,7 @@ void CrossAssetModelBuilder::buildModel() const {
      * Calibrate EQ components
      */
 
-    for (Size i = 0; i < eqParametrizations.size(); i++) {
+    for (Size i = 0; i < eqParametrizations_.size(); i++) {
         boost::shared_ptr<EqBsData> eq = config_->eqConfigs()[i];
         if (!eq->calibrateSigma()) {
             DLOG("EQ Calibration " << i << " skipped");
@@ -560,8 +821,11 @@ void CrossAssetModelBuilder::buildModel() const {
         }
         DLOG("EQ Calibration " << i);
         // attach pricing engines to helpers
-        Currency eqCcy = eqParametrizations[i]->currency();
+        Currency eqCcy = eqParametrizations_[i]->currency();
         Size eqCcyIdx = model_->ccyIndex(eqCcy);
+        eqOptionBaskets_[i] =
+            boost::static_pointer_cast<EqBsBuilder>(subBuilders_.at(CrossAssetModel::AssetType::EQ).at(i))
+                ->optionBasket();
         boost::shared_ptr<QuantExt::AnalyticXAssetLgmEquityOptionEngine> engine =
             boost::make_shared<QuantExt::AnalyticXAssetLgmEquityOptionEngine>(*model_, i, eqCcyIdx);
         for (Size j = 0; j < eqOptionBaskets_[i].size(); j++)
@@ -569,6 +833,15 @@ void CrossAssetModelBuilder::buildModel() const {
 
         if (!dontCalibrate_) {
 
+            std::vector<Size> irIndices = {0, eqCcyIdx};
+            if (!calibrationInputsChanged(CrossAssetModel::AssetType::EQ, i, eqOptionBaskets_[i], irIndices, false)) {
+                DLOG("EQ Calibration " << i << " skipped, calibration inputs have not changed");
+                continue;
+            }
+
+            resetParameters(eqParametrizations_[i],
+                            initialParameters_.at(std::make_pair(CrossAssetModel::AssetType::EQ, i)));
+
             if (eq->calibrationType() == CalibrationType::Bootstrap && eq->sigmaParamType() == ParamType::Piecewise)
                 model_->calibrateBsVolatilitiesIterative(CrossAssetModel::AssetType::EQ, i, eqOptionBaskets_[i],
                                                          *optimizationMethod_, endCriteria_);
@@ -581,7 +854,7 @@ void CrossAssetModelBuilder::buildModel() const {
                 if (fabs(eqOptionCalibrationErrors_[i]) < config_->bootstrapTolerance()) {
                     TLOGGERSTREAM("Calibration details:");
                     TLOGGERSTREAM(
-                        getCalibrationDetails(eqOptionBaskets_[i], eqParametrizations[i], irParametrizations[0]));
+                        getCalibrationDetails(eqOptionBaskets_[i], eqParametrizations_[i], irParametrizations_[0]));
                     TLOGGERSTREAM("rmse = " << eqOptionCalibrationErrors_[i]);
                 } else {
                     std::string exceptionMessage = "EQ BS " + std::to_string(i) + " calibration error " +
@@ -591,45 +864,41 @@ void CrossAssetModelBuilder::buildModel() const {
                     WLOG(StructuredModelErrorMessage("Failed to calibrate EQ BS Model", exceptionMessage, id_));
                     WLOGGERSTREAM("Calibration details:");
                     WLOGGERSTREAM(
-                        getCalibrationDetails(eqOptionBaskets_[i], eqParametrizations[i], irParametrizations[0]));
+                        getCalibrationDetails(eqOptionBaskets_[i], eqParametrizations_[i], irParametrizations_[0]));
                     WLOGGERSTREAM("rmse = " << eqOptionCalibrationErrors_[i]);
                     if (!continueOnError_)
                         QL_FAIL(exceptionMessage);
                 }
             }
+
+            calibrationInputsChanged(CrossAssetModel::AssetType::EQ, i, eqOptionBaskets_[i], irIndices, true);
         }
     }
 
-    /*************************
-     * Calibrate COM components
-     */
-
-    for (Size i = 0; i < csBuilder.size(); i++) {
-        DLOG("COM Calibration " << i);
-        comOptionCalibrationErrors_[i] = csBuilder[i]->error();
-    }
-    
     /*************************
      * Relink LGM discount curves to curves used for INF calibration
      */
 
-    for (Size i = 0; i < irParametrizations.size(); i++) {
-        auto p = irParametrizations[i];
-        irDiscountCurves[i].linkTo(*market_->discountCurve(p->currency().code(), configurationInfCalibration_));
+    for (Size i = 0; i < irParametrizations_.size(); i++) {
+        auto p = irParametrizations_[i];
+        irDiscountCurves_[i].linkTo(*market_->discountCurve(p->currency().code(), configurationInfCalibration_));
         DLOG("Relinked discounting curve for " << p->currency().code() << " for INF calibration");
     }
 
     // Calibrate INF components
-    for (Size i = 0; i < infParameterizations.size(); i++) {
+    for (Size i = 0; i < infParameterizations_.size(); i++) {
         boost::shared_ptr<InflationModelData> imData = config_->infConfigs()[i];
+        if (!dontCalibrate_)
+            resetParameters(infParameterizations_[i],
+                            initialParameters_.at(std::make_pair(CrossAssetModel::AssetType::INF, i)));
         if (auto dkData = boost::dynamic_pointer_cast<InfDkData>(imData)) {
-            auto dkParam = boost::dynamic_pointer_cast<InfDkParametrization>(infParameterizations[i]);
+            auto dkParam = boost::dynamic_pointer_cast<InfDkParametrization>(infParameterizations_[i]);
             QL_REQUIRE(dkParam, "Expected DK model data to have given a DK parameterisation.");
             const auto& builder = subBuilders_.at(CrossAssetModel::AssetType::INF).at(i);
             const auto& dkBuilder = boost::dynamic_pointer_cast<InfDkBuilder>(builder);
             calibrateInflation(*dkData, i, dkBuilder->optionBasket(), dkParam);
         } else if (auto jyData = boost::dynamic_pointer_cast<InfJyData>(imData)) {
-            auto jyParam = boost::dynamic_pointer_cast<InfJyParameterization>(infParameterizations[i]);
+            auto jyParam = boost::dynamic_pointer_cast<InfJyParameterization>(infParameterizations_[i]);
             QL_REQUIRE(jyParam, "Expected JY model data to have given a JY parameterisation.");
             const auto& builder = subBuilders_.at(CrossAssetModel::AssetType::INF).at(i);
             const auto& jyBuilder = boost::dynamic_pointer_cast<InfJyBuilder>(builder);
@@ -643,17 +912,15 @@ void CrossAssetModelBuilder::buildModel() const {
      * Relink LGM discount curves to final model curves
      */
 
-    for (Size i = 0; i < irParametrizations.size(); i++) {
-        auto p = irParametrizations[i];
-        irDiscountCurves[i].linkTo(*market_->discountCurve(p->currency().code(), configurationFinalModel_));
+    for (Size i = 0; i < irParametrizations_.size(); i++) {
+        auto p = irParametrizations_[i];
+        irDiscountCurves_[i].linkTo(*market_->discountCurve(p->currency().code(), configurationFinalModel_));
         DLOG("Relinked discounting curve for " << p->currency().code() << " as final model curves");
     }
 
     // play safe (although the cache of the model should be empty at
     // this point from all what we know...)
     model_->update();
-
-    DLOG("Building CrossAssetModel done");
 }
 
 void CrossAssetModelBuilder::forceRecalculate() {
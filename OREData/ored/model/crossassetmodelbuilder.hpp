@@ -34,10 +34,14 @@
 #include <qle/models/modelbuilder.hpp>
 
 #include <ored/marketdata/market.hpp>
+#include <ored/model/calibrationpointcache.hpp>
+#include <ored/model/commodityschwartzmodelbuilder.hpp>
 #include <ored/model/crossassetmodeldata.hpp>
+#include <ored/model/hwbuilder.hpp>
 #include <ored/model/inflation/infdkdata.hpp>
 #include <ored/model/inflation/infjydata.hpp>
 #include <ored/model/inflation/infjybuilder.hpp>
+#include <ored/model/lgmbuilder.hpp>
 #include <ored/utilities/xmlutils.hpp>
 
 namespace ore {
@@ -50,6 +54,16 @@ using namespace QuantLib;
   passed to the constructor), and a model configuration (passed to
   the "build" member function) to build and calibrate a cross asset model.
 
+  The IR and COM components are calibrated first, they do not depend on other components of the model and are
+  calibrated in parallel if more than one calibration thread is given and QL_ENABLE_SESSIONS and
+  QL_ENABLE_THREAD_SAFE_OBSERVER_PATTERN are set. The market term structures used by these calibrations are calculated
+  before the threads start and the threads copy the evaluation date, settings and fixings of the calling thread. The
+  FX, EQ and INF components are then calibrated against the IR components in sequence.
+
+  On a recalibration the model is rebuilt if the correlations or the evaluation date have changed. Otherwise the
+  components are recalibrated in place, and FX and EQ components whose calibration inputs (option basket, discount
+  curves and IR model parameters) have not changed are not recalibrated.
+
   \ingroup models
  */
 class CrossAssetModelBuilder : public QuantExt::ModelBuilder {
@@ -84,7 +98,9 @@ public:
 	//! salvaging algorithm to apply to correlation matrix
 	const SalvagingAlgorithm::Type salvaging = SalvagingAlgorithm::None,
         //! id of the builder
-        const std::string& id = "unknown");
+        const std::string& id = "unknown",
+        //! number of threads used to calibrate the IR and COM components
+        const Size calibrationThreads = 1);
 
     //! Default destructor
     ~CrossAssetModelBuilder() {}
@@ -110,6 +126,7 @@ public:
 private:
     void performCalculations() const override;
     void buildModel() const;
+    void calibrateModel() const;
     void registerWithSubBuilders();
     void unregisterWithSubBuilders();
 
@@ -141,6 +158,7 @@ private:
     const std::string referenceCalibrationGrid_;
     const SalvagingAlgorithm::Type salvaging_;
     const std::string id_;
+    const Size calibrationThreads_;
 
     // TODO: Move CalibrationErrorType, optimizer and end criteria parameters to data
     boost::shared_ptr<OptimizationMethod> optimizationMethod_;
@@ -155,6 +173,28 @@ private:
     // resulting model
     mutable RelinkableHandle<QuantExt::CrossAssetModel> model_;
 
+    // model components kept for an in place recalibration
+    mutable Date buildDate_;
+    mutable std::vector<boost::shared_ptr<QuantExt::Parametrization>> irParametrizations_;
+    mutable std::vector<RelinkableHandle<YieldTermStructure>> irDiscountCurves_;
+    mutable std::vector<boost::shared_ptr<QuantExt::FxBsParametrization>> fxParametrizations_;
+    mutable std::vector<boost::shared_ptr<QuantExt::EqBsParametrization>> eqParametrizations_;
+    mutable std::vector<boost::shared_ptr<QuantExt::Parametrization>> infParameterizations_;
+    mutable std::vector<boost::shared_ptr<LgmBuilder>> lgmBuilder_;
+    mutable std::vector<boost::shared_ptr<HwBuilder>> hwBuilder_;
+    mutable std::vector<boost::shared_ptr<CommoditySchwartzModelBuilder>> csBuilder_;
+
+    // raw parameter values before the calibration, a recalibration starts from these values
+    mutable std::map<std::pair<QuantExt::CrossAssetModel::AssetType, Size>, std::vector<Array>> initialParameters_;
+
+    // calibration inputs of the last calibration of the FX and EQ components
+    mutable std::map<std::pair<QuantExt::CrossAssetModel::AssetType, Size>, CalibrationPointCache> calibrationPointCache_;
+
+    // checks whether the calibration inputs of a FX or EQ component have changed and updates the cache if requested
+    bool calibrationInputsChanged(const QuantExt::CrossAssetModel::AssetType t, const Size i,
+                                  const std::vector<boost::shared_ptr<BlackCalibrationHelper>>& basket,
+                                  const std::vector<Size>& irIndices, const bool updateCache) const;
+
     // Calibrate DK inflation model
     void calibrateInflation(const InfDkData& data,
         QuantLib::Size modelIdx,
@@ -17,8 +17,49 @@
 */
 
 #include <ored/portfolio/builders/commodityforward.hpp>
+#include <ored/utilities/log.hpp>
+
+#include <qle/models/projectedcrossassetmodel.hpp>
+#include <qle/pricingengines/mccamcommodityforwardengine.hpp>
 
 namespace ore {
 namespace data {
+
+using namespace QuantLib;
+using namespace QuantExt;
+
+boost::shared_ptr<QuantLib::PricingEngine> CamAmcCommodityForwardEngineBuilder::engineImpl(const Currency& ccy) {
+
+    DLOG("Building AMC commodity forward engine for ccy " << ccy.code() << " (from externally given CAM)");
+
+    // the engine is keyed by ccy only, so we select all COM components in this ccy together with the IR / FX
+    // components for the base ccy and the commodity ccy
+
+    auto components = getIrFxComponents(cam_, {ccy});
+    for (Size i = 0; i < cam_->components(CrossAssetModel::AssetType::COM); ++i) {
+        if (cam_->com(i)->currency() == ccy)
+            components.push_back(std::make_pair(CrossAssetModel::AssetType::COM, i));
+    }
+    std::vector<Size> externalModelIndices;
+    Handle<CrossAssetModel> model(getProjectedCrossAssetModel(cam_, components, externalModelIndices));
+
+    // we assume that the model has the pricing discount curves attached already, so
+    // we leave the discountCurves vector empty here
+    std::vector<Handle<YieldTermStructure>> discountCurves;
+
+    // NPV is in the commodity ccy, consistent with the npv currency of an ORE Commodity Forward Trade
+    auto engine = boost::make_shared<McCamCommodityForwardEngine>(
+        model, parseSequenceType(engineParameter("Training.Sequence")),
+        parseSequenceType(engineParameter("Pricing.Sequence")), parseInteger(engineParameter("Training.Samples")),
+        parseInteger(engineParameter("Pricing.Samples")), parseInteger(engineParameter("Training.Seed")),
+        parseInteger(engineParameter("Pricing.Seed")), parseInteger(engineParameter("Training.BasisFunctionOrder")),
+        parsePolynomType(engineParameter("Training.BasisFunction")),
+        parseSobolBrownianGeneratorOrdering(engineParameter("BrownianBridgeOrdering")),
+        parseSobolRsgDirectionIntegers(engineParameter("SobolDirectionIntegers")), discountCurves, simulationDates_,
+        externalModelIndices, parseBool(engineParameter("MinObsDate")));
+
+    return engine;
+}
+
 } // namespace data
 } // namespace ore
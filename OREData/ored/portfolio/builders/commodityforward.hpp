@@ -26,31 +26,59 @@
 #include <boost/make_shared.hpp>
 #include <ored/portfolio/builders/cachingenginebuilder.hpp>
 #include <ored/portfolio/enginefactory.hpp>
+#include <qle/models/crossassetmodel.hpp>
 #include <qle/pricingengines/discountingcommodityforwardengine.hpp>
 
 namespace ore {
 namespace data {
 
-//! Engine builder for commodity forward
+//! Engine builder base class for commodity forward
 /*! Pricing engines are cached by currency
     \ingroup builders
  */
-class CommodityForwardEngineBuilder
+class CommodityForwardEngineBuilderBase
     : public CachingPricingEngineBuilder<std::string, const QuantLib::Currency&> {
 public:
-    CommodityForwardEngineBuilder()
-        : CachingEngineBuilder("DiscountedCashflows", "DiscountingCommodityForwardEngine", {"CommodityForward"}) {}
+    CommodityForwardEngineBuilderBase(const std::string& model, const std::string& engine)
+        : CachingEngineBuilder(model, engine, {"CommodityForward"}) {}
 
 protected:
     virtual std::string keyImpl(const QuantLib::Currency& ccy) override {
         return ccy.code();
     }
+};
 
+//! Engine builder for commodity forward
+/*! Pricing engines are cached by currency
+    \ingroup builders
+ */
+class CommodityForwardEngineBuilder : public CommodityForwardEngineBuilderBase {
+public:
+    CommodityForwardEngineBuilder()
+        : CommodityForwardEngineBuilderBase("DiscountedCashflows", "DiscountingCommodityForwardEngine") {}
+
+protected:
     virtual boost::shared_ptr<QuantLib::PricingEngine> engineImpl(const QuantLib::Currency& ccy) override {
         return boost::make_shared<QuantExt::DiscountingCommodityForwardEngine>(
             market_->discountCurve(ccy.code(), configuration(MarketContext::pricing)));
     }
 };
 
+//! Commodity forward engine builder for external cam, with additional simulation dates (AMC)
+class CamAmcCommodityForwardEngineBuilder : public CommodityForwardEngineBuilderBase {
+public:
+    // for external cam, with additional simulation dates (AMC)
+    CamAmcCommodityForwardEngineBuilder(const boost::shared_ptr<QuantExt::CrossAssetModel>& cam,
+                                        const std::vector<Date>& simulationDates)
+        : CommodityForwardEngineBuilderBase("CrossAssetModel", "AMC"), cam_(cam), simulationDates_(simulationDates) {}
+
+protected:
+    virtual boost::shared_ptr<QuantLib::PricingEngine> engineImpl(const QuantLib::Currency& ccy) override;
+
+private:
+    const boost::shared_ptr<QuantExt::CrossAssetModel> cam_;
+    const std::vector<Date> simulationDates_;
+};
+
 } // namespace data
 } // namespace ore
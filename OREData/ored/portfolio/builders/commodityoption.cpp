@@ -18,7 +18,54 @@
 
 #include <ored/portfolio/builders/commodityoption.hpp>
 
+#include <qle/models/projectedcrossassetmodel.hpp>
+#include <qle/pricingengines/mccamcommodityoptionengine.hpp>
+
 namespace ore {
 namespace data {
+
+using namespace QuantLib;
+using namespace QuantExt;
+
+boost::shared_ptr<PricingEngine> CamAmcCommodityOptionEngineBuilder::engineImpl(const string& assetName,
+                                                                                const Currency& ccy,
+                                                                                const AssetClass& assetClassUnderlying,
+                                                                                const Date& expiryDate) {
+
+    QL_REQUIRE(assetClassUnderlying == AssetClass::COM, "Commodity Option required");
+
+    DLOG("Building AMC commodity option engine for " << assetName << " / " << ccy.code()
+                                                      << " (from externally given CAM)");
+
+    Size comIdx = cam_->comIndex(assetName);
+    Currency comCcy = cam_->com(comIdx)->currency();
+    auto comIndex = *market_->commodityIndex(assetName, configuration(MarketContext::pricing));
+
+    // select the IR / FX components for the base ccy, the commodity ccy and the option ccy and the COM component
+    // itself, the state process indices of the projected model are the external model indices for the engine
+
+    auto components = getIrFxComponents(cam_, {comCcy, ccy});
+    components.push_back(std::make_pair(CrossAssetModel::AssetType::COM, comIdx));
+    std::vector<Size> externalModelIndices;
+    Handle<CrossAssetModel> model(getProjectedCrossAssetModel(cam_, components, externalModelIndices));
+
+    // we assume that the model has the pricing discount curves attached already, so
+    // we leave the discountCurves vector empty here
+    std::vector<Handle<YieldTermStructure>> discountCurves;
+
+    // NPV should be in ccy, consistent with the npv currency of an ORE Commodity Option Trade
+    auto engine = boost::make_shared<McCamCommodityOptionEngine>(
+        model, comIndex, comCcy, ccy, parseSequenceType(engineParameter("Training.Sequence")),
+        parseSequenceType(engineParameter("Pricing.Sequence")), parseInteger(engineParameter("Training.Samples")),
+        parseInteger(engineParameter("Pricing.Samples")), parseInteger(engineParameter("Training.Seed")),
+        parseInteger(engineParameter("Pricing.Seed")), parseInteger(engineParameter("Training.BasisFunctionOrder")),
+        parsePolynomType(engineParameter("Training.BasisFunction")),
+        parseSobolBrownianGeneratorOrdering(engineParameter("BrownianBridgeOrdering")),
+        parseSobolRsgDirectionIntegers(engineParameter("SobolDirectionIntegers")), discountCurves, simulationDates_,
+        externalModelIndices, parseBool(engineParameter("MinObsDate")));
+
+    return engine;
+}
+
 } // namespace data
 } // namespace ore
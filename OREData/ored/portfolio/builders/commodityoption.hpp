@@ -24,6 +24,7 @@
 #pragma once
 
 #include <ored/portfolio/builders/vanillaoption.hpp>
+#include <qle/models/crossassetmodel.hpp>
 
 namespace ore {
 namespace data {
@@ -73,5 +74,26 @@ public:
         : AmericanOptionBAWEngineBuilder("BlackScholes", {"CommodityOptionAmerican"}, AssetClass::COM) {}
 };
 
+//! Commodity option engine builder for external cam, with additional simulation dates (AMC)
+/*! Pricing engines are cached by asset/currency
+    \ingroup builders
+ */
+class CamAmcCommodityOptionEngineBuilder : public VanillaOptionEngineBuilder {
+public:
+    // for external cam, with additional simulation dates (AMC)
+    CamAmcCommodityOptionEngineBuilder(const boost::shared_ptr<QuantExt::CrossAssetModel>& cam, const std::vector<Date>& simulationDates)
+        : VanillaOptionEngineBuilder("CrossAssetModel", "AMC", {"CommodityOption", "CommodityOptionForward"}, AssetClass::COM, Date()), cam_(cam),
+          simulationDates_(simulationDates) {}
+
+protected:
+    boost::shared_ptr<PricingEngine> engineImpl(const string& assetName, const Currency& ccy,
+                                                const AssetClass& assetClassUnderlying,
+                                                const Date& expiryDate) override;
+
+private:
+    const boost::shared_ptr<QuantExt::CrossAssetModel> cam_;
+    const std::vector<Date> simulationDates_;
+};
+
 } // namespace data
 } // namespace ore
@@ -22,8 +22,48 @@
 */
 
 #include <ored/portfolio/builders/commodityswap.hpp>
+#include <ored/utilities/log.hpp>
+
+#include <qle/models/projectedcrossassetmodel.hpp>
+#include <qle/pricingengines/mccamcommodityswapengine.hpp>
 
 namespace ore {
 namespace data {
+
+using namespace QuantLib;
+using namespace QuantExt;
+
+boost::shared_ptr<QuantLib::PricingEngine> CamAmcCommoditySwapEngineBuilder::engineImpl(const Currency& ccy) {
+
+    DLOG("Building AMC commodity swap engine for ccy " << ccy.code() << " (from externally given CAM)");
+
+    // the engine is keyed by ccy only, so we select all COM components in this ccy together with the IR / FX
+    // components for the base ccy and the swap ccy
+
+    auto components = getIrFxComponents(cam_, {ccy});
+    for (Size i = 0; i < cam_->components(CrossAssetModel::AssetType::COM); ++i) {
+        if (cam_->com(i)->currency() == ccy)
+            components.push_back(std::make_pair(CrossAssetModel::AssetType::COM, i));
+    }
+    std::vector<Size> externalModelIndices;
+    Handle<CrossAssetModel> model(getProjectedCrossAssetModel(cam_, components, externalModelIndices));
+
+    // we assume that the model has the pricing discount curves attached already, so
+    // we leave the discountCurves vector empty here
+    std::vector<Handle<YieldTermStructure>> discountCurves;
+
+    auto engine = boost::make_shared<McCamCommoditySwapEngine>(
+        model, ccy, parseSequenceType(engineParameter("Training.Sequence")),
+        parseSequenceType(engineParameter("Pricing.Sequence")), parseInteger(engineParameter("Training.Samples")),
+        parseInteger(engineParameter("Pricing.Samples")), parseInteger(engineParameter("Training.Seed")),
+        parseInteger(engineParameter("Pricing.Seed")), parseInteger(engineParameter("Training.BasisFunctionOrder")),
+        parsePolynomType(engineParameter("Training.BasisFunction")),
+        parseSobolBrownianGeneratorOrdering(engineParameter("BrownianBridgeOrdering")),
+        parseSobolRsgDirectionIntegers(engineParameter("SobolDirectionIntegers")), discountCurves, simulationDates_,
+        externalModelIndices, parseBool(engineParameter("MinObsDate")));
+
+    return engine;
+}
+
 } // namespace data
 } // namespace ore
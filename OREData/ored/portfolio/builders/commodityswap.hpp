@@ -27,23 +27,35 @@
 #include <ored/portfolio/builders/cachingenginebuilder.hpp>
 #include <ored/portfolio/enginefactory.hpp>
 #include <ql/pricingengines/swap/discountingswapengine.hpp>
+#include <qle/models/crossassetmodel.hpp>
 
 namespace ore {
 namespace data {
 
-//! Engine builder for Commodity Swaps
+//! Engine builder base class for Commodity Swaps
 /*! Pricing engines are cached by currency
 -
 \ingroup builders
 */
-class CommoditySwapEngineBuilder : public CachingPricingEngineBuilder<string, const Currency&> {
+class CommoditySwapEngineBuilderBase : public CachingPricingEngineBuilder<string, const Currency&> {
 public:
-    CommoditySwapEngineBuilder()
-        : CachingEngineBuilder("DiscountedCashflows", "CommoditySwapEngine", {"CommoditySwap"}) {}
+    CommoditySwapEngineBuilderBase(const std::string& model, const std::string& engine)
+        : CachingEngineBuilder(model, engine, {"CommoditySwap"}) {}
 
 protected:
     virtual std::string keyImpl(const Currency& ccy) override { return ccy.code(); }
+};
+
+//! Engine builder for Commodity Swaps
+/*! Pricing engines are cached by currency
+-
+\ingroup builders
+*/
+class CommoditySwapEngineBuilder : public CommoditySwapEngineBuilderBase {
+public:
+    CommoditySwapEngineBuilder() : CommoditySwapEngineBuilderBase("DiscountedCashflows", "CommoditySwapEngine") {}
 
+protected:
     virtual boost::shared_ptr<QuantLib::PricingEngine> engineImpl(const Currency& ccy) override {
 
         Handle<YieldTermStructure> yts = market_->discountCurve(ccy.code(), configuration(MarketContext::pricing));
@@ -51,5 +63,21 @@ protected:
     };
 };
 
+//! Commodity swap engine builder for external cam, with additional simulation dates (AMC)
+class CamAmcCommoditySwapEngineBuilder : public CommoditySwapEngineBuilderBase {
+public:
+    // for external cam, with additional simulation dates (AMC)
+    CamAmcCommoditySwapEngineBuilder(const boost::shared_ptr<QuantExt::CrossAssetModel>& cam,
+                                     const std::vector<Date>& simulationDates)
+        : CommoditySwapEngineBuilderBase("CrossAssetModel", "AMC"), cam_(cam), simulationDates_(simulationDates) {}
+
+protected:
+    virtual boost::shared_ptr<QuantLib::PricingEngine> engineImpl(const Currency& ccy) override;
+
+private:
+    const boost::shared_ptr<QuantExt::CrossAssetModel> cam_;
+    const std::vector<Date> simulationDates_;
+};
+
 } // namespace data
 } // namespace ore
@@ -17,8 +17,49 @@
 */
 
 #include <ored/portfolio/builders/equityforward.hpp>
+#include <ored/utilities/log.hpp>
+
+#include <qle/models/projectedcrossassetmodel.hpp>
+#include <qle/pricingengines/mccamequityforwardengine.hpp>
 
 namespace ore {
 namespace data {
+
+using namespace QuantLib;
+using namespace QuantExt;
+
+boost::shared_ptr<PricingEngine> CamAmcEquityForwardEngineBuilder::engineImpl(const string& equityName,
+                                                                              const Currency& ccy) {
+
+    DLOG("Building AMC equity forward engine for " << equityName << " / " << ccy.code()
+                                                    << " (from externally given CAM)");
+
+    // select the IR / FX components for the base ccy and the equity ccy and the EQ component itself, the state
+    // process indices of the projected model are the external model indices for the engine
+
+    auto components = getIrFxComponents(cam_, {ccy});
+    components.push_back(std::make_pair(CrossAssetModel::AssetType::EQ, cam_->eqIndex(equityName)));
+    std::vector<Size> externalModelIndices;
+    Handle<CrossAssetModel> model(getProjectedCrossAssetModel(cam_, components, externalModelIndices));
+
+    // we assume that the model has the pricing discount curves attached already, so
+    // we leave the discountCurves vector empty here
+    std::vector<Handle<YieldTermStructure>> discountCurves;
+
+    // NPV is in the equity ccy, consistent with the npv currency of an ORE Equity Forward Trade
+    auto engine = boost::make_shared<McCamEquityForwardEngine>(
+        model, *market_->equityCurve(equityName, configuration(MarketContext::pricing)),
+        parseSequenceType(engineParameter("Training.Sequence")),
+        parseSequenceType(engineParameter("Pricing.Sequence")), parseInteger(engineParameter("Training.Samples")),
+        parseInteger(engineParameter("Pricing.Samples")), parseInteger(engineParameter("Training.Seed")),
+        parseInteger(engineParameter("Pricing.Seed")), parseInteger(engineParameter("Training.BasisFunctionOrder")),
+        parsePolynomType(engineParameter("Training.BasisFunction")),
+        parseSobolBrownianGeneratorOrdering(engineParameter("BrownianBridgeOrdering")),
+        parseSobolRsgDirectionIntegers(engineParameter("SobolDirectionIntegers")), discountCurves, simulationDates_,
+        externalModelIndices, parseBool(engineParameter("MinObsDate")));
+
+    return engine;
+}
+
 } // namespace data
 } // namespace ore
@@ -26,26 +26,39 @@
 #include <boost/make_shared.hpp>
 #include <ored/portfolio/builders/cachingenginebuilder.hpp>
 #include <ored/portfolio/enginefactory.hpp>
+#include <qle/models/crossassetmodel.hpp>
 #include <qle/pricingengines/discountingequityforwardengine.hpp>
 
 namespace ore {
 namespace data {
 
-//! Engine Builder for European Equity Forwards
+//! Engine Builder base class for Equity Forwards
 /*! Pricing engines are cached by equity/currency
 
     \ingroup builders
  */
-class EquityForwardEngineBuilder : public CachingPricingEngineBuilder<string, const string&, const Currency&> {
+class EquityForwardEngineBuilderBase : public CachingPricingEngineBuilder<string, const string&, const Currency&> {
 public:
-    EquityForwardEngineBuilder()
-        : CachingEngineBuilder("DiscountedCashflows", "DiscountingEquityForwardEngine", {"EquityForward"}) {}
+    EquityForwardEngineBuilderBase(const std::string& model, const std::string& engine)
+        : CachingEngineBuilder(model, engine, {"EquityForward"}) {}
 
 protected:
     virtual string keyImpl(const string& equityName, const Currency& ccy) override {
         return equityName + "/" + ccy.code();
     }
+};
+
+//! Engine Builder for European Equity Forwards
+/*! Pricing engines are cached by equity/currency
+
+    \ingroup builders
+ */
+class EquityForwardEngineBuilder : public EquityForwardEngineBuilderBase {
+public:
+    EquityForwardEngineBuilder()
+        : EquityForwardEngineBuilderBase("DiscountedCashflows", "DiscountingEquityForwardEngine") {}
 
+protected:
     virtual boost::shared_ptr<PricingEngine> engineImpl(const string& equityName, const Currency& ccy) override {
         return boost::make_shared<QuantExt::DiscountingEquityForwardEngine>(
             market_->equityForecastCurve(equityName, configuration(MarketContext::pricing)),
@@ -55,5 +68,21 @@ protected:
     }
 };
 
+//! Equity forward engine builder for external cam, with additional simulation dates (AMC)
+class CamAmcEquityForwardEngineBuilder : public EquityForwardEngineBuilderBase {
+public:
+    // for external cam, with additional simulation dates (AMC)
+    CamAmcEquityForwardEngineBuilder(const boost::shared_ptr<QuantExt::CrossAssetModel>& cam,
+                                     const std::vector<Date>& simulationDates)
+        : EquityForwardEngineBuilderBase("CrossAssetModel", "AMC"), cam_(cam), simulationDates_(simulationDates) {}
+
+protected:
+    virtual boost::shared_ptr<PricingEngine> engineImpl(const string& equityName, const Currency& ccy) override;
+
+private:
+    const boost::shared_ptr<QuantExt::CrossAssetModel> cam_;
+    const std::vector<Date> simulationDates_;
+};
+
 } // namespace data
 } // namespace ore
@@ -18,7 +18,52 @@
 
 #include <ored/portfolio/builders/equityoption.hpp>
 
+#include <qle/models/projectedcrossassetmodel.hpp>
+#include <qle/pricingengines/mccamequityoptionengine.hpp>
+
 namespace ore {
 namespace data {
+
+using namespace QuantLib;
+using namespace QuantExt;
+
+boost::shared_ptr<PricingEngine> CamAmcEquityOptionEngineBuilder::engineImpl(const string& assetName,
+                                                                             const Currency& ccy,
+                                                                             const AssetClass& assetClassUnderlying,
+                                                                             const Date& expiryDate) {
+
+    QL_REQUIRE(assetClassUnderlying == AssetClass::EQ, "Equity Option required");
+
+    DLOG("Building AMC equity option engine for " << assetName << " / " << ccy.code()
+                                                   << " (from externally given CAM)");
+
+    auto eqIndex = *market_->equityCurve(assetName, configuration(MarketContext::pricing));
+
+    // select the IR / FX components for the base ccy, the equity ccy and the option ccy and the EQ component itself,
+    // the state process indices of the projected model are the external model indices for the engine
+
+    auto components = getIrFxComponents(cam_, {eqIndex->currency(), ccy});
+    components.push_back(std::make_pair(CrossAssetModel::AssetType::EQ, cam_->eqIndex(assetName)));
+    std::vector<Size> externalModelIndices;
+    Handle<CrossAssetModel> model(getProjectedCrossAssetModel(cam_, components, externalModelIndices));
+
+    // we assume that the model has the pricing discount curves attached already, so
+    // we leave the discountCurves vector empty here
+    std::vector<Handle<YieldTermStructure>> discountCurves;
+
+    // NPV should be in ccy, consistent with the npv currency of an ORE Equity Option Trade
+    auto engine = boost::make_shared<McCamEquityOptionEngine>(
+        model, eqIndex, ccy, parseSequenceType(engineParameter("Training.Sequence")),
+        parseSequenceType(engineParameter("Pricing.Sequence")), parseInteger(engineParameter("Training.Samples")),
+        parseInteger(engineParameter("Pricing.Samples")), parseInteger(engineParameter("Training.Seed")),
+        parseInteger(engineParameter("Pricing.Seed")), parseInteger(engineParameter("Training.BasisFunctionOrder")),
+        parsePolynomType(engineParameter("Training.BasisFunction")),
+        parseSobolBrownianGeneratorOrdering(engineParameter("BrownianBridgeOrdering")),
+        parseSobolRsgDirectionIntegers(engineParameter("SobolDirectionIntegers")), discountCurves, simulationDates_,
+        externalModelIndices, parseBool(engineParameter("MinObsDate")));
+
+    return engine;
+}
+
 } // namespace data
 } // namespace ore
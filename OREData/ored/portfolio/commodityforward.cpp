@@ -138,8 +138,8 @@ void CommodityForward::build(const boost::shared_ptr<EngineFactory>& engineFacto
     // Pricing engine
     boost::shared_ptr<EngineBuilder> builder = engineFactory->builder(tradeType_);
     QL_REQUIRE(builder, "No builder found for " << tradeType_);
-    boost::shared_ptr<CommodityForwardEngineBuilder> commodityForwardEngineBuilder =
-        boost::dynamic_pointer_cast<CommodityForwardEngineBuilder>(builder);
+    boost::shared_ptr<CommodityForwardEngineBuilderBase> commodityForwardEngineBuilder =
+        boost::dynamic_pointer_cast<CommodityForwardEngineBuilderBase>(builder);
     commodityForward->setPricingEngine(commodityForwardEngineBuilder->engine(currency)); // the engine accounts for NDF if settlement data are present
 
     // set up other Trade details
@@ -49,8 +49,8 @@ void CommoditySwap::build(const boost::shared_ptr<EngineFactory>& engineFactory)
 
     const boost::shared_ptr<Market> market = engineFactory->market();
     boost::shared_ptr<EngineBuilder> builder = engineFactory->builder("CommoditySwap");
-    boost::shared_ptr<CommoditySwapEngineBuilder> engineBuilder =
-        boost::dynamic_pointer_cast<CommoditySwapEngineBuilder>(builder);
+    boost::shared_ptr<CommoditySwapEngineBuilderBase> engineBuilder =
+        boost::dynamic_pointer_cast<CommoditySwapEngineBuilderBase>(builder);
     const string& configuration = builder->configuration(MarketContext::pricing);
 
     // Arbitrarily choose NPV currency from 1st leg. Already checked that both leg currencies equal.
@@ -69,8 +69,8 @@ void EquityForward::build(const boost::shared_ptr<EngineFactory>& engineFactory)
     // Pricing engine
     boost::shared_ptr<EngineBuilder> builder = engineFactory->builder(tradeType_);
     QL_REQUIRE(builder, "No builder found for " << tradeType_);
-    boost::shared_ptr<EquityForwardEngineBuilder> eqFwdBuilder =
-        boost::dynamic_pointer_cast<EquityForwardEngineBuilder>(builder);
+    boost::shared_ptr<EquityForwardEngineBuilderBase> eqFwdBuilder =
+        boost::dynamic_pointer_cast<EquityForwardEngineBuilderBase>(builder);
     inst->setPricingEngine(eqFwdBuilder->engine(name, ccy));
 
     // set up other Trade details
@@ -0,0 +1,225 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <ored/report/inmemoryreport.hpp>
+
+namespace ore {
+namespace data {
+
+Size InMemoryReport::Column::size() const {
+    switch (type) {
+    case ColumnType::Size:
+    case ColumnType::String:
+        return sizes.size();
+    case ColumnType::Real:
+        return reals.size();
+    case ColumnType::Date:
+        return dates.size();
+    case ColumnType::Period:
+        return periods.size();
+    default:
+        QL_FAIL("InMemoryReport: internal error, unknown column type " << static_cast<int>(type));
+    }
+}
+
+void InMemoryReport::Column::addString(const string& s) {
+    auto r = dictionaryIndex.emplace(s, dictionary.size());
+    if (r.second)
+        dictionary.push_back(s);
+    sizes.push_back(r.first->second);
+}
+
+const InMemoryReport::Column& InMemoryReport::column(Size i, ColumnType type) const {
+    QL_REQUIRE(i < columns_.size(), "InMemoryReport: column index " << i << " out of range, report has "
+                                                                    << columns_.size() << " columns");
+    QL_REQUIRE(columns_[i].type == type, "InMemoryReport: type mismatch for column "
+                                             << i << " (" << headers_[i] << "), requested "
+                                             << static_cast<int>(type) << ", have "
+                                             << static_cast<int>(columns_[i].type));
+    return columns_[i];
+}
+
+Report& InMemoryReport::addColumn(const string& name, const ReportType& rt, Size precision) {
+    headers_.push_back(name);
+    columnTypes_.push_back(rt);
+    columnPrecision_.push_back(precision);
+    columns_.push_back(Column());
+    columns_.back().type = static_cast<ColumnType>(rt.which());
+    i_++;
+    return *this;
+}
+
+Report& InMemoryReport::next() {
+    QL_REQUIRE(i_ == headers_.size(), "Cannot go to next line, only " << i_ << " entires filled");
+    i_ = 0;
+    return *this;
+}
+
+Report& InMemoryReport::add(const ReportType& rt) {
+    // check type is valid
+    QL_REQUIRE(i_ < headers_.size(), "No column to add [" << rt << "] to.");
+    QL_REQUIRE(rt.which() == columnTypes_[i_].which(),
+               "Cannot add value " << rt << " of type " << rt.which() << " to column " << headers_[i_]
+                                   << " of type " << columnTypes_[i_].which());
+
+    Column& c = columns_[i_];
+    switch (c.type) {
+    case ColumnType::Size:
+        c.sizes.push_back(boost::get<Size>(rt));
+        break;
+    case ColumnType::Real:
+        c.reals.push_back(boost::get<Real>(rt));
+        break;
+    case ColumnType::String:
+        c.addString(boost::get<string>(rt));
+        break;
+    case ColumnType::Date:
+        c.dates.push_back(boost::get<Date>(rt));
+        break;
+    case ColumnType::Period:
+        c.periods.push_back(boost::get<Period>(rt));
+        break;
+    default:
+        QL_FAIL("InMemoryReport: internal error, unknown column type " << static_cast<int>(c.type));
+    }
+    i_++;
+    return *this;
+}
+
+Report& InMemoryReport::add(const InMemoryReport& report) {
+    QL_REQUIRE(columns() == report.columns(),
+               "Cannot combine reports of different sizes (" << columns() << " vs " << report.columns() << ").");
+    end();
+    for (Size i = 0; i < columns(); i++) {
+        string h1 = headers_[i];
+        string h2 = report.header(i);
+        QL_REQUIRE(h1 == h2, "Cannot combine reports with different headers (\"" << h1 << "\" and \"" << h2 << "\")");
+        QL_REQUIRE(columns_[i].type == report.columns_[i].type,
+                   "Cannot combine reports with different types for column \"" << h1 << "\"");
+    }
+
+    if (i_ == headers_.size())
+        next();
+
+    // append column by column, string codes are translated to this report's dictionary
+    for (Size i = 0; i < columns(); i++) {
+        Column& c = columns_[i];
+        const Column& o = report.columns_[i];
+        switch (c.type) {
+        case ColumnType::Size:
+            c.sizes.insert(c.sizes.end(), o.sizes.begin(), o.sizes.end());
+            break;
+        case ColumnType::Real:
+            c.reals.insert(c.reals.end(), o.reals.begin(), o.reals.end());
+            break;
+        case ColumnType::String: {
+            vector<Size> codes(o.dictionary.size());
+            for (Size k = 0; k < o.dictionary.size(); ++k) {
+                auto r = c.dictionaryIndex.emplace(o.dictionary[k], c.dictionary.size());
+                if (r.second)
+                    c.dictionary.push_back(o.dictionary[k]);
+                codes[k] = r.first->second;
+            }
+            c.sizes.reserve(c.sizes.size() + o.sizes.size());
+            for (auto const& k : o.sizes)
+                c.sizes.push_back(codes[k]);
+            break;
+        }
+        case ColumnType::Date:
+            c.dates.insert(c.dates.end(), o.dates.begin(), o.dates.end());
+            break;
+        case ColumnType::Period:
+            c.periods.insert(c.periods.end(), o.periods.begin(), o.periods.end());
+            break;
+        default:
+            QL_FAIL("InMemoryReport: internal error, unknown column type " << static_cast<int>(c.type));
+        }
+    }
+
+    return *this;
+}
+
+void InMemoryReport::end() {
+    QL_REQUIRE(i_ == headers_.size() || i_ == 0,
+               "report is finalized with incomplete row, got data for " << i_ << " columns out of " << columns());
+}
+
+Report::ReportType InMemoryReport::value(Size j, Size i) const {
+    QL_REQUIRE(i < columns_.size(), "InMemoryReport: column index " << i << " out of range, report has "
+                                                                    << columns_.size() << " columns");
+    const Column& c = columns_[i];
+    switch (c.type) {
+    case ColumnType::Size:
+        return c.sizes.at(j);
+    case ColumnType::Real:
+        return c.reals.at(j);
+    case ColumnType::String:
+        return c.dictionary[c.sizes.at(j)];
+    case ColumnType::Date:
+        return c.dates.at(j);
+    case ColumnType::Period:
+        return c.periods.at(j);
+    default:
+        QL_FAIL("InMemoryReport: internal error, unknown column type " << static_cast<int>(c.type));
+    }
+}
+
+vector<Report::ReportType> InMemoryReport::data(Size i) const {
+    QL_REQUIRE(i < columns_.size(), "InMemoryReport: column index " << i << " out of range, report has "
+                                                                    << columns_.size() << " columns");
+    QL_REQUIRE(columns_[i].size() == rows(), "internal error: report column "
+                                                 << i << " (" << header(i) << ") contains " << columns_[i].size()
+                                                 << " rows, expected are " << rows() << " rows.");
+    vector<ReportType> result;
+    result.reserve(rows());
+    for (Size j = 0; j < rows(); ++j)
+        result.push_back(value(j, i));
+    return result;
+}
+
+void InMemoryReport::toFile(const string& filename, const char sep, const bool commentCharacter, char quoteChar,
+                            const string& nullString, bool lowerHeader) const {
+
+    CSVFileReport cReport(filename, sep, commentCharacter, quoteChar, nullString, lowerHeader);
+
+    for (Size i = 0; i < headers_.size(); i++) {
+        cReport.addColumn(headers_[i], columnTypes_[i], columnPrecision_[i]);
+    }
+
+    auto numColumns = columns();
+    if (numColumns > 0) {
+        auto numRows = rows();
+        for (Size i = 0; i < numColumns; i++) {
+            QL_REQUIRE(columns_[i].size() == numRows, "internal error: report column "
+                                                          << i << " (" << header(i) << ") contains "
+                                                          << columns_[i].size() << " rows, expected are " << numRows
+                                                          << " rows.");
+        }
+        for (Size i = 0; i < numRows; i++) {
+            cReport.next();
+            for (Size j = 0; j < numColumns; j++) {
+                cReport.add(value(i, j));
+            }
+        }
+    }
+
+    cReport.end();
+}
+
+} // namespace data
+} // namespace ore
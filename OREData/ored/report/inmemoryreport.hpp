@@ -26,6 +26,8 @@
 #include <ored/report/csvreport.hpp>
 #include <ored/report/report.hpp>
 #include <ql/errors.hpp>
+#include <algorithm>
+#include <unordered_map>
 #include <vector>
 namespace ore {
 namespace data {
@@ -34,112 +36,80 @@ using std::vector;
 
 /*! InMemoryReport just stores report information in local vectors and provides an interface to access
  *  the values. It could be used as a backend to a GUI
+ *
+ *  The data is stored column-wise in typed, contiguous vectors. Strings are dictionary-encoded per column, i.e.
+ *  each distinct string value is stored once and the column holds indices into the dictionary. The typed column
+ *  accessors give access to the data without copying it.
  \ingroup report
  */
 class InMemoryReport : public Report {
 public:
-    InMemoryReport() : i_(0) {}
-
-    Report& addColumn(const string& name, const ReportType& rt, Size precision = 0) override {
-        headers_.push_back(name);
-        columnTypes_.push_back(rt);
-        columnPrecision_.push_back(precision);
-        data_.push_back(vector<ReportType>()); // Initialise vector for
-        i_++;
-        return *this;
-    }
-
-    Report& next() override {
-        QL_REQUIRE(i_ == headers_.size(), "Cannot go to next line, only " << i_ << " entires filled");
-        i_ = 0;
-        return *this;
-    }
-
-    Report& add(const ReportType& rt) override {
-        // check type is valid
-        QL_REQUIRE(i_ < headers_.size(), "No column to add [" << rt << "] to.");
-        QL_REQUIRE(rt.which() == columnTypes_[i_].which(),
-                   "Cannot add value " << rt << " of type " << rt.which() << " to column " << headers_[i_]
-                                       << " of type " << columnTypes_[i_].which());
+    //! indices of the types in ReportType, as returned by ReportType::which()
+    enum class ColumnType { Size = 0, Real = 1, String = 2, Date = 3, Period = 4 };
 
-        data_[i_].push_back(rt);
-        i_++;
-        return *this;
-    }
+    InMemoryReport() : i_(0) {}
 
-    Report& add(const InMemoryReport& report) {
-        QL_REQUIRE(columns() == report.columns(),
-                   "Cannot combine reports of different sizes (" << columns() << " vs " << report.columns() << ").");
-        end();
-        for (Size i = 0; i < columns(); i++) {
-            string h1 = headers_[i];
-            string h2 = report.header(i);
-            QL_REQUIRE(h1 == h2, "Cannot combine reports with different headers (\"" << h1 << "\" and \"" << h2 << "\")");
-        }
-
-        if (i_ == headers_.size())
-            next();
-        
-        for (Size rowIdx = 0; rowIdx < report.rows(); rowIdx++) {
-            for (Size columnIdx = 0; columnIdx < report.columns(); columnIdx++) {
-                add(report.data(columnIdx)[rowIdx]);
-            }
-            next();
-        }
-        
-        return *this;
-    }
+    Report& addColumn(const string& name, const ReportType& rt, Size precision = 0) override;
+    Report& next() override;
+    Report& add(const ReportType& rt) override;
+    void end() override;
 
-    void end() override {
-        QL_REQUIRE(i_ == headers_.size() || i_ == 0,
-                   "report is finalized with incomplete row, got data for " << i_ << " columns out of " << columns());
-    }
+    //! Appends the rows of another report with the same columns
+    Report& add(const InMemoryReport& report);
 
     // InMemoryInterface
     Size columns() const { return headers_.size(); }
-    Size rows() const { return columns() == 0 ? 0 : data_[0].size(); }
+    Size rows() const { return columns() == 0 ? 0 : columns_[0].size(); }
     const string& header(Size i) const { return headers_[i]; }
     bool hasHeader(string h) const { return std::find(headers_.begin(), headers_.end(), h) != headers_.end(); }
     ReportType columnType(Size i) const { return columnTypes_[i]; }
     Size columnPrecision(Size i) const { return columnPrecision_[i]; }
-    //! Returns the data
-    const vector<ReportType>& data(Size i) const {
-        QL_REQUIRE(data_[i].size() == rows(), "internal error: report column "
-                                                  << i << " (" << header(i) << ") contains " << data_[i].size()
-                                                  << " rows, expected are " << rows() << " rows.");
-        return data_[i];
+
+    //! Returns the value in row j and column i
+    ReportType value(Size j, Size i) const;
+    //! Returns a copy of the data of column i, prefer value() or the typed accessors below for large reports
+    vector<ReportType> data(Size i) const;
+
+    //! \name Typed access to the column data without copying
+    //@{
+    const vector<Size>& sizeData(Size i) const { return column(i, ColumnType::Size).sizes; }
+    const vector<Real>& realData(Size i) const { return column(i, ColumnType::Real).reals; }
+    const vector<Date>& dateData(Size i) const { return column(i, ColumnType::Date).dates; }
+    const vector<Period>& periodData(Size i) const { return column(i, ColumnType::Period).periods; }
+    //! the dictionary codes of a string column
+    const vector<Size>& stringCodes(Size i) const { return column(i, ColumnType::String).sizes; }
+    //! the dictionary of a string column
+    const vector<string>& stringDictionary(Size i) const { return column(i, ColumnType::String).dictionary; }
+    const string& stringValue(Size j, Size i) const {
+        const Column& c = column(i, ColumnType::String);
+        return c.dictionary[c.sizes.at(j)];
     }
+    //@}
 
+    //! Writes the report to a csv file, the rows are streamed to the file without building any temporary copies
     void toFile(const string& filename, const char sep = ',', const bool commentCharacter = true, char quoteChar = '\0',
-                const string& nullString = "#N/A", bool lowerHeader = false) {
-
-        CSVFileReport cReport(filename, sep, commentCharacter, quoteChar, nullString, lowerHeader);
-
-        for (Size i = 0; i < headers_.size(); i++) {
-            cReport.addColumn(headers_[i], columnTypes_[i], columnPrecision_[i]);
-        }
-
-        auto numColumns = columns();
-        if (numColumns > 0) {
-            auto numRows = data_[0].size();
-
-            for (Size i = 0; i < numRows; i++) {
-                cReport.next();
-                for (Size j = 0; j < numColumns; j++) {
-                    cReport.add(data_[j][i]);
-                }
-            }
-        }
-
-        cReport.end();
-    }
+                const string& nullString = "#N/A", bool lowerHeader = false) const;
 
 private:
+    struct Column {
+        ColumnType type;
+        // Size values or dictionary codes for string columns
+        vector<Size> sizes;
+        vector<Real> reals;
+        vector<Date> dates;
+        vector<Period> periods;
+        vector<string> dictionary;
+        std::unordered_map<string, Size> dictionaryIndex;
+        Size size() const;
+        void addString(const string& s);
+    };
+    const Column& column(Size i, ColumnType type) const;
+
     Size i_;
     vector<string> headers_;
     vector<ReportType> columnTypes_;
     vector<Size> columnPrecision_;
-    vector<vector<ReportType>> data_;
+    vector<Column> columns_;
 };
 
 //! InMemoryReport with access to plain types instead of boost::variant<>, to facilitate language bindings
@@ -152,29 +122,26 @@ public:
     std::string header(Size i) const { return imReport_->header(i); }
     // returns: 0 Size, 1 Real, 2 string, 3 Date, 4 Period
     Size columnType(Size i) const { return imReport_->columnType(i).which(); }
-    vector<int> dataAsSize(Size i) const { return sizeToInt(data_T<Size>(i, 0)); }
-    vector<Real> dataAsReal(Size i) const { return data_T<Real>(i, 1); }
-    vector<string> dataAsString(Size i) const { return data_T<string>(i, 2); }
-    vector<Date> dataAsDate(Size i) const { return data_T<Date>(i, 3); }
-    vector<Period> dataAsPeriod(Size i) const { return data_T<Period>(i, 4); }
+    vector<int> dataAsSize(Size i) const { return sizeToInt(imReport_->sizeData(i)); }
+    const vector<Real>& dataAsReal(Size i) const { return imReport_->realData(i); }
+    vector<string> dataAsString(Size i) const {
+        vector<string> tmp;
+        tmp.reserve(rows());
+        for (auto const& c : imReport_->stringCodes(i))
+            tmp.push_back(imReport_->stringDictionary(i)[c]);
+        return tmp;
+    }
+    const vector<Date>& dataAsDate(Size i) const { return imReport_->dateData(i); }
+    const vector<Period>& dataAsPeriod(Size i) const { return imReport_->periodData(i); }
     // for convenience, access by row j and column i
-    Size rows() const { return columns() == 0 ? 0 : imReport_->data(0).size(); }
-    int dataAsSize(Size j, Size i) const { return int(boost::get<Size>(imReport_->data(i).at(j))); }
-    Real dataAsReal(Size j, Size i) const { return boost::get<Real>(imReport_->data(i).at(j)); }
-    string dataAsString(Size j, Size i) const { return boost::get<string>(imReport_->data(i).at(j)); }
-    Date dataAsDate(Size j, Size i) const { return boost::get<Date>(imReport_->data(i).at(j)); }
-    Period dataAsPeriod(Size j, Size i) const { return boost::get<Period>(imReport_->data(i).at(j)); }
+    Size rows() const { return imReport_->rows(); }
+    int dataAsSize(Size j, Size i) const { return int(imReport_->sizeData(i).at(j)); }
+    Real dataAsReal(Size j, Size i) const { return imReport_->realData(i).at(j); }
+    string dataAsString(Size j, Size i) const { return imReport_->stringValue(j, i); }
+    Date dataAsDate(Size j, Size i) const { return imReport_->dateData(i).at(j); }
+    Period dataAsPeriod(Size j, Size i) const { return imReport_->periodData(i).at(j); }
 
 private:
-    template <typename T> vector<T> data_T(Size i, Size w) const {
-        QL_REQUIRE(columnType(i) == w,
-                   "PlainTypeInMemoryReport::data_T(column=" << i << ",expectedType=" << w
-                   << "): Type mismatch, have " << columnType(i));
-        vector<T> tmp;
-        for(auto const& d: imReport_->data(i))
-            tmp.push_back(boost::get<T>(d));
-        return tmp;
-    }
     vector<int> sizeToInt(const vector<Size>& v) const {
         return std::vector<int>(std::begin(v), std::end(v));
     }
@@ -37,7 +37,9 @@
 #include <qle/instruments/cashflowresults.hpp>
 #include <qle/time/yearcounter.hpp>
 
-#include <boost/lexical_cast.hpp>
+#include <charconv>
+#include <cerrno>
+#include <cstdlib>
 #include <regex>
 
 using namespace QuantLib;
@@ -49,6 +51,18 @@ using boost::algorithm::to_lower_copy;
 namespace ore {
 namespace data {
 
+namespace {
+// parses [begin, end) as an integer without allocating, an optional sign is accepted as in boost::lexical_cast
+bool parseInteger(const char* begin, const char* end, Integer& result) {
+    if (begin != end && *begin == '+' && std::next(begin) != end && *std::next(begin) != '-')
+        ++begin;
+    if (begin == end)
+        return false;
+    auto r = std::from_chars(begin, end, result);
+    return r.ec == std::errc() && r.ptr == end;
+}
+} // namespace
+
 Date parseDate(const string& s) {
     // TODO: review
 
@@ -60,50 +74,54 @@ Date parseDate(const string& s) {
     QL_REQUIRE((s.size() >= 3 && s.size() <= 6) || s.size() == 8 || s.size() == 10,
                "invalid date format of \"" << s << "\", date string length 8 or 10 or between 3 and 6 required");
 
-    vector<string> tokens;
-    boost::split(tokens, s, boost::is_any_of("-/.:"));
+    // tokens are separated by any of -/.: we only need the positions of the first three separators
+    const char* b = s.data();
+    const char* e = b + s.size();
+    const char* sep[3];
+    Size nSep = 0;
+    for (const char* c = b; c != e && nSep < 3; ++c) {
+        if (*c == '-' || *c == '/' || *c == '.' || *c == ':')
+            sep[nSep++] = c;
+    }
 
-    if (tokens.size() == 1) {
+    Integer y, m, d;
+    if (nSep == 0) {
         if (s.size() == 8) {
             // yyyymmdd
-            int y = parseInteger(s.substr(0, 4));
-            int m = parseInteger(s.substr(4, 2));
-            int d = parseInteger(s.substr(6, 2));
-            return Date(d, Month(m), y);
+            if (parseInteger(b, b + 4, y) && parseInteger(b + 4, b + 6, m) && parseInteger(b + 6, e, d))
+                return Date(d, Month(m), y);
         } else if (s.size() >= 3 && s.size() <= 6) {
             // Excel format
             // Boundaries will be checked by Date constructor
             // Boundaries are minDate = 367 i.e. Jan 1st, 1901
             // and maxDate = 109574 i.e. Dec 31st, 2199
-            BigInteger serial = parseInteger(s);
-            return Date(serial);
+            Integer serial;
+            if (parseInteger(b, e, serial))
+                return Date(static_cast<BigInteger>(serial));
         }
-    } else if (tokens.size() == 3) {
-        if (tokens[0].size() == 4) {
+    } else if (nSep == 2) {
+        if (sep[0] - b == 4) {
             // yyyy-mm-dd
             // yyyy/mm/dd
             // yyyy.mm.dd
-            int y = parseInteger(tokens[0]);
-            int m = parseInteger(tokens[1]);
-            int d = parseInteger(tokens[2]);
-            return Date(d, Month(m), y);
-        } else if (tokens[0].size() == 2) {
+            if (parseInteger(b, sep[0], y) && parseInteger(sep[0] + 1, sep[1], m) && parseInteger(sep[1] + 1, e, d))
+                return Date(d, Month(m), y);
+        } else if (sep[0] - b == 2) {
             // dd-mm-yy
             // dd/mm/yy
             // dd.mm.yy
             // dd-mm-yyyy
             // dd/mm/yyyy
             // dd.mm.yyyy
-            int d = parseInteger(tokens[0]);
-            int m = parseInteger(tokens[1]);
-            int y = parseInteger(tokens[2]);
-            if (y < 100) {
-                if (y > 80)
-                    y += 1900;
-                else
-                    y += 2000;
+            if (parseInteger(b, sep[0], d) && parseInteger(sep[0] + 1, sep[1], m) && parseInteger(sep[1] + 1, e, y)) {
+                if (y < 100) {
+                    if (y > 80)
+                        y += 1900;
+                    else
+                        y += 2000;
+                }
+                return Date(d, Month(m), y);
             }
-            return Date(d, Month(m), y);
         }
     }
 
@@ -111,17 +129,18 @@ Date parseDate(const string& s) {
 }
 
 Real parseReal(const string& s) {
-    try {
-        return std::stod(s);
-    } catch (const std::exception& ex) {
-        QL_FAIL("Failed to parseReal(\"" << s << "\") " << ex.what());
-    }
+    Real result;
+    QL_REQUIRE(tryParseReal(s, result), "Failed to parseReal(\"" << s << "\")");
+    return result;
 }
 
 bool tryParseReal(const string& s, QuantLib::Real& result) {
-    try {
-        result = std::stod(s);
-    } catch (...) {
+    // same conversion as std::stod, but without throwing on failure
+    const char* b = s.c_str();
+    char* e;
+    errno = 0;
+    result = std::strtod(b, &e);
+    if (e == b || errno == ERANGE) {
         result = Null<Real>();
         return false;
     }
@@ -129,11 +148,9 @@ bool tryParseReal(const string& s, QuantLib::Real& result) {
 }
 
 Integer parseInteger(const string& s) {
-    try {
-        return boost::lexical_cast<Integer>(s.c_str());
-    } catch (std::exception& ex) {
-        QL_FAIL("Failed to parseInteger(\"" << s << "\") " << ex.what());
-    }
+    Integer result;
+    QL_REQUIRE(parseInteger(s.data(), s.data() + s.size(), result), "Failed to parseInteger(\"" << s << "\")");
+    return result;
 }
 
 bool parseBool(const string& s) {
@@ -165,7 +182,37 @@ bool isOnePeriod(const string& s) {
     return true;
 }
 
-Period parsePeriod(const string& s) { return PeriodParser::parse(s); }
+Period parsePeriod(const string& s) {
+    // fast path for a single period like 3M, everything else is left to the QuantLib parser
+    if (s.size() >= 2) {
+        TimeUnit units;
+        switch (s.back()) {
+        case 'D':
+        case 'd':
+            units = Days;
+            break;
+        case 'W':
+        case 'w':
+            units = Weeks;
+            break;
+        case 'M':
+        case 'm':
+            units = Months;
+            break;
+        case 'Y':
+        case 'y':
+            units = Years;
+            break;
+        default:
+            return PeriodParser::parse(s);
+        }
+        Integer n;
+        auto r = std::from_chars(s.data(), s.data() + s.size() - 1, n);
+        if (r.ec == std::errc() && r.ptr == s.data() + s.size() - 1)
+            return Period(n, units);
+    }
+    return PeriodParser::parse(s);
+}
 
 BusinessDayConvention parseBusinessDayConvention(const string& s) {
     static map<string, BusinessDayConvention> m = {{"F", Following},
@@ -351,6 +351,32 @@ BOOST_AUTO_TEST_CASE(testIborConventionConstruction7D) {
     testIborIndexConvention("CNY-REPO-7D", "CNY", "A365F", 2, "MF", true, "CNY-REPO-1W");
 }
 
+BOOST_AUTO_TEST_CASE(testConventionsLookup) {
+    BOOST_TEST_MESSAGE("Testing conventions lookup by id, type and FX currency pair");
+
+    Conventions conventions;
+    conventions.add(boost::make_shared<FXConvention>("EUR-USD-FX", "2", "EUR", "USD", "10000", "EUR,USD"));
+    conventions.add(boost::make_shared<FXConvention>("EUR-JPY-FX", "2", "EUR", "JPY", "100", "EUR,JPY"));
+    conventions.add(boost::make_shared<IborIndexConvention>("EUR-EURIBOR-6M", "TARGET", "A360", 2, "MF", false));
+
+    // FX conventions are found for both orders of the currency pair
+    BOOST_CHECK_EQUAL(conventions.getFxConvention("EUR", "USD")->id(), "EUR-USD-FX");
+    BOOST_CHECK_EQUAL(conventions.getFxConvention("USD", "EUR")->id(), "EUR-USD-FX");
+    BOOST_CHECK_EQUAL(conventions.getFxConvention("JPY", "EUR")->id(), "EUR-JPY-FX");
+    BOOST_CHECK_THROW(conventions.getFxConvention("USD", "JPY"), QuantLib::Error);
+
+    // flipped ids are found as well
+    BOOST_CHECK(conventions.has("USD-EUR-FX"));
+    BOOST_CHECK(conventions.has("EUR-EURIBOR-6M", Convention::Type::IborIndex));
+    BOOST_CHECK(!conventions.has("EUR-EURIBOR-6M", Convention::Type::FX));
+    BOOST_CHECK(!conventions.has("EUR-EURIBOR-3M"));
+    BOOST_CHECK_THROW(conventions.get("EUR-EURIBOR-3M"), QuantLib::Error);
+
+    BOOST_CHECK_EQUAL(conventions.get(Convention::Type::FX).size(), 2);
+    BOOST_CHECK_EQUAL(conventions.get(Convention::Type::IborIndex).size(), 1);
+    BOOST_CHECK(conventions.get(Convention::Type::OIS).empty());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
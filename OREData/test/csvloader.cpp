@@ -0,0 +1,120 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+#include <fstream>
+#include <ored/marketdata/csvloader.hpp>
+#include <oret/toplevelfixture.hpp>
+
+using namespace QuantLib;
+using namespace ore::data;
+using namespace std;
+
+namespace {
+
+// writes the given lines to a temporary file which is removed on destruction
+struct TempFile {
+    explicit TempFile(const vector<string>& lines)
+        : path((boost::filesystem::temp_directory_path() / boost::filesystem::unique_path()).string()) {
+        ofstream file(path);
+        for (auto const& l : lines)
+            file << l << "\n";
+    }
+    ~TempFile() { boost::filesystem::remove(path); }
+    string path;
+};
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREDataTestSuite, ore::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(CSVLoaderTests)
+
+BOOST_AUTO_TEST_CASE(testDuplicates) {
+
+    BOOST_TEST_MESSAGE("Testing CSVLoader with duplicate quotes and fixings...");
+
+    Settings::instance().evaluationDate() = Date(3, Jan, 2023);
+
+    TempFile market({"2023-01-03 FX/RATE/EUR/USD 1.05", "2023-01-03 FX/RATE/EUR/USD 1.10",
+                     "2023-01-03 FX/RATE/EUR/GBP 0.88"});
+    TempFile fixings({"2023-01-02 EUR-EURIBOR-6M 0.025", "2023-01-02 EUR-EURIBOR-6M 0.030"});
+    CSVLoader loader(market.path, fixings.path);
+
+    Date asof(3, Jan, 2023);
+    BOOST_CHECK_EQUAL(loader.loadQuotes(asof).size(), 2);
+    // the first entry wins
+    BOOST_CHECK_EQUAL(loader.get("FX/RATE/EUR/USD", asof)->quote()->value(), 1.05);
+    BOOST_CHECK_EQUAL(loader.get("FX/RATE/EUR/GBP", asof)->quote()->value(), 0.88);
+
+    auto f = loader.loadFixings();
+    BOOST_REQUIRE_EQUAL(f.size(), 1);
+    BOOST_CHECK_EQUAL(f.begin()->fixing, 0.025);
+}
+
+BOOST_AUTO_TEST_CASE(testBadLines) {
+
+    BOOST_TEST_MESSAGE("Testing CSVLoader with invalid lines and quotes...");
+
+    Settings::instance().evaluationDate() = Date(3, Jan, 2023);
+
+    TempFile fixings(vector<string>{});
+    Date asof(3, Jan, 2023);
+
+    // quotes which can not be parsed are skipped, comments and blank lines are ignored
+    TempFile market({"# a comment", "", "2023-01-03 FX/RATE/EUR 1.05", "2023-01-03,FX/RATE/EUR/USD;1.10",
+                     "  2023-01-03\tFX/RATE/EUR/GBP   0.88  "});
+    CSVLoader loader(market.path, fixings.path);
+    BOOST_CHECK_EQUAL(loader.loadQuotes(asof).size(), 2);
+    BOOST_CHECK_THROW(loader.get("FX/RATE/EUR", asof), QuantLib::Error);
+    BOOST_CHECK_EQUAL(loader.get("FX/RATE/EUR/USD", asof)->quote()->value(), 1.10);
+    BOOST_CHECK_EQUAL(loader.get("FX/RATE/EUR/GBP", asof)->quote()->value(), 0.88);
+    BOOST_CHECK_EQUAL(loader.get(set<string>{"FX/RATE/EUR", "FX/RATE/EUR/USD"}, asof).size(), 1);
+    BOOST_CHECK_EQUAL(loader.get(Wildcard("FX/RATE/EUR*"), asof).size(), 2);
+
+    // lines with a wrong number of tokens, invalid dates or invalid values are errors
+    TempFile tokens({"2023-01-03 FX/RATE/EUR/USD"});
+    BOOST_CHECK_THROW(CSVLoader(tokens.path, fixings.path), QuantLib::Error);
+    TempFile date({"2023-13-03 FX/RATE/EUR/USD 1.10"});
+    BOOST_CHECK_THROW(CSVLoader(date.path, fixings.path), QuantLib::Error);
+    TempFile value({"2023-01-03 FX/RATE/EUR/USD abc"});
+    BOOST_CHECK_THROW(CSVLoader(value.path, fixings.path), QuantLib::Error);
+}
+
+BOOST_AUTO_TEST_CASE(testHasQuotes) {
+
+    BOOST_TEST_MESSAGE("Testing CSVLoader::hasQuotes...");
+
+    Settings::instance().evaluationDate() = Date(3, Jan, 2023);
+
+    TempFile market({"2023-01-02 FX/RATE/EUR 1.05", "2023-01-02 MM/RATE/EUR 0.01", "2023-01-03 FX/RATE/EUR 1.05",
+                     "2023-01-03 FX/RATE/EUR/USD 1.10"});
+    TempFile fixings(vector<string>{});
+    CSVLoader loader(market.path, fixings.path);
+
+    // no quote on 2023-01-02 can be parsed
+    BOOST_CHECK(!loader.hasQuotes(Date(2, Jan, 2023)));
+    BOOST_CHECK(loader.loadQuotes(Date(2, Jan, 2023)).empty());
+    BOOST_CHECK(loader.hasQuotes(Date(3, Jan, 2023)));
+    BOOST_CHECK(!loader.hasQuotes(Date(4, Jan, 2023)));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,117 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/make_shared.hpp>
+#include <boost/test/unit_test.hpp>
+#include <ored/report/inmemoryreport.hpp>
+#include <oret/toplevelfixture.hpp>
+
+using namespace QuantLib;
+using namespace ore::data;
+using namespace std;
+
+namespace {
+void fillReport(InMemoryReport& report, Size offset) {
+    for (Size i = 0; i < 5; ++i) {
+        report.next()
+            .add(offset + i)
+            .add(static_cast<Real>(offset + i) * 1.5)
+            .add(i % 2 == 0 ? string("even") : string("odd"))
+            .add(Date(1, Jan, 2023) + static_cast<Integer>(offset + i))
+            .add((offset + i) * Months);
+    }
+    report.end();
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREDataTestSuite, ore::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(InMemoryReportTests)
+
+BOOST_AUTO_TEST_CASE(testColumnarStorage) {
+
+    BOOST_TEST_MESSAGE("Testing columnar storage of InMemoryReport...");
+
+    InMemoryReport report;
+    report.addColumn("Index", Size())
+        .addColumn("Value", Real(), 2)
+        .addColumn("Label", string())
+        .addColumn("Date", Date())
+        .addColumn("Tenor", Period());
+    fillReport(report, 0);
+
+    BOOST_REQUIRE_EQUAL(report.columns(), 5);
+    BOOST_REQUIRE_EQUAL(report.rows(), 5);
+    BOOST_CHECK_EQUAL(report.sizeData(0)[3], 3);
+    BOOST_CHECK_CLOSE(report.realData(1)[3], 4.5, 1E-12);
+    BOOST_CHECK_EQUAL(report.stringValue(3, 2), "odd");
+    BOOST_CHECK_EQUAL(report.dateData(3)[3], Date(4, Jan, 2023));
+    BOOST_CHECK_EQUAL(report.periodData(4)[3], 3 * Months);
+
+    // strings are dictionary encoded
+    BOOST_CHECK_EQUAL(report.stringDictionary(2).size(), 2);
+    BOOST_CHECK_EQUAL(report.stringCodes(2).size(), 5);
+
+    // variant access
+    BOOST_CHECK_EQUAL(boost::get<string>(report.value(4, 2)), "even");
+    vector<Report::ReportType> data = report.data(1);
+    BOOST_REQUIRE_EQUAL(data.size(), 5);
+    BOOST_CHECK_CLOSE(boost::get<Real>(data[2]), 3.0, 1E-12);
+
+    // type mismatches
+    BOOST_CHECK_THROW(report.realData(0), QuantLib::Error);
+    BOOST_CHECK_THROW(report.next().add(string("wrong type")), QuantLib::Error);
+}
+
+BOOST_AUTO_TEST_CASE(testAppendReport) {
+
+    BOOST_TEST_MESSAGE("Testing appending an InMemoryReport to another one...");
+
+    InMemoryReport report1, report2;
+    for (auto r : {&report1, &report2}) {
+        r->addColumn("Index", Size())
+            .addColumn("Value", Real(), 2)
+            .addColumn("Label", string())
+            .addColumn("Date", Date())
+            .addColumn("Tenor", Period());
+    }
+    fillReport(report1, 0);
+    fillReport(report2, 5);
+    report2.next().add(Size(10)).add(0.0).add(string("new")).add(Date(1, Feb, 2023)).add(1 * Years);
+    report2.end();
+
+    report1.add(report2);
+
+    BOOST_REQUIRE_EQUAL(report1.rows(), 11);
+    for (Size i = 0; i < 10; ++i) {
+        BOOST_CHECK_EQUAL(report1.sizeData(0)[i], i);
+        BOOST_CHECK_EQUAL(report1.stringValue(i, 2), i % 5 % 2 == 0 ? "even" : "odd");
+    }
+    BOOST_CHECK_EQUAL(report1.stringValue(10, 2), "new");
+    BOOST_CHECK_EQUAL(report1.stringDictionary(2).size(), 3);
+
+    PlainInMemoryReport plain(boost::make_shared<InMemoryReport>(report1));
+    BOOST_CHECK_EQUAL(plain.rows(), 11);
+    BOOST_CHECK_EQUAL(plain.dataAsString(2).at(10), "new");
+    BOOST_CHECK_EQUAL(plain.dataAsSize(7, 0), 7);
+    BOOST_CHECK_EQUAL(plain.dataAsDate(3).at(10), Date(1, Feb, 2023));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
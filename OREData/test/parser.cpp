@@ -18,6 +18,7 @@
 */
 
 #include <boost/test/unit_test.hpp>
+#include <boost/timer/timer.hpp>
 #include <iostream>
 #include <ored/marketdata/marketdatumparser.hpp>
 #include <ored/utilities/parsers.hpp>
@@ -332,6 +333,62 @@ BOOST_AUTO_TEST_CASE(testDatePeriodParsing) {
     BOOST_CHECK_THROW(ore::data::parseDateOrPeriod("xx17-06-05", d, p, isDate), QuantLib::Error);
 }
 
+BOOST_AUTO_TEST_CASE(testParserPerformance) {
+
+    BOOST_TEST_MESSAGE("Testing performance of date, period and real parsing...");
+
+    // inputs as they appear in trade and market data files
+    std::vector<std::string> dates = {"2017-06-05", "20170605", "05/06/2017", "05.06.17", "42891"};
+    std::vector<std::string> periods = {"3M", "10Y", "1W", "2D", "1Y6M", "-6M"};
+    std::vector<std::string> reals = {"0.0125", "-1.5E-4", "100", "12345.678", "1e10"};
+    std::vector<std::string> invalidReals = {"", "abc", "1e999"};
+
+    const Size n = 100000;
+    Size count = 0;
+
+    boost::timer::cpu_timer timer;
+    for (Size i = 0; i < n; ++i) {
+        for (auto const& s : dates)
+            count += ore::data::parseDate(s) != Date() ? 1 : 0;
+    }
+    Real dateTime = timer.elapsed().wall * 1e-6;
+
+    timer.start();
+    for (Size i = 0; i < n; ++i) {
+        for (auto const& s : periods)
+            count += ore::data::parsePeriod(s).length() != 0 ? 1 : 0;
+    }
+    Real periodTime = timer.elapsed().wall * 1e-6;
+
+    timer.start();
+    Real sum = 0.0, r;
+    for (Size i = 0; i < n; ++i) {
+        for (auto const& s : reals)
+            sum += ore::data::parseReal(s);
+        for (auto const& s : invalidReals)
+            count += ore::data::tryParseReal(s, r) ? 0 : 1;
+    }
+    Real realTime = timer.elapsed().wall * 1e-6;
+
+    BOOST_TEST_MESSAGE("parseDate   : " << n * dates.size() << " calls in " << dateTime << " ms");
+    BOOST_TEST_MESSAGE("parsePeriod : " << n * periods.size() << " calls in " << periodTime << " ms");
+    BOOST_TEST_MESSAGE("parseReal   : " << n * (reals.size() + invalidReals.size()) << " calls in " << realTime
+                                        << " ms");
+
+    BOOST_CHECK_EQUAL(count, n * (dates.size() + periods.size() + invalidReals.size()));
+    BOOST_CHECK_CLOSE(sum, n * (0.0125 - 1.5E-4 + 100.0 + 12345.678 + 1E10), 1E-8);
+
+    // the fast paths agree with the general parsers
+    BOOST_CHECK_EQUAL(ore::data::parseDate("42891"), Date(5, Jun, 2017));
+    BOOST_CHECK_EQUAL(ore::data::parsePeriod("-6M"), -6 * Months);
+    BOOST_CHECK_EQUAL(ore::data::parsePeriod("10Y"), 10 * Years);
+    BOOST_CHECK_EQUAL(ore::data::parseInteger("+42"), 42);
+    BOOST_CHECK_THROW(ore::data::parseInteger("42x"), QuantLib::Error);
+    BOOST_CHECK_THROW(ore::data::parseReal("abc"), QuantLib::Error);
+    BOOST_CHECK(!ore::data::tryParseReal("1e999", r));
+    BOOST_CHECK(r == Null<Real>());
+}
+
 BOOST_AUTO_TEST_CASE(testMarketDatumParsing) {
 
     BOOST_TEST_MESSAGE("Testing market datum parsing...");
@@ -38,9 +38,11 @@
 */
 
 #include <qle/cashflows/overnightindexedcoupon.hpp>
+#include <qle/indexes/fallbackovernightindex.hpp>
 
 #include <ql/cashflows/cashflowvectors.hpp>
 #include <ql/cashflows/couponpricer.hpp>
+#include <ql/indexes/indexmanager.hpp>
 #include <ql/termstructures/yieldtermstructure.hpp>
 #include <ql/time/calendars/weekendsonly.hpp>
 #include <ql/utilities/vectors.hpp>
@@ -64,6 +66,12 @@ OvernightIndexedCoupon::OvernightIndexedCoupon(const Date& paymentDate, Real nom
       overnightIndex_(overnightIndex), includeSpread_(includeSpread), lookback_(lookback), rateCutoff_(rateCutoff),
       rateComputationStartDate_(rateComputationStartDate), rateComputationEndDate_(rateComputationEndDate) {
 
+    // observe the fixing history to validate the cached past fixings, see compute() in the pricer
+    if (!boost::dynamic_pointer_cast<FallbackOvernightIndex>(overnightIndex)) {
+        fixingHistoryObserver_ = boost::make_shared<FixingHistoryObserver>();
+        fixingHistoryObserver_->registerWith(IndexManager::instance().notifier(overnightIndex->name()));
+    }
+
     Date valueStart = rateComputationStartDate_ == Null<Date>() ? startDate : rateComputationStartDate_;
     Date valueEnd = rateComputationEndDate_ == Null<Date>() ? endDate : rateComputationEndDate_;
     if (lookback != 0 * Days) {
@@ -205,23 +213,59 @@ void OvernightIndexedCouponPricer::compute() const {
                                                           << ")");
     Size nCutoff = n - coupon_->rateCutoff();
 
-    Real compoundFactor = 1.0, compoundFactorWithoutSpread = 1.0;
-
-    // already fixed part
-    Date today = Settings::instance().evaluationDate();
-    while (i < n && fixingDates[std::min(i, nCutoff)] < today) {
-        // rate must have been fixed
-        Rate pastFixing = index->pastFixing(fixingDates[std::min(i, nCutoff)]);
-        QL_REQUIRE(pastFixing != Null<Real>(),
-                   "Missing " << index->name() << " fixing for " << fixingDates[std::min(i, nCutoff)]);
-        if (coupon_->includeSpread()) {
-            compoundFactorWithoutSpread *= (1.0 + pastFixing * dt[i]);
-            pastFixing += coupon_->spread();
+    // already fixed part, the past fixings and the compounded factors over them are cached in the coupon and
+    // extended when the evaluation date moves forward
+    std::vector<Real>& pastFixings = coupon_->pastFixings_;
+    std::vector<Real>& pastFactors = coupon_->pastCompoundFactors_;
+    std::vector<Real>& pastFactorsWithoutSpread = coupon_->pastCompoundFactorsWithoutSpread_;
+    if (coupon_->fixingHistoryObserver_ == nullptr) {
+        pastFixings.clear();
+        pastFactors.resize(1);
+        pastFactorsWithoutSpread.resize(1);
+    } else if (coupon_->fixingHistoryObserver_->changed) {
+        // the fixing history has changed, if it has grown and the last cached fixing is unchanged, fixings were added
+        // after the cached ones (e.g. by the FixingManager) and the cache is kept, otherwise keep the cache up to the
+        // first fixing that differs from the history
+        const TimeSeries<Real>& history = index->timeSeries();
+        Size k = pastFixings.size();
+        if (k > 0 && (history.size() <= coupon_->pastFixingsHistorySize_ ||
+                      history[fixingDates[std::min(k - 1, nCutoff)]] != pastFixings.back())) {
+            k = 0;
+            while (k < pastFixings.size() && history[fixingDates[std::min(k, nCutoff)]] == pastFixings[k])
+                ++k;
+            pastFixings.resize(k);
+            pastFactors.resize(k + 1);
+            pastFactorsWithoutSpread.resize(k + 1);
         }
-        compoundFactor *= (1.0 + pastFixing * dt[i]);
+        coupon_->pastFixingsHistorySize_ = history.size();
+        coupon_->fixingHistoryObserver_->changed = false;
+    }
+    Date today = Settings::instance().evaluationDate();
+    Size nCached = pastFixings.size();
+    while (i < nCached && fixingDates[std::min(i, nCutoff)] < today)
         ++i;
+    if (i == nCached && i < n && fixingDates[std::min(i, nCutoff)] < today) {
+        if (coupon_->fixingHistoryObserver_ != nullptr)
+            coupon_->pastFixingsHistorySize_ = index->timeSeries().size();
+        while (i < n && fixingDates[std::min(i, nCutoff)] < today) {
+            // rate must have been fixed
+            Rate pastFixing = index->pastFixing(fixingDates[std::min(i, nCutoff)]);
+            QL_REQUIRE(pastFixing != Null<Real>(),
+                       "Missing " << index->name() << " fixing for " << fixingDates[std::min(i, nCutoff)]);
+            pastFixings.push_back(pastFixing);
+            Real factorWithoutSpread = pastFactorsWithoutSpread.back();
+            if (coupon_->includeSpread()) {
+                factorWithoutSpread *= (1.0 + pastFixing * dt[i]);
+                pastFixing += coupon_->spread();
+            }
+            pastFactors.push_back(pastFactors.back() * (1.0 + pastFixing * dt[i]));
+            pastFactorsWithoutSpread.push_back(factorWithoutSpread);
+            ++i;
+        }
     }
 
+    Real compoundFactor = pastFactors[i], compoundFactorWithoutSpread = pastFactorsWithoutSpread[i];
+
     // today is a border case
     if (i < n && fixingDates[std::min(i, nCutoff)] == today) {
         // might have been fixed
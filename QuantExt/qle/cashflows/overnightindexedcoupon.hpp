@@ -68,6 +68,13 @@ using namespace QuantLib;
 
     if includeSpread = true, the spread is included in the daily compounding,
     otherwise it is added to the effective coupon rate after the compounding
+
+    The past fixings and the compounded factor over the fixings before the evaluation date are cached in the coupon
+    and extended incrementally as the evaluation date moves forward. When the index' fixing history in the
+    IndexManager changes and has grown while the last cached fixing is unchanged (e.g. the FixingManager adds
+    simulated fixings), the cache is kept. Otherwise it is checked against the history and truncated at the first
+    differing fixing. Fallback overnight indices are not cached, since their past fixings depend on other indices
+    and on the evaluation date.
 */
 class OvernightIndexedCoupon : public FloatingRateCoupon {
 public:
@@ -118,6 +125,7 @@ public:
     void accept(AcyclicVisitor&) override;
     //@}
 private:
+    friend class OvernightIndexedCouponPricer;
     boost::shared_ptr<OvernightIndex> overnightIndex_;
     std::vector<Date> valueDates_, fixingDates_;
     mutable std::vector<Rate> fixings_;
@@ -127,6 +135,17 @@ private:
     Period lookback_;
     Natural rateCutoff_;
     Date rateComputationStartDate_, rateComputationEndDate_;
+    //! flags changes of the fixing history of the index in the IndexManager
+    class FixingHistoryObserver : public Observer {
+    public:
+        void update() override { changed = true; }
+        bool changed = false;
+    };
+    // cached past fixings and compounded factors over the first i past fixings, null observer if not cached
+    boost::shared_ptr<FixingHistoryObserver> fixingHistoryObserver_;
+    mutable std::vector<Real> pastFixings_, pastCompoundFactors_ = {1.0}, pastCompoundFactorsWithoutSpread_ = {1.0};
+    // size of the fixing history the cached past fixings were last read from or checked against
+    mutable Size pastFixingsHistorySize_ = 0;
 };
 
 //! OvernightIndexedCoupon pricer
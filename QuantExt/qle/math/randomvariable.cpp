@@ -246,6 +246,16 @@ void RandomVariable::expand() {
     data_.resize(size(), data_.front());
 }
 
+Real* RandomVariable::data() {
+    QL_REQUIRE(!deterministic_, "RandomVariable::data(): deterministic variable does not provide data access");
+    return data_.data();
+}
+
+const Real* RandomVariable::data() const {
+    QL_REQUIRE(!deterministic_, "RandomVariable::data(): deterministic variable does not provide data access");
+    return data_.data();
+}
+
 // Real* RandomVariable::begin() {
 //     QL_REQUIRE(!deterministic_, "Deterministic_ RandomVariable does not provide iterators");
 //     return &data_.front();
@@ -138,6 +138,10 @@ struct RandomVariable {
 
     void expand();
 
+    // direct access to the samples, only for non-deterministic variables, call expand() before if necessary
+    Real* data();
+    const Real* data() const;
+
     static std::function<void(RandomVariable&)> deleter;
 
 private:
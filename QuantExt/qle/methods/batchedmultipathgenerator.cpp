@@ -0,0 +1,129 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/methods/batchedmultipathgenerator.hpp>
+
+#include <algorithm>
+
+namespace QuantExt {
+
+BatchedMultiPathGenerator::BatchedMultiPathGenerator(const SequenceType s,
+                                                     const boost::shared_ptr<StochasticProcess>& process,
+                                                     const TimeGrid& timeGrid, const BigNatural seed,
+                                                     const SobolBrownianGenerator::Ordering ordering,
+                                                     const SobolRsg::DirectionIntegers directionIntegers,
+                                                     const Size batchSize)
+    : process_(boost::dynamic_pointer_cast<CrossAssetStateProcess>(process)), timeGrid_(timeGrid),
+      batchSize_(batchSize), next_(MultiPath(process->size(), timeGrid), 1.0) {
+    QL_REQUIRE(process_, "BatchedMultiPathGenerator: CrossAssetStateProcess required");
+    QL_REQUIRE(timeGrid_.size() > 1, "BatchedMultiPathGenerator: time grid must contain at least one time step");
+    QL_REQUIRE(batchSize_ > 0, "BatchedMultiPathGenerator: batch size must be positive");
+    variateGenerator_ =
+        makeMultiPathVariateGenerator(s, process_->factors(), timeGrid_, seed, ordering, directionIntegers);
+    reset();
+}
+
+void BatchedMultiPathGenerator::nextBatch(const Size n, std::vector<std::vector<RandomVariable>>& paths) const {
+
+    Size steps = timeGrid_.size() - 1;
+    Size factors = process_->factors();
+    Size states = process_->size();
+
+    paths.resize(steps);
+    for (Size j = 0; j < steps; ++j) {
+        paths[j].resize(states);
+        for (Size k = 0; k < states; ++k) {
+            paths[j][k] = RandomVariable(n);
+            paths[j][k].expand();
+        }
+    }
+
+    /* the samples are processed in chunks of at most batchSize_ samples, so that the variates are only held in memory
+       for one chunk and not for all n samples; dw[j][f] holds the variates of factor f for time step j for all
+       samples of the current chunk */
+
+    Array initialValues = process_->initialValues();
+    std::vector<std::vector<RandomVariable>> dw(steps, std::vector<RandomVariable>(factors));
+    std::vector<RandomVariable> x(states), xNext(states);
+
+    for (Size offset = 0; offset < n; offset += batchSize_) {
+        Size m = std::min(batchSize_, n - offset);
+
+        // draw the variates
+
+        for (Size j = 0; j < steps; ++j) {
+            for (Size f = 0; f < factors; ++f) {
+                dw[j][f] = RandomVariable(m);
+                dw[j][f].expand();
+            }
+        }
+        for (Size i = 0; i < m; ++i) {
+            auto v = variateGenerator_->next();
+            for (Size j = 0; j < steps; ++j) {
+                for (Size f = 0; f < factors; ++f) {
+                    dw[j][f].data()[i] = v.value[j][f];
+                }
+            }
+        }
+
+        // evolve the chunk step by step and copy the states into the path buffer
+
+        for (Size k = 0; k < states; ++k)
+            x[k] = RandomVariable(m, initialValues[k]);
+        for (Size j = 0; j < steps; ++j) {
+            process_->evolveBatch(timeGrid_[j], x, timeGrid_.dt(j), dw[j], xNext);
+            for (Size k = 0; k < states; ++k) {
+                Real* target = paths[j][k].data() + offset;
+                for (Size i = 0; i < m; ++i)
+                    target[i] = xNext[k][i];
+            }
+            std::swap(x, xNext);
+        }
+    }
+}
+
+const Sample<MultiPath>& BatchedMultiPathGenerator::next() const {
+    if (currentSample_ == batchSize_ || batch_.empty()) {
+        nextBatch(batchSize_, batch_);
+        currentSample_ = 0;
+    }
+    MultiPath& path = next_.value;
+    Array initialValues = process_->initialValues();
+    for (Size k = 0; k < path.assetNumber(); ++k) {
+        path[k].front() = initialValues[k];
+        for (Size j = 0; j < batch_.size(); ++j) {
+            path[k][j + 1] = batch_[j][k][currentSample_];
+        }
+    }
+    ++currentSample_;
+    return next_;
+}
+
+void BatchedMultiPathGenerator::reset() {
+    variateGenerator_->reset();
+    batch_.clear();
+    currentSample_ = 0;
+}
+
+void BatchedMultiPathGenerator::skipTo(const Size n) {
+    variateGenerator_->skipTo(n);
+    batch_.clear();
+    currentSample_ = 0;
+}
+
+} // namespace QuantExt
@@ -0,0 +1,68 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file batchedmultipathgenerator.hpp
+    \brief multi path generator evolving batches of paths of a cross asset state process
+    \ingroup methods
+*/
+
+#pragma once
+
+#include <qle/math/randomvariable.hpp>
+#include <qle/methods/multipathgeneratorbase.hpp>
+#include <qle/methods/multipathvariategenerator.hpp>
+#include <qle/processes/crossassetstateprocess.hpp>
+
+namespace QuantExt {
+
+/*! Generates paths of a CrossAssetStateProcess in batches. The variates are identical to those used by the generator
+    returned by makeMultiPathGenerator() for the same parameters. For each time step the whole batch is evolved using
+    CrossAssetStateProcess::evolveBatch(), i.e. the paths agree with the ones of the standard generator up to rounding.
+
+    nextBatch() writes the paths into a samples-contiguous buffer, which is the layout consumed by the AMC engines.
+    The variates are drawn and evolved in chunks of at most batchSize samples, so that only the paths and not the
+    variates of all samples are held in memory. The MultiPathGeneratorBase interface is served from an internal batch
+    of the given size. */
+class BatchedMultiPathGenerator : public MultiPathGeneratorBase {
+public:
+    BatchedMultiPathGenerator(const SequenceType s, const boost::shared_ptr<StochasticProcess>& process,
+                              const TimeGrid& timeGrid, const BigNatural seed,
+                              const SobolBrownianGenerator::Ordering ordering = SobolBrownianGenerator::Steps,
+                              const SobolRsg::DirectionIntegers directionIntegers = SobolRsg::JoeKuoD7,
+                              const Size batchSize = 1024);
+
+    /*! Generates the next n paths. On return paths[j][k] holds the value of state variable k at time grid point j + 1
+        for all samples, the buffer is resized if necessary. */
+    void nextBatch(const Size n, std::vector<std::vector<RandomVariable>>& paths) const;
+
+    const Sample<MultiPath>& next() const override;
+    void reset() override;
+    void skipTo(const Size n) override;
+
+private:
+    boost::shared_ptr<CrossAssetStateProcess> process_;
+    TimeGrid timeGrid_;
+    Size batchSize_;
+    boost::shared_ptr<MultiPathVariateGeneratorBase> variateGenerator_;
+
+    mutable std::vector<std::vector<RandomVariable>> batch_;
+    mutable Size currentSample_;
+    mutable Sample<MultiPath> next_;
+};
+
+} // namespace QuantExt
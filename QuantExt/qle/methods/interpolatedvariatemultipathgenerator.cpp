@@ -108,4 +108,6 @@ const Sample<MultiPath>& InterpolatedVariateMultiPathGenerator::next() const {
 
 void InterpolatedVariateMultiPathGenerator::reset() { currentPath_ = 0; }
 
+void InterpolatedVariateMultiPathGenerator::skipTo(const Size n) { currentPath_ = n; }
+
 } // namespace QuantExt
@@ -38,6 +38,7 @@ public:
         const Scheme& scheme = Scheme::Cumulative);
     const Sample<MultiPath>& next() const override;
     void reset() override;
+    void skipTo(const Size n) override;
 
 private:
     const boost::shared_ptr<StochasticProcess> process_;
@@ -20,10 +20,19 @@
 
 #include <boost/make_shared.hpp>
 
+#include <cstdint>
+#include <limits>
+
 using namespace QuantLib;
 
 namespace QuantExt {
 
+void MultiPathGeneratorBase::skipTo(const Size n) {
+    reset();
+    for (Size i = 0; i < n; ++i)
+        next();
+}
+
 MultiPathGeneratorMersenneTwister::MultiPathGeneratorMersenneTwister(
     const boost::shared_ptr<StochasticProcess>& process, const TimeGrid& grid, BigNatural seed, bool antitheticSampling)
     : process_(process), grid_(grid), seed_(seed), antitheticSampling_(antitheticSampling), antitheticVariate_(true) {
@@ -36,6 +45,23 @@ void MultiPathGeneratorMersenneTwister::reset() {
     antitheticVariate_ = true;
 }
 
+void MultiPathGeneratorMersenneTwister::skipTo(const Size n) {
+    // with antithetic sampling the samples 2k and 2k+1 are generated from the same sequence
+    Size dim = process_->factors() * (grid_.size() - 1);
+    Size sequenceIndex = antitheticSampling_ ? n / 2 : n;
+    MersenneTwisterUniformRng rng(seed_);
+    for (Size i = 0; i < sequenceIndex * dim; ++i)
+        rng.nextInt32();
+    pg_ = boost::make_shared<MultiPathGenerator<PseudoRandom::rsg_type> >(
+        process_, grid_, PseudoRandom::rsg_type(RandomSequenceGenerator<MersenneTwisterUniformRng>(dim, rng)), false);
+    antitheticVariate_ = true;
+    if (antitheticSampling_ && n % 2 == 1) {
+        // the next sample is the antithetic path of the current sequence
+        pg_->next();
+        antitheticVariate_ = false;
+    }
+}
+
 MultiPathGeneratorSobol::MultiPathGeneratorSobol(const boost::shared_ptr<StochasticProcess>& process,
                                                  const TimeGrid& grid, BigNatural seed,
                                                  SobolRsg::DirectionIntegers directionIntegers)
@@ -50,6 +76,15 @@ void MultiPathGeneratorSobol::reset() {
             SobolRsg(process_->factors() * (grid_.size() - 1), seed_, directionIntegers_)));
 }
 
+void MultiPathGeneratorSobol::skipTo(const Size n) {
+    QL_REQUIRE(n < std::numeric_limits<std::uint32_t>::max(),
+               "MultiPathGeneratorSobol::skipTo(): sample index " << n << " exceeds Sobol sequence period");
+    SobolRsg rsg(process_->factors() * (grid_.size() - 1), seed_, directionIntegers_);
+    rsg.skipTo(static_cast<std::uint32_t>(n));
+    pg_ = boost::make_shared<MultiPathGenerator<InverseCumulativeRsg<SobolRsg, InverseCumulativeNormal> > >(
+        process_, grid_, InverseCumulativeRsg<SobolRsg, InverseCumulativeNormal>(rsg));
+}
+
 MultiPathGeneratorSobolBrownianBridge::MultiPathGeneratorSobolBrownianBridge(
     const boost::shared_ptr<StochasticProcess>& process, const TimeGrid& grid,
     SobolBrownianGenerator::Ordering ordering, BigNatural seed, SobolRsg::DirectionIntegers directionIntegers)
@@ -63,6 +98,12 @@ void MultiPathGeneratorSobolBrownianBridge::reset() {
                                                       directionIntegers_);
 }
 
+void MultiPathGeneratorSobolBrownianBridge::skipTo(const Size n) {
+    reset();
+    for (Size i = 0; i < n; ++i)
+        gen_->nextPath();
+}
+
 const Sample<MultiPath>& MultiPathGeneratorSobolBrownianBridge::next() const {
     Array asset = process_->initialValues();
     MultiPath& path = next_.value;
@@ -45,6 +45,11 @@ public:
     virtual ~MultiPathGeneratorBase() {}
     virtual const Sample<MultiPath>& next() const = 0;
     virtual void reset() = 0;
+    /*! Positions the generator such that the next call to next() returns the sample with the given (zero based)
+        index, i.e. the same path as the (n+1)th call to next() after reset(). This allows to split a simulation
+        into chunks of samples that are generated independently and still reproduce the paths of a serial run.
+        The default implementation resets the generator and draws n samples. */
+    virtual void skipTo(const Size n);
 };
 
 //! Instantiation of MultiPathGenerator with standard PseudoRandom traits
@@ -56,6 +61,9 @@ public:
                                       bool antitheticSampling = false);
     const Sample<MultiPath>& next() const override;
     void reset() override;
+    /*! advances the Mersenne Twister by the number of uniform draws consumed by the skipped samples, without
+        inverse normal transformation and path evolution */
+    void skipTo(const Size n) override;
 
 private:
     const boost::shared_ptr<StochasticProcess> process_;
@@ -86,6 +94,8 @@ public:
                             SobolRsg::DirectionIntegers directionIntegers = SobolRsg::JoeKuoD7);
     const Sample<MultiPath>& next() const override;
     void reset() override;
+    //! sets the Sobol counter directly to the required sample index
+    void skipTo(const Size n) override;
 
 private:
     const boost::shared_ptr<StochasticProcess> process_;
@@ -107,6 +117,9 @@ public:
                                           SobolRsg::DirectionIntegers directionIntegers = SobolRsg::JoeKuoD7);
     const Sample<MultiPath>& next() const override;
     void reset() override;
+    /*! the Sobol generator inside the SobolBrownianGenerator is not accessible, the skipped samples are drawn and
+        bridged, but no path evolution takes place */
+    void skipTo(const Size n) override;
 
 private:
     const boost::shared_ptr<StochasticProcess> process_;
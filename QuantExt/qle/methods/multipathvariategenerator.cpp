@@ -20,6 +20,9 @@
 
 #include <boost/make_shared.hpp>
 
+#include <cstdint>
+#include <limits>
+
 using namespace QuantLib;
 
 namespace QuantExt {
@@ -41,6 +44,12 @@ Sample<std::vector<Array>> MultiPathVariateGeneratorBase::next() const {
     return result;
 }
 
+void MultiPathVariateGeneratorBase::skipTo(const Size n) {
+    reset();
+    for (Size i = 0; i < n; ++i)
+        next();
+}
+
 MultiPathVariateGeneratorMersenneTwister::MultiPathVariateGeneratorMersenneTwister(const Size dimension,
                                                                                    const TimeGrid& grid,
                                                                                    BigNatural seed,
@@ -59,6 +68,24 @@ void MultiPathVariateGeneratorMersenneTwister::reset() {
     antitheticVariate_ = true;
 }
 
+void MultiPathVariateGeneratorMersenneTwister::skipTo(const Size n) {
+    // with antithetic sampling the samples 2k and 2k+1 are generated from the same sequence
+    Size dim = dimension_ * (grid_.size() - 1);
+    Size sequenceIndex = antitheticSampling_ ? n / 2 : n;
+    MersenneTwisterUniformRng rng(seed_);
+    for (Size i = 0; i < sequenceIndex * dim; ++i)
+        rng.nextInt32();
+    rsg_ = boost::make_shared<
+        InverseCumulativeRsg<RandomSequenceGenerator<MersenneTwisterUniformRng>, InverseCumulativeNormal>>(
+        RandomSequenceGenerator<MersenneTwisterUniformRng>(dim, rng), InverseCumulativeNormal());
+    antitheticVariate_ = true;
+    if (antitheticSampling_ && n % 2 == 1) {
+        // the next sample is the antithetic sample of the current sequence
+        rsg_->nextSequence();
+        antitheticVariate_ = false;
+    }
+}
+
 Sample<std::vector<Real>> MultiPathVariateGeneratorMersenneTwister::nextSequence() const {
     if (antitheticSampling_) {
         antitheticVariate_ = !antitheticVariate_;
@@ -85,6 +112,14 @@ void MultiPathVariateGeneratorSobol::reset() {
         SobolRsg(dimension_ * (grid_.size() - 1), seed_, directionIntegers_), InverseCumulativeNormal());
 }
 
+void MultiPathVariateGeneratorSobol::skipTo(const Size n) {
+    QL_REQUIRE(n < std::numeric_limits<std::uint32_t>::max(),
+               "MultiPathVariateGeneratorSobol::skipTo(): sample index " << n << " exceeds Sobol sequence period");
+    SobolRsg rsg(dimension_ * (grid_.size() - 1), seed_, directionIntegers_);
+    rsg.skipTo(static_cast<std::uint32_t>(n));
+    rsg_ = boost::make_shared<InverseCumulativeRsg<SobolRsg, InverseCumulativeNormal>>(rsg, InverseCumulativeNormal());
+}
+
 Sample<std::vector<Real>> MultiPathVariateGeneratorSobol::nextSequence() const { return rsg_->nextSequence(); }
 
 MultiPathVariateGeneratorSobolBrownianBridge::MultiPathVariateGeneratorSobolBrownianBridge(
@@ -100,6 +135,13 @@ void MultiPathVariateGeneratorSobolBrownianBridge::reset() {
         boost::make_shared<SobolBrownianGenerator>(dimension_, grid_.size() - 1, ordering_, seed_, directionIntegers_);
 }
 
+void MultiPathVariateGeneratorSobolBrownianBridge::skipTo(const Size n) {
+    // the Sobol generator inside the SobolBrownianGenerator is not accessible, so we draw the skipped samples
+    reset();
+    for (Size i = 0; i < n; ++i)
+        gen_->nextPath();
+}
+
 Sample<std::vector<Real>> MultiPathVariateGeneratorSobolBrownianBridge::nextSequence() const {
     // not needed, we directly overwrite next()
     return Sample<std::vector<Real>>(std::vector<Real>(), 0.0);
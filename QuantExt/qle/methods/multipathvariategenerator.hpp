@@ -34,6 +34,8 @@ public:
     virtual ~MultiPathVariateGeneratorBase() {}
     virtual Sample<std::vector<Array>> next() const;
     virtual void reset() = 0;
+    //! same semantics as MultiPathGeneratorBase::skipTo(), the default implementation resets and draws n samples
+    virtual void skipTo(const Size n);
 
 protected:
     virtual Sample<std::vector<Real>> nextSequence() const = 0;
@@ -47,6 +49,7 @@ public:
     MultiPathVariateGeneratorMersenneTwister(const Size dimension, const TimeGrid& grid, BigNatural seed = 0,
                                              bool antitheticSampling = false);
     void reset() override;
+    void skipTo(const Size n) override;
 
 private:
     Sample<std::vector<Real>> nextSequence() const override;
@@ -69,6 +72,7 @@ public:
     MultiPathVariateGeneratorSobol(const Size dimension, const TimeGrid&, BigNatural seed = 0,
                                    SobolRsg::DirectionIntegers directionIntegers = SobolRsg::JoeKuoD7);
     void reset() override;
+    void skipTo(const Size n) override;
 
 private:
     Sample<std::vector<Real>> nextSequence() const override;
@@ -87,6 +91,7 @@ public:
         SobolRsg::DirectionIntegers directionIntegers = SobolRsg::JoeKuoD7);
     Sample<std::vector<Array>> next() const override;
     void reset() override;
+    void skipTo(const Size n) override;
 
 private:
     Sample<std::vector<Real>> nextSequence() const override;
@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include <qle/methods/batchedmultipathgenerator.hpp>
 #include <qle/methods/multipathgeneratorbase.hpp>
 
 namespace QuantExt {
@@ -50,4 +51,24 @@ public:
     }
 };
 
+//! Path generator factory building a BatchedMultiPathGenerator for cross asset state processes
+/*! Other processes fall back to the standard multi path generator. */
+class BatchedMultiPathGeneratorFactory : public PathGeneratorFactory {
+public:
+    explicit BatchedMultiPathGeneratorFactory(const Size batchSize = 1024) : batchSize_(batchSize) {}
+    boost::shared_ptr<MultiPathGeneratorBase> build(const SequenceType s,
+                                                    const boost::shared_ptr<StochasticProcess>& process,
+                                                    const TimeGrid& timeGrid, const BigNatural seed,
+                                                    const SobolBrownianGenerator::Ordering ordering,
+                                                    const SobolRsg::DirectionIntegers directionIntegers) override {
+        if (boost::dynamic_pointer_cast<CrossAssetStateProcess>(process) != nullptr && timeGrid.size() > 1)
+            return boost::make_shared<BatchedMultiPathGenerator>(s, process, timeGrid, seed, ordering,
+                                                                 directionIntegers, batchSize_);
+        return makeMultiPathGenerator(s, process, timeGrid, seed, ordering, directionIntegers);
+    }
+
+private:
+    Size batchSize_;
+};
+
 } // namespace QuantExt
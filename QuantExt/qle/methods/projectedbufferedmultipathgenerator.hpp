@@ -40,6 +40,7 @@ public:
         const boost::shared_ptr<std::vector<std::vector<QuantLib::Path>>>& bufferedPaths);
     const Sample<MultiPath>& next() const override;
     void reset() override;
+    void skipTo(const Size n) override;
 
 private:
     const std::vector<Size> stateProcessProjection_;
@@ -70,4 +70,6 @@ const Sample<MultiPath>& ProjectedVariateMultiPathGenerator::next() const {
 
 void ProjectedVariateMultiPathGenerator::reset() { variateGenerator_->reset(); }
 
+void ProjectedVariateMultiPathGenerator::skipTo(const Size n) { variateGenerator_->skipTo(n); }
+
 } // namespace QuantExt
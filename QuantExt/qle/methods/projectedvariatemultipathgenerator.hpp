@@ -39,6 +39,7 @@ public:
                                        const boost::shared_ptr<MultiPathVariateGeneratorBase>& variateGenerator);
     const Sample<MultiPath>& next() const override;
     void reset() override;
+    void skipTo(const Size n) override;
 
 private:
     const boost::shared_ptr<StochasticProcess> process_;
@@ -0,0 +1,92 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/models/lgmconvolutionrollbackoperator.hpp>
+
+#include <ql/errors.hpp>
+
+#include <boost/make_shared.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace QuantExt {
+
+LgmConvolutionRollbackOperator::LgmConvolutionRollbackOperator(const std::vector<Real>& y, const std::vector<Real>& w,
+                                                               const int mx, const int nx, const Real zeta0,
+                                                               const Real zeta1) {
+    QL_REQUIRE(y.size() == w.size() && !y.empty(), "LgmConvolutionRollbackOperator: y ("
+                                                       << y.size() << ") and w (" << w.size()
+                                                       << ") must have the same non-zero size");
+    QL_REQUIRE(zeta1 > 0.0 && zeta1 >= zeta0, "LgmConvolutionRollbackOperator: zeta1 ("
+                                                  << zeta1 << ") > 0 and zeta1 >= zeta0 (" << zeta0 << ") required");
+
+    Real sigma = std::sqrt(zeta1);
+    Real dx = sigma / static_cast<Real>(nx);
+    Real std = std::sqrt(zeta1 - zeta0);
+    Real dx2 = std::sqrt(zeta0) / static_cast<Real>(nx);
+
+    int my2 = static_cast<int>(y.size()) - 1;
+    int kmin = zeta0 == 0.0 ? mx : 0, kmax = zeta0 == 0.0 ? mx : 2 * mx;
+
+    std::vector<int> kk(y.size());
+    std::vector<Real> kp(y.size());
+    rowStart_.push_back(0);
+    for (int k = kmin; k <= kmax; ++k) {
+        // Map y index to x index, not integer in general, and get the adjacent integer x index <= kp,
+        // kp is increasing in i, so that the x indices touched by row k form a contiguous band
+        for (int i = 0; i <= my2; ++i) {
+            kp[i] = (dx2 * (k - mx) + y[i] * std) / dx + mx;
+            kk[i] = int(std::floor(kp[i]));
+        }
+        int lo = std::min(std::max(kk[0], 0), 2 * mx);
+        int hi = std::min(std::max(kk[my2] + 1, 0), 2 * mx);
+        Size offset = weights_.size();
+        weights_.resize(offset + hi - lo + 1, 0.0);
+        auto c = [this, offset, lo](const int x) -> Real& { return weights_[offset + x - lo]; };
+        // linear interpolation on kk <= kp <= kk + 1 with flat extrapolation
+        for (int i = 0; i <= my2; ++i) {
+            if (kk[i] < 0)
+                c(0) += w[i];
+            else if (kk[i] + 1 > 2 * mx)
+                c(2 * mx) += w[i];
+            else {
+                c(kk[i] + 1) += w[i] * (kp[i] - kk[i]);
+                c(kk[i]) += w[i] * (1.0 + kk[i] - kp[i]);
+            }
+        }
+        first_.push_back(lo);
+        rowStart_.push_back(weights_.size());
+    }
+}
+
+const LgmConvolutionRollbackOperator&
+LgmConvolutionRollbackOperatorCache::get(const std::vector<Real>& y, const std::vector<Real>& w, const int mx,
+                                         const int nx, const Real zeta0, const Real zeta1) {
+    auto key = std::make_pair(zeta0, zeta1);
+    auto it = operators_.find(key);
+    if (it != operators_.end())
+        return *it->second;
+    if (operators_.size() >= maxSize_)
+        operators_.clear();
+    auto op = boost::make_shared<LgmConvolutionRollbackOperator>(y, w, mx, nx, zeta0, zeta1);
+    operators_[key] = op;
+    return *op;
+}
+
+} // namespace QuantExt
@@ -0,0 +1,97 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file lgmconvolutionrollbackoperator.hpp
+    \brief precomputed rollback operator for the LGM convolution solvers
+
+    \ingroup engines
+*/
+
+#pragma once
+
+#include <ql/types.hpp>
+
+#include <boost/shared_ptr.hpp>
+
+#include <map>
+#include <vector>
+
+namespace QuantExt {
+
+using QuantLib::Real;
+using QuantLib::Size;
+
+//! Precomputed rollback operator for the LGM convolution solvers
+/*! The rollback of a deflated NPV vector on the x-grid from t1 to t0 is a linear map. The operator is stored as a
+    sparse matrix with one contiguous band of weights per row, the band starting at x-index first(k) for row k. The
+    weights combine the convolution weights of the y-grid with the linear interpolation weights on the x-grid, so
+    that applying the operator is a dot product per row.
+
+    The operator only depends on the solver grid and on zeta(t0), zeta(t1). If zeta(t0) is zero, the operator has a
+    single row, the rolled back value is then the same for all x-grid points.
+*/
+class LgmConvolutionRollbackOperator {
+public:
+    /*! y, w are the y-grid and convolution weights of the solver, the x-grid has 2 mx + 1 points with nx points
+        per standard deviation */
+    LgmConvolutionRollbackOperator(const std::vector<Real>& y, const std::vector<Real>& w, const int mx, const int nx,
+                                   const Real zeta0, const Real zeta1);
+
+    //! number of rows, this is either 1 or the x-grid size
+    Size rows() const { return first_.size(); }
+
+    //! applies the operator to v, result must have rows() elements
+    template <typename ValueType> void apply(const ValueType* v, ValueType* result, const ValueType& zero) const;
+
+private:
+    std::vector<Size> first_, rowStart_;
+    std::vector<Real> weights_;
+};
+
+//! Cache of rollback operators keyed by (zeta(t0), zeta(t1))
+/*! Under scenario revaluation all trades priced with the same solver share the operators. The cache is cleared
+    once it contains more than maxSize operators. The class is not thread safe. */
+class LgmConvolutionRollbackOperatorCache {
+public:
+    explicit LgmConvolutionRollbackOperatorCache(const Size maxSize = 256) : maxSize_(maxSize) {}
+    const LgmConvolutionRollbackOperator& get(const std::vector<Real>& y, const std::vector<Real>& w, const int mx,
+                                              const int nx, const Real zeta0, const Real zeta1);
+    void clear() { operators_.clear(); }
+    Size size() const { return operators_.size(); }
+
+private:
+    Size maxSize_;
+    std::map<std::pair<Real, Real>, boost::shared_ptr<LgmConvolutionRollbackOperator>> operators_;
+};
+
+// implementation
+
+template <typename ValueType>
+void LgmConvolutionRollbackOperator::apply(const ValueType* v, ValueType* result, const ValueType& zero) const {
+    for (Size k = 0; k < first_.size(); ++k) {
+        ValueType s(zero);
+        const ValueType* x = v + first_[k];
+        const Real* c = &weights_[rowStart_[k]];
+        Size n = rowStart_[k + 1] - rowStart_[k];
+        for (Size j = 0; j < n; ++j)
+            s += c[j] * x[j];
+        result[k] = s;
+    }
+}
+
+} // namespace QuantExt
@@ -26,12 +26,15 @@
 
 #include <qle/math/randomvariable.hpp>
 #include <qle/models/lgm.hpp>
+#include <qle/models/lgmconvolutionrollbackoperator.hpp>
 
 namespace QuantExt {
 
 //! Numerical convolution solver for the LGM model
 /*! Reference: Hagan, Methodology for callable swaps and Bermudan
                exercise into swaptions
+
+    The rollback operators are cached, see LgmConvolutionRollbackOperatorCache.
 */
 
 class LgmConvolutionSolver2 {
@@ -56,6 +59,7 @@ private:
     int mx_, my_, nx_;
     Real h_;
     std::vector<Real> y_, w_;
+    mutable LgmConvolutionRollbackOperatorCache rollbackOperators_;
 };
 
 } // namespace QuantExt
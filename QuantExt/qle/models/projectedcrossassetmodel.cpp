@@ -18,6 +18,8 @@
 
 #include <qle/models/projectedcrossassetmodel.hpp>
 
+#include <algorithm>
+
 namespace QuantExt {
 
 boost::shared_ptr<CrossAssetModel>
@@ -124,4 +126,18 @@ std::vector<Size> getStateProcessProjection(const boost::shared_ptr<CrossAssetMo
     return stateProcessProjection;
 }
 
+std::vector<std::pair<CrossAssetModel::AssetType, Size>>
+getIrFxComponents(const boost::shared_ptr<CrossAssetModel>& model, const std::vector<Currency>& currencies) {
+    std::vector<std::pair<CrossAssetModel::AssetType, Size>> ir, fx;
+    for (Size i = 0; i < model->components(CrossAssetModel::AssetType::IR); ++i) {
+        if (i == 0 || std::find(currencies.begin(), currencies.end(), model->ir(i)->currency()) != currencies.end()) {
+            ir.push_back(std::make_pair(CrossAssetModel::AssetType::IR, i));
+            if (i > 0)
+                fx.push_back(std::make_pair(CrossAssetModel::AssetType::FX, i - 1));
+        }
+    }
+    ir.insert(ir.end(), fx.begin(), fx.end());
+    return ir;
+}
+
 } // namespace QuantExt
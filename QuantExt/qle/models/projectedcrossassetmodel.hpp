@@ -41,4 +41,10 @@ getProjectedCrossAssetModel(const boost::shared_ptr<CrossAssetModel>& model,
 std::vector<Size> getStateProcessProjection(const boost::shared_ptr<CrossAssetModel>& model,
                                             const boost::shared_ptr<CrossAssetModel>& projectedModel);
 
+/* Returns the IR components for the domestic currency of the model and the given currencies and the associated FX
+   components, in the order in which they appear in the model. Further components (INF, CR, EQ, COM) can be appended
+   to the result before passing it to getProjectedCrossAssetModel(). */
+std::vector<std::pair<CrossAssetModel::AssetType, Size>>
+getIrFxComponents(const boost::shared_ptr<CrossAssetModel>& model, const std::vector<Currency>& currencies);
+
 } // namespace QuantExt
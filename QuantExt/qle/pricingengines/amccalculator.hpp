@@ -45,8 +45,8 @@ public:
      */
     virtual std::vector<QuantExt::RandomVariable>
     simulatePath(const std::vector<QuantLib::Real>& pathTimes,
-                 std::vector<std::vector<QuantExt::RandomVariable>>& paths, const std::vector<bool>& isRelevantTime,
-                 const bool stickyCloseOutRun) = 0;
+                 const std::vector<std::vector<QuantExt::RandomVariable>>& paths,
+                 const std::vector<bool>& isRelevantTime, const bool stickyCloseOutRun) = 0;
 };
 
 } // namespace QuantExt
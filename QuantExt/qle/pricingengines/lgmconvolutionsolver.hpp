@@ -25,12 +25,15 @@
 #pragma once
 
 #include <qle/models/lgm.hpp>
+#include <qle/models/lgmconvolutionrollbackoperator.hpp>
 
 namespace QuantExt {
 
 //! Numerical convolution solver for the LGM model
 /*! Reference: Hagan, Methodology for callable swaps and Bermudan
                exercise into swaptions
+
+    The rollback operators are cached, see LgmConvolutionRollbackOperatorCache.
 */
 
 class LgmConvolutionSolver {
@@ -57,6 +60,7 @@ private:
     int mx_, my_, nx_;
     Real h_;
     std::vector<Real> y_, w_;
+    mutable LgmConvolutionRollbackOperatorCache rollbackOperators_;
 };
 
 // rollback implementation
@@ -67,41 +71,21 @@ std::vector<ValueType> LgmConvolutionSolver::rollback(const std::vector<ValueTyp
     if (QuantLib::close_enough(t0, t1))
         return v;
     QL_REQUIRE(t0 < t1, "LgmConvolutionSolver::rollback(): t0 (" << t0 << ") < t1 (" << t1 << ") required.");
-    Real sigma = std::sqrt(model_->parametrization()->zeta(t1));
-    Real dx = sigma / static_cast<Real>(nx_);
-    if (QuantLib::close_enough(t0, 0.0)) {
-        // rollback from t1 to t0 = 0
+    QL_REQUIRE(v.size() == gridSize(), "LgmConvolutionSolver::rollback(): v size (" << v.size()
+                                                                                    << ") must match grid size ("
+                                                                                    << gridSize() << ")");
+    Real zeta0 = QuantLib::close_enough(t0, 0.0) ? 0.0 : model_->parametrization()->zeta(t0);
+    const LgmConvolutionRollbackOperator& op =
+        rollbackOperators_.get(y_, w_, mx_, nx_, zeta0, model_->parametrization()->zeta(t1));
+    if (op.rows() == 1) {
+        // rollback to t0 = 0, the result does not depend on the state
         ValueType value(zero);
-        for (int i = 0; i <= 2 * my_; i++) {
-            // Map y index to x index, not integer in general
-            Real kp = y_[i] * sigma / dx + mx_;
-            // Adjacent integer x index <= k
-            int kk = int(floor(kp));
-            // Get value at kp by linear interpolation on
-            // kk <= kp <= kk + 1 with flat extrapolation
-            value +=
-                w_[i] *
-                (kk < 0 ? v[0] : (kk + 1 > 2 * mx_ ? v[2 * mx_] : (kp - kk) * v[kk + 1] + (1.0 + kk - kp) * v[kk]));
-        }
+        op.apply(v.data(), &value, zero);
         return std::vector<ValueType>(2 * mx_ + 1, value);
     } else {
+        // rollback to t0 > 0
         std::vector<ValueType> value(2 * mx_ + 1, zero);
-        // rollback from t1 to t0 > 0
-        Real std = std::sqrt(model_->parametrization()->zeta(t1) - model_->parametrization()->zeta(t0));
-        Real dx2 = std::sqrt(model_->parametrization()->zeta(t0)) / static_cast<Real>(nx_);
-        for (int k = 0; k <= 2 * mx_; k++) {
-            for (int i = 0; i <= 2 * my_; i++) {
-                // Map y index to x index, not integer in generalTo
-                Real kp = (dx2 * (k - mx_) + y_[i] * std) / dx + mx_;
-                // Adjacent integer x index <= k
-                int kk = int(floor(kp));
-                // Get value at kp by linear interpolation on
-                // kk <= kp <= kk + 1 with flat extrapolation
-                value[k] +=
-                    w_[i] *
-                    (kk < 0 ? v[0] : (kk + 1 > 2 * mx_ ? v[2 * mx_] : (kp - kk) * v[kk + 1] + (1.0 + kk - kp) * v[kk]));
-            }
-        }
+        op.apply(v.data(), value.data(), zero);
         return value;
     }
 }
@@ -0,0 +1,78 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/pricingengines/mccamcommodityforwardengine.hpp>
+
+#include <qle/cashflows/indexedcoupon.hpp>
+
+#include <ql/cashflows/simplecashflow.hpp>
+
+namespace QuantExt {
+
+using namespace QuantLib;
+
+McCamCommodityForwardEngine::McCamCommodityForwardEngine(
+    const Handle<CrossAssetModel>& model, const SequenceType calibrationPathGenerator,
+    const SequenceType pricingPathGenerator, const Size calibrationSamples, const Size pricingSamples,
+    const Size calibrationSeed, const Size pricingSeed, const Size polynomOrder,
+    const LsmBasisSystem::PolynomialType polynomType, const SobolBrownianGenerator::Ordering ordering,
+    const SobolRsg::DirectionIntegers directionIntegers, const std::vector<Handle<YieldTermStructure>>& discountCurves,
+    const std::vector<Date>& simulationDates, const std::vector<Size>& externalModelIndices, const bool minimalObsDate)
+    : McMultiLegBaseEngine(model, calibrationPathGenerator, pricingPathGenerator, calibrationSamples, pricingSamples,
+                           calibrationSeed, pricingSeed, polynomOrder, polynomType, ordering, directionIntegers,
+                           discountCurves, simulationDates, externalModelIndices, minimalObsDate) {
+    registerWith(model_);
+    for (auto const& h : discountCurves)
+        registerWith(h);
+}
+
+void McCamCommodityForwardEngine::calculate() const {
+
+    QL_REQUIRE(arguments_.fxIndex == nullptr || arguments_.payCcy == arguments_.currency,
+               "McCamCommodityForwardEngine: non deliverable forwards are not supported");
+
+    Date maturity = arguments_.maturityDate;
+    Date payDate = maturity;
+    if (!arguments_.physicallySettled && arguments_.paymentDate != Date())
+        payDate = arguments_.paymentDate;
+
+    Real w = arguments_.position == Position::Long ? 1.0 : -1.0;
+
+    // the long position receives quantity x F(maturity) and pays quantity x strike on the payment date
+    Leg underlyingLeg{boost::make_shared<IndexWrappedCashFlow>(boost::make_shared<SimpleCashFlow>(1.0, payDate),
+                                                               w * arguments_.quantity, arguments_.index, maturity)};
+    Leg strikeLeg{boost::make_shared<SimpleCashFlow>(-w * arguments_.quantity * arguments_.strike, payDate)};
+
+    leg_ = {underlyingLeg, strikeLeg};
+    currency_ = {arguments_.currency, arguments_.currency};
+    payer_ = {1.0, 1.0};
+    exercise_ = nullptr;
+
+    McMultiLegBaseEngine::calculate();
+
+    // convert base ccy result from McMultiLegbaseEngine to the commodity currency
+    Real fxSpot = 1.0;
+    Size npvCcyIndex = model_->ccyIndex(arguments_.currency);
+    if (npvCcyIndex > 0)
+        fxSpot = model_->fxbs(npvCcyIndex - 1)->fxSpotToday()->value();
+    results_.value = resultValue_ / fxSpot;
+    results_.additionalResults["amcCalculator"] = amcCalculator();
+
+} // calculate
+
+} // namespace QuantExt
@@ -0,0 +1,88 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/pricingengines/mccamcommodityoptionengine.hpp>
+
+#include <qle/cashflows/indexedcoupon.hpp>
+
+#include <ql/cashflows/simplecashflow.hpp>
+
+namespace QuantExt {
+
+using namespace QuantLib;
+
+McCamCommodityOptionEngine::McCamCommodityOptionEngine(
+    const Handle<CrossAssetModel>& model, const boost::shared_ptr<CommodityIndex>& commodityIndex,
+    const Currency& commodityCcy, const Currency& npvCcy, const SequenceType calibrationPathGenerator,
+    const SequenceType pricingPathGenerator, const Size calibrationSamples, const Size pricingSamples,
+    const Size calibrationSeed, const Size pricingSeed, const Size polynomOrder,
+    const LsmBasisSystem::PolynomialType polynomType, const SobolBrownianGenerator::Ordering ordering,
+    const SobolRsg::DirectionIntegers directionIntegers, const std::vector<Handle<YieldTermStructure>>& discountCurves,
+    const std::vector<Date>& simulationDates, const std::vector<Size>& externalModelIndices, const bool minimalObsDate)
+    : McMultiLegBaseEngine(model, calibrationPathGenerator, pricingPathGenerator, calibrationSamples, pricingSamples,
+                           calibrationSeed, pricingSeed, polynomOrder, polynomType, ordering, directionIntegers,
+                           discountCurves, simulationDates, externalModelIndices, minimalObsDate),
+      commodityIndex_(commodityIndex), commodityCcy_(commodityCcy), npvCcy_(npvCcy) {
+    registerWith(model_);
+    registerWith(commodityIndex_);
+    for (auto const& h : discountCurves)
+        registerWith(h);
+}
+
+void McCamCommodityOptionEngine::calculate() const {
+
+    auto payoff = boost::dynamic_pointer_cast<StrikedTypePayoff>(arguments_.payoff);
+    QL_REQUIRE(payoff, "McCamCommodityOptionEngine: non-striked payoff given");
+    QL_REQUIRE(arguments_.exercise->type() == Exercise::European, "McCamCommodityOptionEngine: not an European option");
+    QL_REQUIRE(!arguments_.exercise->dates().empty(), "McCamCommodityOptionEngine: exercise dates are empty");
+
+    // use the future expiring on the forward date, if given
+    boost::shared_ptr<CommodityIndex> index = commodityIndex_;
+    if (arguments_.forwardDate != Date())
+        index = boost::make_shared<CommodityFuturesIndex>(commodityIndex_->underlyingName(), arguments_.forwardDate,
+                                                          commodityIndex_->fixingCalendar(),
+                                                          commodityIndex_->priceCurve());
+
+    // as in the fx option engine, the payment is shifted by one day so that it lies after the exercise date
+    Date expiryDate = arguments_.exercise->dates().front();
+    Date payDate = expiryDate + 1;
+
+    Real w = payoff->optionType() == Option::Call ? 1.0 : -1.0;
+    Leg underlyingLeg{
+        boost::make_shared<IndexWrappedCashFlow>(boost::make_shared<SimpleCashFlow>(w, payDate), 1.0, index, expiryDate)};
+    Leg strikeLeg{boost::make_shared<SimpleCashFlow>(-w * payoff->strike(), payDate)};
+
+    leg_ = {underlyingLeg, strikeLeg};
+    currency_ = {commodityCcy_, commodityCcy_};
+    payer_ = {1.0, 1.0};
+    exercise_ = arguments_.exercise;
+    optionSettlement_ = Settlement::Cash;
+
+    McMultiLegBaseEngine::calculate();
+
+    // convert base ccy result from McMultiLegbaseEngine to desired npv currency
+    Real fxSpot = 1.0;
+    Size npvCcyIndex = model_->ccyIndex(npvCcy_);
+    if (npvCcyIndex > 0)
+        fxSpot = model_->fxbs(npvCcyIndex - 1)->fxSpotToday()->value();
+    results_.value = resultValue_ / fxSpot;
+    results_.additionalResults["underlyingNpv"] = resultUnderlyingNpv_ / fxSpot;
+    results_.additionalResults["amcCalculator"] = amcCalculator();
+} // calculate
+
+} // namespace QuantExt
@@ -0,0 +1,60 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file mccamcommodityoptionengine.hpp
+    \brief MC CAM engine for European Commodity Option instrument
+*/
+
+#pragma once
+
+#include <qle/pricingengines/mcmultilegbaseengine.hpp>
+
+#include <qle/indexes/commodityindex.hpp>
+#include <qle/instruments/vanillaforwardoption.hpp>
+#include <qle/methods/multipathgeneratorbase.hpp>
+#include <qle/models/crossassetmodel.hpp>
+
+namespace QuantExt {
+
+class McCamCommodityOptionEngine : public McMultiLegBaseEngine, public VanillaForwardOption::engine {
+public:
+    /*! this engine works as QuantLib::AnalyticsEuropeanEngine, so that it is compatible with the ORE CommodityOption
+        trade builder, i.e. for a call the commodity price at expiry is received and strike is paid. If the instrument
+        is a VanillaForwardOption, the price of the future expiring on the forward date is used, otherwise the spot
+        price. */
+    McCamCommodityOptionEngine(
+        const Handle<CrossAssetModel>& model, const boost::shared_ptr<CommodityIndex>& commodityIndex,
+        const Currency& commodityCcy, const Currency& npvCcy, const SequenceType calibrationPathGenerator,
+        const SequenceType pricingPathGenerator, const Size calibrationSamples, const Size pricingSamples,
+        const Size calibrationSeed, const Size pricingSeed, const Size polynomOrder,
+        const LsmBasisSystem::PolynomialType polynomType,
+        const SobolBrownianGenerator::Ordering ordering = SobolBrownianGenerator::Steps,
+        const SobolRsg::DirectionIntegers directionIntegers = SobolRsg::JoeKuoD7,
+        const std::vector<Handle<YieldTermStructure>>& discountCurves = std::vector<Handle<YieldTermStructure>>(),
+        const std::vector<Date>& simulationDates = std::vector<Date>(),
+        const std::vector<Size>& externalModelIndices = std::vector<Size>(), const bool minimalObsDate = true);
+
+    void calculate() const override;
+    const Handle<CrossAssetModel>& model() const { return model_; }
+
+private:
+    const boost::shared_ptr<CommodityIndex> commodityIndex_;
+    const Currency commodityCcy_, npvCcy_;
+};
+
+} // namespace QuantExt
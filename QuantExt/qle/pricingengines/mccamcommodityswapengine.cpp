@@ -0,0 +1,59 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/pricingengines/mccamcommodityswapengine.hpp>
+
+namespace QuantExt {
+
+using namespace QuantLib;
+
+McCamCommoditySwapEngine::McCamCommoditySwapEngine(
+    const Handle<CrossAssetModel>& model, const Currency& ccy, const SequenceType calibrationPathGenerator,
+    const SequenceType pricingPathGenerator, const Size calibrationSamples, const Size pricingSamples,
+    const Size calibrationSeed, const Size pricingSeed, const Size polynomOrder,
+    const LsmBasisSystem::PolynomialType polynomType, const SobolBrownianGenerator::Ordering ordering,
+    const SobolRsg::DirectionIntegers directionIntegers, const std::vector<Handle<YieldTermStructure>>& discountCurves,
+    const std::vector<Date>& simulationDates, const std::vector<Size>& externalModelIndices, const bool minimalObsDate)
+    : McMultiLegBaseEngine(model, calibrationPathGenerator, pricingPathGenerator, calibrationSamples, pricingSamples,
+                           calibrationSeed, pricingSeed, polynomOrder, polynomType, ordering, directionIntegers,
+                           discountCurves, simulationDates, externalModelIndices, minimalObsDate),
+      ccy_(ccy) {
+    registerWith(model_);
+    for (auto const& h : discountCurves)
+        registerWith(h);
+}
+
+void McCamCommoditySwapEngine::calculate() const {
+
+    leg_ = arguments_.legs;
+    currency_ = std::vector<Currency>(leg_.size(), ccy_);
+    payer_ = arguments_.payer;
+    exercise_ = nullptr;
+
+    McMultiLegBaseEngine::calculate();
+
+    // convert base ccy result from McMultiLegbaseEngine to the swap currency
+    Real fxSpot = 1.0;
+    Size npvCcyIndex = model_->ccyIndex(ccy_);
+    if (npvCcyIndex > 0)
+        fxSpot = model_->fxbs(npvCcyIndex - 1)->fxSpotToday()->value();
+    results_.value = resultValue_ / fxSpot;
+    results_.additionalResults["amcCalculator"] = amcCalculator();
+} // calculate
+
+} // namespace QuantExt
@@ -0,0 +1,58 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file mccamequityoptionengine.hpp
+    \brief MC CAM engine for European Equity Option instrument
+*/
+
+#pragma once
+
+#include <qle/pricingengines/mcmultilegbaseengine.hpp>
+
+#include <qle/indexes/equityindex.hpp>
+#include <qle/methods/multipathgeneratorbase.hpp>
+#include <qle/models/crossassetmodel.hpp>
+
+#include <ql/instruments/vanillaoption.hpp>
+
+namespace QuantExt {
+
+class McCamEquityOptionEngine : public McMultiLegBaseEngine, public VanillaOption::engine {
+public:
+    /*! this engine works as QuantLib::AnalyticsEuropeanEngine, so that it is compatible with the ORE EquityOption
+        trade builder, i.e. for a call S(expiry) is received and strike is paid, for one unit of the underlying */
+    McCamEquityOptionEngine(
+        const Handle<CrossAssetModel>& model, const boost::shared_ptr<EquityIndex2>& equityIndex,
+        const Currency& npvCcy, const SequenceType calibrationPathGenerator, const SequenceType pricingPathGenerator,
+        const Size calibrationSamples, const Size pricingSamples, const Size calibrationSeed, const Size pricingSeed,
+        const Size polynomOrder, const LsmBasisSystem::PolynomialType polynomType,
+        const SobolBrownianGenerator::Ordering ordering = SobolBrownianGenerator::Steps,
+        const SobolRsg::DirectionIntegers directionIntegers = SobolRsg::JoeKuoD7,
+        const std::vector<Handle<YieldTermStructure>>& discountCurves = std::vector<Handle<YieldTermStructure>>(),
+        const std::vector<Date>& simulationDates = std::vector<Date>(),
+        const std::vector<Size>& externalModelIndices = std::vector<Size>(), const bool minimalObsDate = true);
+
+    void calculate() const override;
+    const Handle<CrossAssetModel>& model() const { return model_; }
+
+private:
+    const boost::shared_ptr<EquityIndex2> equityIndex_;
+    const Currency npvCcy_;
+};
+
+} // namespace QuantExt
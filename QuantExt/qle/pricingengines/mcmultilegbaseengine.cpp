@@ -18,13 +18,18 @@
 
 #include <qle/cashflows/averageonindexedcoupon.hpp>
 #include <qle/cashflows/cappedflooredaveragebmacoupon.hpp>
+#include <qle/cashflows/commodityindexedaveragecashflow.hpp>
+#include <qle/cashflows/commodityindexedcashflow.hpp>
 #include <qle/cashflows/fixedratefxlinkednotionalcoupon.hpp>
 #include <qle/cashflows/floatingratefxlinkednotionalcoupon.hpp>
 #include <qle/cashflows/fxlinkedcashflow.hpp>
 #include <qle/cashflows/indexedcoupon.hpp>
 #include <qle/cashflows/overnightindexedcoupon.hpp>
 #include <qle/cashflows/subperiodscoupon.hpp>
+#include <qle/indexes/commodityindex.hpp>
+#include <qle/indexes/equityindex.hpp>
 #include <qle/math/randomvariablelsmbasissystem.hpp>
+#include <qle/methods/batchedmultipathgenerator.hpp>
 #include <qle/pricingengines/mcmultilegbaseengine.hpp>
 
 #include <ql/cashflows/averagebmacoupon.hpp>
@@ -135,6 +140,120 @@ McMultiLegBaseEngine::CashflowInfo McMultiLegBaseEngine::createCashflowInfo(boos
         };
     }
 
+    // handle equity or commodity index wrapped fixed amount cashflows
+
+    if (auto iwcf = boost::dynamic_pointer_cast<IndexWrappedCashFlow>(flow)) {
+        QL_REQUIRE(boost::dynamic_pointer_cast<SimpleCashFlow>(iwcf->underlying()) != nullptr ||
+                       boost::dynamic_pointer_cast<FixedRateCoupon>(iwcf->underlying()) != nullptr,
+                   "McMultiLegBaseEngine::createCashflowInfo(): index wrapped cashflow in leg "
+                       << legNo << " cashflow " << cfNo << " must wrap a fixed amount cashflow");
+        Real baseAmount = iwcf->underlying()->amount() * iwcf->quantity();
+        Date fixingDate = iwcf->fixingDate();
+        if (iwcf->index() == nullptr || fixingDate <= today_) {
+            info.amountCalculator = [iwcf](const Size n, const std::vector<std::vector<const RandomVariable*>>& states) {
+                return RandomVariable(n, iwcf->amount());
+            };
+            return info;
+        }
+        Real simTime = time(fixingDate);
+        if (auto eq = boost::dynamic_pointer_cast<EquityIndex2>(iwcf->index())) {
+            Size eqIdx = model_->eqIndex(eq->name());
+            info.simulationTimes.push_back(simTime);
+            info.modelIndices.push_back({model_->pIdx(CrossAssetModel::AssetType::EQ, eqIdx)});
+            info.amountCalculator = [baseAmount](const Size n,
+                                                 const std::vector<std::vector<const RandomVariable*>>& states) {
+                return RandomVariable(n, baseAmount) * exp(*states.at(0).at(0));
+            };
+            return info;
+        }
+        if (auto com = boost::dynamic_pointer_cast<CommodityIndex>(iwcf->index())) {
+            Size comIdx = model_->comIndex(com->underlyingName());
+            Real expiryTime = com->isFuturesIndex() ? std::max(simTime, time(com->expiryDate())) : simTime;
+            info.simulationTimes.push_back(simTime);
+            info.modelIndices.push_back({});
+            for (Size j = 0; j < model_->stateVariables(CrossAssetModel::AssetType::COM, comIdx); ++j)
+                info.modelIndices.back().push_back(model_->pIdx(CrossAssetModel::AssetType::COM, comIdx, j));
+            info.amountCalculator = [this, baseAmount, comIdx, simTime, expiryTime](
+                                        const Size n, const std::vector<std::vector<const RandomVariable*>>& states) {
+                return RandomVariable(n, baseAmount) * commodityForwardPrice(comIdx, simTime, expiryTime, states.at(0));
+            };
+            return info;
+        }
+        QL_FAIL("McMultiLegBaseEngine::createCashflowInfo(): index wrapped cashflow in leg "
+                << legNo << " cashflow " << cfNo << " has unsupported index " << iwcf->index()->name());
+    }
+
+    // handle commodity cashflows, future pricing dates are projected from the first future pricing date
+
+    if (auto ccf = boost::dynamic_pointer_cast<CommodityCashFlow>(flow)) {
+        QL_REQUIRE(ccf->fxIndex() == nullptr, "McMultiLegBaseEngine::createCashflowInfo(): commodity cashflow in leg "
+                                                  << legNo << " cashflow " << cfNo
+                                                  << " has an fx index, this is not supported.");
+        auto indexed = boost::dynamic_pointer_cast<CommodityIndexedCashFlow>(ccf);
+        auto average = boost::dynamic_pointer_cast<CommodityIndexedAverageCashFlow>(ccf);
+        QL_REQUIRE(indexed != nullptr || average != nullptr,
+                   "McMultiLegBaseEngine::createCashflowInfo(): unhandled commodity cashflow in leg "
+                       << legNo << " cashflow " << cfNo);
+        QL_REQUIRE(indexed == nullptr || !indexed->isAveragingFrontMonthCashflow(today_),
+                   "McMultiLegBaseEngine::createCashflowInfo(): averaging front month commodity cashflow in leg "
+                       << legNo << " cashflow " << cfNo << " is not supported.");
+        QL_REQUIRE(average == nullptr || !average->offPeakPowerData(),
+                   "McMultiLegBaseEngine::createCashflowInfo(): off peak power commodity cashflow in leg "
+                       << legNo << " cashflow " << cfNo << " is not supported.");
+
+        // for indexed cashflows only the last entry (the pricing date / index pair) is relevant
+        std::vector<std::pair<Date, boost::shared_ptr<CommodityIndex>>> fixings;
+        if (indexed)
+            fixings.push_back(ccf->indices().back());
+        else
+            fixings = ccf->indices();
+        QL_REQUIRE(!fixings.empty(), "McMultiLegBaseEngine::createCashflowInfo(): commodity cashflow in leg "
+                                         << legNo << " cashflow " << cfNo << " has no pricing dates");
+
+        Real pastPriceSum = 0.0;
+        std::vector<Real> futureExpiryTimes;
+        Date firstFuturePricingDate;
+        for (auto const& f : fixings) {
+            if (f.first <= today_) {
+                pastPriceSum += f.second->fixing(f.first);
+            } else {
+                if (firstFuturePricingDate == Date())
+                    firstFuturePricingDate = f.first;
+                futureExpiryTimes.push_back(f.second->isFuturesIndex() ? time(f.second->expiryDate())
+                                                                       : time(f.first));
+            }
+        }
+
+        Real simTime = Null<Real>();
+        Size comIdx = Null<Size>();
+        if (firstFuturePricingDate != Date()) {
+            simTime = time(firstFuturePricingDate);
+            comIdx = model_->comIndex(ccf->index()->underlyingName());
+            info.simulationTimes.push_back(simTime);
+            info.modelIndices.push_back({});
+            for (Size j = 0; j < model_->stateVariables(CrossAssetModel::AssetType::COM, comIdx); ++j)
+                info.modelIndices.back().push_back(model_->pIdx(CrossAssetModel::AssetType::COM, comIdx, j));
+        }
+
+        Real nFixings = static_cast<Real>(fixings.size());
+        Real quantity = ccf->periodQuantity(), gearing = ccf->gearing(), spread = ccf->spread();
+        bool isIndexed = indexed != nullptr;
+        info.amountCalculator = [this, comIdx, simTime, futureExpiryTimes, pastPriceSum, nFixings, quantity, gearing,
+                                 spread, isIndexed](const Size n,
+                                                    const std::vector<std::vector<const RandomVariable*>>& states) {
+            RandomVariable price(n, pastPriceSum);
+            for (auto const& T : futureExpiryTimes)
+                price += commodityForwardPrice(comIdx, simTime, std::max(simTime, T), states.at(0));
+            price /= RandomVariable(n, nFixings);
+            // consistent with CommodityIndexedCashFlow resp. CommodityIndexedAverageCashFlow::performCalculations()
+            if (isIndexed)
+                return RandomVariable(n, quantity * gearing) * (price + RandomVariable(n, spread));
+            return RandomVariable(n, quantity) * (RandomVariable(n, gearing) * price + RandomVariable(n, spread));
+        };
+
+        return info;
+    }
+
     // handle some wrapped coupon types: extract the wrapper info and continue with underlying flow
 
     bool isCapFloored = false;
@@ -576,6 +695,21 @@ McMultiLegBaseEngine::CashflowInfo McMultiLegBaseEngine::createCashflowInfo(boos
     QL_FAIL("McMultiLegBaseEngine::createCashflowInfo(): unhandled coupon leg " << legNo << " cashflow " << cfNo);
 } // createCashflowInfo()
 
+RandomVariable McMultiLegBaseEngine::commodityForwardPrice(const Size comIdx, const Real t, const Real T,
+                                                           const std::vector<const RandomVariable*>& states) const {
+    QL_REQUIRE(!states.empty(), "McMultiLegBaseEngine::commodityForwardPrice(): no states given");
+    Size n = states.front()->size();
+    auto comModel = model_->comModel(comIdx);
+    RandomVariable result(n);
+    Array x(states.size());
+    for (Size k = 0; k < n; ++k) {
+        for (Size j = 0; j < states.size(); ++j)
+            x[j] = (*states[j])[k];
+        result.set(k, comModel->forwardPrice(t, T, x));
+    }
+    return result;
+}
+
 Size McMultiLegBaseEngine::timeIndex(const Time t, const std::set<Real>& times) const {
     auto it = times.find(t);
     QL_REQUIRE(it != times.end(), "McMultiLegBaseEngine::cashflowPathValue(): time ("
@@ -711,22 +845,12 @@ void McMultiLegBaseEngine::calculate() const {
 
     QL_REQUIRE(!simulationTimes.empty(),
                "McMultiLegBaseEngine::calculate(): no simulation times, this is not expected.");
-    std::vector<std::vector<RandomVariable>> pathValues(
-        simulationTimes.size(),
-        std::vector<RandomVariable>(model_->stateProcess()->size(), RandomVariable(calibrationSamples_)));
+    std::vector<std::vector<RandomVariable>> pathValues;
 
     TimeGrid timeGrid(simulationTimes.begin(), simulationTimes.end());
-    auto pathGenerator = makeMultiPathGenerator(calibrationPathGenerator_, model_->stateProcess(), timeGrid,
-                                                calibrationSeed_, ordering_, directionIntegers_);
-
-    for (Size i = 0; i < calibrationSamples_; ++i) {
-        MultiPath path = pathGenerator->next().value;
-        for (Size j = 0; j < simulationTimes.size(); ++j) {
-            for (Size k = 0; k < model_->stateProcess()->size(); ++k) {
-                pathValues[j][k].set(i, path[k][j + 1]);
-            }
-        }
-    }
+    BatchedMultiPathGenerator pathGenerator(calibrationPathGenerator_, model_->stateProcess(), timeGrid,
+                                            calibrationSeed_, ordering_, directionIntegers_);
+    pathGenerator.nextBatch(calibrationSamples_, pathValues);
 
     // for each xva and exercise time collect the relevant cashflow amounts and train a model on them
 
@@ -848,7 +972,7 @@ MultiLegBaseAmcCalculator::MultiLegBaseAmcCalculator(
 
 std::vector<QuantExt::RandomVariable>
 MultiLegBaseAmcCalculator::simulatePath(const std::vector<QuantLib::Real>& pathTimes,
-                                        std::vector<std::vector<QuantExt::RandomVariable>>& paths,
+                                        const std::vector<std::vector<QuantExt::RandomVariable>>& paths,
                                         const std::vector<bool>& isRelevantTime, const bool stickyCloseOutRun) {
 
     // check input path consistency
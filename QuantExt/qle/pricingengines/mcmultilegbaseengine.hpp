@@ -110,6 +110,10 @@ private:
     CashflowInfo createCashflowInfo(boost::shared_ptr<CashFlow> flow, const Currency& payCcy, Real payer, Size legNo,
                                     Size cfNo) const;
 
+    // commodity forward price F(t,T) of a commodity component, given the component's states at t
+    RandomVariable commodityForwardPrice(const Size comIdx, const Real t, const Real T,
+                                         const std::vector<const RandomVariable*>& states) const;
+
     // get the index of a time in the given simulation times set
     Size timeIndex(const Time t, const std::set<Real>& simulationTimes) const;
 
@@ -136,7 +140,7 @@ public:
 
     Currency npvCurrency() override { return baseCurrency_; }
     std::vector<QuantExt::RandomVariable> simulatePath(const std::vector<QuantLib::Real>& pathTimes,
-                                                       std::vector<std::vector<QuantExt::RandomVariable>>& paths,
+                                                       const std::vector<std::vector<QuantExt::RandomVariable>>& paths,
                                                        const std::vector<bool>& isRelevantTime,
                                                        const bool stickyCloseOutRun) override;
 
@@ -50,6 +50,19 @@ inline void setValue2(Matrix& m, const Real& value, const QuantExt::CrossAssetMo
     Size j = model->wIdx(t2, i2, offset2);
     m[i][j] = value;
 }
+
+// y += a * x for all samples
+inline void addScaled(Real* y, const Real a, const RandomVariable& x, const Size samples) {
+    if (x.deterministic()) {
+        Real v = a * x[0];
+        for (Size i = 0; i < samples; ++i)
+            y[i] += v;
+    } else {
+        const Real* xd = x.data();
+        for (Size i = 0; i < samples; ++i)
+            y[i] += a * xd[i];
+    }
+}
 } // anonymous namespace
 
 CrossAssetStateProcess::CrossAssetStateProcess(const CrossAssetModel* const model)
@@ -559,6 +572,48 @@ Array CrossAssetStateProcess::evolve(Time t0, const Array& x0, Time dt, const Ar
     return res;
 }
 
+void CrossAssetStateProcess::evolveBatch(Time t0, const std::vector<RandomVariable>& x0, Time dt,
+                                         const std::vector<RandomVariable>& dw,
+                                         std::vector<RandomVariable>& x1) const {
+
+    QL_REQUIRE(x0.size() == size(), "CrossAssetStateProcess::evolveBatch(): x0 size ("
+                                        << x0.size() << ") does not match process size (" << size() << ")");
+    QL_REQUIRE(dw.size() == factors(), "CrossAssetStateProcess::evolveBatch(): dw size ("
+                                           << dw.size() << ") does not match number of factors (" << factors()
+                                           << ")");
+    QL_REQUIRE(!dw.empty(), "CrossAssetStateProcess::evolveBatch(): no factors");
+
+    x1.resize(size());
+
+    if (auto exact = boost::dynamic_pointer_cast<CrossAssetStateProcess::ExactDiscretization>(discretization_)) {
+        QL_REQUIRE(cirppCount_ == 0, "only euler discretization is supported for CIR++");
+        exact->evolveBatch(*this, t0, x0, dt, dw, x1);
+        return;
+    }
+
+    // fall back to a path wise evolution
+
+    Size samples = dw.front().size();
+    Array x0p(size()), dwp(factors());
+    std::vector<Real*> out(size());
+    for (Size k = 0; k < size(); ++k) {
+        if (x1[k].size() != samples || x1[k].deterministic()) {
+            x1[k] = RandomVariable(samples);
+            x1[k].expand();
+        }
+        out[k] = x1[k].data();
+    }
+    for (Size s = 0; s < samples; ++s) {
+        for (Size k = 0; k < size(); ++k)
+            x0p[k] = x0[k][s];
+        for (Size f = 0; f < factors(); ++f)
+            dwp[f] = dw[f][s];
+        Array r = evolve(t0, x0p, dt, dwp);
+        for (Size k = 0; k < size(); ++k)
+            out[k][s] = r[k];
+    }
+}
+
 CrossAssetStateProcess::ExactDiscretization::ExactDiscretization(const CrossAssetModel* const model,
                                                                  SalvagingAlgorithm::Type salvaging)
     : model_(model), salvaging_(salvaging) {
@@ -950,10 +1005,74 @@ Matrix CrossAssetStateProcess::ExactDiscretization::covarianceImpl(const Stochas
     return res;
 }
 
+Matrix CrossAssetStateProcess::ExactDiscretization::driftMatrix(const StochasticProcess& p, Time t0, Time dt) const {
+    cache_key k = {t0, dt};
+    auto i = cache_a_.find(k);
+    if (i == cache_a_.end()) {
+        // driftImpl2 is linear in x0, so we get the columns of the matrix by applying it to the unit vectors
+        Matrix res(model_->dimension(), model_->dimension(), 0.0);
+        Array e(model_->dimension(), 0.0);
+        for (Size c = 0; c < model_->dimension(); ++c) {
+            e[c] = 1.0;
+            Array col = driftImpl2(p, t0, e, dt);
+            std::copy(col.begin(), col.end(), res.column_begin(c));
+            e[c] = 0.0;
+        }
+        cache_a_.insert(std::make_pair(k, res));
+        return res;
+    } else {
+        return i->second;
+    }
+}
+
+void CrossAssetStateProcess::ExactDiscretization::evolveBatch(const StochasticProcess& p, Time t0,
+                                                              const std::vector<RandomVariable>& x0, Time dt,
+                                                              const std::vector<RandomVariable>& dw,
+                                                              std::vector<RandomVariable>& x1) const {
+    Size dim = model_->dimension();
+    Size samples = dw.front().size();
+
+    // x1 = m + A x0 + D dw with the state independent part m of the expectation, the matrix representation A of the
+    // state dependent part and the diffusion D, all of them only depend on t0, dt and are cached
+
+    Array m;
+    cache_key k = {t0, dt};
+    auto i = cache_m_.find(k);
+    if (i == cache_m_.end()) {
+        m = driftImpl1(p, t0, Array(), dt);
+        cache_m_.insert(std::make_pair(k, m));
+    } else {
+        m = i->second;
+    }
+    Matrix A = driftMatrix(p, t0, dt);
+    Matrix D = diffusion(p, t0, Array(dim, 0.0), dt);
+    QL_REQUIRE(D.columns() == dw.size(), "CrossAssetStateProcess::ExactDiscretization::evolveBatch(): diffusion has "
+                                             << D.columns() << " columns, but " << dw.size() << " factors given");
+
+    for (Size r = 0; r < dim; ++r) {
+        RandomVariable& y = x1[r];
+        if (y.size() != samples || y.deterministic()) {
+            y = RandomVariable(samples);
+            y.expand();
+        }
+        Real* yd = y.data();
+        std::fill(yd, yd + samples, m[r]);
+        for (Size c = 0; c < dim; ++c) {
+            if (A[r][c] != 0.0)
+                addScaled(yd, A[r][c], x0[c], samples);
+        }
+        for (Size c = 0; c < D.columns(); ++c) {
+            if (D[r][c] != 0.0)
+                addScaled(yd, D[r][c], dw[c], samples);
+        }
+    }
+}
+
 void CrossAssetStateProcess::ExactDiscretization::flushCache() const {
     cache_m_.clear();
     cache_v_.clear();
     cache_d_.clear();
+    cache_a_.clear();
 }
 
 } // namespace QuantExt
@@ -25,6 +25,8 @@
 #ifndef quantext_crossasset_stateprocess_hpp
 #define quantext_crossasset_stateprocess_hpp
 
+#include <qle/math/randomvariable.hpp>
+
 #include <ql/math/matrixutilities/pseudosqrt.hpp>
 #include <ql/stochasticprocess.hpp>
 
@@ -54,6 +56,13 @@ public:
     /*! specific members */
     virtual void flushCache() const;
 
+    /*! Evolves a batch of paths by one time step. The states x0, x1 and the variates dw hold all samples per state
+        variable resp. factor contiguously, x1 is resized if necessary and must not alias x0. For the exact
+        discretization the step is computed as dense matrix operations on the whole batch, which reproduces evolve()
+        up to rounding, otherwise evolve() is called for each sample. */
+    virtual void evolveBatch(Time t0, const std::vector<RandomVariable>& x0, Time dt,
+                             const std::vector<RandomVariable>& dw, std::vector<RandomVariable>& x1) const;
+
 protected:
     virtual Matrix diffusionOnCorrelatedBrownians(Time t, const Array& x) const;
     virtual Matrix diffusionOnCorrelatedBrowniansImpl(Time t, const Array& x) const;
@@ -73,12 +82,16 @@ protected:
         virtual Array drift(const StochasticProcess&, Time t0, const Array& x0, Time dt) const override;
         virtual Matrix diffusion(const StochasticProcess&, Time t0, const Array& x0, Time dt) const override;
         virtual Matrix covariance(const StochasticProcess&, Time t0, const Array& x0, Time dt) const override;
+        void evolveBatch(const StochasticProcess&, Time t0, const std::vector<RandomVariable>& x0, Time dt,
+                         const std::vector<RandomVariable>& dw, std::vector<RandomVariable>& x1) const;
         void flushCache() const;
 
     protected:
         virtual Array driftImpl1(const StochasticProcess&, Time t0, const Array& x0, Time dt) const;
         virtual Array driftImpl2(const StochasticProcess&, Time t0, const Array& x0, Time dt) const;
         virtual Matrix covarianceImpl(const StochasticProcess&, Time t0, const Array& x0, Time dt) const;
+        // driftImpl2 is linear in x0, this returns the matrix representation of it
+        Matrix driftMatrix(const StochasticProcess&, Time t0, Time dt) const;
 
         const CrossAssetModel* const model_;
         SalvagingAlgorithm::Type salvaging_;
@@ -98,7 +111,7 @@ protected:
             }
         };
         mutable boost::unordered_map<cache_key, Array, cache_hasher> cache_m_;
-        mutable boost::unordered_map<cache_key, Matrix, cache_hasher> cache_v_, cache_d_;
+        mutable boost::unordered_map<cache_key, Matrix, cache_hasher> cache_v_, cache_d_, cache_a_;
     }; // ExactDiscretization
 
     // cache for process drift and diffusion (e.g. used in Euler discretization)
@@ -238,6 +238,7 @@
 #include <qle/math/randomvariablelsmbasissystem.hpp>
 #include <qle/math/stabilisedglls.hpp>
 #include <qle/math/trace.hpp>
+#include <qle/methods/batchedmultipathgenerator.hpp>
 #include <qle/methods/brownianbridgepathinterpolator.hpp>
 #include <qle/methods/fdmdefaultableequityjumpdiffusionfokkerplanckop.hpp>
 #include <qle/methods/fdmdefaultableequityjumpdiffusionop.hpp>
@@ -309,6 +310,7 @@
 #include <qle/models/jyimpliedzeroinflationtermstructure.hpp>
 #include <qle/models/lgm.hpp>
 #include <qle/models/lgmcalibrationinfo.hpp>
+#include <qle/models/lgmconvolutionrollbackoperator.hpp>
 #include <qle/models/lgmconvolutionsolver2.hpp>
 #include <qle/models/lgmimplieddefaulttermstructure.hpp>
 #include <qle/models/lgmimpliedyieldtermstructure.hpp>
@@ -383,7 +385,12 @@
 #include <qle/pricingengines/inflationcapfloorengines.hpp>
 #include <qle/pricingengines/intrinsicascotengine.hpp>
 #include <qle/pricingengines/lgmconvolutionsolver.hpp>
+#include <qle/pricingengines/mccamcommodityforwardengine.hpp>
+#include <qle/pricingengines/mccamcommodityoptionengine.hpp>
+#include <qle/pricingengines/mccamcommodityswapengine.hpp>
 #include <qle/pricingengines/mccamcurrencyswapengine.hpp>
+#include <qle/pricingengines/mccamequityforwardengine.hpp>
+#include <qle/pricingengines/mccamequityoptionengine.hpp>
 #include <qle/pricingengines/mccamfxforwardengine.hpp>
 #include <qle/pricingengines/mccamfxoptionengine.hpp>
 #include <qle/pricingengines/mclgmswapengine.hpp>
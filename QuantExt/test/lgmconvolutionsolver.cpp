@@ -0,0 +1,94 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "toplevelfixture.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include <qle/models/irlgm1fconstantparametrization.hpp>
+#include <qle/models/lgm.hpp>
+#include <qle/models/lgmconvolutionsolver2.hpp>
+#include <qle/pricingengines/lgmconvolutionsolver.hpp>
+
+#include <ql/currencies/europe.hpp>
+#include <ql/termstructures/yield/flatforward.hpp>
+#include <ql/time/calendars/nullcalendar.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+
+#include <boost/make_shared.hpp>
+
+using namespace QuantLib;
+using namespace QuantExt;
+
+BOOST_FIXTURE_TEST_SUITE(QuantExtTestSuite, qle::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(LgmConvolutionSolverTest)
+
+namespace {
+boost::shared_ptr<LinearGaussMarkovModel> testModel() {
+    Handle<YieldTermStructure> yts(boost::make_shared<FlatForward>(0, NullCalendar(), 0.02, Actual365Fixed()));
+    return boost::make_shared<LinearGaussMarkovModel>(
+        boost::make_shared<IrLgm1fConstantParametrization>(EURCurrency(), yts, 0.01, 0.01));
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(testRollback) {
+
+    BOOST_TEST_MESSAGE("Testing LGM convolution solver rollback...");
+
+    auto model = testModel();
+    LgmConvolutionSolver2 solver(model, 5.0, 10, 5.0, 10);
+    Size n = solver.gridSize(), mx = (n - 1) / 2;
+
+    // the state is a martingale, a constant is preserved
+
+    RandomVariable x1 = solver.stateGrid(5.0);
+    RandomVariable x0 = solver.stateGrid(2.0);
+    RandomVariable c(n, 1.0);
+    c.expand();
+
+    RandomVariable rx = solver.rollback(x1, 5.0, 2.0);
+    RandomVariable rc = solver.rollback(c, 5.0, 2.0);
+    for (Size k = mx / 2; k <= 3 * mx / 2; ++k) {
+        BOOST_CHECK_SMALL(rx[k] - x0[k], 1E-6);
+        BOOST_CHECK_SMALL(rc[k] - 1.0, 1E-6);
+    }
+
+    RandomVariable r0 = solver.rollback(x1, 5.0, 0.0);
+    BOOST_CHECK(r0.deterministic());
+    BOOST_CHECK_SMALL(r0.at(0), 1E-8);
+
+    // a second rollback with the cached operator gives identical results
+
+    RandomVariable rx2 = solver.rollback(x1, 5.0, 2.0);
+    for (Size k = 0; k < n; ++k)
+        BOOST_CHECK_EQUAL(rx2[k], rx[k]);
+
+    // the vector based solver uses the same operators
+
+    LgmConvolutionSolver solver1(model, 5.0, 10, 5.0, 10);
+    std::vector<Real> x1v(n);
+    for (Size k = 0; k < n; ++k)
+        x1v[k] = x1[k];
+    std::vector<Real> rx1 = solver1.rollback(x1v, 5.0, 2.0);
+    for (Size k = 0; k < n; ++k)
+        BOOST_CHECK_EQUAL(rx1[k], rx[k]);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
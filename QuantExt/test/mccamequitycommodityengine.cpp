@@ -0,0 +1,177 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <test/toplevelfixture.hpp>
+
+#include <qle/pricingengines/mccamcommodityforwardengine.hpp>
+#include <qle/pricingengines/mccamcommodityoptionengine.hpp>
+#include <qle/pricingengines/mccamequityforwardengine.hpp>
+#include <qle/pricingengines/mccamequityoptionengine.hpp>
+
+#include <qle/instruments/commodityforward.hpp>
+#include <qle/instruments/equityforward.hpp>
+#include <qle/instruments/vanillaforwardoption.hpp>
+#include <qle/models/commodityschwartzparametrization.hpp>
+#include <qle/models/crossassetmodel.hpp>
+#include <qle/models/eqbsconstantparametrization.hpp>
+#include <qle/models/irlgm1fconstantparametrization.hpp>
+#include <qle/pricingengines/discountingcommodityforwardengine.hpp>
+#include <qle/pricingengines/discountingequityforwardengine.hpp>
+#include <qle/termstructures/pricecurve.hpp>
+
+#include <ql/currencies/europe.hpp>
+#include <ql/exercise.hpp>
+#include <ql/instruments/vanillaoption.hpp>
+#include <ql/math/interpolations/linearinterpolation.hpp>
+#include <ql/pricingengines/blackformula.hpp>
+#include <ql/quotes/simplequote.hpp>
+#include <ql/termstructures/yield/flatforward.hpp>
+#include <ql/time/calendars/nullcalendar.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+
+using namespace QuantLib;
+using namespace QuantExt;
+using namespace boost::unit_test_framework;
+
+namespace {
+
+/* single currency (EUR) model with a LGM component of small volatility, so that the rates are almost deterministic
+   and the AMC prices can be compared to the analytic prices using the initial curves */
+struct AmcEqComTestData : public qle::test::TopLevelFixture {
+    AmcEqComTestData()
+        : refDate(12, January, 2015), yts(boost::make_shared<FlatForward>(refDate, 0.02, Actual365Fixed())),
+          divYts(boost::make_shared<FlatForward>(refDate, 0.01, Actual365Fixed())),
+          eqSpot(boost::make_shared<SimpleQuote>(100.0)), fxSpot(boost::make_shared<SimpleQuote>(1.0)) {
+        Settings::instance().evaluationDate() = refDate;
+        lgm = boost::make_shared<IrLgm1fConstantParametrization>(EURCurrency(), yts, 0.0001, 0.01);
+        eq = boost::make_shared<EqBsConstantParametrization>(EURCurrency(), "EQ1", eqSpot, fxSpot, 0.20, yts, divYts);
+        std::vector<Period> periods{1 * Days, 1 * Years, 2 * Years, 5 * Years, 10 * Years};
+        std::vector<Real> prices{100.0, 101.0, 102.0, 105.0, 110.0};
+        priceCurve = Handle<PriceTermStructure>(
+            boost::make_shared<InterpolatedPriceCurve<Linear>>(periods, prices, Actual365Fixed(), EURCurrency()));
+        com = boost::make_shared<CommoditySchwartzParametrization>(EURCurrency(), "WTI", priceCurve, fxSpot, 0.15,
+                                                                   0.05);
+        model = Handle<CrossAssetModel>(
+            boost::make_shared<CrossAssetModel>(std::vector<boost::shared_ptr<Parametrization>>{lgm, eq, com}));
+        eqIndex = boost::make_shared<EquityIndex2>("EQ1", NullCalendar(), EURCurrency(), eqSpot, yts, divYts);
+        comIndex = boost::make_shared<CommoditySpotIndex>("WTI", NullCalendar(), priceCurve);
+    }
+    SavedSettings backup;
+    Date refDate;
+    Handle<YieldTermStructure> yts, divYts;
+    Handle<Quote> eqSpot, fxSpot;
+    Handle<PriceTermStructure> priceCurve;
+    boost::shared_ptr<IrLgm1fConstantParametrization> lgm;
+    boost::shared_ptr<EqBsConstantParametrization> eq;
+    boost::shared_ptr<CommoditySchwartzParametrization> com;
+    Handle<CrossAssetModel> model;
+    boost::shared_ptr<EquityIndex2> eqIndex;
+    boost::shared_ptr<CommoditySpotIndex> comIndex;
+}; // AmcEqComTestData
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OreAmcTestSuite, qle::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(AmcMcCamEquityCommodityEngineTest)
+
+BOOST_FIXTURE_TEST_CASE(testEquityForward, AmcEqComTestData) {
+
+    BOOST_TEST_MESSAGE("Testing pricing of equity forward with AMC engine vs discounting engine");
+
+    EquityForward fwd("EQ1", EURCurrency(), Position::Long, 10.0, Date(12, January, 2020), 95.0);
+
+    fwd.setPricingEngine(boost::make_shared<DiscountingEquityForwardEngine>(yts, divYts, eqSpot, yts));
+    Real npv0 = fwd.NPV();
+
+    fwd.setPricingEngine(boost::make_shared<McCamEquityForwardEngine>(
+        model, eqIndex, SobolBrownianBridge, SobolBrownianBridge, 10000, 10000, 42, 42, 4, LsmBasisSystem::Monomial));
+    Real npv1 = fwd.NPV();
+
+    BOOST_TEST_MESSAGE("npv (discounting engine) = " << npv0 << ", npv (amc engine) = " << npv1);
+    BOOST_CHECK_SMALL(npv1 - npv0, 0.01 * std::abs(npv0));
+}
+
+BOOST_FIXTURE_TEST_CASE(testEquityOption, AmcEqComTestData) {
+
+    BOOST_TEST_MESSAGE("Testing pricing of european equity option with AMC engine vs Black formula");
+
+    Date expiry(12, January, 2020);
+    Real strike = 100.0;
+    VanillaOption option(boost::make_shared<PlainVanillaPayoff>(Option::Call, strike),
+                         boost::make_shared<EuropeanExercise>(expiry));
+
+    // the amc engine pays on expiry + 1
+    Real t = yts->timeFromReference(expiry);
+    Real forward = eqSpot->value() * divYts->discount(expiry) / yts->discount(expiry);
+    Real npv0 = blackFormula(Option::Call, strike, forward, 0.20 * std::sqrt(t), yts->discount(expiry + 1));
+
+    option.setPricingEngine(boost::make_shared<McCamEquityOptionEngine>(model, eqIndex, EURCurrency(),
+                                                                        SobolBrownianBridge, SobolBrownianBridge, 10000,
+                                                                        10000, 42, 42, 4, LsmBasisSystem::Monomial));
+    Real npv1 = option.NPV();
+
+    BOOST_TEST_MESSAGE("npv (black formula) = " << npv0 << ", npv (amc engine) = " << npv1);
+    BOOST_CHECK_SMALL(npv1 - npv0, 0.01 * npv0);
+}
+
+BOOST_FIXTURE_TEST_CASE(testCommodityForward, AmcEqComTestData) {
+
+    BOOST_TEST_MESSAGE("Testing pricing of commodity forward with AMC engine vs discounting engine");
+
+    CommodityForward fwd(comIndex, EURCurrency(), Position::Short, 100.0, Date(12, January, 2019), 100.0);
+
+    fwd.setPricingEngine(boost::make_shared<DiscountingCommodityForwardEngine>(yts));
+    Real npv0 = fwd.NPV();
+
+    fwd.setPricingEngine(boost::make_shared<McCamCommodityForwardEngine>(
+        model, SobolBrownianBridge, SobolBrownianBridge, 10000, 10000, 42, 42, 4, LsmBasisSystem::Monomial));
+    Real npv1 = fwd.NPV();
+
+    BOOST_TEST_MESSAGE("npv (discounting engine) = " << npv0 << ", npv (amc engine) = " << npv1);
+    BOOST_CHECK_SMALL(npv1 - npv0, 0.01 * std::abs(npv0));
+}
+
+BOOST_FIXTURE_TEST_CASE(testCommodityOption, AmcEqComTestData) {
+
+    BOOST_TEST_MESSAGE("Testing pricing of european commodity option with AMC engine vs Black formula");
+
+    Date expiry(12, January, 2019);
+    Real strike = 101.0;
+    VanillaForwardOption option(boost::make_shared<PlainVanillaPayoff>(Option::Put, strike),
+                                boost::make_shared<EuropeanExercise>(expiry), Date());
+
+    // Var[ln F(T,T)] = V(0,T) - V(T,T), the amc engine pays on expiry + 1
+    Real t = priceCurve->timeFromReference(expiry);
+    Real variance = com->VtT(0.0, t) - com->VtT(t, t);
+    Real npv0 = blackFormula(Option::Put, strike, priceCurve->price(expiry), std::sqrt(variance),
+                             yts->discount(expiry + 1));
+
+    option.setPricingEngine(boost::make_shared<McCamCommodityOptionEngine>(
+        model, comIndex, EURCurrency(), EURCurrency(), SobolBrownianBridge, SobolBrownianBridge, 10000, 10000, 42, 42,
+        4, LsmBasisSystem::Monomial));
+    Real npv1 = option.NPV();
+
+    BOOST_TEST_MESSAGE("npv (black formula) = " << npv0 << ", npv (amc engine) = " << npv1);
+    BOOST_CHECK_SMALL(npv1 - npv0, 0.01 * npv0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
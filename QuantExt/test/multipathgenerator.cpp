@@ -0,0 +1,167 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "toplevelfixture.hpp"
+#include <boost/test/unit_test.hpp>
+
+#include <qle/methods/batchedmultipathgenerator.hpp>
+#include <qle/methods/multipathgeneratorbase.hpp>
+#include <qle/methods/multipathvariategenerator.hpp>
+#include <qle/models/crossassetmodel.hpp>
+#include <qle/models/fxbsconstantparametrization.hpp>
+#include <qle/models/irlgm1fconstantparametrization.hpp>
+
+#include <ql/currencies/america.hpp>
+#include <ql/currencies/europe.hpp>
+#include <ql/math/matrix.hpp>
+#include <ql/processes/geometricbrownianprocess.hpp>
+#include <ql/processes/stochasticprocessarray.hpp>
+#include <ql/quotes/simplequote.hpp>
+#include <ql/termstructures/yield/flatforward.hpp>
+#include <ql/time/calendars/nullcalendar.hpp>
+#include <ql/time/daycounters/actual365fixed.hpp>
+
+#include <boost/make_shared.hpp>
+
+using namespace QuantLib;
+using namespace QuantExt;
+
+BOOST_FIXTURE_TEST_SUITE(QuantExtTestSuite, qle::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(MultiPathGeneratorTest)
+
+namespace {
+boost::shared_ptr<StochasticProcess> testProcess() {
+    std::vector<boost::shared_ptr<StochasticProcess1D>> processes = {
+        boost::make_shared<GeometricBrownianMotionProcess>(100.0, 0.02, 0.20),
+        boost::make_shared<GeometricBrownianMotionProcess>(50.0, 0.01, 0.30)};
+    Matrix corr(2, 2, 1.0);
+    corr[0][1] = corr[1][0] = 0.5;
+    return boost::make_shared<StochasticProcessArray>(processes, corr);
+}
+
+boost::shared_ptr<CrossAssetModel> testModel(const CrossAssetModel::Discretization discretization) {
+    Handle<YieldTermStructure> eurYts(boost::make_shared<FlatForward>(0, NullCalendar(), 0.02, Actual365Fixed()));
+    Handle<YieldTermStructure> usdYts(boost::make_shared<FlatForward>(0, NullCalendar(), 0.03, Actual365Fixed()));
+    std::vector<boost::shared_ptr<Parametrization>> parametrizations = {
+        boost::make_shared<IrLgm1fConstantParametrization>(EURCurrency(), eurYts, 0.01, 0.02),
+        boost::make_shared<IrLgm1fConstantParametrization>(USDCurrency(), usdYts, 0.012, 0.03),
+        boost::make_shared<FxBsConstantParametrization>(
+            USDCurrency(), Handle<Quote>(boost::make_shared<SimpleQuote>(0.9)), 0.15)};
+    Matrix corr(3, 3, 1.0);
+    corr[0][1] = corr[1][0] = 0.6;
+    corr[0][2] = corr[2][0] = 0.2;
+    corr[1][2] = corr[2][1] = -0.2;
+    return boost::make_shared<CrossAssetModel>(parametrizations, corr, SalvagingAlgorithm::None, IrModel::Measure::LGM,
+                                               discretization);
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(testSkipTo) {
+
+    BOOST_TEST_MESSAGE("Testing skipTo() of multi path generators...");
+
+    auto process = testProcess();
+    TimeGrid grid(5.0, 10);
+    const Size samples = 20;
+
+    for (auto s : {MersenneTwister, MersenneTwisterAntithetic, Sobol, SobolBrownianBridge}) {
+        BOOST_TEST_MESSAGE("sequence type " << s);
+        auto gen = makeMultiPathGenerator(s, process, grid, 42);
+        std::vector<MultiPath> reference;
+        for (Size i = 0; i < samples; ++i)
+            reference.push_back(gen->next().value);
+        for (Size n : {0, 1, 2, 7, 12, 19}) {
+            // skip on a used generator, so that we also check that the state is fully reset
+            gen->skipTo(n);
+            for (Size i = n; i < std::min(n + 3, samples); ++i) {
+                const MultiPath& p = gen->next().value;
+                for (Size a = 0; a < p.assetNumber(); ++a) {
+                    for (Size t = 0; t < p.pathSize(); ++t) {
+                        BOOST_CHECK_EQUAL(p[a][t], reference[i][a][t]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testVariateSkipTo) {
+
+    BOOST_TEST_MESSAGE("Testing skipTo() of multi path variate generators...");
+
+    TimeGrid grid(5.0, 10);
+    const Size samples = 20, dimension = 3;
+
+    for (auto s : {MersenneTwister, MersenneTwisterAntithetic, Sobol, SobolBrownianBridge}) {
+        BOOST_TEST_MESSAGE("sequence type " << s);
+        auto gen = makeMultiPathVariateGenerator(s, dimension, grid, 42);
+        std::vector<std::vector<Array>> reference;
+        for (Size i = 0; i < samples; ++i)
+            reference.push_back(gen->next().value);
+        for (Size n : {0, 1, 2, 7, 12, 19}) {
+            gen->skipTo(n);
+            for (Size i = n; i < std::min(n + 3, samples); ++i) {
+                std::vector<Array> v = gen->next().value;
+                for (Size t = 0; t < v.size(); ++t) {
+                    for (Size d = 0; d < dimension; ++d) {
+                        BOOST_CHECK_EQUAL(v[t][d], reference[i][t][d]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testBatchedPaths) {
+
+    BOOST_TEST_MESSAGE("Testing batched multi path generator against serial path generation...");
+
+    TimeGrid grid(5.0, 10);
+    const Size samples = 50;
+
+    for (auto discretization : {CrossAssetModel::Discretization::Exact, CrossAssetModel::Discretization::Euler}) {
+        auto process = testModel(discretization)->stateProcess();
+        for (auto s : {MersenneTwister, MersenneTwisterAntithetic, Sobol, SobolBrownianBridge}) {
+            BOOST_TEST_MESSAGE("sequence type " << s);
+            auto serial = makeMultiPathGenerator(s, process, grid, 42);
+            BatchedMultiPathGenerator batched(s, process, grid, 42, SobolBrownianGenerator::Steps, SobolRsg::JoeKuoD7,
+                                              16);
+            std::vector<std::vector<RandomVariable>> paths;
+            batched.nextBatch(samples, paths);
+            batched.reset();
+            BOOST_REQUIRE_EQUAL(paths.size(), grid.size() - 1);
+            for (Size i = 0; i < samples; ++i) {
+                const MultiPath& p = serial->next().value;
+                const MultiPath& q = batched.next().value;
+                for (Size a = 0; a < p.assetNumber(); ++a) {
+                    for (Size t = 0; t < p.pathSize(); ++t) {
+                        BOOST_CHECK_SMALL(q[a][t] - p[a][t], 1E-12);
+                        if (t > 0) {
+                            BOOST_CHECK_SMALL(paths[t - 1][a][i] - p[a][t], 1E-12);
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
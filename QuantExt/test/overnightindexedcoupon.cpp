@@ -0,0 +1,124 @@
+/*
+ Copyright (C) 2023 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include "toplevelfixture.hpp"
+#include <boost/test/unit_test.hpp>
+#include <ql/indexes/ibor/estr.hpp>
+#include <ql/indexes/indexmanager.hpp>
+#include <ql/termstructures/yield/flatforward.hpp>
+#include <ql/time/daycounters/actual360.hpp>
+#include <qle/cashflows/overnightindexedcoupon.hpp>
+
+#include <boost/make_shared.hpp>
+
+using namespace QuantLib;
+using namespace QuantExt;
+using namespace boost::unit_test_framework;
+
+namespace {
+
+struct OisCouponTestData {
+    OisCouponTestData()
+        : today(16, Jan, 2023), start(3, Jan, 2023), end(3, Feb, 2023),
+          curve(boost::make_shared<FlatForward>(today, 0.02, Actual360())),
+          index(boost::make_shared<Estr>(curve)) {
+        Settings::instance().evaluationDate() = today;
+        IndexManager::instance().clearHistories();
+        coupon = makeCoupon();
+        setFixings(0.01);
+    }
+    ~OisCouponTestData() { IndexManager::instance().clearHistories(); }
+
+    boost::shared_ptr<OvernightIndexedCoupon> makeCoupon() const {
+        return boost::make_shared<OvernightIndexedCoupon>(end, 1.0, start, end, index, 1.0, 0.001, Date(), Date(),
+                                                          DayCounter(), false, true);
+    }
+
+    // sets the fixing history for the past fixing dates of the coupon to a flat value
+    void setFixings(const Real value) const {
+        TimeSeries<Real> history;
+        for (auto const& d : coupon->fixingDates())
+            if (d < today)
+                history[d] = value;
+        IndexManager::instance().setHistory(index->name(), history);
+    }
+
+    SavedSettings backup;
+    Date today, start, end;
+    Handle<YieldTermStructure> curve;
+    boost::shared_ptr<OvernightIndex> index;
+    boost::shared_ptr<OvernightIndexedCoupon> coupon;
+};
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(QuantExtTestSuite, qle::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(OvernightIndexedCouponTest)
+
+BOOST_FIXTURE_TEST_CASE(testCachedPastFixingsMovingEvaluationDate, OisCouponTestData) {
+
+    BOOST_TEST_MESSAGE("Testing cached past fixings of OIS coupon with moving evaluation date...");
+
+    coupon->rate();
+    for (Date d = today + 1; d < end; ++d) {
+        Settings::instance().evaluationDate() = d;
+        if (index->isValidFixingDate(d - 1))
+            index->addFixing(d - 1, 0.01 + 0.0001 * (d - today));
+        BOOST_CHECK_CLOSE(coupon->rate(), makeCoupon()->rate(), 1E-10);
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(testCachedPastFixingsSetHistory, OisCouponTestData) {
+
+    BOOST_TEST_MESSAGE("Testing cached past fixings of OIS coupon after IndexManager::setHistory()...");
+
+    Real rate0 = coupon->rate();
+    setFixings(0.03);
+    Real rate1 = coupon->rate();
+    BOOST_CHECK(std::abs(rate1 - rate0) > 1E-6);
+    BOOST_CHECK_CLOSE(rate1, makeCoupon()->rate(), 1E-10);
+}
+
+BOOST_FIXTURE_TEST_CASE(testCachedPastFixingsOverwrite, OisCouponTestData) {
+
+    BOOST_TEST_MESSAGE("Testing cached past fixings of OIS coupon after overwriting a fixing...");
+
+    Real rate0 = coupon->rate();
+    Date d = coupon->fixingDates()[3];
+    BOOST_REQUIRE(d < today);
+    index->addFixing(d, 0.05, true);
+    Real rate1 = coupon->rate();
+    BOOST_CHECK(std::abs(rate1 - rate0) > 1E-6);
+    BOOST_CHECK_CLOSE(rate1, makeCoupon()->rate(), 1E-10);
+}
+
+BOOST_FIXTURE_TEST_CASE(testCachedPastFixingsClearHistories, OisCouponTestData) {
+
+    BOOST_TEST_MESSAGE("Testing cached past fixings of OIS coupon after IndexManager::clearHistories()...");
+
+    coupon->rate();
+    IndexManager::instance().clearHistories();
+    BOOST_CHECK_THROW(coupon->rate(), QuantLib::Error);
+    setFixings(0.02);
+    BOOST_CHECK_CLOSE(coupon->rate(), makeCoupon()->rate(), 1E-10);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()